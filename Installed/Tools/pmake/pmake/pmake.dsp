@@ -101,6 +101,19 @@ SOURCE=..\..\..\..\Tools\pmake\pmake\arch.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\..\Tools\pmake\pmake\cache.c
+
+!IF  "$(CFG)" == "pmake - Win32 Release"
+
+!ELSEIF  "$(CFG)" == "pmake - Win32 Debug"
+
+# ADD CPP /I "$(ROOT_DIR)\Tools\vc++\include $(ROOT_DIR)\Tools\include"
+
+!ENDIF 
+
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\..\..\Tools\pmake\pmake\compat.c
 
 !IF  "$(CFG)" == "pmake - Win32 Release"
@@ -31,7 +31,12 @@
  * DESCRIPTION:
  *	Implementation of the Table object.
  *
- *	XXX: Optimize for byte-sized elements?
+ *	To avoid walking the chunks to find a position, each table keeps
+ *	the position of the first element of each chunk in a parallel
+ *	array. Operations that change the number of elements in a chunk
+ *	invalidate the entries for the chunks that follow it, and these
+ *	are recomputed when next needed. The chunk found by the most
+ *	recent search is checked first, as accesses tend to be clustered.
  *
  ***********************************************************************/
 #ifndef lint
@@ -60,12 +65,22 @@ typedef struct {
     int	    	tableSize;  	/* Number of elements in the table */
     int	    	eltSize;    	/* Size of each element */
     int	    	eltsPerChunk;	/* Initial size of each chunk */
+    int	    	*starts;    	/* Position of first element in each chunk */
+    int	    	numStarts;  	/* Number of valid entries in starts */
+    int	    	maxStarts;  	/* Number of entries allocated for starts */
+    int	    	hint;	    	/* Chunk found by the last search */
 } TableRec, *TablePtr;
 
 #define INITIAL_NUM_CHUNKS  	1
 
 #define SCALE(pos,tp)  ((tp)->eltSize==1?(pos):(pos)*(tp)->eltSize)
 
+/*
+ * Note that the number of elements in chunk i has changed, so the starting
+ * positions of all chunks after it are no longer known.
+ */
+#define TableDirty(tp,i)    if ((tp)->numStarts > (i)+1) (tp)->numStarts = (i)+1
+
 
 /***********************************************************************
  *				TableVerify
@@ -81,25 +96,120 @@ typedef struct {
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	11/ 6/89	Initial Revision
+ *	agent	10/16/26	Full check only if TABLE_DEBUG, as it's
+ *				linear in the size of the table
  *
  ***********************************************************************/
 static void
 TableVerify(TablePtr	tp)
 {
+#if defined(TABLE_DEBUG)
     int	    	    i;
     TableChunk      *tcp;
     int	    	    size;
 
     assert(tp->numChunks <=
               malloc_size((malloc_t)tp->chunks)/sizeof(TableChunk));
-    assert(tp->numChunks >= 1);
 
     for (i = 0, size = 0, tcp = tp->chunks; i < tp->numChunks; i++, tcp++) {
+	if (i < tp->numStarts) {
+	    assert(tp->starts[i] == size);
+	}
 	size += tcp->numElts;
 	assert(tcp->maxElts <= malloc_size(tcp->elts)/tp->eltSize);
 	assert(tcp->numElts <= tcp->maxElts);
     }
     assert(size == tp->tableSize);
+#endif /* TABLE_DEBUG */
+    assert(tp->numChunks >= 1);
+    assert(tp->numStarts <= tp->numChunks);
+}
+
+
+/***********************************************************************
+ *				TableFind
+ ***********************************************************************
+ * SYNOPSIS:	    Locate the chunk holding an element of the table.
+ * CALLED BY:	    Table_Delete, Table_Insert, Table_Store, Table_Lookup,
+ *		    Table_Fetch
+ * RETURN:	    The index of the chunk, or tp->numChunks if pos is
+ *		    beyond the end of the table.
+ *		    *offPtr set to the position of the element within
+ *		    the chunk.
+ * SIDE EFFECTS:    The starting positions of the chunks may be computed
+ *		    and the search hint updated.
+ *
+ * STRATEGY:	    Try the chunk found last time, and the one after it,
+ *		    before bringing the starts array up to date and doing
+ *		    a binary search. The last chunk whose start is <= pos
+ *		    can't be empty unless pos is beyond the end of the
+ *		    table, so empty chunks need no special handling.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+TableFind(TablePtr  tp,
+	  int	    pos,
+	  int	    *offPtr)
+{
+    int	    i;
+    int	    lo, hi;
+
+    if ((pos < 0) || (pos >= tp->tableSize)) {
+	*offPtr = pos - tp->tableSize;
+	return(tp->numChunks);
+    }
+
+    for (i = tp->hint; i < tp->hint + 2 && i < tp->numStarts; i++) {
+	if ((pos >= tp->starts[i]) &&
+	    (pos < tp->starts[i] + tp->chunks[i].numElts))
+	{
+	    tp->hint = i;
+	    *offPtr = pos - tp->starts[i];
+	    return(i);
+	}
+    }
+
+    /*
+     * Bring the starting positions up to date.
+     */
+    if (tp->numStarts < tp->numChunks) {
+	if (tp->maxStarts < tp->numChunks) {
+	    tp->maxStarts = tp->numChunks * 2;
+	    tp->starts = (int *)realloc((void *)tp->starts,
+					tp->maxStarts * sizeof(int));
+	}
+	if (tp->numStarts == 0) {
+	    tp->starts[0] = 0;
+	    tp->numStarts = 1;
+	}
+	for (i = tp->numStarts; i < tp->numChunks; i++) {
+	    tp->starts[i] = tp->starts[i-1] + tp->chunks[i-1].numElts;
+	}
+	tp->numStarts = tp->numChunks;
+    }
+
+    /*
+     * Find the last chunk starting at or before pos.
+     */
+    lo = 0;
+    hi = tp->numChunks - 1;
+    while (lo < hi) {
+	i = (lo + hi + 1) / 2;
+	if (tp->starts[i] <= pos) {
+	    lo = i;
+	} else {
+	    hi = i - 1;
+	}
+    }
+
+    tp->hint = lo;
+    *offPtr = pos - tp->starts[lo];
+    return(lo);
 }
 
 /***********************************************************************
@@ -133,6 +243,10 @@ Table_Init(int	eltSize,    	    /* Size of each element */
     tp->tableSize = 	0;
     tp->eltSize =   	eltSize;
     tp->eltsPerChunk = 	eltsPerChunk;
+    tp->starts =    	(int *)malloc(tp->numChunks * sizeof(int));
+    tp->numStarts = 	0;
+    tp->maxStarts = 	tp->numChunks;
+    tp->hint =	    	0;
 
     for (i = 0; i < tp->numChunks; i++) {
 	tp->chunks[i].numElts = 0;
@@ -169,12 +283,23 @@ Table_Delete(Table  table,  	/* Table to alter */
     TablePtr	    tp = (TablePtr)table;
     int	    	    i;
     TableChunk	    *tcp;
+    int	    	    first;
 
     TableVerify(tp);
 
+    /*
+     * Start with the chunk holding pos. Its start doesn't change, but
+     * those of all the chunks after it may.
+     */
+    first = TableFind(tp, pos, &pos);
+    if (first == tp->numChunks) {
+	return;
+    }
+    TableDirty(tp, first);
+
     tp->tableSize -= numElts;
 
-    for (i = tp->numChunks, tcp = tp->chunks;
+    for (i = tp->numChunks - first, tcp = &tp->chunks[first];
 	 numElts > 0 && i > 0;
 	 i--, tcp++)
     {
@@ -258,6 +383,7 @@ Table_Insert(Table  table,
     TablePtr	    tp = (TablePtr)table;
     int	    	    i;
     TableChunk	    *tcp;
+    int	    	    first;
 
     TableVerify(tp);
     assert(numElts <= tp->eltsPerChunk);
@@ -269,9 +395,23 @@ Table_Insert(Table  table,
 	return;
     }
 
+    /*
+     * Start with the chunk holding pos. If pos is at or beyond the end,
+     * only the final chunk (and any added after it) can change.
+     */
+    first = TableFind(tp, pos, &pos);
+    if (first == tp->numChunks) {
+	pos = tp->chunks[tp->numChunks-1].numElts;
+	first = tp->numChunks-1;
+    }
+    TableDirty(tp, first);
+
     tp->tableSize += numElts;
 
-    for (i = tp->numChunks, tcp = tp->chunks; i > 0; i--, tcp++) {
+    for (i = tp->numChunks - first, tcp = &tp->chunks[first];
+	 i > 0;
+	 i--, tcp++)
+    {
 	if (pos >= tcp->numElts) {
 	    pos -= tcp->numElts;
 	} else {
@@ -662,8 +802,8 @@ Table_Write(Table   	    table,
  *
  * STRATEGY:	    If pos is TABLE_END, we know we can just extend the
  *	    	    puppy, so we do so.
- *	    	    Else, run through the chunks looking for where to
- *	    	    start storing the new elements. Store the elements
+ *	    	    Else, find the chunk in which to start storing the
+ *	    	    new elements. A single byte is stored directly. Store the elements
  *	    	    in the appropriate chunks w/o modifying the lengths
  *	    	    at all (not inserting, only overwriting). If there
  *	    	    are still elements to be stored when we reach the
@@ -764,7 +904,21 @@ Table_Store(Table   table,  	/* Table to modify */
 	result = (void *)NULL;
 
 	if (pos < tp->tableSize) {
-	    for (i=tp->numChunks, tcp=tp->chunks; i > 0 && numElts; i--, tcp++)
+	    i = TableFind(tp, pos, &pos);
+	    tcp = &tp->chunks[i];
+
+	    if ((numElts == 1) && (tp->eltSize == 1)) {
+		/*
+		 * Single byte, as when fixing up code -- no need for bcopy
+		 * or the loop.
+		 */
+		result = tcp->elts + pos;
+		*(byte *)result = *(byte *)eltPtr;
+		TableVerify(tp);
+		return(result);
+	    }
+
+	    for (i = tp->numChunks - i; i > 0 && numElts; i--, tcp++)
 	    {
 		if (pos < tcp->numElts) {
 		    int 	numCopy;
@@ -942,18 +1096,14 @@ Table_Lookup(Table  table,
 {
     TablePtr	    tp = (TablePtr)table;
     int	    	    i;
-    TableChunk	    *tcp;
 
     TableVerify(tp);
 
-    for (i = tp->numChunks, tcp = tp->chunks; i > 0; i--, tcp++) {
-	if (pos >= tcp->numElts) {
-	    pos -= tcp->numElts;
-	} else {
-	    return (tcp->elts + SCALE(pos,tp));
-	}
+    i = TableFind(tp, pos, &pos);
+    if (i == tp->numChunks) {
+	return((void *)NULL);
     }
-    return((void *)NULL);
+    return (tp->chunks[i].elts + SCALE(pos,tp));
 }
 
 
@@ -1084,25 +1234,26 @@ Table_Fetch(Table   table,  	/* Table from which to extract */
 
     TableVerify(tp);
 
-    for (i = tp->numChunks, tcp = tp->chunks; i > 0; i--, tcp++) {
-	if (pos >= tcp->numElts) {
-	    pos -= tcp->numElts;
-	} else {
-	    break;
-	}
-    }
+    i = TableFind(tp, pos, &pos);
 
-    if (i == 0) {
+    if (i == tp->numChunks) {
 	/*
 	 * Elements not in the table, so return 0.
 	 */
 	bzero(eltPtr, SCALE(numElts,tp));
 	return;
     }
+    tcp = &tp->chunks[i];
+    i = tp->numChunks - i;
 
     ep = tcp->elts + (pos * tp->eltSize);
 
-    if (tcp->numElts - pos >= numElts) {
+    if ((numElts == 1) && (tp->eltSize == 1)) {
+	/*
+	 * Single byte -- no need for bcopy.
+	 */
+	*(byte *)eltPtr = *(byte *)ep;
+    } else if (tcp->numElts - pos >= numElts) {
 	/*
 	 * All in this chunk -- just copy them into the buffer.
 	 */
@@ -80,6 +80,7 @@ extern int  	    numImport;	    /* Number of libraries actually imported
 extern EntryPt 	    *entryPoints;   /* Entry points exported by the
 				     * geode/kernel */
 extern int  	    numEPs; 	    /* Number of entry points exported */
+extern int  	    numPublished;   /* Number of routines marked published */
 
 extern int  	    makeLDF;	    /* Non-zero if .ldf file should be created
 				     * for library/kernel */
@@ -110,6 +110,10 @@ SOURCE=.\geo.c
 # End Source File
 # Begin Source File
 
+SOURCE=.\incr.c
+# End Source File
+# Begin Source File
+
 SOURCE=.\kernel.c
 # End Source File
 # Begin Source File
@@ -198,6 +202,10 @@ SOURCE=.\glue.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\incr.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\library.h
 # End Source File
 # Begin Source File
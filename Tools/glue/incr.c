@@ -0,0 +1,555 @@
+/***********************************************************************
+ *
+ *	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * PROJECT:	  PCGEOS
+ * MODULE:	  Glue -- Incremental linking
+ * FILE:	  incr.c
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * ROUTINES:
+ *	Name	  	    Description
+ *	----	  	    -----------
+ *	Incr_Init   	    Figure the name of the link-state file
+ *	Incr_UpToDate	    See if the last link's outputs are still good
+ *	Incr_NoteInput	    Record a file the link read (or looked for)
+ *	Incr_NoteOutput	    Record a file the link produced
+ *	Incr_Save   	    Write the link-state file after a good link
+ *	Incr_Touch  	    Bring the outputs of a skipped link up to date
+ *
+ * REVISION HISTORY:
+ *	Date	  Name	    Description
+ *	----	  ----	    -----------
+ *	10/16/26  agent	    Initial version
+ *
+ * DESCRIPTION:
+ *	When -I is given, glue keeps a link-state file (<output>.gls) next
+ *	to the output recording the arguments it was given, a fingerprint
+ *	(size and content hash) of every object, library, parameter and
+ *	platform file it read, and the size and modification time of every
+ *	file it wrote. If a later link is given the same arguments and
+ *	every input still has the same contents, the outputs from the
+ *	previous link are kept rather than being regenerated. This
+ *	is what happens when an object is recompiled without its contents
+ *	changing, e.g. when a header is touched. The kept outputs have
+ *	their modification times updated so make sees them as newer than
+ *	the inputs and doesn't run glue again next time.
+ *
+ *	Any input that has actually changed gets a full link: the symbol
+ *	file is rebuilt from scratch in pass 1, and pass 2 writes the
+ *	relocations and the output image together, so there's no partial
+ *	result from the previous link to patch.
+ *
+ *	Files that were looked for but not found (as when searching the
+ *	library path) are recorded too, so a library appearing earlier in
+ *	the search path forces a relink.
+ *
+ *	The file is plain text:
+ *	    glue-link-state <version>
+ *	    args <hash>
+ *	    in <size> <hash> <mtime> <path>	(size -1 if absent)
+ *	    out <size> <mtime> <path>
+ *
+ ***********************************************************************/
+#ifndef lint
+static char *rcsid =
+"$Id$";
+#endif lint
+
+#include    "glue.h"
+#include    "incr.h"
+#include    <sys/types.h>
+#include    <sys/stat.h>
+#if defined(_WIN32)
+#include    <sys/utime.h>
+#else
+#include    <utime.h>
+#endif
+
+#define INCR_MAGIC  	"glue-link-state"
+#define INCR_VERSION	1
+
+typedef struct _IncrFile {
+    struct _IncrFile	*next;
+    long    	    	size;	    /* -1 if the file doesn't exist */
+    unsigned long   	hash;	    /* Hash of the contents (inputs only) */
+    long    	    	mtime;	    /* Modification time */
+    char    	    	name[LABEL_IN_STRUCT];
+} IncrFile;
+
+int 	    	incrWanted = 0;
+
+static char 	    	*incrFile;	/* Name of the link-state file */
+static unsigned long	incrArgs;	/* Hash of the arguments */
+static IncrFile	    	*incrInputs;
+static IncrFile	    	*incrOutputs;
+
+
+/***********************************************************************
+ *				IncrHash
+ ***********************************************************************
+ * SYNOPSIS:	    Add bytes to a running FNV-1a hash.
+ * CALLED BY:	    INTERNAL
+ * RETURN:	    The new hash value
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static unsigned long
+IncrHash(unsigned long	    hash,
+	 const unsigned char *bytes,
+	 int	    	    len)
+{
+    while (len-- > 0) {
+	hash = ((hash ^ *bytes++) * 16777619UL) & 0xffffffffUL;
+    }
+    return(hash);
+}
+
+
+/***********************************************************************
+ *				IncrFingerprint
+ ***********************************************************************
+ * SYNOPSIS:	    Find the size, modification time and, if desired,
+ *		    content hash of a file.
+ * CALLED BY:	    Incr_NoteInput, Incr_NoteOutput, Incr_UpToDate
+ * RETURN:	    Nothing. *sizePtr is -1 if the file doesn't exist.
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+IncrFingerprint(const char  	*file,
+		long	    	*sizePtr,
+		long	    	*mtimePtr,
+		unsigned long	*hashPtr)   /* NULL if no hash wanted */
+{
+    struct stat	    stb;
+    FILE    	    *f;
+    unsigned char   buf[8192];
+    int	    	    n;
+    unsigned long   hash;
+
+    if (stat(file, &stb) < 0) {
+	*sizePtr = -1;
+	*mtimePtr = 0;
+	if (hashPtr != NULL) {
+	    *hashPtr = 0;
+	}
+	return;
+    }
+    *sizePtr = (long)stb.st_size;
+    *mtimePtr = (long)stb.st_mtime;
+
+    if (hashPtr == NULL) {
+	return;
+    }
+
+    hash = 2166136261UL;
+    f = fopen(file, "rb");
+    if (f != NULL) {
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+	    hash = IncrHash(hash, buf, n);
+	}
+	fclose(f);
+    }
+    *hashPtr = hash;
+}
+
+
+/***********************************************************************
+ *				IncrAdd
+ ***********************************************************************
+ * SYNOPSIS:	    Add a file to a list, if it's not already there.
+ * CALLED BY:	    Incr_NoteInput, Incr_NoteOutput
+ * RETURN:	    The record for the file, or NULL if already present.
+ * SIDE EFFECTS:    Memory is allocated.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static IncrFile *
+IncrAdd(IncrFile    **listPtr,
+	const char  *file)
+{
+    IncrFile	*ifp;
+
+    for (ifp = *listPtr; ifp != NULL; ifp = ifp->next) {
+	if (strcmp(ifp->name, file) == 0) {
+	    return(NULL);
+	}
+    }
+
+    ifp = (IncrFile *)malloc(sizeof(IncrFile) + strlen(file) + 1);
+    strcpy(ifp->name, file);
+    ifp->next = *listPtr;
+    *listPtr = ifp;
+
+    return(ifp);
+}
+
+
+/***********************************************************************
+ *				IncrFree
+ ***********************************************************************
+ * SYNOPSIS:	    Free all the records in a list.
+ * CALLED BY:	    Incr_UpToDate
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    *listPtr is set to NULL.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+IncrFree(IncrFile   **listPtr)
+{
+    IncrFile	*ifp, *next;
+
+    for (ifp = *listPtr; ifp != NULL; ifp = next) {
+	next = ifp->next;
+	free((malloc_t)ifp);
+    }
+    *listPtr = NULL;
+}
+
+
+/***********************************************************************
+ *				Incr_Init
+ ***********************************************************************
+ * SYNOPSIS:	    Prepare for an incremental link.
+ * CALLED BY:	    main
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    incrFile and incrArgs are set.
+ *
+ * STRATEGY:	    The link-state file is named by replacing the
+ *		    output file's suffix with "gls", just as for the
+ *		    .sym and .map files.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Incr_Init(char	*outfile,
+	  int	argc,
+	  char	**argv)
+{
+    char    	*cp;
+    int	    	i;
+
+    incrFile = (char *)malloc(strlen(outfile) + 1 + 3 + 1);
+    strcpy(incrFile, outfile);
+
+    cp = (char *)rindex(incrFile, '.');
+
+    if (cp++ == NULL) {
+	cp = incrFile + strlen(incrFile);
+	*cp++ = '.';
+    }
+    strcpy(cp, "gls");
+
+    /*
+     * The arguments include the names of all the objects, so there's no
+     * need to worry about the order or number of them separately.
+     */
+    incrArgs = 2166136261UL;
+    for (i = 1; i < argc; i++) {
+	incrArgs = IncrHash(incrArgs, (unsigned char *)argv[i],
+			    strlen(argv[i]) + 1);
+    }
+}
+
+
+/***********************************************************************
+ *				Incr_UpToDate
+ ***********************************************************************
+ * SYNOPSIS:	    See if the outputs of the previous link can be
+ *		    used as-is.
+ * CALLED BY:	    main
+ * RETURN:	    TRUE if nothing needs to be done.
+ * SIDE EFFECTS:    If a link is required, the link-state file is
+ *		    removed so a failed link can't leave it behind.
+ *		    Otherwise the files it lists are recorded for
+ *		    Incr_Touch.
+ *
+ * STRATEGY:	    An input whose size and modification time match is
+ *		    taken to be unchanged without reading it. One that
+ *		    has merely been touched is hashed and compared.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+int
+Incr_UpToDate(void)
+{
+    FILE    	    *f;
+    char    	    line[1024];
+    int	    	    version;
+    unsigned long   args;
+    int	    	    upToDate;
+
+    f = fopen(incrFile, "r");
+    if (f == NULL) {
+	return(FALSE);
+    }
+
+    upToDate = FALSE;
+
+    if ((fgets(line, sizeof(line), f) == NULL) ||
+	(sscanf(line, INCR_MAGIC " %d", &version) != 1) ||
+	(version != INCR_VERSION) ||
+	(fgets(line, sizeof(line), f) == NULL) ||
+	(sscanf(line, "args %lx", &args) != 1) ||
+	(args != incrArgs))
+    {
+	goto done;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+	long	    	size, mtime, csize, cmtime;
+	unsigned long	hash, chash;
+	int	    	n;
+	char	    	*name;
+	IncrFile    	*ifp;
+
+	n = strlen(line);
+	while ((n > 0) && ((line[n-1] == '\n') || (line[n-1] == '\r'))) {
+	    line[--n] = '\0';
+	}
+
+	if (sscanf(line, "in %ld %lx %ld %n", &size, &hash, &mtime, &n) == 3) {
+	    name = line + n;
+	    IncrFingerprint(name, &csize, &cmtime, (unsigned long *)NULL);
+	    if (csize != size) {
+		printf("%s changed\n", name);
+		goto done;
+	    }
+	    if ((size != -1) && (cmtime != mtime)) {
+		IncrFingerprint(name, &csize, &cmtime, &chash);
+		if (chash != hash) {
+		    printf("%s changed\n", name);
+		    goto done;
+		}
+	    }
+	    /*
+	     * Remember the current modification time, so a touched input
+	     * needn't be hashed again next time.
+	     */
+	    if ((ifp = IncrAdd(&incrInputs, name)) != NULL) {
+		ifp->size = size;
+		ifp->hash = hash;
+		ifp->mtime = cmtime;
+	    }
+	} else if (sscanf(line, "out %ld %ld %n", &size, &mtime, &n) == 2) {
+	    name = line + n;
+	    IncrFingerprint(name, &csize, &cmtime, (unsigned long *)NULL);
+	    if ((csize != size) || (cmtime != mtime)) {
+		printf("%s changed\n", name);
+		goto done;
+	    }
+	    (void)IncrAdd(&incrOutputs, name);
+	} else {
+	    goto done;
+	}
+    }
+    upToDate = TRUE;
+
+done:
+    fclose(f);
+    if (!upToDate) {
+	/*
+	 * The real link will note its own inputs and outputs, and
+	 * Incr_NoteInput won't fingerprint a file it's already seen.
+	 */
+	IncrFree(&incrInputs);
+	IncrFree(&incrOutputs);
+	(void)unlink(incrFile);
+    }
+    return(upToDate);
+}
+
+
+/***********************************************************************
+ *				Incr_NoteInput
+ ***********************************************************************
+ * SYNOPSIS:	    Record a file the link is reading, or tried to read.
+ * CALLED BY:	    Obj_Open, Parse_GeodeParams, Library_ReadPlatformFile
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The file is read and hashed, if it exists.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Incr_NoteInput(const char   *file)
+{
+    IncrFile	*ifp;
+
+    if (!incrWanted || ((ifp = IncrAdd(&incrInputs, file)) == NULL)) {
+	return;
+    }
+    IncrFingerprint(file, &ifp->size, &ifp->mtime, &ifp->hash);
+}
+
+
+/***********************************************************************
+ *				Incr_NoteOutput
+ ***********************************************************************
+ * SYNOPSIS:	    Record a file the link is producing.
+ * CALLED BY:	    main, Library_WriteLDF
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    None. The file is examined by Incr_Save.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Incr_NoteOutput(const char  *file)
+{
+    if (incrWanted) {
+	(void)IncrAdd(&incrOutputs, file);
+    }
+}
+
+
+/***********************************************************************
+ *				Incr_Save
+ ***********************************************************************
+ * SYNOPSIS:	    Write the link-state file after a successful link.
+ * CALLED BY:	    main
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The link-state file is (re)created.
+ *
+ * STRATEGY:	    Write to a temporary file and rename it into place,
+ *		    so an interrupted write can't produce a file that
+ *		    claims the outputs are good.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Incr_Save(void)
+{
+    FILE    	*f;
+    IncrFile	*ifp;
+    char    	*tmp;
+    int	    	ok;
+
+    if (!incrWanted) {
+	return;
+    }
+
+    tmp = (char *)malloc(strlen(incrFile) + 2);
+    sprintf(tmp, "%s~", incrFile);
+
+    f = fopen(tmp, "w");
+    if (f == NULL) {
+	Notify(NOTIFY_WARNING, "couldn't create link-state file %s", tmp);
+	free((malloc_t)tmp);
+	return;
+    }
+
+    fprintf(f, "%s %d\n", INCR_MAGIC, INCR_VERSION);
+    fprintf(f, "args %lx\n", incrArgs);
+    for (ifp = incrInputs; ifp != NULL; ifp = ifp->next) {
+	fprintf(f, "in %ld %lx %ld %s\n", ifp->size, ifp->hash, ifp->mtime,
+		ifp->name);
+    }
+    for (ifp = incrOutputs; ifp != NULL; ifp = ifp->next) {
+	IncrFingerprint(ifp->name, &ifp->size, &ifp->mtime,
+			(unsigned long *)NULL);
+	fprintf(f, "out %ld %ld %s\n", ifp->size, ifp->mtime, ifp->name);
+    }
+
+    ok = !ferror(f);
+    if (fclose(f) != 0) {
+	ok = FALSE;
+    }
+
+#if defined(_WIN32)
+    /*
+     * rename() won't replace an existing file here.
+     */
+    (void)unlink(incrFile);
+#endif
+    if (!ok || (rename(tmp, incrFile) < 0)) {
+	Notify(NOTIFY_WARNING, "couldn't write link-state file %s", incrFile);
+	(void)unlink(tmp);
+    }
+    free((malloc_t)tmp);
+}
+
+
+/***********************************************************************
+ *				Incr_Touch
+ ***********************************************************************
+ * SYNOPSIS:	    Mark the outputs of a skipped link as current.
+ * CALLED BY:	    main
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The outputs' modification times are set to now and
+ *		    the link-state file is rewritten to match.
+ *
+ * STRATEGY:	    Without this, an input that was rebuilt without
+ *		    changing would stay newer than the outputs and make
+ *		    would run glue on every build.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Incr_Touch(void)
+{
+    IncrFile	*ifp;
+
+    for (ifp = incrOutputs; ifp != NULL; ifp = ifp->next) {
+	if (utime(ifp->name, NULL) < 0) {
+	    Notify(NOTIFY_WARNING, "couldn't update modification time of %s",
+		   ifp->name);
+	}
+    }
+    Incr_Save();
+}
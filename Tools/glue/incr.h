@@ -0,0 +1,33 @@
+/***********************************************************************
+ *
+ *	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * PROJECT:	  PCGEOS
+ * MODULE:	  Glue -- Incremental linking
+ * FILE:	  incr.h
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * REVISION HISTORY:
+ *	Date	  Name	    Description
+ *	----	  ----	    -----------
+ *	10/16/26  agent	    Initial version
+ *
+ * DESCRIPTION:
+ *	Interface to the link-state file kept beside the output when
+ *	incremental linking is enabled.
+ *
+ ***********************************************************************/
+#ifndef _INCR_H_
+#define _INCR_H_
+
+extern int  	incrWanted; 	/* Non-zero if -I given */
+
+extern void 	Incr_Init(char *outfile, int argc, char **argv);
+extern int  	Incr_UpToDate(void);
+extern void 	Incr_NoteInput(const char *file);
+extern void 	Incr_NoteOutput(const char *file);
+extern void 	Incr_Save(void);
+extern void 	Incr_Touch(void);
+
+#endif /* _INCR_H_ */
@@ -46,6 +46,7 @@ static char *rcsid =
 #include    "sym.h"
 #include    "parse.h"
 #include    "library.h"
+#include    "incr.h"
 #include    "st.h"
 #include    <ctype.h>
 
@@ -71,6 +72,7 @@ int	            numPlatformLibs = 0;
 int	    numImport = 0;
 EntryPt	    *entryPoints;
 int	    numEPs = 0;
+int	    numPublished = 0;
 
 static VMHandle	    	ldf;	    /* Handle open to .ldf file */
 static VMBlockHandle	ldfStrings; /* String table for the thing */
@@ -200,6 +202,7 @@ LibraryEnsureOpen(void)
 	 * Make sure any old version is biffed
 	 */
 	(void)unlink(file);
+	Incr_NoteOutput(file);
 	/*
 	 * Attempt to create a new version.
 	 */
@@ -808,6 +811,7 @@ Library_MarkPublished(char 	*name)
 	sym->flags |= OSYM_REF;
 	sym->u.proc.flags |= OSYM_PROC_PUBLISHED;
 	VMUnlockDirty(symbols, symBlock);
+	numPublished++;
 
 	/*
 	 * Add the published symbol into the .ldf file so we can store the
@@ -2131,6 +2135,7 @@ Library_ReadPlatformFile(char   *name) /* File name */
                     minorProto;
 
     sprintf(file, "%s.plt", name);
+    Incr_NoteInput(file);
     fh = fopen(file, "r");
     if (fh == NULL) {
 	/*
@@ -2141,6 +2146,7 @@ Library_ReadPlatformFile(char   *name) /* File name */
 	     * Stick the name onto the end of this directory and try that
 	     */
 	    sprintf(file, "%s"QUOTED_SLASH"%s.plt", dirs[i], name);
+	    Incr_NoteInput(file);
 	    fh = fopen(file, "r");
 	    if (fh != NULL) {
 		break;
@@ -2239,6 +2245,7 @@ Library_ReadShipFile(char   *name) /* File name */
                     minorProto;
 
     sprintf(file, "%s.plt", name);
+    Incr_NoteInput(file);
     fh = fopen(file, "r");
     if (fh == NULL) {
 	/*
@@ -2249,6 +2256,7 @@ Library_ReadShipFile(char   *name) /* File name */
 	     * Stick the name onto the end of this directory and try that
 	     */
 	    sprintf(file, "%s"QUOTED_SLASH"%s.plt", dirs[i], name);
+	    Incr_NoteInput(file);
 	    fh = fopen(file, "r");
 	    if (fh != NULL) {
 		break;
@@ -38,6 +38,7 @@ static char *rcsid =
 #include    "sym.h"
 #include    "geo.h"
 #include    "library.h"
+#include    "incr.h"
 
 #define Boolean SpriteBoolean
 #define Address SpriteAddress
@@ -736,7 +737,8 @@ usage(char  *cmd, char *msg)
 	{"-G <major>", "specify the major release number of the PC/GEOS system"},
 	{"-z", "output resouce number info and longname into rsc.rsc"},
 	{"-f", "create old format symbol file"},
-	{"-F<dir>", "specify product directory for .ldf and rsc.rsc file"}
+	{"-F<dir>", "specify product directory for .ldf and rsc.rsc file"},
+	{"-I", "keep the outputs if no input has changed since the last -I link"}
     };
 
     /*
@@ -1972,6 +1974,9 @@ main(argc, argv)
 	    case 'm':
 		mapwanted = 1;
 		break;
+	    case 'I':
+		incrWanted = 1;
+		break;
             case 'f':
 		/* support both formats */
 		oldSymfileFormat = FALSE;
@@ -2267,6 +2272,24 @@ main(argc, argv)
 				  * change from here on out) */
     }
 
+    /*
+     * If linking incrementally and nothing's changed since the last link,
+     * there's nothing to do.
+     */
+    if (incrWanted) {
+	Incr_Init(outfile, argc, argv);
+	if (Incr_UpToDate()) {
+	    printf("%s is up to date\n", outfile);
+	    Incr_Touch();
+	    exit(0);
+	}
+	Incr_NoteOutput(outfile);
+	Incr_NoteOutput(symfile);
+	if (mapfile != NULL) {
+	    Incr_NoteOutput(mapfile);
+	}
+    }
+
     /*
      * Create the symbol file. The output file will be created during
      * the interpass.
@@ -2445,6 +2468,7 @@ printf("Pass1Load++ %s\n", argv[i]);
 	if (df != NULL) {
 	    malloc_printstats((malloc_printstats_callback *)fprintf, df);
 	    fclose(df);
+	    MemPrintStats((MemPrintFunc *)fprintf, stderr);
 	    fprintf(stderr, "pass1 memory stats dumped to %s\n", dumpfile);
 	}
     }
@@ -2464,6 +2488,7 @@ printf("before InterPass\n");
 	if (df != NULL) {
 	    malloc_printstats((malloc_printstats_callback *)fprintf, df);
 	    fclose(df);
+	    MemPrintStats((MemPrintFunc *)fprintf, stderr);
 	    fprintf(stderr, "interpass memory stats dumped to %s\n", dumpfile);
 	}
     }
@@ -2518,6 +2543,7 @@ printf("before InterPass\n");
 	if (df != NULL) {
 	    malloc_printstats((malloc_printstats_callback *)fprintf, df);
 	    fclose(df);
+	    MemPrintStats((MemPrintFunc *)fprintf, stderr);
 	    fprintf(stderr, "pass2 memory stats dumped to %s\n", dumpfile);
 	}
     }
@@ -2559,10 +2585,16 @@ printf("before InterPass\n");
 	if (df != NULL) {
 	    malloc_printstats((malloc_printstats_callback *)fprintf, df);
 	    fclose(df);
+	    MemPrintStats((MemPrintFunc *)fprintf, stderr);
 	    fprintf(stderr, "final memory stats dumped to %s\n", dumpfile);
 	}
     }
 
+    /*
+     * Everything's written, so record what went into it.
+     */
+    Incr_Save();
+
     exit(0);
 
 err_exit:
@@ -1723,6 +1723,7 @@ MSObjMapExternal(const char	*file,	    /* Name of object file being read */
 			    if (os->type == OSYM_PROC) {
 				os->u.proc.flags |= OSYM_PROC_PUBLISHED;
 				VMDirty(symbols, pubBlock);
+				numPublished++;
 			    }
 			} else {
 			    publishedID = NullID;
@@ -42,6 +42,7 @@ static char *rcsid =
 #include    "msobj.h"
 #include    "obj.h"
 #include    "sym.h"
+#include    "incr.h"
 #include    <objSwap.h>
 #include    <st.h>
 #include    <errno.h>
@@ -81,6 +82,11 @@ Obj_Open(const char    	*file,      /* Name of file to open */
     ObjHeader	    *hdr;   	/* Header in map block */
     short   	    minor, major;
 
+    /*
+     * Record the file (or its absence) for incremental linking.
+     */
+    Incr_NoteInput(file);
+
     /*
      * Open the object file. Note we don't give it a relocation routine yet
      * as we don't know if the file was written with a different byte order.
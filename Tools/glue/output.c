@@ -42,6 +42,21 @@ static char *rcsid =
 #include    "output.h"
 #include    "sym.h"
 
+#if defined(unix) || defined(_LINUX)
+#include    <sys/mman.h>
+
+/*
+ * Not every library's <sys/mman.h> spells these the same way. If there's
+ * no anonymous mapping at all, Out_Init just uses malloc.
+ */
+#if !defined(MAP_ANON) && defined(MAP_ANONYMOUS)
+#define MAP_ANON    MAP_ANONYMOUS
+#endif
+#ifndef MAP_FAILED
+#define MAP_FAILED  ((void *)-1)
+#endif
+#endif /* unix || _LINUX */
+
 static genptr	outbuf;
 static long 	outsize;
 extern Boolean 	oldSymfileFormat;
@@ -65,19 +80,32 @@ typedef int (*CmpCallback)(const void *, const void*);
  * RETURN:	    Nothing
  * SIDE EFFECTS:    outbuf is allocated.
  *
- * STRATEGY:	    None
+ * STRATEGY:	    Where we can, map anonymous memory for the image: it
+ *	    	    comes to us zero-filled a page at a time as it's
+ *	    	    touched, rather than all at once up front.
  *
  * REVISION HISTORY:
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	10/19/89	Initial Revision
+ *	agent	10/16/26	Map the image on Linux hosts too
  *
  ***********************************************************************/
 void
 Out_Init(long	    size)   	/* Size of output file */
 {
-    outbuf = (void *)malloc(size);
     outsize = size;
+
+#if (defined(unix) || defined(_LINUX)) && defined(MAP_ANON)
+    if (size != 0) {
+	outbuf = (genptr)mmap((void *)0, size, PROT_READ|PROT_WRITE,
+			      MAP_PRIVATE|MAP_ANON, -1, 0);
+	if (outbuf != (genptr)MAP_FAILED) {
+	    return;
+	}
+    }
+#endif
+    outbuf = (void *)malloc(size);
     /*
      * Yuck. Zero the whole mess, as HighC relies on this...
      */
@@ -1141,6 +1169,7 @@ Out_PromoteGroups(void)
 		 * biff it and replace the variable with the table for the
 		 * entire segment.
 		 */
+		Sym_NoteMerge(symbols, sd->syms, ns->syms);
 		VMFree(symbols, ns->syms);
 		ns->syms = sd->syms;
 
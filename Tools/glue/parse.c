@@ -106,6 +106,7 @@ static char *rcsid =
 #include    "library.h"
 #include    "sym.h"
 #include    "parse.h"
+#include    "incr.h"
 
 #include    <ctype.h>
 #include    <objfmt.h>
@@ -2685,6 +2686,7 @@ Parse_GeodeParams(char	*file,
 
     loadingLibs = libsOnly;
 
+    Incr_NoteInput(file);
     yyin = fopen(file, "rt");
 
     if (yyin == NULL) {
@@ -37,6 +37,7 @@ static char *rcsid =
 #include    "library.h"
 #include    "sym.h"
 #include    "parse.h"
+#include    "incr.h"
 
 #include    <ctype.h>
 #include    <objfmt.h>
@@ -1610,6 +1611,7 @@ Parse_GeodeParams(char	*file,
 
     loadingLibs = libsOnly;
 
+    Incr_NoteInput(file);
     yyin = fopen(file, "rt");
 
     if (yyin == NULL) {
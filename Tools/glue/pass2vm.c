@@ -1381,7 +1381,15 @@ Pass2VM_Load(const char *file,	/* File name (for error messages) */
 	    rbase = nextRel = NULL;
 	}
 
-	for (block = s->syms; block != 0; block = next) {
+	/*
+	 * Look for published routines in the segment, so their code can be
+	 * copied to the .ldf file. If nothing's been published, there's no
+	 * point in looking up every procedure to find out.
+	 */
+	for (block = (numPublished != 0) ? s->syms : 0;
+	     block != 0;
+	     block = next)
+	{
 	    symHdr = (ObjSymHeader *)VMLock(fh, block, (MemHandle *)NULL);
 	    MemInfo(mem, (genptr *)NULL, &memSize);
 
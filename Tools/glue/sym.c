@@ -64,6 +64,196 @@ extern Boolean oldSymfileFormat;
  */
 SymUndef  	*symUndefHead;	    /* Head of list of undefined symbols */
 
+/*
+ * In-memory index of the entries in all the symbol tables, so finding a
+ * symbol doesn't require locking and searching the VM blocks of a hash
+ * chain. The VM tables are still maintained as symbols are entered, as
+ * they're what ends up in the .sym file; the index just mirrors them.
+ *
+ * The index is an open-addressed hash table keyed on the symbol's ID alone,
+ * so all the entries for a name are found along the same probe sequence.
+ * This allows a table's entries to be given to another table (when a group
+ * is promoted to a segment) without rehashing.
+ */
+typedef struct {
+    VMHandle	    file;   	/* File containing the table */
+    VMBlockHandle   table;  	/* Table in which the symbol was entered */
+    VMBlockHandle   block;  	/* Block containing the symbol */
+    word    	    offset; 	/* Offset of the symbol within the block */
+    ID	    	    id;	    	/* Name of the symbol */
+    byte    	    state;  	/* SIE_FREE, SIE_USED or SIE_DELETED */
+} SymIndexEntry;
+
+#define SIE_FREE    	0
+#define SIE_USED    	1
+#define SIE_DELETED 	2   	/* Removed, but mustn't end a probe */
+
+#define SYM_INDEX_INIT_SIZE 	4096	/* Must be a power of 2 */
+#define SYM_INDEX_HASH(id, size) \
+    ((unsigned)(((unsigned long)(id) * 2654435761UL) >> 8) & ((size)-1))
+
+static SymIndexEntry	*symIndex = NULL;
+static unsigned	    	symIndexSize = 0;   /* Number of slots */
+static unsigned	    	symIndexUsed = 0;   /* Slots not SIE_FREE */
+
+
+/***********************************************************************
+ *				SymIndexFind
+ ***********************************************************************
+ * SYNOPSIS:	    Find the index entry for a symbol in a table.
+ * CALLED BY:	    Sym_Enter, Sym_Find, Sym_FindWithSegmentAndFile,
+ *		    Sym_EnterUndef
+ * RETURN:	    The entry, or NULL if the symbol isn't in the table.
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static SymIndexEntry *
+SymIndexFind(VMHandle	    file,
+	     VMBlockHandle  table,
+	     ID	    	    id)
+{
+    unsigned	    i;
+    SymIndexEntry   *sie;
+
+    if (symIndexSize == 0) {
+	return(NULL);
+    }
+
+    for (i = SYM_INDEX_HASH(id, symIndexSize);
+	 (sie = &symIndex[i])->state != SIE_FREE;
+	 i = (i + 1) & (symIndexSize - 1))
+    {
+	if ((sie->state == SIE_USED) && (sie->id == id) &&
+	    (sie->table == table) && (sie->file == file))
+	{
+	    return(sie);
+	}
+    }
+    return(NULL);
+}
+
+
+/***********************************************************************
+ *				SymIndexAdd
+ ***********************************************************************
+ * SYNOPSIS:	    Record a newly-entered symbol in the index.
+ * CALLED BY:	    Sym_Enter
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The index may be enlarged, discarding deleted slots.
+ *
+ * STRATEGY:	    Keep the index no more than 3/4 full, counting
+ *		    deleted slots, so probes stay short.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+SymIndexAdd(VMHandle	    file,
+	    VMBlockHandle   table,
+	    ID	    	    id,
+	    VMBlockHandle   block,
+	    word    	    offset)
+{
+    unsigned	    i;
+    SymIndexEntry   *sie;
+
+    if ((symIndexUsed + 1) * 4 > symIndexSize * 3) {
+	SymIndexEntry	*old = symIndex;
+	unsigned    	oldSize = symIndexSize;
+	unsigned    	newSize;
+
+	newSize = (symIndexSize == 0) ? SYM_INDEX_INIT_SIZE : symIndexSize*2;
+	symIndex = (SymIndexEntry *)calloc(newSize, sizeof(SymIndexEntry));
+	symIndexSize = newSize;
+	symIndexUsed = 0;
+
+	for (sie = old; sie < &old[oldSize]; sie++) {
+	    if (sie->state == SIE_USED) {
+		for (i = SYM_INDEX_HASH(sie->id, newSize);
+		     symIndex[i].state != SIE_FREE;
+		     i = (i + 1) & (newSize - 1))
+		{
+		    ;
+		}
+		symIndex[i] = *sie;
+		symIndexUsed++;
+	    }
+	}
+	if (old != NULL) {
+	    free((malloc_t)old);
+	}
+    }
+
+    for (i = SYM_INDEX_HASH(id, symIndexSize);
+	 symIndex[i].state == SIE_USED;
+	 i = (i + 1) & (symIndexSize - 1))
+    {
+	;
+    }
+    sie = &symIndex[i];
+    if (sie->state == SIE_FREE) {
+	symIndexUsed++;
+    }
+    sie->file = file;
+    sie->table = table;
+    sie->id = id;
+    sie->block = block;
+    sie->offset = offset;
+    sie->state = SIE_USED;
+}
+
+
+/***********************************************************************
+ *				Sym_NoteMerge
+ ***********************************************************************
+ * SYNOPSIS:	    Note that the hash chains of one table have been
+ *		    linked into another.
+ * CALLED BY:	    Out_PromoteGroups
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    Entries for "from" become entries for "table".
+ *
+ * STRATEGY:	    The merged chains go at the head of the table's
+ *		    chains, so a symbol of the same name already in the
+ *		    table can no longer be found there. Drop it from the
+ *		    index to match.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Sym_NoteMerge(VMHandle	    	file,
+	      VMBlockHandle 	table,	/* Table receiving the chains */
+	      VMBlockHandle 	from)	/* Table whose chains they were */
+{
+    SymIndexEntry   *sie;
+
+    for (sie = symIndex; sie < &symIndex[symIndexSize]; sie++) {
+	if ((sie->state == SIE_USED) && (sie->table == from) &&
+	    (sie->file == file))
+	{
+	    SymIndexEntry   *old = SymIndexFind(file, table, sie->id);
+
+	    if (old != NULL) {
+		old->state = SIE_DELETED;
+	    }
+	    sie->table = table;
+	}
+    }
+}
+
 
 /***********************************************************************
  *				Sym_Create
@@ -196,31 +386,37 @@ Sym_Destroy(VMHandle  	    file,
     }
 
     VMFree(file, table);
+
+    /*
+     * Remove the table's entries from the index, as the handle may be
+     * reused.
+     */
+    for (i = 0; i < symIndexSize; i++) {
+	if ((symIndex[i].state == SIE_USED) && (symIndex[i].table == table) &&
+	    (symIndex[i].file == file))
+	{
+	    symIndex[i].state = SIE_DELETED;
+	}
+    }
 }
 
 
 /***********************************************************************
- *				SymLookup
+ *				SymChainHead
  ***********************************************************************
- * SYNOPSIS:	    Find a symbol in the table, or at least where the
- *	    	    thing would go, if not already there.
- * CALLED BY:	    Sym_Enter, Sym_Find.
- * RETURN:	    If present:
- *	    	    	returns non-zero
- *	    	    	*blockPtr holds VMBlock containing the hash entry
- *	    	    	*hdrPtr points to the locked memory for it
- *	    	    	*hePtr points to the entry itself.
- *	    	    	*bucketPtr points to the chain pointer for
- *	    	    	    the chain in which the entry resides.
- *	    	    If absent:
- *	    	    	returns zero
- *	    	    	*bucketPtr points to chain pointer for the chain.
+ * SYNOPSIS:	    Find where a symbol not in the table would go.
+ * CALLED BY:	    Sym_Enter
+ * RETURN:	    *bucketPtr points to chain pointer for the chain.
+ *	    	    *blockPtr holds the head block of the chain (0 if none)
+ *	    	    *hdrPtr points to the locked memory for it
+ *	    	    *hePtr points to the next entry to be allocated in it.
  *
- *	    	    In either case, table and *blockPtr (if non-zero)
- *	    	    	remain LOCKED.
+ *	    	    table and *blockPtr (if non-zero) remain LOCKED.
  * SIDE EFFECTS:
  *
- * STRATEGY:
+ * STRATEGY:	    Whether the symbol is already present is determined
+ *		    from the index, so there's no need to search the
+ *		    chain itself.
  *
  * REVISION HISTORY:
  *	Name	Date		Description
@@ -228,18 +424,17 @@ Sym_Destroy(VMHandle  	    file,
  *	ardeb	10/20/89	Initial Revision
  *
  ***********************************************************************/
-static int
-SymLookup(VMHandle  	file,
-	  VMBlockHandle	table,
-	  ID	    	id,
-	  VMBlockHandle	**bucketPtr,
-	  VMBlockHandle	*blockPtr,
-	  ObjHashBlock	**hdrPtr,
-	  ObjHashEntry	**hePtr)
+static void
+SymChainHead(VMHandle  	file,
+	     VMBlockHandle	table,
+	     ID	    	id,
+	     VMBlockHandle	**bucketPtr,
+	     VMBlockHandle	*blockPtr,
+	     ObjHashBlock	**hdrPtr,
+	     ObjHashEntry	**hePtr)
 {
     int	    	    index;
     VMBlockHandle   cur;
-    VMBlockHandle   next;
     ObjHashHeader   *hdr;
 
     if (oldSymfileFormat == TRUE) {
@@ -252,29 +447,8 @@ SymLookup(VMHandle  	file,
 
     *bucketPtr = &hdr->chains[index];
 
-    for (cur = hdr->chains[index]; cur != 0; cur = next) {
-	ObjHashBlock	*hb;
-	ObjHashEntry	*he;
-
-	hb = (ObjHashBlock *)VMLock(file, cur, (MemHandle *)NULL);
-	next = hb->next;
-
-	for (he = hb->entries; he < &hb->entries[hb->nextEnt]; he++) {
-	    if (he->name == id) {
-		/*
-		 * Set return variables, leaving both blocks locked.
-		 */
-		*blockPtr = cur;
-		*hdrPtr = hb;
-		*hePtr = he;
-		return(1);
-	    }
-	}
-	VMUnlock(file, cur);
-    }
-
     /*
-     * Be nice and return the head block already locked, if it exists, with
+     * Return the head block already locked, if it exists, with
      * he pointing at the next entry to be allocated.
      */
     cur = *blockPtr = **bucketPtr;
@@ -288,8 +462,6 @@ SymLookup(VMHandle  	file,
 	*hdrPtr = NULL;
 	*hePtr = NULL;
     }
-
-    return(0);
 }
 
 
@@ -609,7 +781,7 @@ Sym_Enter(VMHandle  	file,    	/* Output file */
     VMBlockHandle   *bucket;	    /* Bucket in which symbol is to sit */
     VMBlockHandle   block;  	    /* Block in which symbol is to sit */
     ObjHashBlock    *hb;    	    /* Locked version of same */
-    ObjHashEntry    *he;    	    /* Entry at which duplicate was found */
+    ObjHashEntry    *he;    	    /* Entry to fill in */
     int	    	    obj_syms_per;   /* used to support both symfile formats */
 
 			    //Notify(NOTIFY_WARNING,
@@ -617,7 +789,7 @@ Sym_Enter(VMHandle  	file,    	/* Output file */
 				  // id);
 
 
-    if (!SymLookup(file, table, id, &bucket, &block, &hb, &he)) {
+    if (SymIndexFind(file, table, id) == NULL) {
 	VMID	    vmid;
 	/*
 	 * See if the block contains symbols -- we need to do other things
@@ -641,32 +813,25 @@ Sym_Enter(VMHandle  	file,    	/* Output file */
 		 * is non-zero.
 		 */
 		int 	    i;	    	/* Index of current segment */
-		/* More-or-less-junk variables for search */
-		VMBlockHandle   oblock;
-		ObjHashBlock    *ohb;
-		ObjHashEntry    *ohe;
-		VMBlockHandle   *obucket;
+		SymIndexEntry	*sie;	/* Entry for symbol in other segment */
 
 		for (i = 0; i < seg_NumSegs; i++) {
 		    SegDesc 	*sd = seg_Segments[i];
 
 		    if ((sd->syms != table) &&
-			SymLookup(symbols, sd->syms, id, &obucket,
-				  &oblock, &ohb, &ohe))
+			((sie = SymIndexFind(symbols, sd->syms, id)) != NULL))
 		    {
 			ObjSym  *osym;
 
-			osym = (ObjSym *)((genptr)VMLock(symbols, ohe->block,
-						 (MemHandle *)NULL)+ohe->offset);
+			osym = (ObjSym *)((genptr)VMLock(symbols, sie->block,
+						 (MemHandle *)NULL)+sie->offset);
 
 			if (osym->flags & OSYM_GLOBAL) {
 			    Notify(NOTIFY_ERROR,
 				   "%i already defined (in segment %i)",
 				   id, sd->name);
 			}
-			VMUnlock(symbols, ohe->block);
-			VMUnlock(symbols, oblock);
-			VMUnlock(symbols, sd->syms);
+			VMUnlock(symbols, sie->block);
 		    }
 		}
 
@@ -675,6 +840,12 @@ Sym_Enter(VMHandle  	file,    	/* Output file */
 	    VMUnlock(file, symBlock);
 	}
 
+	/*
+	 * Locate the head of the chain only now, as SymCheckUndef may
+	 * lock and unlock the table itself.
+	 */
+	SymChainHead(file, table, id, &bucket, &block, &hb, &he);
+
 	if (oldSymfileFormat == TRUE) {
 	    obj_syms_per = OBJ_SYMS_PER;
 	} else {
@@ -703,7 +874,7 @@ Sym_Enter(VMHandle  	file,    	/* Output file */
 	    *bucket = new;
 	    he = hb->entries;
 	    /*
-	     * If not first in the chain, unlock the block that SymLookup
+	     * If not first in the chain, unlock the block that SymChainHead
 	     * locked for us.
 	     */
 	    if (block != 0) {
@@ -725,10 +896,15 @@ Sym_Enter(VMHandle  	file,    	/* Output file */
 
 	hb->nextEnt += 1;
 
+	SymIndexAdd(file, table, id, symBlock, symOff);
+
 	/*
-	 * Release the block now the data are in.
+	 * Release the block now the data are in. table and block were
+	 * left locked by SymChainHead.
 	 */
 	VMDirty(file, block);
+	VMUnlock(file, block);
+	VMUnlock(file, table);
     } else {
 	/*
 	 * Multiple definitions of local symbols in different segments
@@ -737,11 +913,6 @@ Sym_Enter(VMHandle  	file,    	/* Output file */
 	 */
 	Notify(NOTIFY_ERROR, "%i multiply defined in a single segment", id);
     }
-    /*
-     * table and block were left locked by SymLookup
-     */
-    VMUnlock(file, block);
-    VMUnlock(file, table);
 }
 
 
@@ -779,18 +950,15 @@ Sym_FindWithSegmentAndFile(VMHandle   	    file,	   /* File in which to
 						    * that contains the symbol
 						    */
 {
-    VMBlockHandle   *bucket;	    /* Bucket in which symbol sits */
-    VMBlockHandle   block;  	    /* Block in which symbol sits */
-    ObjHashBlock    *hb;    	    /* Locked version of same */
-    ObjHashEntry    *he;    	    /* Entry at which symbol was found */
-    int	    	    retval;
+    SymIndexEntry   *sie = NULL;    /* Entry for symbol in current segment */
     int 	    i;
     SegDesc 	    *sd = NULL;
 
     for (i = 0; i < seg_NumSegs; i++) {
 	sd = seg_Segments[i];
 
-	if (SymLookup(file, sd->syms, id, &bucket, &block, &hb, &he) == 1)
+	sie = SymIndexFind(file, sd->syms, id);
+	if (sie != NULL)
 	{
 	    int 	    	isglobal;
 	    ObjSym	    	*os;
@@ -799,17 +967,13 @@ Sym_FindWithSegmentAndFile(VMHandle   	    file,	   /* File in which to
 	    /*
 	     * Lock the defined version down.
 	     */
-	    osh = (ObjSymHeader *)VMLock(file,he->block,(MemHandle *)NULL);
+	    osh = (ObjSymHeader *)VMLock(file,sie->block,(MemHandle *)NULL);
 
-	    os = (ObjSym *)((genptr)osh + he->offset);
+	    os = (ObjSym *)((genptr)osh + sie->offset);
 
 	    isglobal = (os->flags & OSYM_GLOBAL);
 
-	    /*
-	     * Release the table and symbol always
-	     */
-	    VMUnlock(file, sd->syms);
-	    VMUnlock(file, he->block);
+	    VMUnlock(file, sie->block);
 
 	    if (isglobal || (!globalOnly && fileName == NULL)) {
 		break;
@@ -817,44 +981,24 @@ Sym_FindWithSegmentAndFile(VMHandle   	    file,	   /* File in which to
 		if (strncmp(fileName, sd->file, strlen(fileName)) == 0) {
 			break;
 		}
-	    } else {
-		VMUnlock(file, block);
 	    }
-	} else {
-	    if (block) {
-		VMUnlock(file, block);
-	    }
-	    VMUnlock(file, sd->syms);
 	}
 	sd = NULL;
     }
-    if (sd != NULL) {
-	/*
-	 * If sd is non-null, we broke out of the loop when we found a
-	 * global symbol of the proper name, or a local symbol in the
-	 * right file
-	 */
-	retval = 1;
-    } else {
-	/*
-	 * If none defined, block is already unlocked.
-	 */
-	block = 0;
-	retval = 0;
+    if (sd == NULL) {
+	return(0);
     }
 
-    if (retval) {
-	*sdPtr = sd;
-	if (he != NULL) {
-		*symBlockPtr = he->block;
-		*symOffPtr = he->offset;
-	}
-    }
-    if (block != 0) {
-	VMUnlock(file, block);
-    }
+    /*
+     * If sd is non-null, we broke out of the loop when we found a
+     * global symbol of the proper name, or a local symbol in the
+     * right file
+     */
+    *sdPtr = sd;
+    *symBlockPtr = sie->block;
+    *symOffPtr = sie->offset;
 
-    return(retval);
+    return(1);
 }
 
 int
@@ -934,11 +1078,7 @@ Sym_Find(VMHandle   	file,	    	/* File in which to search */
 	 int	    	globalOnly) 	/* TRUE if only a global symbol is
 					 * acceptable */
 {
-    VMBlockHandle   *bucket;	    /* Bucket in which symbol sits */
-    VMBlockHandle   block;  	    /* Block in which symbol sits */
-    ObjHashBlock    *hb;    	    /* Locked version of same */
-    ObjHashEntry    *he;    	    /* Entry at which symbol was found */
-    int	    	    retval;
+    SymIndexEntry   *sie;   	    /* Entry for the symbol */
 
     if (table == 0) {
 	/*
@@ -952,19 +1092,16 @@ Sym_Find(VMHandle   	file,	    	/* File in which to search */
 				   globalOnly, &sd));
 
     } else {
-	retval = SymLookup(file, table, id, &bucket, &block, &hb, &he);
-	VMUnlock(file, table);
+	sie = SymIndexFind(file, table, id);
     }
 
-    if (retval) {
-	*symBlockPtr = he->block;
-	*symOffPtr = he->offset;
-    }
-    if (block != 0) {
-	VMUnlock(file, block);
+    if (sie == NULL) {
+	return(0);
     }
+    *symBlockPtr = sie->block;
+    *symOffPtr = sie->offset;
 
-    return(retval);
+    return(1);
 }
 
 
@@ -1010,10 +1147,7 @@ Sym_EnterUndef(VMHandle	    	file,	/* Output file */
 	 * mismatch between the symbol's declaration and its definition.
 	 */
 	int 	    i;	    	/* Index of current segment */
-	VMBlockHandle   block;	/* Block containing actual/potential entry */
-	ObjHashBlock    *hb;	/* Header of same */
-	ObjHashEntry    *he;	/* Actual/potential entry */
-	VMBlockHandle   *bucket;/* Head pointer of bucket for sym */
+	SymIndexEntry	*sie;	/* Entry for sym in current segment */
 	SegDesc 	*sd;	/* Descriptor of already-defined sym segment */
 	SegDesc	    	*su;	/* Descriptor of this undefined sym segment */
 	ObjSymHeader    *osh;	/* Header of block containing defined sym */
@@ -1043,11 +1177,12 @@ Sym_EnterUndef(VMHandle	    	file,	/* Output file */
 				 * valid only if sd is non-null, and that's
 				 * the only time osh is used) */
 	ds = NULL;		/* Be quiet, GCC (ditto) */
+	sie = NULL;		/* Be quiet, GCC (ditto) */
 
 	for (i = 0; i < seg_NumSegs; i++) {
 	    sd = seg_Segments[i];
 
-	    if (SymLookup(file, sd->syms, id, &bucket, &block, &hb, &he))
+	    if ((sie = SymIndexFind(file, sd->syms, id)) != NULL)
 	    {
 		int 	isglobal;
 
@@ -1056,33 +1191,25 @@ Sym_EnterUndef(VMHandle	    	file,	/* Output file */
 		 * block for it -- SymCompareSyms will do so if required.
 		 */
 		osh = (ObjSymHeader *)VMLock(file,
-					     he->block,
+					     sie->block,
 					     (MemHandle *)NULL);
 
-		ds = (ObjSym *)((genptr)osh + he->offset);
+		ds = (ObjSym *)((genptr)osh + sie->offset);
 
 		isglobal = (ds->flags & OSYM_GLOBAL);
 
-		VMUnlock(file, block);
-		VMUnlock(file, sd->syms);
-
 		if (isglobal) {
 		    /*
 		     * Record symbol block and break out of loop
 		     */
-		    dblock = he->block;
+		    dblock = sie->block;
 		    break;
 		} else {
 		    /*
 		     * Release the symbol block
 		     */
-		    VMUnlock(file, he->block);
-		}
-	    } else {
-		if (block) {
-		    VMUnlock(file, block);
+		    VMUnlock(file, sie->block);
 		}
-		VMUnlock(file, sd->syms);
 	    }
 	    sd = NULL;
 	}
@@ -1104,7 +1231,7 @@ Sym_EnterUndef(VMHandle	    	file,	/* Output file */
 	    /*
 	     * Generate any necessary error messages
 	     */
-	    SymCompareSyms(file, sd->syms, ds, he->offset, file, osh->types,
+	    SymCompareSyms(file, sd->syms, ds, sie->offset, file, osh->types,
 			   table, os, tfile, tbase);
 
 	    /*
@@ -30,6 +30,9 @@
 extern VMBlockHandle	    Sym_Create(VMHandle file);
 extern void 	    	    Sym_Close(VMHandle file, VMBlockHandle table);
 extern void                 Sym_Destroy (VMHandle file, VMBlockHandle table);
+extern void 	    	    Sym_NoteMerge(VMHandle 	    file,
+					  VMBlockHandle table,
+					  VMBlockHandle from);
 extern void 	    	    Sym_Enter(VMHandle 	    file,
 				      VMBlockHandle table,
 				      ID    	    id,
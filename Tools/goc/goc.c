@@ -42,10 +42,14 @@ static char *rcsid =
 #include    "malloc.h"
 #include    "scan.h"		/* for depends.h (sigh) */
 #include    "depends.h"		/* for directoryOverride */
+#include    "pch.h"
 
 #if defined(unix)
 #include    <sys/time.h>
 #include    <sys/resource.h>
+#include    <sys/types.h>
+#include    <sys/wait.h>
+#include    <unistd.h>
 #endif
 
 #include    <fileargs.h>
@@ -118,6 +122,18 @@ int 		allowOptimize = TRUE;
 int 		allowOptimize = FALSE;
 #endif
 
+/*
+ * Batch mode (-B): the file listing the jobs, how many may run at once,
+ * and the arguments goc was given, to start afresh with if need be.
+ */
+static char	*batchFile = NULL;
+static int	batchJobs = 1;
+static char	*progName;
+static int	sharedArgc;
+static char	**sharedArgv;
+static int	jobArgc;
+static char	**jobArgv;
+
 Compilers compiler = COM_HIGHC; 	    	/* type of compiler */
 
 FILE		  *yyin;
@@ -198,6 +214,12 @@ char *_cl = "";
 extern void DoFinalOutput(void);
 void DoProtoMinorChecks(void);
 void ParseArgs(int argc, char **argv);
+static void ParseFlags(int argc, char **argv);
+static void OpenFiles(void);
+#if defined(unix)
+static void BatchRun(void);
+static void BatchRestart(void);
+#endif
 
 
 
@@ -269,6 +291,12 @@ Usage(char *fmt, ...)
 	    "\t-d[ylsoumLOd]\toutput debugging information\n"
 	    "\t-D<name>=<val>\tdefine the goc macro <name> to be <val>\n"
 	    "\t-D<name>\tdefine the goc macro <name>\n"
+	    "\t-B<jobfile>\tUNIX-only, compile the files listed in <jobfile>\n"
+	    "\t\t\t(\"-\" for stdin), one line of arguments each\n"
+	    "\t-j<n>\t\twith -B, compile up to <n> files at once\n"
+	    "\t-g<image>\tuse headers precompiled into <image> when they match\n"
+	    "\t-G<image>\tprecompile the headers @included by the input into\n"
+	    "\t\t\t<image>\n"
 	    "\t-I<dir>\t\tspecify include directory\n"
             "\t-I-\t\tturn off relative includes\n"
 	    "\t-l\t\tgenerate localization files\n"
@@ -570,6 +598,18 @@ main(int argc, char **argv)
     Symbol_Init();
     Scan_Init();			/* Uses symbol stuff */
 
+#if defined(unix)
+    if (batchFile != NULL) {
+	BatchRun();			/* Returns in the child for a job */
+    }
+#endif
+
+    if (!Pch_Init()) {			/* Uses both */
+#if defined(unix)
+	BatchRestart();
+#endif
+    }
+
     if (makeDepend){
 	printf("%s : %s\n",outFile,inFile);
 	fflush(stdout);
@@ -585,6 +625,10 @@ main(int argc, char **argv)
         exit(yyerrors);
     }
 
+    if (pchMakeName != NULL) {
+	Pch_Write();
+    }
+
     if (gocdebug) {
 	fprintf(stderr, "Parse successful, starting semantic checks...\n");
     }
@@ -622,11 +666,11 @@ main(int argc, char **argv)
 	Localize_DumpLocalizations();
     }
 
-#if defined(unix)
-    (void) pclose(yyin);
-#else
-    fclose(yyin);
-#endif
+    /*
+     * yyin was closed by yystdwrap when it hit the end of the input file;
+     * closing it again here crashed goc on exit on some hosts, and under
+     * -B the exit status of each job matters.
+     */
 
 #if defined(unix)
     if (gocdebug) {
@@ -926,16 +970,16 @@ OpenOutputFile(char *outFile)
 void
 ParseArgs(int argc, char **argv)
 {
-    int	    	ac;
-
-
     /* Check to see if we have to fetch our args from a file.      */
     /* If we do, read them and reset argc and argv.                */
     /* Then do the normal arg stuff.                               */
 
+    progName = argv[0];
     if(argc == 2 && HAS_ARGS_FILE(argv)){
       GetFileArgs(ARGS_FILE(argv),&argc,&argv);
     }
+    sharedArgc = argc;
+    sharedArgv = argv;
 
     /* Make our default compiler assumption. We assume HighC. */
 
@@ -945,8 +989,53 @@ ParseArgs(int argc, char **argv)
     compilerCastForOffset	= highCCastForOffset;
     defStringType = asciiStringType;
 
+    ParseFlags(argc, argv);
+
+    if (batchFile != NULL) {
+	/*
+	 * The input and output files come with each job.
+	 */
+	if (inFile[0] != '\0') {
+	    Usage("-B takes its input files from %s", batchFile);
+	}
+	if (pchMakeName != NULL) {
+	    Usage("-B and -G can't be used together");
+	}
+	/*
+	 * Scan_Init defines things in the name of the current file.
+	 */
+	curFile = (File *)malloc(sizeof(File));
+	curFile->next = (File *)0;
+	curFile->line = 1;
+	curFile->name = String_Enter(batchFile, strlen(batchFile));
+	return;
+    }
+
+    OpenFiles();
+}
+
+
+/***********************************************************************
+ *				ParseFlags
+ ***********************************************************************
+ * SYNOPSIS:	  Parse arguments, on the command line or for a job
+ * CALLED BY:	  ParseArgs, BatchRun
+ * RETURN:	  No
+ * SIDE EFFECTS:  Lots
+ *
+ * STRATEGY:
+ *	argv[0] is skipped, as for the command line.
+ *
+ ***********************************************************************/
+static void
+ParseFlags(int argc, char **argv)
+{
+    int	    	ac;
+    int	    	startAc;
+
     for (ac = 1; ac < argc; ac++) {
 	if (argv[ac][0] == '-') {
+	    startAc = ac;
 	    switch (argv[ac][1]) {
 		case 'a': {
 		    issueArgsUsedPragma = FALSE;
@@ -1102,6 +1191,37 @@ ParseArgs(int argc, char **argv)
 		    break;
 		}
 
+		case 'B':
+		case 'j':
+#if defined(unix)
+		    if(argv[ac][2] == '\0'){
+			Usage("-%c requires an argument", argv[ac][1]);
+		    }
+		    if (argv[ac][1] == 'B') {
+			batchFile = argv[ac] + 2;
+		    } else if ((batchJobs = atoi(argv[ac] + 2)) < 1) {
+			Usage("-j requires a number of files");
+		    }
+#else
+		    Usage("-%c is only supported on UNIX", argv[ac][1]);
+#endif
+		    break;
+
+		case 'g':
+		case 'G':
+		    if(argv[ac][2] == '\0'){
+			Usage("-%c requires an argument", argv[ac][1]);
+		    }
+		    if (argv[ac][1] == 'g') {
+			pchUseName = argv[ac] + 2;
+		    } else {
+			pchMakeName = argv[ac] + 2;
+		    }
+		    if (pchUseName != NULL && pchMakeName != NULL) {
+			Usage("-g and -G can't be used together");
+		    }
+		    break;
+
 		case 'I' :
 		    if(argv[ac][2] == '\0'){
 			Usage("-I requires an argument");
@@ -1220,6 +1340,7 @@ ParseArgs(int argc, char **argv)
 		    Usage("Argument %c unknown", argv[ac][1]);
 		    /*NOTREACHED*/
 	 }
+	    Pch_NoteArgs(&argv[startAc], ac - startAc + 1);
 	} else {
 	    if (inFile[0] != '\0') {
 	        fprintf(stderr, "your input file is %s.\n", inFile);
@@ -1229,7 +1350,23 @@ ParseArgs(int argc, char **argv)
 	    strcpy(inFile, argv[ac]);
 	}
     }
+}
+
 
+/***********************************************************************
+ *				OpenFiles
+ ***********************************************************************
+ * SYNOPSIS:	  Open the input and output files
+ * CALLED BY:	  ParseArgs, BatchRun
+ * RETURN:	  No
+ * SIDE EFFECTS:  yyin, curFile and foutput are set
+ *
+ * STRATEGY:
+ *
+ ***********************************************************************/
+static void
+OpenFiles(void)
+{
     /* Open input file */
     if (inFile[0] == 0) {
 	Usage("Need a file on which to work");
@@ -1254,3 +1391,267 @@ ParseArgs(int argc, char **argv)
 	exit(1);
     }
 }
+
+#if defined(unix)
+
+/*
+ * A job in a batch that's been started and not yet waited for
+ */
+typedef struct {
+    int	    	pid;
+    char    	*desc;	    	/* Its line in the job file */
+} BatchJob;
+
+
+/***********************************************************************
+ *				BatchSplit
+ ***********************************************************************
+ * SYNOPSIS:	  Break a line of the job file into arguments
+ * CALLED BY:	  BatchRun
+ * RETURN:	  the number of arguments
+ * SIDE EFFECTS:  jobArgc and jobArgv are set, argv[0] being our name.
+ *	    	  The line is chopped up.
+ *
+ * STRATEGY:
+ *	Arguments are separated by white space; a line starting with #
+ *	is a comment.
+ *
+ ***********************************************************************/
+static int
+BatchSplit(char *line)
+{
+    char    *cp;
+    int	    max = 8;
+
+    jobArgv = (char **)malloc(max * sizeof(char *));
+    jobArgv[0] = progName;
+    jobArgc = 1;
+    for (cp = strtok(line, " \t\r\n");
+	 cp != NULL;
+	 cp = strtok((char *)NULL, " \t\r\n"))
+    {
+	if (jobArgc == 1 && *cp == '#') {
+	    break;
+	}
+	if (jobArgc + 1 == max) {
+	    max *= 2;
+	    jobArgv = (char **)realloc((malloc_t)jobArgv, max * sizeof(char *));
+	}
+	jobArgv[jobArgc++] = cp;
+    }
+    jobArgv[jobArgc] = NULL;
+    return (jobArgc - 1);
+}
+
+
+/***********************************************************************
+ *				BatchWait
+ ***********************************************************************
+ * SYNOPSIS:	  Wait for a job in a batch to finish
+ * CALLED BY:	  BatchRun
+ * RETURN:	  No
+ * SIDE EFFECTS:  the job is removed from running and, if it failed,
+ *	    	  reported and counted in *failedPtr
+ *
+ * STRATEGY:
+ *
+ ***********************************************************************/
+static void
+BatchWait(BatchJob *running, int *numRunningPtr, int *failedPtr)
+{
+    int	    pid;
+    int	    status;
+    int	    i;
+
+    pid = wait(&status);
+    if (pid < 0) {
+	perror("wait");
+	exit(1);
+    }
+    for (i = 0; i < *numRunningPtr; i++) {
+	if (running[i].pid == pid) {
+	    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		fprintf(stderr, "goc: failed: %s\n", running[i].desc);
+		*failedPtr += 1;
+	    }
+	    free(running[i].desc);
+	    running[i] = running[--*numRunningPtr];
+	    break;
+	}
+    }
+}
+
+
+/***********************************************************************
+ *				BatchRun
+ ***********************************************************************
+ * SYNOPSIS:	  Compile each file listed in the job file
+ * CALLED BY:	  main
+ * RETURN:	  Only in the process for a job, with its arguments parsed
+ *	    	  and its files open
+ * SIDE EFFECTS:  goc exits once every job is done, with status 1 if
+ *	    	  any failed.
+ *
+ * STRATEGY:
+ *	Each job is compiled by a child process, up to batchJobs at once,
+ *	so it starts with everything goc has set up so far -- above all,
+ *	the headers precompiled in an image given with -g, which is
+ *	loaded just once, here -- and leaves nothing behind for the next.
+ *	The arguments on the command line apply to every job, with those
+ *	on the job's line added.
+ *
+ *	The job file is read in full before any job starts, so nothing a
+ *	child does to the stream can upset the reading of it.
+ *
+ ***********************************************************************/
+static void
+BatchRun(void)
+{
+    FILE    	*jobs;
+    char    	line[1024];
+    char    	*cur = NULL;	/* Line being gathered */
+    int	    	curLen = 0;
+    int	    	len;
+    int	    	atEnd = FALSE;
+    char    	**lines = NULL;
+    int	    	numLines = 0;
+    BatchJob	*running;
+    int	    	numRunning = 0;
+    int	    	failed = 0;
+    int	    	pid;
+    int	    	i, ac;
+    char    	*cp;
+
+    if (strcmp(batchFile, "-") == 0) {
+	jobs = stdin;
+    } else if ((jobs = fopen(batchFile, "r")) == NULL) {
+	Usage("%s: %s", batchFile, strerror(errno));
+    }
+    while (!atEnd) {
+	/*
+	 * fgets stops when the buffer fills, so a long line comes in
+	 * pieces. Gather them up to the newline (or the end of the file)
+	 * before taking the line as a job.
+	 */
+	if (fgets(line, sizeof(line), jobs) != NULL) {
+	    len = strlen(line);
+	    cur = (char *)realloc((malloc_t)cur, curLen + len + 1);
+	    strcpy(cur + curLen, line);
+	    curLen += len;
+	    if (curLen == 0 || cur[curLen-1] != '\n') {
+		continue;
+	    }
+	    cur[--curLen] = '\0';
+	} else if (cur == NULL) {
+	    break;
+	} else {
+	    atEnd = TRUE;
+	}
+	lines = (char **)realloc((malloc_t)lines,
+				 (numLines + 1) * sizeof(char *));
+	lines[numLines++] = cur;
+	cur = NULL;
+	curLen = 0;
+    }
+    if (jobs != stdin) {
+	fclose(jobs);
+    }
+
+    /*
+     * Load the headers every job is to share.
+     */
+    Pch_Preload();
+
+    running = (BatchJob *)malloc(batchJobs * sizeof(BatchJob));
+    for (i = 0; i < numLines; i++) {
+	if (BatchSplit(lines[i]) == 0) {
+	    free((malloc_t)jobArgv);
+	    continue;
+	}
+	while (numRunning == batchJobs) {
+	    BatchWait(running, &numRunning, &failed);
+	}
+
+	fflush(stdout);
+	fflush(stderr);
+	pid = fork();
+	if (pid == 0) {
+	    ParseFlags(jobArgc, jobArgv);
+	    OpenFiles();
+	    return;
+	} else if (pid < 0) {
+	    perror("fork");
+	    failed++;
+	} else {
+	    /*
+	     * Describe the job by its arguments, its line having been
+	     * chopped up by BatchSplit.
+	     */
+	    cp = (char *)malloc(strlen(progName) + 1);
+	    strcpy(cp, progName);
+	    for (ac = 1; ac < jobArgc; ac++) {
+		cp = (char *)realloc((malloc_t)cp, strlen(cp) +
+				     strlen(jobArgv[ac]) + 2);
+		strcat(cp, " ");
+		strcat(cp, jobArgv[ac]);
+	    }
+	    running[numRunning].pid = pid;
+	    running[numRunning].desc = cp;
+	    numRunning++;
+	}
+	free((malloc_t)jobArgv);
+    }
+    while (numRunning > 0) {
+	BatchWait(running, &numRunning, &failed);
+    }
+    exit(failed ? 1 : 0);
+}
+
+
+/***********************************************************************
+ *				BatchRestart
+ ***********************************************************************
+ * SYNOPSIS:	  Compile a job in a fresh goc
+ * CALLED BY:	  main, when the headers loaded for the batch can't be
+ *	    	  used for this job
+ * RETURN:	  No
+ * SIDE EFFECTS:  the process is replaced
+ *
+ * STRATEGY:
+ *	Run goc with the same arguments the job was given, bar -B and -j.
+ *	It says why if it can't use the precompiled headers.
+ *
+ ***********************************************************************/
+static void
+BatchRestart(void)
+{
+    char    **argv;
+    int	    ac, n = 0;
+
+    argv = (char **)malloc((sharedArgc + jobArgc + 1) * sizeof(char *));
+    argv[n++] = progName;
+    for (ac = 1; ac < sharedArgc; ac++) {
+	if (sharedArgv[ac][0] == '-' &&
+	    (sharedArgv[ac][1] == 'B' || sharedArgv[ac][1] == 'j'))
+	{
+	    continue;
+	}
+	argv[n++] = sharedArgv[ac];
+    }
+    for (ac = 1; ac < jobArgc; ac++) {
+	argv[n++] = jobArgv[ac];
+    }
+    argv[n] = NULL;
+
+    fclose(yyin);
+    if (foutput != stdout) {
+	fclose(foutput);
+    }
+    fflush(stdout);
+    fflush(stderr);
+    execvp(progName, argv);
+    perror(progName);
+    exit(1);
+}
+
+#endif /* unix */
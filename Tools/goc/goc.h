@@ -240,6 +240,7 @@ extern Boolean LocateSuperForVariant(Symbol *class, Symbol *object,
 
 extern void OutputLineNumberForSym(Symbol *sym);
 extern void OutputLineNumber(int lineNumber, char *fileName);
+extern void OutputForgetLineFile(void);
 extern void OutputSubst(char *str, char *find, char *repl);
 extern void OutputSubstOptr(char *str);
 extern int  OutputLineDirectiveOrNewlinesForFile (int difference,
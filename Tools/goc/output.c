@@ -1167,6 +1167,7 @@ OutputLineNumber(int lineNumber, char *fileName)
 }
 
 char outputLineNumberBuf[1024];
+static char *prevFile = NULL;/* string table entry for previous fileName */
 
 int
 OutputLineNumberWithCount(int lineNumber, char *fileName,Boolean print)
@@ -1174,7 +1175,6 @@ OutputLineNumberWithCount(int lineNumber, char *fileName,Boolean print)
     int	length;
     char *from;
     char *to;
-    static char *prevFile = NULL;/* string table entry for previous fileName */
 
     switch(compiler){
       case COM_HIGHC:
@@ -1219,6 +1219,16 @@ OutputLineNumberWithCount(int lineNumber, char *fileName,Boolean print)
     return length;
 }
 
+/*
+ * Make the next line directive name its file. Used when output has been
+ * copied from elsewhere, so the previous directive isn't known.
+ */
+void
+OutputForgetLineFile(void)
+{
+    prevFile = NULL;
+}
+
 
 
 /***********************************************************************
@@ -0,0 +1,1953 @@
+/***********************************************************************
+ * PROJECT:	  PCGEOS
+ * MODULE:	  goc -- Precompiled headers
+ * FILE:	  pch.c
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * ROUTINES:
+ *	Name	  	    Description
+ *	----	  	    -----------
+ *	Pch_NoteArgs	    Record arguments that affect how headers parse
+ *	Pch_Init    	    Check and load the image given with -g, or
+ *	    	    	    get ready to make the one given with -G
+ *	Pch_Preload 	    Load the image given with -g for a batch
+ *	Pch_Include 	    Copy the output for an @include from the image
+ *	Pch_IncludeDone	    Note the end of an @include's output
+ *	Pch_Write   	    Write the image given with -G
+ *
+ * DESCRIPTION:
+ *	Nearly every .goc file starts by @including the same big class
+ *	headers, and parsing them takes most of goc's time. With -G, goc
+ *	parses a file holding just those @include lines and writes an image
+ *	of everything the headers left behind: the symbols (classes,
+ *	messages, instance variables, vardata, exported ranges, protominor
+ *	symbols), the goc macros, the list of files read, and the text
+ *	output for each @include. With -g, if the input file starts with
+ *	the same @includes and the image is up to date, the image is loaded
+ *	before parsing begins and each of those @includes just copies its
+ *	output from the image, so the headers are never read.
+ *
+ *	An image is only used if it was made with the same arguments (bar
+ *	the file names and debugging flags), if none of the files it was
+ *	made from has changed, and if the input file's first @includes are
+ *	the image's, with nothing but C code between them; otherwise the
+ *	headers are parsed as usual. Headers that define resources, chunks
+ *	or objects can't be precompiled.
+ *
+ *	The image is a stream of 32-bit little-endian integers and strings.
+ *	Each pointer to a symbol or scope is written as an index, the
+ *	object's contents being written once, after all the roots, in the
+ *	order the indices were handed out; symbols that exist before any
+ *	file is read (the vis moniker and keyboard symbols, _reloc) are
+ *	written by name instead. The same routine visits an object's fields
+ *	for both writing and reading, so the two can't drift apart. Strings
+ *	that were in the string table go back into it, so comparing them by
+ *	address still works.
+ *
+ ***********************************************************************/
+#ifndef lint
+static char *rcsid =
+"$Id$";
+#endif lint
+
+#include    <config.h>
+#include    "goc.h"
+#include    "parse.h"
+#include    "scan.h"
+#include    "hash.h"
+#include    "stringt.h"
+#include    "symbol.h"
+#include    "pch.h"
+#include    <ctype.h>
+#include    <stddef.h>
+#include    <malloc.h>
+#include    <compat/string.h>
+#include    <compat/stdlib.h>
+#include    <sys/types.h>
+#include    <sys/stat.h>
+
+#if defined(unix) || defined(_LINUX)
+#include    <sys/mman.h>
+#include    <fcntl.h>
+#include    <unistd.h>
+#endif
+
+#if defined(_MSDOS)
+#define STAT _stat
+#else
+#define STAT stat
+#endif
+
+extern int  	    makeDepend;
+extern Symbol	    *classBeingParsed;
+extern Symbol	    *curResource;
+extern Symbol	    *curProtoMinor;
+extern MethodModels defaultModel;
+
+char	*pchUseName = NULL;
+char	*pchMakeName = NULL;
+
+#define PCH_MAGIC   	"GOCPCH01"
+#define PCH_MAGIC_LEN	8
+
+/*
+ * Kinds of object with an index of their own
+ */
+#define PCH_SYMBOL  	1
+#define PCH_SCOPE   	2
+
+/*
+ * Special values for a reference to a symbol or scope
+ */
+#define PCH_NULL    	0
+#define PCH_BASE    	-1  	/* Symbol: followed by scope code & name */
+#define PCH_GLOBAL  	-1  	/* Scope: the global scope */
+#define PCH_VIS_MONIKER	-2  	/* Scope: visMonikerScope */
+#define PCH_KBD	    	-3  	/* Scope: kbdAcceleratorScope */
+
+/*
+ * Kinds of string
+ */
+#define PCH_STR_NULL	0
+#define PCH_STR_PLAIN	1   	/* Its own copy */
+#define PCH_STR_ID  	2   	/* In the string table */
+
+#define PCH_END_OF_MACRO 0x10000	/* Past any MBlk length */
+
+/*
+ * An @include in the input file, whose output is in the image.
+ */
+typedef struct {
+    char    	*includeName;	/* Name as given */
+    int	    	localSearch;	/* Non-zero if given in quotes */
+    char    	*path;	    	/* File it was found in */
+    int	    	pushed;	    	/* Non-zero if the file was read, zero if
+				 * it had been @included already */
+    long    	start, end; 	/* Extent of its output (when making) */
+    char    	*text;	    	/* Its output (when using) */
+    int	    	textLen;
+} PchInclude;
+
+static PchInclude   *pchIncludes = NULL;
+static int  	    numPchIncludes = 0;
+static int  	    nextPchInclude = 0;	/* Next one to copy (when using) */
+static Boolean	    pchLoaded = FALSE;
+
+static char 	    *pchArgs = NULL;	/* Arguments that matter, each
+					 * followed by a newline */
+static int  	    pchArgsLen = 0;
+static int  	    pchLoadedArgsLen;	/* pchArgsLen when image loaded */
+
+static Hash_Table   pchBaseSyms;    	/* Symbols there before any file is
+					 * read, mapped to their scope */
+static Hash_Table   pchBaseMacros;  	/* Macros defined by arguments */
+
+/*
+ * State while writing or reading an image
+ */
+static Boolean	    pchReading;
+static FILE 	    *pchStream;	    	/* Writing: the image */
+static Hash_Table   pchIndices;	    	/* Writing: object -> index */
+static Symbol	    *pchRefused;    	/* Writing: symbol we can't write */
+static unsigned char *pchPtr;	    	/* Reading: next byte */
+static unsigned char *pchEnd;	    	/* Reading: end of the image */
+static char 	    *pchImageName;  	/* Reading: for error messages */
+static void 	    **pchObjects;   	/* Object for each index */
+static char 	    *pchKinds;	    	/* Kind of each object */
+static int  	    numPchObjects, maxPchObjects;
+
+static void PchSym(Symbol **symp);
+static void PchScope(Scope **scopep);
+
+
+
+/***********************************************************************
+ *				PchCorrupt
+ ***********************************************************************
+ * SYNOPSIS:	  Give up on an image that doesn't make sense
+ * CALLED BY:	  the reading routines
+ * RETURN:	  No
+ * SIDE EFFECTS:  Process exits.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchCorrupt(void)
+{
+    FatalError("precompiled header image %s is corrupt; remove it",
+	       pchImageName);
+}
+
+
+/***********************************************************************
+ *				PchInt
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read an integer
+ * CALLED BY:	  the visiting routines
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  *ip is set when reading.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchInt(int *ip)
+{
+    unsigned long   l;
+
+    if (pchReading) {
+	if (pchEnd - pchPtr < 4) {
+	    PchCorrupt();
+	}
+	l = (unsigned long)pchPtr[0] | ((unsigned long)pchPtr[1] << 8) |
+	    ((unsigned long)pchPtr[2] << 16) | ((unsigned long)pchPtr[3] << 24);
+	pchPtr += 4;
+	if (l & 0x80000000UL) {
+	    *ip = -(int)(~l & 0x7fffffffUL) - 1;
+	} else {
+	    *ip = (int)l;
+	}
+    } else {
+	l = (unsigned long)*ip;
+	putc((int)(l & 0xff), pchStream);
+	putc((int)((l >> 8) & 0xff), pchStream);
+	putc((int)((l >> 16) & 0xff), pchStream);
+	putc((int)((l >> 24) & 0xff), pchStream);
+    }
+}
+
+/***********************************************************************
+ *				PchBytes
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read a run of bytes
+ * CALLED BY:	  the visiting routines
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the bytes are copied into buf when reading.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchBytes(char *buf, int n)
+{
+    if (pchReading) {
+	if (n < 0 || pchEnd - pchPtr < n) {
+	    PchCorrupt();
+	}
+	bcopy(pchPtr, buf, n);
+	pchPtr += n;
+    } else {
+	fwrite(buf, 1, n, pchStream);
+    }
+}
+
+/***********************************************************************
+ *				PchStr
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read a string
+ * CALLED BY:	  the visiting routines
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  *sp is set when reading.
+ *
+ * STRATEGY:
+ *	The string is written with its null, so one read from a mapped
+ *	image can go straight to String_Enter. A string that was in the
+ *	string table when written goes back into it when read; any other
+ *	string gets a copy of its own, as whoever made it may change or
+ *	free it.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchStr(char **sp)
+{
+    int	    kind;
+    int	    len;
+
+    if (pchReading) {
+	PchInt(&kind);
+	if (kind == PCH_STR_NULL) {
+	    *sp = NULL;
+	    return;
+	}
+	PchInt(&len);
+	if (len < 0 || pchEnd - pchPtr < len + 1 || pchPtr[len] != '\0') {
+	    PchCorrupt();
+	}
+	if (kind == PCH_STR_ID) {
+	    *sp = String_Enter((char *)pchPtr, len);
+	} else {
+	    *sp = (char *)malloc(len + 1);
+	    bcopy(pchPtr, *sp, len + 1);
+	}
+	pchPtr += len + 1;
+    } else if (*sp == NULL) {
+	kind = PCH_STR_NULL;
+	PchInt(&kind);
+    } else {
+	len = strlen(*sp);
+	kind = (String_Lookup(*sp, len) == *sp) ? PCH_STR_ID : PCH_STR_PLAIN;
+	PchInt(&kind);
+	PchInt(&len);
+	fwrite(*sp, 1, len + 1, pchStream);
+    }
+}
+
+
+/***********************************************************************
+ *				PchObject
+ ***********************************************************************
+ * SYNOPSIS:	  Map an object to its index, or an index to its object
+ * CALLED BY:	  PchSym, PchScope
+ * RETURN:	  the index (writing) or the object (reading)
+ * SIDE EFFECTS:  When writing, an object not seen before is given the
+ *	    	  next index and queued to have its contents written.
+ *	    	  When reading, an object not seen before is allocated,
+ *	    	  its contents to be filled in when they're reached.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchGrow(int n)
+{
+    if (n > maxPchObjects) {
+	int 	newMax = maxPchObjects ? maxPchObjects : 256;
+
+	while (newMax < n) {
+	    newMax *= 2;
+	}
+	if (pchObjects == NULL) {
+	    pchObjects = (void **)malloc(newMax * sizeof(void *));
+	    pchKinds = (char *)malloc(newMax);
+	} else {
+	    pchObjects = (void **)realloc((malloc_t)pchObjects,
+					  newMax * sizeof(void *));
+	    pchKinds = (char *)realloc((malloc_t)pchKinds, newMax);
+	}
+	bzero(&pchObjects[maxPchObjects],
+	      (newMax - maxPchObjects) * sizeof(void *));
+	bzero(&pchKinds[maxPchObjects], newMax - maxPchObjects);
+	maxPchObjects = newMax;
+    }
+}
+
+static int
+PchIndexOf(void *obj, int kind)
+{
+    Hash_Entry	*entry;
+    Boolean 	new;
+
+    entry = Hash_CreateEntry(&pchIndices, (Address)obj, &new);
+    if (new) {
+	PchGrow(numPchObjects + 1);
+	pchObjects[numPchObjects] = obj;
+	pchKinds[numPchObjects] = kind;
+	numPchObjects += 1;
+	Hash_SetValue(entry, (long)numPchObjects);
+    }
+    return ((int)(long)Hash_GetValue(entry));
+}
+
+static void *
+PchObjectAt(int index, int kind)
+{
+    if (index < 1 || index > 0x1000000) {
+	PchCorrupt();
+    }
+    PchGrow(index);
+    if (pchObjects[index-1] == NULL) {
+	pchObjects[index-1] = calloc(1, (kind == PCH_SYMBOL) ?
+				     sizeof(Symbol) : sizeof(Scope));
+	pchKinds[index-1] = kind;
+	if (index > numPchObjects) {
+	    numPchObjects = index;
+	}
+    } else if (pchKinds[index-1] != kind) {
+	PchCorrupt();
+    }
+    return (pchObjects[index-1]);
+}
+
+
+/***********************************************************************
+ *				PchScopeByCode
+ ***********************************************************************
+ * SYNOPSIS:	  Map one of the scopes made before any file is read to
+ *	    	  or from the code for it
+ * CALLED BY:	  PchScope, PchSym, Pch_Init
+ * RETURN:	  the scope, or NullScope
+ * SIDE EFFECTS:  None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Scope *
+PchScopeByCode(int code)
+{
+    switch (code) {
+	case PCH_GLOBAL:    	return (globalScope);
+	case PCH_VIS_MONIKER:	return (visMonikerScope);
+	case PCH_KBD:	    	return (kbdAcceleratorScope);
+	default:    	    	return (NullScope);
+    }
+}
+
+static int
+PchCodeForScope(Scope *scope)
+{
+    if (scope == globalScope) {
+	return (PCH_GLOBAL);
+    } else if (scope == visMonikerScope) {
+	return (PCH_VIS_MONIKER);
+    } else if (scope == kbdAcceleratorScope) {
+	return (PCH_KBD);
+    } else {
+	return (PCH_NULL);
+    }
+}
+
+
+/***********************************************************************
+ *				PchSym
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read a reference to a symbol
+ * CALLED BY:	  the visiting routines
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  *symp is set when reading.
+ *
+ * STRATEGY:
+ *	A symbol that was there before any file was read is written as
+ *	the code for its scope and its name, and read by looking it up,
+ *	as there's only ever one of it. Any other symbol is written as its
+ *	index.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchSym(Symbol **symp)
+{
+    Hash_Entry	*entry;
+    int	    	i;
+    int	    	code;
+    char    	*name;
+    Scope   	*scope;
+
+    if (pchReading) {
+	PchInt(&i);
+	if (i == PCH_NULL) {
+	    *symp = NullSymbol;
+	} else if (i == PCH_BASE) {
+	    PchInt(&code);
+	    PchStr(&name);
+	    scope = PchScopeByCode(code);
+	    if (scope == NullScope || name == NULL ||
+		(entry = Hash_FindEntry(scope->symbols, name)) == NULL)
+	    {
+		PchCorrupt();
+	    }
+	    *symp = (Symbol *)Hash_GetValue(entry);
+	} else {
+	    *symp = (Symbol *)PchObjectAt(i, PCH_SYMBOL);
+	}
+    } else if (*symp == NullSymbol) {
+	i = PCH_NULL;
+	PchInt(&i);
+    } else if ((entry = Hash_FindEntry(&pchBaseSyms,
+				       (Address)*symp)) != NULL)
+    {
+	i = PCH_BASE;
+	code = (int)(long)Hash_GetValue(entry);
+	PchInt(&i);
+	PchInt(&code);
+	PchStr(&(*symp)->name);
+    } else {
+	i = PchIndexOf(*symp, PCH_SYMBOL);
+	PchInt(&i);
+    }
+}
+
+/***********************************************************************
+ *				PchScope
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read a reference to a scope
+ * CALLED BY:	  the visiting routines
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  *scopep is set when reading.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchScope(Scope **scopep)
+{
+    int	    i;
+
+    if (pchReading) {
+	PchInt(&i);
+	if (i == PCH_NULL) {
+	    *scopep = NullScope;
+	} else if (i < 0) {
+	    if ((*scopep = PchScopeByCode(i)) == NullScope) {
+		PchCorrupt();
+	    }
+	} else {
+	    *scopep = (Scope *)PchObjectAt(i, PCH_SCOPE);
+	}
+    } else {
+	if (*scopep == NullScope) {
+	    i = PCH_NULL;
+	} else if ((i = PchCodeForScope(*scopep)) == PCH_NULL) {
+	    i = PchIndexOf(*scopep, PCH_SCOPE);
+	}
+	PchInt(&i);
+    }
+}
+
+
+/***********************************************************************
+ *				PchSymbolTable
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read the symbols in a scope's table
+ * CALLED BY:	  PchScopeBody, PchState
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the symbols are entered in the table when reading.
+ *
+ * STRATEGY:
+ *	The name is written with each symbol, as the symbol itself may
+ *	not be read until later.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchSymbolTable(Hash_Table *table)
+{
+    Hash_Entry	*entry;
+    Hash_Search	search;
+    Symbol  	*sym;
+    char    	*name;
+    int	    	count;
+
+    if (pchReading) {
+	PchInt(&count);
+	while (count-- > 0) {
+	    PchStr(&name);
+	    PchSym(&sym);
+	    if (name == NULL || sym == NullSymbol) {
+		PchCorrupt();
+	    }
+	    entry = Hash_CreateEntry(table, name, NULL);
+	    Hash_SetValue(entry, sym);
+	}
+    } else {
+	count = 0;
+	for (entry = Hash_EnumFirst(table, &search);
+	     entry != NULL;
+	     entry = Hash_EnumNext(&search))
+	{
+	    if (Hash_FindEntry(&pchBaseSyms,
+			       (Address)Hash_GetValue(entry)) == NULL)
+	    {
+		count++;
+	    }
+	}
+	PchInt(&count);
+	for (entry = Hash_EnumFirst(table, &search);
+	     entry != NULL;
+	     entry = Hash_EnumNext(&search))
+	{
+	    sym = (Symbol *)Hash_GetValue(entry);
+	    if (Hash_FindEntry(&pchBaseSyms, (Address)sym) == NULL) {
+		name = entry->key.ptr;
+		PchStr(&name);
+		PchSym(&sym);
+	    }
+	}
+    }
+}
+
+/***********************************************************************
+ *				PchScopeBody
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read the contents of a scope
+ * CALLED BY:	  PchObjects
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the scope is filled in when reading.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchScopeBody(Scope *scope)
+{
+    PchScope(&scope->parent);
+    PchInt(&scope->restrict);
+    if (pchReading) {
+	scope->symbols = (Hash_Table *) malloc(sizeof(Hash_Table));
+	Hash_InitTable(scope->symbols, 0, HASH_ONE_WORD_KEYS, 3);
+    }
+    PchSymbolTable(scope->symbols);
+}
+
+
+/***********************************************************************
+ *				PchParams
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read a message's parameter list
+ * CALLED BY:	  PchSymbolBody
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the list is built when reading.
+ *
+ * STRATEGY:
+ *	Each element is preceded by a non-zero word, the list being ended
+ *	by a zero. The same goes for the other lists below.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchParams(MessageParam **paramp)
+{
+    int	    more;
+
+    for (;;) {
+	more = (*paramp != NullParam);
+	PchInt(&more);
+	if (!more) {
+	    *paramp = NullParam;
+	    return;
+	}
+	if (pchReading) {
+	    *paramp = (MessageParam *)calloc(1, sizeof(MessageParam));
+	}
+	PchStr(&(*paramp)->name);
+	PchStr(&(*paramp)->ctype);
+	PchStr(&(*paramp)->typeSuffix);
+	paramp = &(*paramp)->next;
+    }
+}
+
+/***********************************************************************
+ *				PchMethods
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read a class's list of methods
+ * CALLED BY:	  PchSymbolBody
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the list is built when reading.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchMethods(Method **methp)
+{
+    int	    more;
+    int	    model;
+
+    for (;;) {
+	more = (*methp != NullMethod);
+	PchInt(&more);
+	if (!more) {
+	    *methp = NullMethod;
+	    return;
+	}
+	if (pchReading) {
+	    *methp = (Method *)calloc(1, sizeof(Method));
+	}
+	PchStr(&(*methp)->name);
+	model = (int)(*methp)->model;
+	PchInt(&model);
+	(*methp)->model = (MethodModels)model;
+	PchSym(&(*methp)->message);
+	PchSym(&(*methp)->class);
+	PchInt(&(*methp)->htd);
+	methp = &(*methp)->next;
+    }
+}
+
+/***********************************************************************
+ *				PchRelocs
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read a class's list of relocations
+ * CALLED BY:	  PchSymbolBody
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the list is built when reading.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchRelocs(Reloc **relp)
+{
+    int	    more;
+    int	    type;
+
+    for (;;) {
+	more = (*relp != NullReloc);
+	PchInt(&more);
+	if (!more) {
+	    *relp = NullReloc;
+	    return;
+	}
+	if (pchReading) {
+	    *relp = (Reloc *)calloc(1, sizeof(Reloc));
+	}
+	PchStr(&(*relp)->text);
+	type = (int)(*relp)->type;
+	PchInt(&type);
+	(*relp)->type = (RelocTypes)type;
+	PchSym(&(*relp)->tag);
+	PchInt(&(*relp)->count);
+	PchStr(&(*relp)->structName);
+	relp = &(*relp)->next;
+    }
+}
+
+/***********************************************************************
+ *				PchDefaults
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read a class's list of overridden defaults
+ * CALLED BY:	  PchSymbolBody
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the list is built when reading.
+ *
+ * STRATEGY:
+ *	A class's defaults have only a name and a value; the rest of an
+ *	InstanceValue is for objects.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchDefaults(InstanceValue **instp)
+{
+    int	    more;
+
+    for (;;) {
+	more = (*instp != NullInstanceValue);
+	PchInt(&more);
+	if (!more) {
+	    *instp = NullInstanceValue;
+	    return;
+	}
+	if (pchReading) {
+	    *instp = (InstanceValue *)calloc(1, sizeof(InstanceValue));
+	}
+	PchStr(&(*instp)->name);
+	PchStr(&(*instp)->value);
+	instp = &(*instp)->next;
+    }
+}
+
+/***********************************************************************
+ *				PchMessageTail
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read where a class's next message goes
+ * CALLED BY:	  PchSymbolBody
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  nextMessageElementPtr is set when reading.
+ *
+ * STRATEGY:
+ *	nextMessageElementPtr points either at the class's own
+ *	firstMessagePtr or at the nextMessage field of its last message,
+ *	so it's written as which of those it is.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchMessageTail(Symbol *class)
+{
+    Symbol  **tailp = class->data.symClass.nextMessageElementPtr;
+    Symbol  *last = NullSymbol;
+    int	    where;
+
+    if (tailp == NULL) {
+	where = 0;
+    } else if (tailp == &class->data.symClass.firstMessagePtr) {
+	where = 1;
+    } else {
+	where = 2;
+	last = (Symbol *)((char *)tailp -
+			  offsetof(Symbol, data.symMessage.nextMessage));
+    }
+    PchInt(&where);
+    if (where == 2) {
+	PchSym(&last);
+    }
+    if (pchReading) {
+	switch (where) {
+	    case 0:
+		class->data.symClass.nextMessageElementPtr = NULL;
+		break;
+	    case 1:
+		class->data.symClass.nextMessageElementPtr =
+		    &class->data.symClass.firstMessagePtr;
+		break;
+	    case 2:
+		if (last == NullSymbol) {
+		    PchCorrupt();
+		}
+		class->data.symClass.nextMessageElementPtr =
+		    &last->data.symMessage.nextMessage;
+		break;
+	    default:
+		PchCorrupt();
+	}
+    }
+}
+
+
+/***********************************************************************
+ *				PchSymbolBody
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read the contents of a symbol
+ * CALLED BY:	  PchObjects
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the symbol is filled in when reading. If the symbol
+ *	    	  is of a type that can't be written, pchRefused is set.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchSymbolBody(Symbol *sym)
+{
+    int	    i;
+
+    PchInt(&sym->type);
+    PchInt(&sym->flags);
+    PchStr(&sym->name);
+    PchStr(&sym->fileName);
+    PchStr(&sym->realFileName);
+    PchInt(&sym->lineNumber);
+
+    switch (sym->type) {
+	case CLASS_SYM:
+	    PchSym(&sym->data.symClass.superclass);
+	    PchScope(&sym->data.symClass.localSymbols);
+	    PchInt(&sym->data.symClass.masterLevel);
+	    PchInt(&sym->data.symClass.firstMessage);
+	    PchInt(&sym->data.symClass.nextMessage);
+	    PchInt(&sym->data.symClass.nextTag);
+	    PchSym(&sym->data.symClass.firstMessagePtr);
+	    PchMessageTail(sym);
+	    PchSym(&sym->data.symClass.instanceData);
+	    PchSym(&sym->data.symClass.nextDeclaredClass);
+	    PchMethods(&sym->data.symClass.firstMethod);
+	    PchInt(&sym->data.symClass.methodCount);
+	    PchStr(&sym->data.symClass.root);
+	    PchRelocs(&sym->data.symClass.relocList);
+	    PchInt(&sym->data.symClass.masterMessages);
+	    PchDefaults(&sym->data.symClass.defaultList);
+	    PchInt(&sym->data.symClass.numUsed);
+	    if (pchReading) {
+		if (sym->data.symClass.numUsed < 0) {
+		    PchCorrupt();
+		}
+		sym->data.symClass.used = (sym->data.symClass.numUsed == 0) ?
+		    (Symbol **)NULL :
+		    (Symbol **)malloc(sym->data.symClass.numUsed *
+				      sizeof(Symbol *));
+	    }
+	    for (i = 0; i < sym->data.symClass.numUsed; i++) {
+		PchSym(&sym->data.symClass.used[i]);
+	    }
+	    PchSym(&sym->data.symClass.classSeg);
+	    break;
+	case MSG_SYM:
+	    PchSym(&sym->data.symMessage.class);
+	    PchSym(&sym->data.symMessage.nextMessage);
+	    PchInt(&sym->data.symMessage.messageNumber);
+	    PchInt(&sym->data.symMessage.mpd);
+	    PchStr(&sym->data.symMessage.mpdString);
+	    PchParams(&sym->data.symMessage.firstParam);
+	    PchStr(&sym->data.symMessage.returnType);
+	    PchSym(&sym->data.symMessage.protoMinor);
+	    break;
+	case EXPORT_SYM:
+	    PchSym(&sym->data.symExport.class);
+	    PchInt(&sym->data.symExport.firstMessage);
+	    PchInt(&sym->data.symExport.nextMessage);
+	    break;
+	case VARDATA_SYM:
+	    PchSym(&sym->data.symVardata.class);
+	    PchInt(&sym->data.symVardata.tag);
+	    PchStr(&sym->data.symVardata.ctype);
+	    PchStr(&sym->data.symVardata.typeSuffix);
+	    PchSym(&sym->data.symVardata.protoMinor);
+	    break;
+	case PROTOMINOR_SYM:
+	    PchSym(&sym->data.symProtoMinor.msgOrVardataSym);
+	    PchInt(&sym->data.symProtoMinor.references);
+	    break;
+	case REG_INSTANCE_SYM:
+	case VARIANT_PTR_SYM:
+	case LINK_SYM:
+	case VIS_MONIKER_SYM:
+	case KBD_ACCELERATOR_SYM:
+	case OPTR_SYM:
+	case CHUNK_INST_SYM:
+	    PchSym(&sym->data.symRegInstance.next);
+	    PchStr(&sym->data.symRegInstance.ctype);
+	    PchStr(&sym->data.symRegInstance.defaultValue);
+	    PchStr(&sym->data.symRegInstance.typeSuffix);
+	    break;
+	case COMPOSITE_SYM:
+	    /*
+	     * MakeInstanceVar sets the typeSuffix of every instance
+	     * variable, composites included, so it's kept too.
+	     */
+	    PchSym(&sym->data.symComposite.next);
+	    PchStr(&sym->data.symComposite.ctype);
+	    PchSym(&sym->data.symComposite.linkPart);
+	    PchStr(&sym->data.symRegInstance.typeSuffix);
+	    break;
+	case RESOURCE_SYM:
+	case CHUNK_SYM:
+	case OBJECT_SYM:
+	case VIS_MONIKER_CHUNK_SYM:
+	case GCN_LIST_SYM:
+	case GCN_LIST_OF_LISTS_SYM:
+	    if (pchReading) {
+		PchCorrupt();
+	    } else if (pchRefused == NullSymbol) {
+		pchRefused = sym;
+	    }
+	    break;
+	default:
+	    PchInt(&sym->data.symSpecial.value);
+	    break;
+    }
+}
+
+
+/***********************************************************************
+ *				PchMacros
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read the goc macros the headers defined
+ * CALLED BY:	  PchState
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the macros are defined when reading.
+ *
+ * STRATEGY:
+ *	A body is a chain of blocks, each either text or (with a length
+ *	of zero or less) the number of a parameter, so each is written as
+ *	its length and, if text, the text.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchMacroBody(MBlk **blockp)
+{
+    int	    len;
+
+    for (;;) {
+	len = (*blockp == NULL) ? PCH_END_OF_MACRO : (*blockp)->length;
+	PchInt(&len);
+	if (len == PCH_END_OF_MACRO) {
+	    *blockp = NULL;
+	    return;
+	}
+	if (pchReading) {
+	    if (len >= PCH_END_OF_MACRO) {
+		PchCorrupt();
+	    }
+	    *blockp = (MBlk *)malloc(sizeof(MBlk) +
+				     (len > MACRO_BLOCK_SIZE ? len : 0));
+	    (*blockp)->length = len;
+	    (*blockp)->dynamic = (len <= 0);
+	    (*blockp)->next = NULL;
+	}
+	if (len > 0) {
+	    PchBytes((*blockp)->text, len);
+	}
+	blockp = &(*blockp)->next;
+    }
+}
+
+static void
+PchMacros(void)
+{
+    Hash_Table	*table = Scan_MacroTable();
+    Hash_Entry	*entry;
+    Hash_Search	search;
+    Mac	    	*mac;
+    Mac	    	m;
+    int	    	count;
+
+    if (pchReading) {
+	PchInt(&count);
+	while (count-- > 0) {
+	    PchStr(&m.name);
+	    PchStr(&m.fileName);
+	    PchInt(&m.lineNo);
+	    PchInt(&m.numParams);
+	    PchMacroBody(&m.body);
+	    if (m.name == NULL) {
+		PchCorrupt();
+	    }
+	    (void)DefineMacro(m.name, m.fileName, m.lineNo, m.numParams,
+			      m.body);
+	}
+    } else {
+	count = 0;
+	for (entry = Hash_EnumFirst(table, &search);
+	     entry != NULL;
+	     entry = Hash_EnumNext(&search))
+	{
+	    if (Hash_FindEntry(&pchBaseMacros,
+			       (Address)Hash_GetValue(entry)) == NULL)
+	    {
+		count++;
+	    }
+	}
+	PchInt(&count);
+	for (entry = Hash_EnumFirst(table, &search);
+	     entry != NULL;
+	     entry = Hash_EnumNext(&search))
+	{
+	    mac = (Mac *)Hash_GetValue(entry);
+	    if (Hash_FindEntry(&pchBaseMacros, (Address)mac) == NULL) {
+		PchStr(&mac->name);
+		PchStr(&mac->fileName);
+		PchInt(&mac->lineNo);
+		PchInt(&mac->numParams);
+		PchMacroBody(&mac->body);
+	    }
+	}
+    }
+}
+
+
+/***********************************************************************
+ *				PchState
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read everything the headers left behind
+ * CALLED BY:	  Pch_Write, Pch_Init
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  When reading, goc is left as if it had just read the
+ *	    	  headers.
+ *
+ * STRATEGY:
+ *	The roots come first: the parser's state, the files read, the
+ *	global scope and the macros. Then come the contents of every
+ *	symbol and scope given an index, in order, until a zero kind.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchState(void)
+{
+    int	    model;
+    int	    count;
+    int	    kind;
+    int	    i;
+    char    *path;
+
+    model = (int)defaultModel;
+    PchInt(&model);
+    defaultModel = (MethodModels)model;
+    PchInt(&specificUI);
+    PchSym(&processClass);
+    PchSym(&curProtoMinor);
+
+    count = numFilesIncluded;
+    PchInt(&count);
+    for (i = 0; i < count; i++) {
+	if (pchReading) {
+	    PchStr(&path);
+	    if (path == NULL) {
+		PchCorrupt();
+	    }
+	    if (!FileHasBeenIncludedAlready(path)) {
+		MarkFileAsIncluded(path);
+	    }
+	} else {
+	    PchStr(&filesIncluded[i]);
+	}
+    }
+
+    PchSymbolTable(globalScope->symbols);
+    PchMacros();
+
+    if (pchReading) {
+	for (i = 0; ; i++) {
+	    PchInt(&kind);
+	    if (kind == 0) {
+		break;
+	    }
+	    if (i >= numPchObjects || pchKinds[i] != kind) {
+		PchCorrupt();
+	    }
+	    if (kind == PCH_SYMBOL) {
+		PchSymbolBody((Symbol *)pchObjects[i]);
+	    } else {
+		PchScopeBody((Scope *)pchObjects[i]);
+	    }
+	}
+	if (i != numPchObjects) {
+	    PchCorrupt();
+	}
+    } else {
+	for (i = 0; i < numPchObjects; i++) {
+	    kind = pchKinds[i];
+	    PchInt(&kind);
+	    if (kind == PCH_SYMBOL) {
+		PchSymbolBody((Symbol *)pchObjects[i]);
+	    } else {
+		PchScopeBody((Scope *)pchObjects[i]);
+	    }
+	}
+	kind = 0;
+	PchInt(&kind);
+    }
+}
+
+
+/***********************************************************************
+ *				PchScanIncludes
+ ***********************************************************************
+ * SYNOPSIS:	  Find the @includes a file starts with
+ * CALLED BY:	  Pch_Init
+ * RETURN:	  the number found; *onlyIncludesPtr is FALSE if they end
+ *	    	  at some other goc directive, TRUE if at the end of file
+ * SIDE EFFECTS:  *namesPtr and *localPtr are set to arrays holding the
+ *	    	  names and whether each was in quotes.
+ *
+ * STRATEGY:
+ *	Only a directive at the start of a line (after any comments)
+ *	counts. Anything else is C code, which goc just copies to the
+ *	output, so it doesn't matter what's between the @includes.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+PchScanIncludes(char *file,
+		char ***namesPtr,
+		int **localPtr,
+		Boolean *onlyIncludesPtr)
+{
+    FILE    *f;
+    char    line[1024];
+    char    *cp, *end;
+    Boolean inComment = FALSE;
+    int	    num = 0, max = 0;
+    char    **names = NULL;
+    int	    *local = NULL;
+
+    *onlyIncludesPtr = TRUE;
+    f = fopen(file, "rb");
+    if (f == NULL) {
+	*namesPtr = NULL;
+	*localPtr = NULL;
+	return (0);
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+	cp = line;
+	for (;;) {
+	    if (inComment) {
+		if ((end = strstr(cp, "*/")) == NULL) {
+		    cp = "";
+		    break;
+		}
+		cp = end + 2;
+		inComment = FALSE;
+	    }
+	    while (isspace(*cp)) {
+		cp++;
+	    }
+	    if (cp[0] != '/' || cp[1] != '*') {
+		break;
+	    }
+	    inComment = TRUE;
+	    cp += 2;
+	}
+	if (*cp != '@') {
+	    continue;
+	}
+	if (strncmp(cp, "@include", 8) != 0 ||
+	    isalnum(cp[8]) || cp[8] == '_')
+	{
+	    *onlyIncludesPtr = FALSE;
+	    break;
+	}
+	for (cp += 8; *cp == ' ' || *cp == '\t'; cp++) {
+	    ;
+	}
+	if ((*cp != '<' && *cp != '"') ||
+	    (end = strchr(cp + 1, (*cp == '<') ? '>' : '"')) == NULL)
+	{
+	    *onlyIncludesPtr = FALSE;
+	    break;
+	}
+	if (num == max) {
+	    max = max ? max * 2 : 8;
+	    names = (char **)realloc((malloc_t)names, max * sizeof(char *));
+	    local = (int *)realloc((malloc_t)local, max * sizeof(int));
+	}
+	local[num] = (*cp == '"');
+	*end = '\0';
+	names[num] = String_EnterNoLen(cp + 1);
+	num++;
+    }
+    fclose(f);
+    *namesPtr = names;
+    *localPtr = local;
+    return (num);
+}
+
+
+/***********************************************************************
+ *				Pch_NoteArgs
+ ***********************************************************************
+ * SYNOPSIS:	  Record an argument that affects how headers are parsed
+ * CALLED BY:	  ParseArgs
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the argument (and any value that followed it) is
+ *	    	  added to pchArgs
+ *
+ * STRATEGY:
+ *	The input and output files, the debugging flags, -M and the
+ *	images themselves make no difference to what the headers turn
+ *	into, so an image made with some of them can be used with others.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Pch_NoteArgs(char **argv, int argc)
+{
+    int	    i;
+    int	    len;
+
+    if (argv[0][0] != '-' || strchr("dgGMoFPRBj", argv[0][1]) != NULL) {
+	return;
+    }
+    for (i = 0; i < argc; i++) {
+	len = strlen(argv[i]);
+	pchArgs = (char *)realloc((malloc_t)pchArgs, pchArgsLen + len + 2);
+	bcopy(argv[i], pchArgs + pchArgsLen, len);
+	pchArgsLen += len;
+	pchArgs[pchArgsLen++] = '\n';
+	pchArgs[pchArgsLen] = '\0';
+    }
+}
+
+
+/***********************************************************************
+ *				PchMap
+ ***********************************************************************
+ * SYNOPSIS:	  Get an image into memory for reading
+ * CALLED BY:	  Pch_Init
+ * RETURN:	  TRUE if it could be read
+ * SIDE EFFECTS:  pchPtr and pchEnd are set. The image stays in memory
+ *	    	  for the rest of the run, as the text for the @includes
+ *	    	  is copied to the output straight from it.
+ *
+ * STRATEGY:
+ *	Map the file where we can, as most of it is read just once.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+PchMap(char *name)
+{
+    struct STAT	stb;
+    unsigned char *base;
+#if defined(unix) || defined(_LINUX)
+    int	    	fd;
+
+    fd = open(name, O_RDONLY);
+    if (fd < 0) {
+	return (FALSE);
+    }
+    if (fstat(fd, &stb) < 0 || stb.st_size == 0) {
+	close(fd);
+	return (FALSE);
+    }
+    base = (unsigned char *)mmap(NULL, stb.st_size, PROT_READ, MAP_PRIVATE,
+				 fd, 0);
+    close(fd);
+    if (base == (unsigned char *)MAP_FAILED) {
+	return (FALSE);
+    }
+#else
+    FILE    	*f;
+
+    if (STAT(name, &stb) < 0 || stb.st_size == 0) {
+	return (FALSE);
+    }
+    f = fopen(name, "rb");
+    if (f == NULL) {
+	return (FALSE);
+    }
+    base = (unsigned char *)malloc(stb.st_size);
+    if (fread(base, 1, stb.st_size, f) != stb.st_size) {
+	fclose(f);
+	free((malloc_t)base);
+	return (FALSE);
+    }
+    fclose(f);
+#endif
+    pchPtr = base;
+    pchEnd = base + stb.st_size;
+    return (TRUE);
+}
+
+
+/***********************************************************************
+ *				PchHeader
+ ***********************************************************************
+ * SYNOPSIS:	  Write or read, and when reading check, the part of an
+ *	    	  image that says whether it can be used
+ * CALLED BY:	  Pch_Write, Pch_Init
+ * RETURN:	  NULL if all's well, else why the image can't be used
+ * SIDE EFFECTS:  When reading, pchIncludes is set up.
+ *
+ * STRATEGY:
+ *	The header holds the arguments, the files read with the time each
+ *	was modified and its size, and the @includes with their output.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static char *
+PchHeader(FILE *output)
+{
+    char    	*args;
+    char    	*path;
+    struct STAT	stb;
+    int	    	count;
+    int	    	mtime, size;
+    int	    	i;
+    char    	*stale = NULL;
+    PchInclude	*pi;
+
+    if (pchReading) {
+	if (pchEnd - pchPtr < PCH_MAGIC_LEN ||
+	    strncmp((char *)pchPtr, PCH_MAGIC, PCH_MAGIC_LEN) != 0)
+	{
+	    return ("it isn't one this goc can read");
+	}
+	pchPtr += PCH_MAGIC_LEN;
+    } else {
+	fwrite(PCH_MAGIC, 1, PCH_MAGIC_LEN, pchStream);
+    }
+
+    args = pchArgs ? pchArgs : "";
+    PchStr(&args);
+    if (pchReading && strcmp(args, pchArgs ? pchArgs : "") != 0) {
+	return ("it was made with different arguments");
+    }
+
+    count = numFilesIncluded;
+    PchInt(&count);
+    for (i = 0; i < count; i++) {
+	if (!pchReading) {
+	    path = filesIncluded[i];
+	    if (STAT(path, &stb) < 0) {
+		stb.st_mtime = 0;
+		stb.st_size = 0;
+	    }
+	    mtime = (int)stb.st_mtime;
+	    size = (int)stb.st_size;
+	}
+	PchStr(&path);
+	PchInt(&mtime);
+	PchInt(&size);
+	if (pchReading && stale == NULL &&
+	    (STAT(path, &stb) < 0 || (int)stb.st_mtime != mtime ||
+	     (int)stb.st_size != size))
+	{
+	    stale = path;
+	}
+    }
+    if (stale != NULL) {
+	static char why[1024];
+
+	sprintf(why, "%.900s has changed", stale);
+	return (why);
+    }
+
+    PchInt(&numPchIncludes);
+    if (pchReading) {
+	if (numPchIncludes < 0) {
+	    PchCorrupt();
+	}
+	pchIncludes = (PchInclude *)calloc(numPchIncludes + 1,
+					   sizeof(PchInclude));
+    }
+    for (i = 0; i < numPchIncludes; i++) {
+	pi = &pchIncludes[i];
+	PchStr(&pi->includeName);
+	PchInt(&pi->localSearch);
+	PchStr(&pi->path);
+	PchInt(&pi->pushed);
+	if (pchReading) {
+	    if (pi->includeName == NULL || pi->path == NULL) {
+		PchCorrupt();
+	    }
+	    PchInt(&pi->textLen);
+	    if (pi->textLen < 0 || pchEnd - pchPtr < pi->textLen) {
+		PchCorrupt();
+	    }
+	    pi->text = (char *)pchPtr;
+	    pchPtr += pi->textLen;
+	} else {
+	    char    buf[4096];
+	    long    left;
+	    int	    n;
+
+	    pi->textLen = (int)(pi->end - pi->start);
+	    PchInt(&pi->textLen);
+	    fseek(output, pi->start, SEEK_SET);
+	    for (left = pi->textLen; left > 0; left -= n) {
+		n = fread(buf, 1, (left > sizeof(buf)) ? sizeof(buf) : left,
+			  output);
+		if (n <= 0) {
+		    return ("the output file couldn't be read back");
+		}
+		fwrite(buf, 1, n, pchStream);
+	    }
+	}
+    }
+    return (NULL);
+}
+
+
+/***********************************************************************
+ *				PchNoteBase
+ ***********************************************************************
+ * SYNOPSIS:	  Note the symbols and macros that exist before any file
+ *	    	  is read, so they're not written to an image
+ * CALLED BY:	  Pch_Init, Pch_Preload
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  pchBaseSyms and pchBaseMacros are filled in
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchNoteBase(void)
+{
+    Hash_Entry	*entry;
+    Hash_Search	search;
+    Scope   	*scope;
+    int	    	code;
+
+    Hash_InitTable(&pchBaseSyms, 0, HASH_ONE_WORD_KEYS, 3);
+    for (code = PCH_GLOBAL; code >= PCH_KBD; code--) {
+	scope = PchScopeByCode(code);
+	for (entry = Hash_EnumFirst(scope->symbols, &search);
+	     entry != NULL;
+	     entry = Hash_EnumNext(&search))
+	{
+	    Hash_SetValue(Hash_CreateEntry(&pchBaseSyms,
+					   (Address)Hash_GetValue(entry),
+					   NULL),
+			  (long)code);
+	}
+    }
+    Hash_InitTable(&pchBaseMacros, 0, HASH_ONE_WORD_KEYS, 3);
+    for (entry = Hash_EnumFirst(Scan_MacroTable(), &search);
+	 entry != NULL;
+	 entry = Hash_EnumNext(&search))
+    {
+	(void)Hash_CreateEntry(&pchBaseMacros, (Address)Hash_GetValue(entry),
+			       NULL);
+    }
+}
+
+
+/***********************************************************************
+ *				PchCheckInput
+ ***********************************************************************
+ * SYNOPSIS:	  See if the input file starts with the image's @includes
+ * CALLED BY:	  PchLoad, Pch_Init
+ * RETURN:	  NULL if it does, else why the image can't be used
+ * SIDE EFFECTS:  None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static char *
+PchCheckInput(void)
+{
+    char    	**names;
+    int	    	*local;
+    int	    	num;
+    int	    	i;
+    Boolean 	onlyIncludes;
+    char    	*why = NULL;
+
+    num = PchScanIncludes(inFile, &names, &local, &onlyIncludes);
+    if (num < numPchIncludes) {
+	why = "the input file doesn't start with its @includes";
+    } else {
+	for (i = 0; i < numPchIncludes; i++) {
+	    if (strcmp(names[i], pchIncludes[i].includeName) != 0 ||
+		local[i] != pchIncludes[i].localSearch)
+	    {
+		why = "the input file doesn't start with its @includes";
+		break;
+	    }
+	}
+    }
+    if (names != NULL) {
+	free((malloc_t)names);
+	free((malloc_t)local);
+    }
+    return (why);
+}
+
+
+/***********************************************************************
+ *				PchLoad
+ ***********************************************************************
+ * SYNOPSIS:	  Check the image given with -g and, if it can be used,
+ *	    	  load it
+ * CALLED BY:	  Pch_Init, Pch_Preload
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  If the image is used, goc is left as if it had read
+ *	    	  the headers in it, bar their output. If not, a warning
+ *	    	  says why.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+PchLoad(Boolean checkInput)
+{
+    char    *why;
+
+    pchImageName = pchUseName;
+    if (!PchMap(pchUseName)) {
+	if (gocdebug) {
+	    fprintf(stderr, "No precompiled headers in %s\n", pchUseName);
+	}
+	return;
+    }
+    pchReading = TRUE;
+    why = PchHeader((FILE *)NULL);
+    if (why == NULL && checkInput) {
+	why = PchCheckInput();
+    }
+    if (why != NULL) {
+	fprintf(stderr, "Warning: not using precompiled headers in %s: %s\n",
+		pchUseName, why);
+	pchReading = FALSE;
+	numPchIncludes = 0;
+	return;
+    }
+
+    Hash_InitTable(&pchIndices, 0, HASH_ONE_WORD_KEYS, 3);
+    PchState();
+    pchReading = FALSE;
+    pchLoaded = TRUE;
+    pchLoadedArgsLen = pchArgsLen;
+    if (gocdebug) {
+	fprintf(stderr, "Loaded %d objects from precompiled headers in %s\n",
+		numPchObjects, pchUseName);
+    }
+}
+
+
+/***********************************************************************
+ *				Pch_Init
+ ***********************************************************************
+ * SYNOPSIS:	  Load the image given with -g, if it can be used, or
+ *	    	  get ready to make the one given with -G
+ * CALLED BY:	  main, after Scan_Init
+ * RETURN:	  FALSE if an image was loaded by Pch_Preload but can't be
+ *	    	  used for this input file, so goc must start afresh
+ * SIDE EFFECTS:  If the image is used, goc is left as if it had read
+ *	    	  the headers in it, bar their output.
+ *
+ * STRATEGY:
+ *	An image is only used if the input file's leading @includes begin
+ *	with the image's. The image can be loaded before the input file
+ *	is parsed, as anything before those @includes is just C code.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+Boolean
+Pch_Init(void)
+{
+    char    	**names;
+    int	    	*local;
+    Boolean 	onlyIncludes;
+
+    if (pchLoaded) {
+	/*
+	 * Loaded before the arguments for this file were seen. They must
+	 * not have added any that change how headers parse, nor asked for
+	 * the headers to be read.
+	 */
+	return (pchArgsLen == pchLoadedArgsLen && !makeDepend &&
+		!allowOptimize && pchMakeName == NULL &&
+		PchCheckInput() == NULL);
+    }
+
+    if (pchUseName == NULL && pchMakeName == NULL) {
+	return (TRUE);
+    }
+
+    PchNoteBase();
+
+    if (pchMakeName != NULL) {
+	if (makeDepend || allowOptimize) {
+	    FatalError("-G can't be used with -M or -p");
+	}
+	if (strcmp(outFile, "-") == 0) {
+	    FatalError("-G needs an output file");
+	}
+	(void)PchScanIncludes(inFile, &names, &local, &onlyIncludes);
+	if (!onlyIncludes) {
+	    FatalError("%s: only @include lines can be precompiled", inFile);
+	}
+	return (TRUE);
+    }
+
+    /*
+     * The dependencies must come from reading the files, and @optimize
+     * does its own thing with them.
+     */
+    if (!makeDepend && !allowOptimize) {
+	PchLoad(TRUE);
+    }
+    return (TRUE);
+}
+
+
+/***********************************************************************
+ *				Pch_Preload
+ ***********************************************************************
+ * SYNOPSIS:	  Load the image given with -g before knowing which files
+ *	    	  it's for
+ * CALLED BY:	  BatchRun
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  As for Pch_Init
+ *
+ * STRATEGY:
+ *	Each file that's then compiled has Pch_Init check whether it can
+ *	use what's been loaded.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Pch_Preload(void)
+{
+    if (pchUseName != NULL && !makeDepend && !allowOptimize) {
+	PchNoteBase();
+	PchLoad(FALSE);
+    }
+}
+
+
+/***********************************************************************
+ *				Pch_Include
+ ***********************************************************************
+ * SYNOPSIS:	  Deal with an @include
+ * CALLED BY:	  ScanMaybeIncludeFile
+ * RETURN:	  TRUE if the @include has been taken care of
+ * SIDE EFFECTS:  When using an image, the file is closed and its output
+ *	    	  copied from the image. When making one, an @include in
+ *	    	  the input file is recorded along with where its output
+ *	    	  starts.
+ *
+ * STRATEGY:
+ *	What's written after the output for a file, to get back to the
+ *	file that @included it, isn't part of the text, as it depends on
+ *	that file, so it's done here.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+Boolean
+Pch_Include(char *includeName,
+	    Boolean localSearch,
+	    char *path,
+	    FILE *newin)
+{
+    PchInclude	*pi;
+
+    if (curFile->next != (File *)NULL) {
+	return (FALSE);
+    }
+
+    if (pchMakeName != NULL) {
+	pchIncludes = (PchInclude *)realloc((malloc_t)pchIncludes,
+					    (numPchIncludes + 1) *
+					    sizeof(PchInclude));
+	pi = &pchIncludes[numPchIncludes++];
+	pi->includeName = includeName;
+	pi->localSearch = localSearch;
+	pi->path = path;
+	pi->pushed = FALSE;
+	pi->start = pi->end = ftell(foutput);
+	pi->text = NULL;
+	pi->textLen = 0;
+	return (FALSE);
+    }
+
+    if (!pchLoaded || nextPchInclude == numPchIncludes) {
+	return (FALSE);
+    }
+    pi = &pchIncludes[nextPchInclude++];
+    if (strcmp(path, pi->path) != 0) {
+	FatalError("%s: @include of %s found %s, not the %s precompiled "
+		   "in %s; compile without -g", curFile->name, includeName,
+		   path, pi->path, pchUseName);
+    }
+    if (newin != NULL) {
+	fclose(newin);
+    }
+    if (foutput) {
+	fwrite(pi->text, 1, pi->textLen, foutput);
+    }
+    if (pi->pushed) {
+	OutputForgetLineFile();
+	OutputLineNumber(yylineno, curFile->name);
+    }
+    return (TRUE);
+}
+
+
+/***********************************************************************
+ *				Pch_IncludeDone
+ ***********************************************************************
+ * SYNOPSIS:	  Note the end of the output for a file the input file
+ *	    	  @included
+ * CALLED BY:	  yystdwrap, on getting back to the input file
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the extent of the last @include's output is recorded
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Pch_IncludeDone(void)
+{
+    if (pchMakeName != NULL && numPchIncludes > 0 &&
+	curFile->next == (File *)NULL)
+    {
+	pchIncludes[numPchIncludes-1].pushed = TRUE;
+	pchIncludes[numPchIncludes-1].end = ftell(foutput);
+    }
+}
+
+
+/***********************************************************************
+ *				Pch_Write
+ ***********************************************************************
+ * SYNOPSIS:	  Write the image given with -G
+ * CALLED BY:	  main, once the input file has been parsed
+ * RETURN:	  Nothing
+ * SIDE EFFECTS:  the image is written, or an error given
+ *
+ * STRATEGY:
+ *	Write to a temporary file and rename it when done, so a goc
+ *	using the image never sees half of one.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Pch_Write(void)
+{
+    FILE    *output;
+    char    *tmp;
+    char    *why;
+
+    if (resourceList != NullSymbol || undefinedList != NullSymbol ||
+	curResource != NullSymbol)
+    {
+	gocerror(NullSymbol, "%s: headers that define resources can't be "
+		 "precompiled", inFile);
+	return;
+    }
+    if (classBeingParsed != NullSymbol || deflibPtr != NullDeflibNode ||
+	classDeclList != NullSymbol || scopePtr != &ScopeArray[0])
+    {
+	gocerror(NullSymbol, "%s: a header leaves a @class, @deflib or "
+		 "scope open, so it can't be precompiled", inFile);
+	return;
+    }
+
+    fflush(foutput);
+    output = fopen(outFile, "rb");
+    if (output == NULL) {
+	gocerror(NullSymbol, "%s: can't read it back to precompile headers",
+		 outFile);
+	return;
+    }
+    tmp = (char *)malloc(strlen(pchMakeName) + 5);
+    sprintf(tmp, "%s.new", pchMakeName);
+    pchStream = fopen(tmp, "wb");
+    if (pchStream == NULL) {
+	fclose(output);
+	gocerror(NullSymbol, "%s: can't create it", tmp);
+	free(tmp);
+	return;
+    }
+
+    pchReading = FALSE;
+    pchRefused = NullSymbol;
+    Hash_InitTable(&pchIndices, 0, HASH_ONE_WORD_KEYS, 3);
+    why = PchHeader(output);
+    fclose(output);
+    if (why == NULL) {
+	PchState();
+	if (pchRefused != NullSymbol) {
+	    why = "headers that define resources, chunks or objects can't be "
+		"precompiled";
+	}
+    }
+    if (fclose(pchStream) != 0 && why == NULL) {
+	why = "the image couldn't be written";
+    }
+    if (why == NULL) {
+	(void)unlink(pchMakeName);
+	if (rename(tmp, pchMakeName) < 0) {
+	    why = "the image couldn't be renamed into place";
+	}
+    }
+    if (why != NULL) {
+	(void)unlink(tmp);
+	gocerror(pchRefused, "%s: %s", pchMakeName, why);
+    } else if (gocdebug) {
+	fprintf(stderr, "Wrote %d objects to precompiled headers in %s\n",
+		numPchObjects, pchMakeName);
+    }
+    free(tmp);
+}
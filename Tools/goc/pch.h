@@ -0,0 +1,55 @@
+/***********************************************************************
+ *
+ *	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * PROJECT:	  PCGEOS
+ * MODULE:	  goc -- Precompiled headers
+ * FILE:	  pch.h
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26   	Initial version
+ *
+ * DESCRIPTION:
+ *	Interface to the precompiled header images made with -G and used
+ *	with -g.
+ *
+ ***********************************************************************/
+#ifndef _PCH_H_
+#define _PCH_H_
+
+#include "goc.h"
+
+/* image to use if it matches (-g), and image to make (-G) */
+extern char *pchUseName;
+extern char *pchMakeName;
+
+/* record arguments that affect how the headers are parsed */
+extern void Pch_NoteArgs(char **argv, int argc);
+
+/*
+ * Check and load the image to use, or prepare to make one. Returns FALSE
+ * if an image loaded by Pch_Preload can't be used for the input file.
+ */
+extern Boolean Pch_Init(void);
+
+/* load the image to use before the input file is known (goc -B) */
+extern void Pch_Preload(void);
+
+/*
+ * Called for every @include. Returns TRUE if the file's output was copied
+ * from the image, in which case the file is closed and mustn't be read.
+ */
+extern Boolean Pch_Include(char *includeName, Boolean localSearch,
+			   char *path, FILE *newin);
+
+/* called when a file @included by the input file has been read */
+extern void Pch_IncludeDone(void);
+
+/* write the image after the input file has been parsed */
+extern void Pch_Write(void);
+
+#endif /* _PCH_H_ */
@@ -39,6 +39,7 @@ static char *rcsid =
 #include    "symbol.h"
 #include    "map.h"
 #include    "depends.h"
+#include    "pch.h"
 #include    <stdio.h>
 #include    <ctype.h>
 #include    <malloc.h>
@@ -2430,6 +2431,11 @@ ScanMaybeIncludeFile (char *path,
     Depends_StoreInclude(includeName,path,localSearch);
  dont_store_include:
 
+    /* headers whose output is in a precompiled image are just copied */
+    if (Pch_Include(includeName, localSearch, path, newin)) {
+	return;
+    }
+
     /* make sure to use full file name.   */
     /* DON'T include file more than once into the same output */
     if(FileHasBeenIncludedAlready(path)){
@@ -2842,6 +2848,7 @@ yystdwrap(void)
 	/* output an #endif for the included file. */
 	/* we do this for files that get copied in and for pre-goced ones */
 	Output("#endif\n");
+	Pch_IncludeDone();
 	OutputLineNumber(yylineno,curFile->name);
 
 	result = FALSE;
@@ -5478,6 +5485,29 @@ Scan_MacroInit(void)
 }
 
 
+/***********************************************************************
+ *				Scan_MacroTable
+ ***********************************************************************
+ * SYNOPSIS:	  Return the table of macros
+ * CALLED BY:	  Pch module
+ * RETURN:	  Hash_Table * holding a Mac * for each macro
+ * SIDE EFFECTS:  None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+Hash_Table *
+Scan_MacroTable(void)
+{
+    return (&macroWords);
+}
+
+
 
 /***********************************************************************
  *				Scan_Init
@@ -196,7 +196,18 @@ typedef struct _MacState {
     struct _MacState	*next;	    /* Next frame in stack */
 }	MacState;
 
-
+/*
+ * Access to the macro table and the list of files read, for saving and
+ * restoring them with precompiled headers.
+ */
+extern Hash_Table *Scan_MacroTable(void);
+extern Mac *DefineMacro(char *name, char *fileName, int lineNo,
+			int numParams, MBlk *body);
+
+extern char **filesIncluded;
+extern int  numFilesIncluded;
+extern void MarkFileAsIncluded(char *name);
+extern Boolean FileHasBeenIncludedAlready(char *name);
 
 #endif /* _SCAN_H_ */
 
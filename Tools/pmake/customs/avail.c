@@ -239,6 +239,15 @@ Avail_Init(criteria, checkTime)
     availInterval.tv_usec = 0;
 
     availCheck = OS_Init();
+
+    /*
+     * Unless told otherwise, accept one job per processor, if the OS
+     * module knows how many there are.
+     */
+    if (!(criteria->changeMask & AVAIL_IMPORTS) && OS_NumCpus() > 0) {
+	criteria->imports = OS_NumCpus();
+	criteria->changeMask |= AVAIL_IMPORTS;
+    }
     
     availEvent = Rpc_EventCreate(&availInterval, Avail_Send, (Rpc_Opaque)0);
 	
@@ -328,7 +337,7 @@ Avail_Local(what, ratingPtr)
 
 	if (load > maxLoad) {
 	    if (verbose) {
-		printf ("load: %f\n", (double) load/FSCALE);
+		printf ("load: %f\n", (double) load/LOADSCALE);
 	    }
 	    return AVAIL_LOAD;
 	}
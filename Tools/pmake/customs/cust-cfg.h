@@ -89,6 +89,11 @@
 #if defined (unix)
 #define CAN_EXPORT
 #endif /* defined (unix) */
+/*
+ * Not for the Watcom _LINUX build: job.c has its Rmt_Begin/Rmt_Export calls
+ * commented out, and rmt.c and customslib.c compile only under unix, so
+ * -x and -X would be flags that do nothing.
+ */
 
 /*
  * If you're using something more reliable than NFS for your filesystem,
@@ -57,6 +57,7 @@ static char *rcsid =
 #include    <stdio.h>
 #include    <sys/ioctl.h>
 #include    <strings.h>
+#include    <string.h>
 #include    <signal.h>
 #include    <sys/resource.h>
 #include    <netdb.h>
@@ -92,6 +93,8 @@ int	    	  	    tcpSocket;
 short			    udpPort;
 int	    	  	    udpSocket;	/* The actual socket to which clients
 					 * connect */
+u_short	    	    	    firstPort;	/* UDP ports of the agents on our */
+u_short	    	    	    lastPort;	/* network (-ports), else udpPort */
 struct sockaddr_in	    localAddr;	/* Address of local socket */
 
 /*-
@@ -446,6 +449,8 @@ Usage (void)
     printf ("\t-net <netnum>	Set customs network number\n");
     printf ("\t-arch <archcode> Set customs architecture code\n");
     printf ("\t-master	    	Allow agent to become the master, if needed\n");
+    printf ("\t-port <num>  	Use port <num> for both udp and tcp services\n");
+    printf ("\t-ports <low>-<high> Share a master with the agents on these ports\n");
     exit(1);
 }
 
@@ -473,6 +478,9 @@ main (int argc, char **argv)
     int	    	  	checkTime;
     struct servent  	*sep;
     int			i;
+    int	    	    	port;
+    int	    	    	lowPort,
+			highPort;
 
     clients = (char **)malloc(sizeof(char *) * argc);
     numClients = 0;
@@ -483,6 +491,11 @@ main (int argc, char **argv)
     argc--, argv++;
     criteria.changeMask = 0;
     checkTime = 0;
+    port = 0;
+    lowPort = highPort = 0;
+    if (getenv(CUSTOMS_PORT_VAR) != NULL) {
+	port = atoi(getenv(CUSTOMS_PORT_VAR));
+    }
 
     while (argc > 0) {
 	if (strcmp (*argv, "-verbose") == 0) {
@@ -580,6 +593,32 @@ main (int argc, char **argv)
 	    }
 	} else if (strcmp(*argv, "-master") == 0) {
 	    canBeMaster = TRUE;
+	} else if (strcmp(*argv, "-port") == 0) {
+	    if (argc > 1 && atoi(argv[1]) > 0) {
+		port = atoi(argv[1]);
+		argc--;
+		argv++;
+	    } else {
+		printf("-port needs a port number for an argument\n");
+		Usage();
+		/*NOTREACHED*/
+	    }
+	} else if (strcmp(*argv, "-ports") == 0) {
+	    if (argc > 1 &&
+		sscanf(argv[1], "%d-%d", &lowPort, &highPort) == 2 &&
+		lowPort > 0 && lowPort <= highPort)
+	    {
+		argc--;
+		argv++;
+	    } else {
+		printf("-ports needs a range of ports (e.g. 8231-8238) for an argument\n");
+		Usage();
+		/*NOTREACHED*/
+	    }
+	    if (highPort - lowPort >= MAXNETS - 1) {
+		printf("-ports can cover at most %d ports\n", MAXNETS - 1);
+		exit(1);
+	    }
 	} else if (**argv == '-') {
 	    printf ("Unknown option %s\n", *argv);
 	    Usage();
@@ -650,7 +689,12 @@ main (int argc, char **argv)
 	fcntl(1, F_SETFL, FAPPEND);
     }
 
-    for (i = 3; i > 0; i--) {
+    /*
+     * A port given explicitly is used for both services, and the services
+     * database isn't consulted.
+     */
+    sep = NULL;
+    for (i = (port > 0) ? 0 : 3; i > 0; i--) {
 	sep = getservbyname("customs", "udp");
 	if (sep == NULL) {
 	    sleep(2);
@@ -658,7 +702,9 @@ main (int argc, char **argv)
 	    break;
 	}
     }
-    if (sep == NULL) {
+    if (port > 0) {
+	udpPort = port;
+    } else if (sep == NULL) {
 	printf("customs/udp (still) unknown\n");
 	udpPort = DEF_CUSTOMS_UDP_PORT;
     } else {
@@ -670,7 +716,7 @@ main (int argc, char **argv)
 	exit(1);
     }
 
-    for (i = 3; i > 0; i--) {
+    for (i = (port > 0) ? 0 : 3; i > 0; i--) {
 	sep = getservbyname("customs", "tcp");
 	if (sep == NULL) {
 	    sleep(2);
@@ -678,7 +724,9 @@ main (int argc, char **argv)
 	    break;
 	}
     }
-    if (sep == NULL) {
+    if (port > 0) {
+	tcpPort = port;
+    } else if (sep == NULL) {
 	printf("customs/tcp (still) unknown\n");
 	tcpPort = DEF_CUSTOMS_TCP_PORT;
     } else {
@@ -689,6 +737,25 @@ main (int argc, char **argv)
 	perror("Rpc_TcpCreate");
 	exit(1);
     }
+
+    /*
+     * Without -ports, our network is the agents on our own port. With it,
+     * agents are told apart by port as well as by address, so the port in
+     * an agent's address must be the one to which jobs are exported, too.
+     */
+    if (lowPort == 0) {
+	firstPort = lastPort = udpPort;
+    } else if ((u_short)udpPort < lowPort || (u_short)udpPort > highPort) {
+	printf("port %d isn't in the -ports range %d-%d\n",
+	       (u_short)udpPort, lowPort, highPort);
+	exit(1);
+    } else if (tcpPort != udpPort) {
+	printf("-ports needs the udp and tcp services on one port (see -port)\n");
+	exit(1);
+    } else {
+	firstPort = lowPort;
+	lastPort = highPort;
+    }
     /*
      * Mark both service sockets as close on exec.
      */
@@ -760,6 +827,9 @@ main (int argc, char **argv)
 
 perror( char *str)
 {
+#ifdef _LINUX
+    printf("%s: %s\n", str, strerror(errno));
+#else
     extern int errno;
     extern char *sys_errlist[];
     extern int sys_nerr;
@@ -769,4 +839,5 @@ perror( char *str)
     } else {
 	printf("%s: %s\n", str, sys_errlist[errno]);
     }
+#endif /* _LINUX */
 }
@@ -90,6 +90,10 @@ typedef enum {
 typedef struct {
     struct in_addr	addr;	    	/* Address of host */
     u_long    	  	id;	  	/* Authentication ID to give it */
+    u_short 	    	port;	    	/* Its agent's TCP port (network
+					 * order), or 0 if it's on the usual
+					 * customs port */
+    u_short 	    	pad;	    	/* Explicit padding */
 } ExportPermit;
 
 
@@ -199,7 +203,7 @@ typedef struct {
 #define CUSTOMS_URETRY	500000
 #define CUSTOMS_NRETRY	2
 
-#define Customs_Align(ptr, type)    (type) (((int)(ptr)+3)&~3)
+#define Customs_Align(ptr, type)    (type) (((long)(ptr)+3)&~3)
 
 #define CUSTOMS_TCP_RETRY   10
 #define CUSTOMS_TCP_URETRY  0
@@ -228,6 +232,15 @@ typedef struct {
 #define DEF_CUSTOMS_UDP_PORT	8231
 #define DEF_CUSTOMS_TCP_PORT	8231
 
+/*
+ * Environment variable that, if set, gives the port to use for both the udp
+ * and tcp services, overriding the services database. Several agents can
+ * run on the one machine, each on its own port, with clients choosing among
+ * them by setting this. Agents started with the same -ports range share a
+ * master however they are spread over the ports and machines.
+ */
+#define CUSTOMS_PORT_VAR	"CUSTOMS_PORT"
+
 /*
  * Rpc front-ends
  */
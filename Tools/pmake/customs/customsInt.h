@@ -23,6 +23,14 @@
 #include    "customs.h"
 #include    <sys/time.h>
 #include    <arpa/inet.h>
+#ifdef _LINUX
+/*
+ * Declare getenv, ctime and friends: their implicit int return loses the
+ * top half of the pointer on 64-bit hosts.
+ */
+#include    <stdlib.h>
+#include    <time.h>
+#endif /* _LINUX */
 
 typedef struct {
     struct in_addr	addr;  	    /* The address of the host */
@@ -52,6 +60,20 @@ typedef struct {
 
 #define Local(sinPtr) Rpc_IsLocal((sinPtr))
 
+/*
+ * Peer is true of an address on one of our network's customs ports, Self
+ * of this agent's own address, and SameAgent of two addresses for the one
+ * agent. Only when the network spans several ports (-ports) do agents on
+ * one machine differ by port alone.
+ */
+#define Peer(sinPtr) ((ntohs((sinPtr)->sin_port) >= firstPort) && \
+		      (ntohs((sinPtr)->sin_port) <= lastPort))
+#define Self(sinPtr) (Local((sinPtr)) && \
+		      ((sinPtr)->sin_port == localAddr.sin_port))
+#define SameAgent(sin1Ptr, sin2Ptr) \
+	(((sin1Ptr)->sin_addr.s_addr == (sin2Ptr)->sin_addr.s_addr) && \
+	 ((sin1Ptr)->sin_port == (sin2Ptr)->sin_port))
+
 /*
  * customs.c:
  */
@@ -70,6 +92,8 @@ extern short	    	    udpPort;	    /* Local customs UDP service port*/
 extern int  	  	    tcpSocket;	    /* Service socket for handing tcp
 					     * rpc calls. */
 extern short	    	    tcpPort;	    /* Local TCP service port */
+extern u_short	    	    firstPort;	    /* First and last UDP ports of */
+extern u_short	    	    lastPort;	    /* the agents on our network */
 extern char 	  	    *regPacket;	    /* Our registration packet */
 extern int  	  	    regPacketLen;   /* The length of it */
 extern int  	  	    numClients;	    /* Number of clients we support */
@@ -84,6 +108,16 @@ Boolean	    	  	    Avail_Send();   /* Send an availability packet to
 					     * the master */
 int	    	  	    Avail_Local();  /* Check local availability */
 extern int  	    	    avail_Bias;	    /* Bias for availability "rating"*/
+/*
+ * os-*.c:
+ */
+int	    	  	    OS_Init();	    /* Return mask of criteria that
+					     * can be checked */
+int	    	  	    OS_Idle();	    /* Keyboard idle time (secs) */
+int	    	  	    OS_Swap();	    /* Percentage of free swap */
+unsigned long	    	    OS_Load();	    /* Load (LOADSCALE units) */
+int	    	  	    OS_NumCpus();   /* Number of processors, or 0 if
+					     * unknown */
 /*
  * import.c:
  */
@@ -105,6 +139,8 @@ void	    	  	    Elect_Init();   	/* Initialization */
 void	    	  	    Elect_GetMaster();	/* Find MCA */
 Boolean	    	  	    Elect_InProgress();	/* See if an election is going
 						 * on. */
+Rpc_Stat    	    	    Elect_Broadcast();	/* Broadcast to the agents
+						 * on our network */
 extern struct sockaddr_in   masterAddr;     /* Address of master's socket */
 extern long		    elect_Token;    /* Token to pass during
 					     * elections */
@@ -113,7 +149,7 @@ extern long		    elect_Token;    /* Token to pass during
  * log.c
  */
 void	    	  	    Log_Init();
-void	    	  	    Log_Send();
+void	    	  	    Log_Send(Rpc_Proc procNum, int pieces, ...);
 
 /*
  * swap.c
@@ -28,6 +28,7 @@ static char *rcsid =
 #include    <arpa/inet.h>
 #include    <assert.h>
 #include    <stdio.h>
+#include    <string.h>
 
 struct sockaddr_in   masterAddr;
 
@@ -73,7 +74,7 @@ enum {
 		     * speaks up. */
 } ElectionState;
 
-InetAddr    	  lastPetition;	/* Address of last sca whose petition we
+SockAddr    	  lastPetition;	/* Address of last sca whose petition we
 				 * accepted. Valid only if WAITING */
 Rpc_Event    	  waitEvent;	/* Event for returning to NONE state after
 				 * WAITING */
@@ -112,7 +113,8 @@ Elect_Init ()
     srandom((int)(getpid() + gethostid() + t.tv_sec + t.tv_usec));
     
     ElectionState = NONE;
-    lastPetition.s_addr = htonl(INADDR_ANY);
+    lastPetition.sin_addr.s_addr = htonl(INADDR_ANY);
+    lastPetition.sin_port = 0;
 
     Rpc_ServerCreate(udpSocket, (Rpc_Proc)CUSTOMS_CAMPAIGN, ElectCampaign,
 		     Rpc_SwapLong, Rpc_SwapLong, (Rpc_Opaque)0);
@@ -121,6 +123,86 @@ Elect_Init ()
     Rpc_ServerCreate(udpSocket, (Rpc_Proc)CUSTOMS_ELECT, ElectForce,
 		     Rpc_SwapNull, Rpc_SwapNull, (Rpc_Opaque)0);
 }
+
+/*-
+ *-----------------------------------------------------------------------
+ * Elect_Broadcast --
+ *	Broadcast a call to the agents on our network. Normally that's
+ *	an Rpc_Broadcast to our port on all attached networks, but if
+ *	the network spans several ports (-ports), the call goes to each
+ *	of those ports on each attached network, or on this machine
+ *	alone if it can't broadcast anywhere.
+ *
+ * Results:
+ *	As for Rpc_Broadcast.
+ *
+ * Side Effects:
+ *	The call is broadcast and handleProc called for each response.
+ *
+ *-----------------------------------------------------------------------
+ */
+Rpc_Stat
+Elect_Broadcast(procNum, inLength, inData, outLength, outData, numRetries,
+		retry, handleProc, handleData)
+    Rpc_Proc 	  	procNum;    	    /* Procedure to call */
+    int	    	  	inLength;   	    /* Length of data for call */
+    Rpc_Opaque 	  	inData;	    	    /* Data for call */
+    int	    	  	outLength;  	    /* Expected length of results */
+    Rpc_Opaque 	  	outData;    	    /* Place to store results */
+    int	    	  	numRetries; 	    /* Number of times to try */
+    struct timeval	*retry;	    	    /* Interval at which to retry */
+    Boolean    	  	(*handleProc)();    /* Function to handle responses */
+    Rpc_Opaque	    	handleData; 	    /* Extra data for handleProc */
+{
+    SockAddr	  	nets[MAXNETS];	    /* Networks we're on */
+    int	    	  	numNets;
+    SockAddr	  	peers[MAXNETS];	    /* Places to send the call */
+    int	    	  	numPeers;
+    int	    	  	numPorts;
+    int	    	  	i;
+
+    if (firstPort == lastPort) {
+	SockAddr    broadcast;
+
+	broadcast.sin_family = AF_INET;
+	broadcast.sin_port = htons(udpPort);
+	broadcast.sin_addr.s_addr = htonl(INADDR_ANY);
+	return Rpc_Broadcast(udpSocket, &broadcast, procNum,
+			     inLength, inData, outLength, outData,
+			     numRetries, retry, handleProc, handleData);
+    }
+
+    Rpc_GetNetworks(udpSocket, MAXNETS, nets, &numNets);
+    if (numNets == 0) {
+	nets[0].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	numNets = 1;
+    }
+    /*
+     * customs.c keeps the range below MAXNETS ports, so at least the first
+     * network always fits.
+     */
+    numPorts = lastPort - firstPort + 1;
+    if (numNets * numPorts >= MAXNETS) {
+	if (verbose) {
+	    printf("Only broadcasting on %d of %d networks\n",
+		   (MAXNETS - 1) / numPorts, numNets);
+	}
+	numNets = (MAXNETS - 1) / numPorts;
+    }
+    for (numPeers = i = 0; i < numNets; i++) {
+	int 	port;
+
+	for (port = firstPort; port <= lastPort; port++) {
+	    peers[numPeers].sin_family = AF_INET;
+	    peers[numPeers].sin_port = htons(port);
+	    peers[numPeers].sin_addr = nets[i].sin_addr;
+	    numPeers++;
+	}
+    }
+    return Rpc_BroadcastToNets(udpSocket, peers, numPeers, procNum,
+			       inLength, inData, outLength, outData,
+			       numRetries, retry, handleProc, handleData);
+}
 
 /*-
  *-----------------------------------------------------------------------
@@ -226,7 +308,7 @@ ElectCampaignResponse(from, len, response)
     int	    	  	len;	    /* Length of response */
     Boolean 	  	*response;  /* Response value */
 {
-    if (ntohs(from->sin_port) != udpPort) {
+    if (!Peer(from)) {
 	/*
 	 * If response from a non-agent, ignore it
 	 */
@@ -236,7 +318,7 @@ ElectCampaignResponse(from, len, response)
 	    campaignResponse = HAVE_CONFLICT;
 	}
     } else if (campaignResponse == HAVE_MASTER) {
-	if (from->sin_addr.s_addr != masterAddr.sin_addr.s_addr) {
+	if (!SameAgent(from, &masterAddr)) {
 	    /*
 	     * If more than one agent is claiming to be the master, inform
 	     * the first one we met of the other one's address. It'll take
@@ -244,8 +326,8 @@ ElectCampaignResponse(from, len, response)
 	     * broadcasting isn't multi-threaded enough -- will get responses
 	     * back and lose them while this call is in progress.
 	     */
-	    printf("Warning: duplicate master at %s\n",
-		   InetNtoA(from->sin_addr));
+	    printf("Warning: duplicate master at %d@%s\n",
+		   ntohs(from->sin_port), InetNtoA(from->sin_addr));
 	    (void) Rpc_Call(udpSocket, &masterAddr, (Rpc_Proc)CUSTOMS_CONFLICT,
 			    sizeof(struct sockaddr_in), (Rpc_Opaque)from,
 			    0, (Rpc_Opaque)0,
@@ -287,7 +369,7 @@ ElectMasterResponse(from, len, response)
     int	    	  	len;	    /* Length of response */
     struct sockaddr_in 	*response;  /* Response value */
 {
-    if (ntohs(from->sin_port) != udpPort) {
+    if (!Peer(from)) {
 	/*
 	 * If response from a non-agent, ignore it
 	 */
@@ -344,13 +426,9 @@ Elect_GetMaster ()
 {
     Boolean  	  	conflict;   	    /* Space for Campaign response */
     Rpc_Stat	  	rstat;	    	    /* Status of broadcast */
-    SockAddr	  	broadcast;  	    /* Address to which to broadcast */
 
     timerclear(&backOff);
-    broadcast.sin_family = AF_INET;
-    broadcast.sin_port = htons(udpPort);
-    broadcast.sin_addr.s_addr = htonl(INADDR_ANY);
-    
+
     /*
      * If we're not allowed to become the master, wait until someone comes
      * along to be it. Master agents will occasionally trumpet their mastery
@@ -367,12 +445,11 @@ Elect_GetMaster ()
 	/*
 	 * First see if anyone else knows the name of a good master.
 	 */
-	rstat = Rpc_Broadcast(udpSocket, &broadcast,
-			      (Rpc_Proc)CUSTOMS_MASTER,
-			      sizeof(elect_Token), (Rpc_Opaque)&elect_Token,
-			      sizeof(masterAddr), (Rpc_Opaque)&masterAddr,
-			      3, &retryTimeOut,
-			      ElectMasterResponse);
+	rstat = Elect_Broadcast((Rpc_Proc)CUSTOMS_MASTER,
+				sizeof(elect_Token), (Rpc_Opaque)&elect_Token,
+				sizeof(masterAddr), (Rpc_Opaque)&masterAddr,
+				3, &retryTimeOut,
+				ElectMasterResponse, (Rpc_Opaque)0);
 
 	if (verbose && rstat != RPC_SUCCESS) {
 	    printf("no such luck. Waiting for master to appear.\n");
@@ -396,12 +473,11 @@ Elect_GetMaster ()
 	}
 	ElectionState = PETITIONING;
 	campaignResponse = HAVE_NONE;
-	rstat = Rpc_Broadcast(udpSocket, &broadcast,
-			      (Rpc_Proc)CUSTOMS_CAMPAIGN,
-			      sizeof(elect_Token), (Rpc_Opaque)&elect_Token,
-			      sizeof(conflict), (Rpc_Opaque)&conflict,
-			      3, &retryTimeOut,
-			      ElectCampaignResponse);
+	rstat = Elect_Broadcast((Rpc_Proc)CUSTOMS_CAMPAIGN,
+				sizeof(elect_Token), (Rpc_Opaque)&elect_Token,
+				sizeof(conflict), (Rpc_Opaque)&conflict,
+				3, &retryTimeOut,
+				ElectCampaignResponse, (Rpc_Opaque)0);
 	switch(rstat) {
 	    case RPC_SUCCESS:
 		/*
@@ -466,10 +542,14 @@ Elect_GetMaster ()
 
 		return;
 	    default: {
+#ifdef _LINUX
+		printf("Elect_Broadcast: %s\n", strerror(errno));
+#else
 		extern int errno;
 		extern char *sys_errlist[];
 
-		printf("Rpc_Broadcast: %s\n", sys_errlist[errno]);
+		printf("Elect_Broadcast: %s\n", sys_errlist[errno]);
+#endif /* _LINUX */
 		printf("CUSTOMS_CAMPAIGN: %s\n", Rpc_ErrorMessage(rstat));
 		break;
 	    }
@@ -546,7 +626,7 @@ ElectCampaign(from, msg, len, data)
     struct sockaddr_in	*from;
     Rpc_Message	  	msg;
     int	    	  	len;
-    int	    	  	*data;
+    long    	  	*data;
 {
     Boolean 	  	response;
     
@@ -554,14 +634,14 @@ ElectCampaign(from, msg, len, data)
 	printf("Received CAMPAIGN from %d@%s: ", ntohs(from->sin_port),
 	       InetNtoA(from->sin_addr));
     }
-    if (ntohs(from->sin_port) != udpPort) {
+    if (!Peer(from)) {
 	return;
     }
-    if (Local(from)) {
+    if (Self(from)) {
 	if (verbose) {
 	    printf("talking to myself, again...\n");
 	}
-    } else if ((len == sizeof(int)) && (*data == elect_Token)) {
+    } else if ((len == sizeof(elect_Token)) && (*data == elect_Token)) {
 	/*
 	 * If machine has same byte-order as we do, then we can play
 	 * master/slave with it...
@@ -579,7 +659,7 @@ ElectCampaign(from, msg, len, data)
 	    response = TRUE;
 	    Rpc_Return(msg, sizeof(response), (Rpc_Opaque)&response);
 	} else if ((ElectionState == WAITING) &&
-		   (lastPetition.s_addr != from->sin_addr.s_addr))
+		   !SameAgent(&lastPetition, from))
 	{
 	    /*
 	     * If someone else was campaigning, we refuse to let
@@ -587,8 +667,9 @@ ElectCampaign(from, msg, len, data)
 	     * campaigning one missed the broadcast somehow.
 	     */
 	    if (verbose) {
-		printf ("return (TRUE) -- conflict with %s\n",
-			InetNtoA(lastPetition));
+		printf ("return (TRUE) -- conflict with %d@%s\n",
+			ntohs(lastPetition.sin_port),
+			InetNtoA(lastPetition.sin_addr));
 	    }
 	    response = TRUE;
 	    Rpc_Return(msg, sizeof(response),
@@ -617,7 +698,7 @@ ElectCampaign(from, msg, len, data)
 		 */
 		ElectionState = WAITING;
 	    }
-	    lastPetition = from->sin_addr;
+	    lastPetition = *from;
 	    
 	    waitTimeout.tv_sec = 10;
 	    waitTimeout.tv_usec = 0;
@@ -650,7 +731,7 @@ ElectNewMaster(from, msg, len, data)
     struct sockaddr_in	*from;
     Rpc_Message	  	msg;
     int	    	  	len;
-    int	    	  	*data;
+    long    	  	*data;
 {
     Rpc_Stat	  	rstat;
 
@@ -658,7 +739,7 @@ ElectNewMaster(from, msg, len, data)
 	printf ("Received NEWMASTER from %d@%s: ", ntohs(from->sin_port),
 		InetNtoA(from->sin_addr));
     }
-    if (ntohs(from->sin_port) != udpPort) {
+    if (!Peer(from)) {
 	time_t	now;
 
 	time(&now);
@@ -673,13 +754,13 @@ ElectNewMaster(from, msg, len, data)
     if ((ElectionState == NONE) || (ElectionState == WAITING) ||
 	(ElectionState == YEARNING))
     {
-	if (Local(from)) {
+	if (Self(from)) {
 	    assert(ElectionState != YEARNING);
 	    Rpc_Return(msg, 0, (Rpc_Opaque)0);
 	    if (verbose) {
 		printf ("talking to myself, again...\n");
 	    }
-	} else if ((len == sizeof(int)) && (*data == elect_Token)) {
+	} else if ((len == sizeof(elect_Token)) && (*data == elect_Token)) {
 	    Rpc_Return(msg, 0, (Rpc_Opaque)0);
 	    if (amMaster) {
 		if (verbose) {
@@ -379,9 +379,20 @@ main (argc, argv)
 	}
     }
 
-    sep = getservbyname("customs", "udp");
+    if (permit.id != 0 && permit.port != 0) {
+	/*
+	 * The agent we exported to shares its port with no other service.
+	 */
+	server.sin_port = permit.port;
+    } else if (getenv(CUSTOMS_PORT_VAR) != NULL &&
+	       atoi(getenv(CUSTOMS_PORT_VAR)) > 0)
+    {
+	server.sin_port = htons(atoi(getenv(CUSTOMS_PORT_VAR)));
+    } else {
+	sep = getservbyname("customs", "udp");
 
-    server.sin_port = sep ? sep->s_port : htons(DEF_CUSTOMS_UDP_PORT);
+	server.sin_port = sep ? sep->s_port : htons(DEF_CUSTOMS_UDP_PORT);
+    }
 
     signal (SIGHUP, PassSig);
     signal (SIGINT, PassSig);
@@ -29,7 +29,39 @@ static char *csid =
 #include    <sys/resource.h>
 #include    <sys/file.h>
 #include    <stdio.h>
-#include    <varargs.h>
+
+#ifdef _LINUX
+/*
+ * Linux has only the bare status word, not union wait, so give ourselves
+ * the (little-endian) BSD layout of it, and status tests that take one.
+ */
+union wait {
+    int	    	w_status;   	/* The whole word */
+    struct {
+	unsigned    w_Termsig:7,    /* Signal that killed the child */
+		    w_Coredump:1,   /* Set if it dumped core */
+		    w_Retcode:8,    /* Exit code, if it exited */
+		    :16;
+    }	    	w_T;
+    struct {
+	unsigned    w_Stopval:8,    /* 0x7f if stopped */
+		    w_Stopsig:8,    /* Signal that stopped the child */
+		    :16;
+    }	    	w_S;
+};
+#define w_termsig   w_T.w_Termsig
+#define w_retcode   w_T.w_Retcode
+#define w_stopsig   w_S.w_Stopsig
+
+#undef WIFSTOPPED
+#undef WIFSIGNALED
+#define WIFSTOPPED(x)	((x).w_S.w_Stopval == 0x7f)
+#define WIFSIGNALED(x)	(!WIFSTOPPED(x) && (x).w_termsig != 0)
+
+#define wait3(statusPtr, options, rusagePtr) \
+	wait3(&(statusPtr)->w_status, (options), (rusagePtr))
+#define setpgrp(pid, pgrp)  setpgid((pid), (pgrp))
+#endif /* _LINUX */
 
 /*
  * Permits published by the MCA are kept in ImportPermit structures on the
@@ -231,8 +263,8 @@ ImportExpire(ln)
  *-----------------------------------------------------------------------
  * ImportAllocated --
  *	Notice that we've been allocated. This call is only allowed to
- *	come from the udp customs port on the master machine (or 127.1
- * 	[localhost] if we are the master).
+ *	come from the master agent's udp port (or 127.1 [localhost] if
+ * 	we are the master).
  *
  * Results:
  *	None.
@@ -255,9 +287,7 @@ ImportAllocated(from, msg, len, permit)
 
     if (len != sizeof(ExportPermit)) {
 	Rpc_Error (msg, RPC_BADARGS);
-    } else if ((from->sin_port == htons(udpPort)) &&
-	       ((from->sin_addr.s_addr == masterAddr.sin_addr.s_addr) ||
-		(amMaster && Local(from))))
+    } else if (SameAgent(from, &masterAddr) || (amMaster && Self(from)))
     {
 	if (verbose) {
 	    printf ("Incoming process from %s (id %u)\n",
@@ -21,7 +21,7 @@ static char *rcsid =
 
 #include    "customsInt.h"
 #include    "log.h"
-#include    <varargs.h>
+#include    <stdarg.h>
 
 static Boolean	    	    logServer;
 static struct sockaddr_in   logServerAddr;
@@ -43,13 +43,11 @@ static int  	  	    numFails;
  *
  *-----------------------------------------------------------------------
  */
-/*VARARGS2*/
 void
-Log_Send (procNum, pieces, va_alist)
-    Rpc_Proc   	  	    procNum;  	/* Procedure to call for log server */
-    int	    	  	    pieces; 	/* Number of pieces of data to
+Log_Send (Rpc_Proc  	    procNum,  	/* Procedure to call for log server */
+	  int	    	    pieces, 	/* Number of pieces of data to
 					 * encode */
-    va_dcl
+	  ...)
 {
     XDR	    	  	    stream;   	/* Memory stream for encoding */
     va_list 	  	    args;    	/* Var for accessing arguments */
@@ -64,12 +62,13 @@ Log_Send (procNum, pieces, va_alist)
 	/*
 	 * Encode each piece of data using the xdr function given for it.
 	 */
-	va_start(args);
+	va_start(args, pieces);
 	while (pieces--) {
 	    encode = va_arg(args, xdrproc_t);
 	    data = va_arg(args, caddr_t);
 	    if (!(*encode) (&stream, data)) {
 		logServer = FALSE;
+		va_end (args);
 		return;
 	    }
 	}
@@ -27,7 +27,7 @@
 #include    <rpc/types.h>
 #include    <rpc/xdr.h>
 
-enum {
+typedef enum {
     LOG_START,	  	/* Job started */
     LOG_FINISH,	  	/* Job finished */
     LOG_STOPPED,  	/* Job stopped */
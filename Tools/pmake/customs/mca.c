@@ -34,6 +34,8 @@ typedef struct {
     long    	    	rating;	    	/* Availability index (high => more
 					 * available */
     struct in_addr	addr;	    	/* Address of the server. */
+    u_short 	    	port;	    	/* Its UDP port (network order), or 0
+					 * until we hear from it */
     unsigned long 	arch;	    	/* Architecture code */
     Rpc_Event  	  	downEvent;  	/* If this event ever gets taken,
 					 * the host is down... */
@@ -49,6 +51,7 @@ static Rpc_Event    boastEvent;	    /* Event that causes us to boast of our
  *-----------------------------------------------------------------------
  * MCACmpAddr --
  *	Compare the address of a Server record to the desired address.
+ *	A record whose port isn't known yet matches any port.
  *
  * Results:
  *	0 or non-0 depending on match or non-match, resp.
@@ -60,16 +63,24 @@ static Rpc_Event    boastEvent;	    /* Event that causes us to boast of our
 static int
 MCACmpAddr (servPtr, addrPtr)
     ServerPtr	  	servPtr;
-    struct in_addr	*addrPtr;
+    struct sockaddr_in	*addrPtr;
 {
-    return (servPtr->addr.s_addr - addrPtr->s_addr);
+    if (servPtr->addr.s_addr != addrPtr->sin_addr.s_addr) {
+	return (1);
+    } else if (servPtr->port == 0 || addrPtr->sin_port == 0) {
+	return (0);
+    } else {
+	return (servPtr->port != addrPtr->sin_port);
+    }
 }
 
 /*-
  *-----------------------------------------------------------------------
  * MCAFindHostAddr --
- *	Find a host in the list of allHosts using its address as a key.
- *	Create it if it isn't there and create is TRUE.
+ *	Find a host in the list of allHosts using its address (and port,
+ *	if given) as a key. Create it if it isn't there and create is TRUE.
+ *	A record made for a client name takes the port of the first agent
+ *	at its address that we hear from.
  *
  * Results:
  *	The ServerPtr for the host.
@@ -91,15 +102,22 @@ MCAFindHostAddr (addr, name, create)
     ServerPtr	  	servPtr;
     struct hostent 	*he;
 
-    if (addr->sin_addr.s_addr == htonl(INADDR_LOOPBACK)) {
+    if ((addr->sin_addr.s_addr == htonl(INADDR_LOOPBACK)) &&
+	(us != (ServerPtr)NULL) &&
+	((addr->sin_port == 0) || (addr->sin_port == us->port)))
+    {
 	/*
-	 * 'localhost' address (127.1) means us.
+	 * 'localhost' address (127.1) means us, unless it's another agent
+	 * on this machine.
 	 */
 	servPtr = us;
     } else {
-	ln = Lst_Find (allHosts, &addr->sin_addr, MCACmpAddr);
+	ln = Lst_Find (allHosts, (ClientData)addr, MCACmpAddr);
 	if (ln != NILLNODE) {
 	    servPtr = (ServerPtr) Lst_Datum (ln);
+	    if (servPtr->port == 0) {
+		servPtr->port = addr->sin_port;
+	    }
 	} else if (create) {
 	    servPtr = (ServerPtr) malloc (sizeof (Server));
 	    servPtr->avail = AVAIL_DOWN;
@@ -117,6 +135,7 @@ MCAFindHostAddr (addr, name, create)
 	    strcpy (servPtr->name, name);
 	    servPtr->clients = NILLST;
 	    servPtr->addr = addr->sin_addr;
+	    servPtr->port = addr->sin_port;
 	    servPtr->downEvent = (Rpc_Event)0;
 	    servPtr->arch = 0;	/* Unknown architecture */
 	    (void)Lst_AtEnd (allHosts, (ClientData)servPtr);
@@ -355,8 +374,7 @@ MCA_HostInt (from, msg, len, data)
     
     clntPtr = MCAFindHostAddr (from, (char *)0, FALSE);
 
-    if ((clntPtr == (ServerPtr) NULL) ||
-	(ntohs(from->sin_port) != udpPort))
+    if ((clntPtr == (ServerPtr) NULL) || !Peer(from))
     {
 	/*
 	 * XXX: This should probably be done through syslog as well to bring
@@ -424,6 +442,12 @@ MCA_HostInt (from, msg, len, data)
 		}
 		permit.addr = servPtr->addr;
 		permit.id = (nextID++ & 0xffff) | (uid << 16);
+		/*
+		 * If our network spans several ports, the client must be
+		 * told which agent at that address to export to.
+		 */
+		permit.port = (firstPort == lastPort) ? 0 : servPtr->port;
+		permit.pad = 0;
 
 		/*
 		 * Before we reply to the requesting server, we must tell the
@@ -431,8 +455,10 @@ MCA_HostInt (from, msg, len, data)
 		 */
 		allocPermit.addr = clntPtr->addr;
 		allocPermit.id = permit.id;
+		allocPermit.port = 0;
+		allocPermit.pad = 0;
 		victim.sin_family = AF_INET;
-		victim.sin_port = htons(udpPort);
+		victim.sin_port = servPtr->port ? servPtr->port : htons(udpPort);
 		victim.sin_addr = servPtr->addr;
 		
 		stat = Rpc_Call(udpSocket, &victim, (Rpc_Proc)CUSTOMS_ALLOC,
@@ -503,7 +529,7 @@ MCARegister (from, msg, len, data)
      *
      * XXX: Should also allow limiting to a group of addresses or networks.
      */
-    if (ntohs(from->sin_port) != udpPort) {
+    if (!Peer(from)) {
 	time_t	now;
 
 	time(&now);
@@ -735,7 +761,7 @@ MCANewMasterResponse(from, len, data)
     int	    	  	len;
     Rpc_Opaque 	  	data;
 {
-    if (ntohs(from->sin_port) != udpPort) {
+    if (!Peer(from)) {
 	/*
 	 * Ignore response if not from offical port
 	 */
@@ -768,21 +794,15 @@ MCABoast(data, ev)
     Rpc_Event	    ev;	    	/* Event that called us */
 {
     struct timeval  again;  	/* Time at which to broadcast again */
-    struct sockaddr_in broadcast;  /* Address to which to broadcast */
 
-    broadcast.sin_family = AF_INET;
-    broadcast.sin_port = htons(udpPort);
-    broadcast.sin_addr.s_addr = htonl(INADDR_ANY);
-    
     /*
      * Let the world know we consider ourselves the master.
      */
-    (void)Rpc_Broadcast(udpSocket, &broadcast,
-			(Rpc_Proc)CUSTOMS_NEWMASTER,
-			sizeof(elect_Token), (Rpc_Opaque)&elect_Token,
-			0, (Rpc_Opaque)0,
-			CUSTOMSINT_NRETRY, &retryTimeOut,
-			MCANewMasterResponse, (Rpc_Opaque)0);
+    (void)Elect_Broadcast((Rpc_Proc)CUSTOMS_NEWMASTER,
+			  sizeof(elect_Token), (Rpc_Opaque)&elect_Token,
+			  0, (Rpc_Opaque)0,
+			  CUSTOMSINT_NRETRY, &retryTimeOut,
+			  MCANewMasterResponse, (Rpc_Opaque)0);
 
     if (boastEvent != NULL) {
 	/*
@@ -822,8 +842,10 @@ MCA_Init ()
     
     allHosts = Lst_Init (TRUE);
 
+    us = (ServerPtr)NULL;
     us = MCAFindHost (localhost, TRUE);
     us->addr = localAddr.sin_addr;
+    us->port = localAddr.sin_port;
     us->arch = arch;
 
     if (numClients != 1 || strcmp (clients[0], "ALL") != 0) {
@@ -0,0 +1,281 @@
+/***********************************************************************
+ *
+ * PROJECT:	  PMake
+ * MODULE:	  Customs -- Linux dependencies
+ * FILE:	  os-linux.c
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * ROUTINES:
+ *	Name	  	    Description
+ *	----	  	    -----------
+ *	OS_Init	    	    Initialize module and return mask of criteria
+ *	    	    	    to be considered in determination.
+ *	OS_Idle	    	    Return machine idle time, in seconds
+ *	OS_Load	    	    Return machine load factor
+ *	OS_Swap	    	    Return free memory
+ *	OS_NumCpus  	    Return the number of processors
+ *
+ * REVISION HISTORY:
+ *	Date	  Name	    Description
+ *	----	  ----	    -----------
+ *	10/16/26  agent	    Initial version
+ *
+ * DESCRIPTION:
+ *	OS-dependent functions for Linux, which are all answered from
+ *	/proc rather than by reading kernel memory.
+ *
+ *	A Linux host is assumed to be a machine in a build farm, not
+ *	somebody's workstation, so there's no keyboard idle time to
+ *	check. The load average is divided by the number of processors,
+ *	so the same -load limit means the same thing on a 4-way machine as
+ *	on a 32-way one, and the "swap" percentage is that of all memory,
+ *	physical and swap, still available to new processes, as it's
+ *	physical memory a compiler runs out of first.
+ *
+ *	The format used is the same as that transmitted for the AVAIL_SET
+ *	RPC.
+ *
+ ***********************************************************************/
+#ifndef lint
+static char *rcsid =
+"$Id$";
+#endif lint
+
+#include    "customsInt.h"
+
+#include    <stdio.h>
+#include    <string.h>
+#include    <unistd.h>
+
+static int  	    numCpus;	/* Number of processors on line */
+
+
+/***********************************************************************
+ *				OS_Init
+ ***********************************************************************
+ * SYNOPSIS:	    Initialize this module
+ * CALLED BY:	    Avail_Init
+ * RETURN:	    Mask of bits indicating what things we can check
+ * SIDE EFFECTS:    numCpus is set.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+int
+OS_Init()
+{
+    int	    retMask = AVAIL_EVERYTHING & ~AVAIL_IDLE;
+    FILE    *f;
+
+    numCpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numCpus < 1) {
+	numCpus = 1;
+    }
+
+    f = fopen("/proc/loadavg", "r");
+    if (f == NULL) {
+	retMask &= ~AVAIL_LOAD;
+    } else {
+	fclose(f);
+    }
+    f = fopen("/proc/meminfo", "r");
+    if (f == NULL) {
+	retMask &= ~AVAIL_SWAP;
+    } else {
+	fclose(f);
+    }
+
+    return(retMask);
+}
+
+/***********************************************************************
+ *				OS_Idle
+ ***********************************************************************
+ * SYNOPSIS:	    Find the idle time of the machine
+ * CALLED BY:	    Avail_Local
+ * RETURN:	    The number of seconds for which the machine has been
+ *	    	    idle.
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:	    Never called, as OS_Init says we can't check this,
+ *	    	    but claim the machine's been idle as long as anyone
+ *	    	    could want.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+int
+OS_Idle()
+{
+    return(MAX_IDLE);
+}
+
+
+/***********************************************************************
+ *				OS_Swap
+ ***********************************************************************
+ * SYNOPSIS:	    Find the percentage of the system's memory that's
+ *	    	    available to new processes.
+ * CALLED BY:	    Avail_Local
+ * RETURN:	    The percentage of available memory
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *	Take MemAvailable (the kernel's own estimate of what can be
+ *	allocated without swapping, which counts reclaimable cache) plus
+ *	the free swap, over all memory and swap. Kernels too old to give
+ *	MemAvailable get free memory plus the buffers and page cache.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+int
+OS_Swap()
+{
+    FILE    	    *f;
+    char    	    line[128];
+    unsigned long   total = 0, avail = 0, freeMem = 0, cached = 0;
+    unsigned long   swapTotal = 0, swapFree = 0;
+    Boolean 	    haveAvail = FALSE;
+    unsigned long   n;
+
+    f = fopen("/proc/meminfo", "r");
+    if (f == NULL) {
+	/*
+	 * Couldn't find out -- assume worst case.
+	 */
+	return(0);
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+	if (sscanf(line, "MemTotal: %lu", &n) == 1) {
+	    total = n;
+	} else if (sscanf(line, "MemAvailable: %lu", &n) == 1) {
+	    avail = n;
+	    haveAvail = TRUE;
+	} else if (sscanf(line, "MemFree: %lu", &n) == 1) {
+	    freeMem = n;
+	} else if (sscanf(line, "Buffers: %lu", &n) == 1) {
+	    cached += n;
+	} else if (sscanf(line, "Cached: %lu", &n) == 1) {
+	    cached += n;
+	} else if (sscanf(line, "SwapTotal: %lu", &n) == 1) {
+	    swapTotal = n;
+	} else if (sscanf(line, "SwapFree: %lu", &n) == 1) {
+	    swapFree = n;
+	}
+    }
+    fclose(f);
+
+    if (!haveAvail) {
+	avail = freeMem + cached;
+    }
+    if (total + swapTotal == 0) {
+	return(0);
+    }
+    /*
+     * The figures are in kilobytes; scale down first if multiplying by
+     * 100 could overflow a 32-bit long.
+     */
+    total += swapTotal;
+    avail += swapFree;
+    if (total > 0x7fffffffUL / 100) {
+	return((int)(avail / (total / 100)));
+    } else {
+	return((int)((avail * 100) / total));
+    }
+}
+
+
+/***********************************************************************
+ *				OS_Load
+ ***********************************************************************
+ * SYNOPSIS:	    Return the current load average per processor in
+ *	    	    standard form
+ * CALLED BY:	    Avail_Local
+ * RETURN:	    The current load as a 32-bit fixed-point number
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+unsigned long
+OS_Load()
+{
+    FILE    *f;
+    double  avenrun[3];
+
+    f = fopen("/proc/loadavg", "r");
+    if (f == NULL) {
+	return(0);
+    }
+    if (fscanf(f, "%lf %lf %lf", &avenrun[0], &avenrun[1], &avenrun[2]) != 3)
+    {
+	fclose(f);
+	return(0);
+    }
+    fclose(f);
+
+#define CVT(v)	(unsigned long)(((v)/numCpus)*LOADSCALE)
+
+#ifdef ALL_LOAD
+    /*
+     * Find largest of the three averages and return that
+     */
+    if (avenrun[0] > avenrun[1]) {
+	if (avenrun[0] > avenrun[2]) {
+	    return(CVT(avenrun[0]));
+	} else {
+	    return(CVT(avenrun[2]));
+	}
+    } else if (avenrun[1] > avenrun[2]) {
+	return(CVT(avenrun[1]));
+    } else {
+	return(CVT(avenrun[2]));
+    }
+#else
+    /*
+     * Just return the 1-minute average.
+     */
+    return(CVT(avenrun[0]));
+#endif
+}
+
+
+/***********************************************************************
+ *				OS_NumCpus
+ ***********************************************************************
+ * SYNOPSIS:	    Return the number of processors on line
+ * CALLED BY:	    Avail_Init
+ * RETURN:	    The number of processors
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+int
+OS_NumCpus()
+{
+    return(numCpus);
+}
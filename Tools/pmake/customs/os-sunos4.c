@@ -14,6 +14,7 @@
  *	OS_Idle	    	    Return machine idle time, in seconds
  *	OS_Load	    	    Return machine load factor
  *	OS_Swap	    	    Return free swap space
+ *	OS_NumCpus  	    Return the number of processors
  *
  * REVISION HISTORY:
  *	Date	  Name	    Description
@@ -292,3 +293,26 @@ OS_Load()
 
     return(result);
 }
+
+
+/***********************************************************************
+ *				OS_NumCpus
+ ***********************************************************************
+ * SYNOPSIS:	    Return the number of processors on line
+ * CALLED BY:	    Avail_Init
+ * RETURN:	    0, as we've no way of knowing
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+int
+OS_NumCpus()
+{
+    return(0);
+}
@@ -62,6 +62,10 @@ static char *rcsid =
  * is to continue waiting and resending at whatever interval it chooses.
  */
 
+#ifdef _LINUX
+#define _GNU_SOURCE 	    	/* glibc only calls it fds_bits then */
+#endif /* _LINUX */
+
 #define FD_SETSIZE  256		/* Make sure this is big enough for both */
 				/* Sun and ISI... */
 
@@ -79,6 +83,20 @@ static char *rcsid =
 #include    <setjmp.h>
 #include    <sys/signal.h>
 #include    <assert.h>
+#ifdef _LINUX
+#include    <sys/param.h>
+#include    <string.h>
+
+/*
+ * A msghdr carries control data rather than access rights, and fd_mask is
+ * a long, which is wider than the int ffs takes.
+ */
+#define msg_accrights	    msg_control
+#define msg_accrightslen    msg_controllen
+#define RpcFirstBit(mask)   ffsl(mask)
+#else
+#define RpcFirstBit(mask)   ffs(mask)
+#endif /* _LINUX */
 
 extern int errno;		/* Not all systems define this */
 
@@ -89,11 +107,6 @@ extern int errno;		/* Not all systems define this */
 #define MAX_DATA_SIZE	2048
 #endif  /* MAX_DATA_SIZE */
 
-#ifndef MAXNETS
-#define MAXNETS	    	10  	/* Maximum number of networks a machine may
-				 * be on (Max # Rpc_Broadcast will broadcast
-				 * to, anyway) */
-#endif /* MAXNETS */
 /*
  * Macro for adding two time values together into a third.
  */
@@ -446,9 +459,11 @@ RpcCacheDestroy(s)
 {
     register int  	i;
     register CacheEntry	*e;
+    CacheEntry	  	*next;
     
     for (i = 0; i < CACHE_THREADS; i++) {
-	for (e = s->cache[i]; e != (CacheEntry *)0; e = e->next) {
+	for (e = s->cache[i]; e != (CacheEntry *)0; e = next) {
+	    next = e->next;
 	    if (e->replyData != (Rpc_Opaque)0) {
 		free((char *)e->replyData);
 	    }
@@ -1487,19 +1502,20 @@ Rpc_Wait()
 		fflush(stdout);
 	    }
 	    
-	    for (base = 0,
-		 rmask = readMask.fds_bits[0],
-		 wmask = writeMask.fds_bits[0],
-		 emask = exceptMask.fds_bits[0];
+	    for (base = 0;
 
 		 base < sizeof(rpc_readMask.fds_bits)/sizeof(fd_mask) &&
 		 rpcWaitSeq == ourSeq;
 
-		 base++,
-		 rmask = readMask.fds_bits[base],
-		 wmask = writeMask.fds_bits[base],
-		 emask = exceptMask.fds_bits[base])
+		 base++)
 	    {
+		/*
+		 * Fetch the masks in here, not in the increment, so we never
+		 * read the word past the end of the sets.
+		 */
+		rmask = readMask.fds_bits[base];
+		wmask = writeMask.fds_bits[base];
+		emask = exceptMask.fds_bits[base];
 		if (rpcDebug) {
 		    printf("\tread(%x), write(%x), except(%x)\n",
 			   rmask, wmask, emask);
@@ -1511,8 +1527,8 @@ Rpc_Wait()
 	continue; \
     }
 		while(rmask && rpcWaitSeq == ourSeq) {
-		    stream = ffs(rmask) - 1;
-		    tmask = 1 << stream;
+		    stream = RpcFirstBit(rmask) - 1;
+		    tmask = (fd_mask)1 << stream;
 		    
 		    stream += base * (sizeof(fd_mask) * NBBY);
 
@@ -1552,8 +1568,8 @@ CHKSTR(stream, rpc_exceptMask, "excepting");
 						what);
 		}
 		while (wmask != 0 && rpcWaitSeq == ourSeq) {
-		    stream = ffs(wmask) - 1;
-		    tmask = 1 << stream;
+		    stream = RpcFirstBit(wmask) - 1;
+		    tmask = (fd_mask)1 << stream;
 		    stream += base * (sizeof(fd_mask)*NBBY);
 		    wmask &= ~tmask;
 		    what = RPC_WRITABLE;
@@ -1580,8 +1596,8 @@ CHKSTR(stream, rpc_exceptMask, "excepting");
 						what);
 		}
 		while (emask != 0 && rpcWaitSeq == ourSeq) {
-		    stream = ffs(emask) - 1;
-		    tmask = 1 << stream;
+		    stream = RpcFirstBit(emask) - 1;
+		    tmask = (fd_mask)1 << stream;
 		    stream += base * (sizeof(fd_mask)*NBBY);
 		    emask &= ~tmask;
 CHKSTR(stream, rpc_exceptMask, "excepting");
@@ -77,6 +77,13 @@ typedef	struct fd_set {
 #define RPC_WRITABLE	2
 #define RPC_EXCEPTABLE	4
 
+/*
+ * Most addresses to which Rpc_BroadcastToNets will send a call at once.
+ * Rpc_Broadcast uses one per network the machine is on; the customs agents
+ * use one per network and port when their network spans several ports.
+ */
+#define MAXNETS	    	64
+
 typedef unsigned short 	Rpc_Proc;
 typedef void 	       *Rpc_Opaque;
 
@@ -111,6 +111,7 @@ Swap_ExportPermit (len, data)
 {
     /* DON'T swap address -- is kept in network byte order all along */
     /* Rpc_SwapLong(sizeof(data->addr), (long *)&data->addr);*/
+    /* DON'T swap port number -- is kept in network byte order all along */
     Rpc_SwapLong(sizeof(data->id), &data->id);
 }
 
@@ -35,7 +35,11 @@ typedef struct ListNode {
  */
 #define LN_DELETED  	0x0001      /* List node should be removed when done */
 
-#define NilListNode	((ListNode)-1)
+/*
+ * Same value as NILLNODE, so an empty list's firstPtr can be handed out
+ * as the NILLNODE it is. (ListNode)-1 isn't NIL once pointers are 64 bits.
+ */
+#define NilListNode	((ListNode)NILLNODE)
 
 typedef enum {
     Head, Middle, Tail, Unknown
@@ -57,7 +61,7 @@ typedef struct	{
 				   * Lst_Remove */
 } *List;
 
-#define NilList	  	((List)-1)
+#define NilList	  	((List)NILLST)
 
 /*
  * PAlloc (var, ptype) --
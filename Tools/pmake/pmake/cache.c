@@ -0,0 +1,449 @@
+/*-
+ * cache.c --
+ *	Content-addressed cache of the files made for targets.
+ *
+ * Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * A target given the .CACHE attribute has its file saved, after it has been
+ * made, in the directory named by -A. The file is filed under a key formed
+ * from the target's name, its commands (with variables expanded) and the
+ * names and contents of all its sources, including those found through
+ * the dependency files makedepend and goc produce, since they're merely
+ * more sources once the makefile has included them. When the target is
+ * next out of date, the key is formed again and, if a file is filed under
+ * it, the file is copied into place rather than the commands being run.
+ *
+ * Only the target's own file is saved, so .CACHE should only be given to
+ * targets whose commands produce nothing else that's needed. Nor can the
+ * key account for changes to the programs the commands run, beyond their
+ * names.
+ *
+ * Interface:
+ *	Cache_Restore	    	If the file for an out-of-date target is in
+ *	    	  	    	the cache, copy it into place and return TRUE.
+ *
+ *	Cache_Save  	    	Save the file for a target that was just made.
+ */
+#include <config.h>
+
+#include    <stdio.h>
+#include    <compat/stdlib.h>
+#include    <compat/string.h>
+#include    <sys/types.h>
+#include    <sys/stat.h>
+#include    <compat/file.h>
+#include    <errno.h>
+
+#include    "make.h"
+
+#if defined(_WIN32)
+#    include    <windows.h>
+#    define CachePid()	    ((int)GetCurrentProcessId())
+#    define CacheMkdir(d)   _mkdir(d)
+#else
+#    include    <unistd.h>
+#    include    <fcntl.h>
+#    define CachePid()	    ((int)getpid())
+#    define CacheMkdir(d)   mkdir((d), 0777)
+#endif /* defined(_WIN32) */
+
+#if !defined(O_BINARY)
+#    define O_BINARY	0
+#endif /* !defined(O_BINARY) */
+
+#define CACHE_BUFSIZE	8192
+
+/*
+ * Running digest of a key or a file. Two different 32-bit hashes of the
+ * same bytes, plus their number, give a key long enough that two different
+ * sets of inputs won't share it by accident.
+ */
+typedef struct {
+    unsigned long   h1;	    	/* FNV-1a */
+    unsigned long   h2;	    	/* sdbm */
+    unsigned long   len;    	/* Bytes digested */
+} CacheHash;
+
+static void	CacheHashInit(CacheHash *ch);
+static void	CacheHashBytes(CacheHash *ch, const char *bytes, int n);
+static void	CacheHashFormat(CacheHash *ch, char *buf);
+static Boolean	CacheHashFile(CacheHash *ch, char *path);
+static char	*CacheKey(GNode *gn);
+static char	*CacheEntry(char *key);
+static Boolean	CacheCopy(char *from, char *to);
+
+
+/***********************************************************************
+ *				CacheHashInit
+ ***********************************************************************
+ * SYNOPSIS:	    Start a digest.
+ * CALLED BY:	    (INTERNAL) CacheKey, CacheHashFile
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    *ch is initialized
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+CacheHashInit(CacheHash *ch)
+{
+    ch->h1 = 2166136261UL;
+    ch->h2 = 0;
+    ch->len = 0;
+}
+
+
+/***********************************************************************
+ *				CacheHashBytes
+ ***********************************************************************
+ * SYNOPSIS:	    Add some bytes to a digest.
+ * CALLED BY:	    (INTERNAL) CacheKey, CacheHashFile
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    *ch is updated
+ *
+ * STRATEGY:	    Values are masked to 32 bits so the digest is the same
+ *		    whatever the size of a long.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+CacheHashBytes(CacheHash *ch, const char *bytes, int n)
+{
+    unsigned long   h1 = ch->h1;
+    unsigned long   h2 = ch->h2;
+    int	    	    i;
+
+    for (i = 0; i < n; i++) {
+	unsigned long	c = (unsigned char)bytes[i];
+
+	h1 = ((h1 ^ c) * 16777619UL) & 0xffffffffUL;
+	h2 = (c + (h2 << 6) + (h2 << 16) - h2) & 0xffffffffUL;
+    }
+    ch->h1 = h1;
+    ch->h2 = h2;
+    ch->len = (ch->len + n) & 0xffffffffUL;
+}
+
+
+/***********************************************************************
+ *				CacheHashFormat
+ ***********************************************************************
+ * SYNOPSIS:	    Print a digest as a string of hex digits.
+ * CALLED BY:	    (INTERNAL) CacheKey, CacheHashFile
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    buf (at least 25 chars) is filled in
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+CacheHashFormat(CacheHash *ch, char *buf)
+{
+    sprintf(buf, "%08lx%08lx%08lx", ch->h1, ch->h2, ch->len);
+}
+
+
+/***********************************************************************
+ *				CacheHashFile
+ ***********************************************************************
+ * SYNOPSIS:	    Add the digest of a file's contents to a digest.
+ * CALLED BY:	    (INTERNAL) CacheKey
+ * RETURN:	    FALSE if the file couldn't be read
+ * SIDE EFFECTS:    *ch is updated
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+CacheHashFile(CacheHash *ch, char *path)
+{
+    CacheHash	fh;
+    char    	buf[CACHE_BUFSIZE];
+    int	    	fd;
+    int	    	n;
+
+    fd = open(path, O_RDONLY|O_BINARY);
+    if (fd < 0) {
+	return (FALSE);
+    }
+    CacheHashInit(&fh);
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+	CacheHashBytes(&fh, buf, n);
+    }
+    (void)close(fd);
+    if (n < 0) {
+	return (FALSE);
+    }
+
+    CacheHashFormat(&fh, buf);
+    CacheHashBytes(ch, buf, strlen(buf) + 1);
+    return (TRUE);
+}
+
+
+/***********************************************************************
+ *				CacheKey
+ ***********************************************************************
+ * SYNOPSIS:	    Form the key for a target's file.
+ * CALLED BY:	    (INTERNAL) Cache_Restore
+ * RETURN:	    the key, in malloc'd memory, or NULL if some source
+ *		    couldn't be read
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:	    This is called from Make_OODate, before the target's
+ *		    .ALLSRC and .OODATE are set, which is as well: the
+ *		    sources are digested by name anyway, and .OODATE
+ *		    depends on times, not contents. Each string digested
+ *		    is followed by its null so the boundaries between them
+ *		    count.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static char *
+CacheKey(GNode *gn)
+{
+    CacheHash	ch;
+    LstNode 	ln;
+    char    	key[32];
+
+    CacheHashInit(&ch);
+    CacheHashBytes(&ch, gn->name, strlen(gn->name) + 1);
+
+    for (ln = Lst_First(gn->commands); ln != NILLNODE; ln = Lst_Succ(ln)) {
+	char	*cmd = Var_Subst((char *)Lst_Datum(ln), gn, FALSE);
+
+	CacheHashBytes(&ch, cmd, strlen(cmd) + 1);
+	free(cmd);
+    }
+
+    for (ln = Lst_First(gn->children); ln != NILLNODE; ln = Lst_Succ(ln)) {
+	GNode	*cgn = (GNode *)Lst_Datum(ln);
+	char	*path;
+
+	if (cgn->type & (OP_USE|OP_EXEC)) {
+	    continue;
+	}
+	path = (cgn->path != NULL) ? cgn->path : cgn->name;
+	CacheHashBytes(&ch, cgn->name, strlen(cgn->name) + 1);
+	if (!CacheHashFile(&ch, path)) {
+	    if (DEBUG(MAKE)) {
+		printf("can't read %s for cache key...", path);
+	    }
+	    return (NULL);
+	}
+    }
+
+    CacheHashFormat(&ch, key);
+    return (Str_New(key));
+}
+
+
+/***********************************************************************
+ *				CacheEntry
+ ***********************************************************************
+ * SYNOPSIS:	    Return the name of the file in the cache for a key.
+ * CALLED BY:	    (INTERNAL) Cache_Restore, Cache_Save
+ * RETURN:	    the name, in malloc'd memory
+ * SIDE EFFECTS:    none
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static char *
+CacheEntry(char *key)
+{
+    char    *entry;
+
+    MallocCheck(entry, strlen(cacheDir) + 1 + strlen(key) + 1);
+    sprintf(entry, "%s/%s", cacheDir, key);
+    return (entry);
+}
+
+
+/***********************************************************************
+ *				CacheCopy
+ ***********************************************************************
+ * SYNOPSIS:	    Copy a file into or out of the cache.
+ * CALLED BY:	    (INTERNAL) Cache_Restore, Cache_Save
+ * RETURN:	    TRUE if the copy was made
+ * SIDE EFFECTS:    the destination is replaced
+ *
+ * STRATEGY:	    The copy is made under a temporary name and renamed
+ *		    into place, so neither another make reading the cache
+ *		    nor a command reading the target ever sees part of a
+ *		    file.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+CacheCopy(char *from, char *to)
+{
+    struct stat	stb;
+    char    	buf[CACHE_BUFSIZE];
+    char    	*tmp;
+    int	    	in, out;
+    int	    	n;
+    Boolean 	ok;
+
+    in = open(from, O_RDONLY|O_BINARY);
+    if (in < 0) {
+	return (FALSE);
+    }
+    if (fstat(in, &stb) < 0) {
+	stb.st_mode = 0666;
+    }
+
+    MallocCheck(tmp, strlen(to) + 16);
+    sprintf(tmp, "%s.%d", to, CachePid());
+    out = open(tmp, O_WRONLY|O_CREAT|O_TRUNC|O_BINARY,
+	       (int)(stb.st_mode & 0777));
+    if (out < 0) {
+	(void)close(in);
+	free(tmp);
+	return (FALSE);
+    }
+
+    ok = TRUE;
+    while ((n = read(in, buf, sizeof(buf))) > 0) {
+	if (write(out, buf, n) != n) {
+	    ok = FALSE;
+	    break;
+	}
+    }
+    if (n < 0) {
+	ok = FALSE;
+    }
+    (void)close(in);
+    if (close(out) < 0) {
+	ok = FALSE;
+    }
+
+#if defined(_WIN32)
+    if (ok) {
+	(void)unlink(to);
+    }
+#endif /* defined(_WIN32) */
+    if (!ok || rename(tmp, to) < 0) {
+	(void)unlink(tmp);
+	ok = FALSE;
+    }
+    free(tmp);
+    return (ok);
+}
+
+
+/***********************************************************************
+ *				Cache_Restore
+ ***********************************************************************
+ * SYNOPSIS:	    Bring an out-of-date target up to date from the cache,
+ *		    if its file is there.
+ * CALLED BY:	    (EXTERNAL) Make_OODate
+ * RETURN:	    TRUE if the target's file was restored
+ * SIDE EFFECTS:    the target's key is stored in gn->cacheKey, for
+ *		    Cache_Save. If the file is restored, gn->mtime is set.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+Boolean
+Cache_Restore(GNode *gn)
+{
+    struct stat	stb;
+    char    	*entry;
+    char    	*target;
+
+    if (cacheDir == NULL || !(gn->type & OP_CACHE) ||
+	noExecute || touchFlag || queryFlag || Lst_IsEmpty(gn->commands))
+    {
+	return (FALSE);
+    }
+
+    if (gn->cacheKey == NULL) {
+	gn->cacheKey = CacheKey(gn);
+	if (gn->cacheKey == NULL) {
+	    return (FALSE);
+	}
+    }
+    entry = CacheEntry(gn->cacheKey);
+    target = (gn->path != NULL) ? gn->path : gn->name;
+    if (!CacheCopy(entry, target)) {
+	free(entry);
+	return (FALSE);
+    }
+    free(entry);
+
+    if (!beSilent) {
+	printf("`%s' restored from cache\n", gn->name);
+	fflush(stdout);
+    }
+    if (stat(target, &stb) == 0) {
+	gn->mtime = stb.st_mtime;
+    } else {
+	gn->mtime = now;
+    }
+    return (TRUE);
+}
+
+
+/***********************************************************************
+ *				Cache_Save
+ ***********************************************************************
+ * SYNOPSIS:	    Save the file for a target just made in the cache.
+ * CALLED BY:	    (EXTERNAL) Make_Update, CompatMake
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the file is copied into the cache directory, which
+ *		    is created if need be
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Cache_Save(GNode *gn)
+{
+    static Boolean  triedMkdir = FALSE;
+    char    	    *entry;
+    char    	    *target;
+
+    if (gn->cacheKey == NULL || gn->made != MADE) {
+	return;
+    }
+    entry = CacheEntry(gn->cacheKey);
+    target = (gn->path != NULL) ? gn->path : gn->name;
+    if (!CacheCopy(target, entry) && !triedMkdir) {
+	triedMkdir = TRUE;
+	if (CacheMkdir(cacheDir) == 0) {
+	    (void)CacheCopy(target, entry);
+	}
+    }
+    free(entry);
+}
@@ -701,6 +701,9 @@ CompatMake (GNode *gn, GNode *pgn)
 	     * This is to keep its state from affecting that of its parent.
 	     */
 	    gn->made = MADE;
+	    if (cacheDir != NULL) {
+		Cache_Save(gn);
+	    }
 #ifndef RECHECK
 	    /*
 	     * We can't re-stat the thing, but we can at least take care of
@@ -54,6 +54,12 @@ CustomsInit()
 {
     struct servent  *sep;
     int	    	i;
+    char    	*port = getenv(CUSTOMS_PORT_VAR);
+
+    if (port != NULL && atoi(port) > 0) {
+	udpPort = tcpPort = atoi(port);
+	goto makeSocket;
+    }
 
     i = 3;
 
@@ -88,7 +94,8 @@ CustomsInit()
     } else {
 	tcpPort = ntohs(sep->s_port);
     }
-    
+
+makeSocket:
     customs_Socket = Rpc_UdpCreate(False, 0);
     (void)fcntl(customs_Socket, F_SETFD, 1);
     bzero(&customs_AgentAddr, sizeof(customs_AgentAddr));
@@ -515,7 +522,14 @@ Customs_RawExport(file, argv, cwd, flags, retSockPtr, permitPtr)
 	return(CUSTOMS_NOIOSOCK);
     }
     importServer.sin_family = AF_INET;
-    importServer.sin_port = htons(tcpPort);
+    if (permitPtr->port != 0) {
+	/*
+	 * The master says which of the agents at that address to use.
+	 */
+	importServer.sin_port = permitPtr->port;
+    } else {
+	importServer.sin_port = htons(tcpPort);
+    }
     importServer.sin_addr = permitPtr->addr;
 
     /*
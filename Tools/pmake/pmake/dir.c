@@ -47,6 +47,9 @@
  *	    	  	    search path.
  *	Dir_ClearPath	    Resets a search path to the empty list.
  *
+ *	Dir_SaveCache	    Write out the directory listings gathered during
+ *	    	  	    this run, if PMAKE_DIRCACHE names a cache file.
+ *
  * For debugging:
  *	Dir_PrintDirectories	Print stats about the directory cache.
  */
@@ -67,6 +70,16 @@ static char     *rcsid = "$Id: dir.c,v 1.12 96/06/24 15:05:23 tbradley Exp $ SPR
 
 #include <sys/stat.h>
 #include <compat/string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#    include <direct.h>
+#    include <process.h>
+#    define getcwd	_getcwd
+#    define getpid	_getpid
+#else
+#    include <unistd.h>
+#endif /* defined(_WIN32) */
 
 #include "make.h"
 #include "hash.h"
@@ -149,6 +162,18 @@ static char     *rcsid = "$Id: dir.c,v 1.12 96/06/24 15:05:23 tbradley Exp $ SPR
  *	filesystem overhead would have to be incurred in Dir_MTime, it made
  *	sense to replace the access() with a stat() and record the mtime
  *	in a cache for when Dir_MTime was actually called.
+ *
+ *	Finally, since a build of the whole tree runs pmake hundreds of times
+ *	over the same include directories, the directory contents may be
+ *	kept between runs. If PMAKE_DIRCACHE names a file, the listing of
+ *	each directory read is saved there along with the directory's mtime,
+ *	and a later run uses the saved listing in place of reading the
+ *	directory so long as the directory's mtime hasn't changed (approach
+ *	3, above, but across runs). A directory modified in the same second
+ *	it was read isn't saved, as a later change in that second wouldn't
+ *	alter its mtime. Files' own mtimes aren't saved: updating a file
+ *	doesn't touch its directory, so there's no cheap way to know a saved
+ *	one is still good.
  */
 
 Lst          dirSearchPath;	/* main search path */
@@ -164,6 +189,28 @@ static int    hits,	      /* Found in directory cache */
 	      nearmisses,     /* Found under search path */
 	      bigmisses;      /* Sought by itself */
 
+/*
+ * A directory listing saved between runs. The names are stored end to end,
+ * each null-terminated.
+ */
+typedef struct {
+    time_t  	mtime;	      /* Directory's mtime when it was read */
+    int	    	numFiles;     /* Number of names in files */
+    int	    	size;	      /* Number of bytes in files */
+    char    	*files;	      /* The names themselves */
+} DirListing;
+
+#define DIR_CACHE_MAGIC	"pmake-dircache 1"
+#define DIR_CACHE_LINE	1024	    /* Longest line in the cache file */
+
+static char	  *dirCacheFile;  /* Cache file, or NULL if none */
+static char	  *dirCacheCwd;	  /* Directory in which we were started, to
+				   * make the cache's names absolute */
+static Hash_Table dirCache;	  /* DirListings by absolute directory name */
+static Boolean	  dirCacheDirty;  /* TRUE if dirCache needs to be saved */
+static int  	  dirCacheHits,	  /* Directories taken from the cache */
+		  dirCacheReads;  /* Directories actually read */
+
 
 /**********************prototypes for static routines****************/
 static Path 	*DirAddDir(Lst path, char *name);
@@ -173,6 +220,10 @@ static void	DirExpandCurly(char *myword, char *brace, Lst path,
 					Lst expansions);
 static void	DirExpandInt(char *myword, Lst path, Lst expansions);
 static int	DirPrintWord(char *myword);
+static char	*DirCacheKey(char *name);
+static void	DirCacheLoad(void);
+static Path	*DirCacheFetch(char *name, time_t *timePtr);
+static void	DirCacheStore(Path *p, time_t mtime);
 
 static Path    	  *dot;	    /* contents of current directory */
 static Hash_Table mtimes;   /* Results of doing a last-resort stat in
@@ -208,6 +259,8 @@ Dir_Init (void)
 #else
     Hash_InitTable(&mtimes, 0, HASH_STRING_KEYS, 0);
 #endif    
+    DirCacheLoad();
+
     /*
      * Since the Path structure is placed on both openDirectories and
      * the path we give Dir_AddDir (which in this case is openDirectories),
@@ -1075,6 +1128,386 @@ Dir_MTime (GNode *gn)
 #include <errno.h>
 #endif
 
+
+/***********************************************************************
+ *				DirCacheKey
+ ***********************************************************************
+ * SYNOPSIS:	    Form the name under which a directory's listing is
+ *		    kept in the cache.
+ * CALLED BY:	    (INTERNAL) DirCacheFetch, DirCacheStore
+ * RETURN:	    the absolute name of the directory, which the caller
+ *		    must free
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:	    pmake is run in many different directories over the
+ *		    same search paths, so relative names are made absolute
+ *		    using the directory in which we were started.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static char *
+DirCacheKey(char *name)
+{
+    char    *key;
+
+    if (IS_PATHSEP(name[0])
+#if defined(_WIN32)
+	|| (name[0] != '\0' && name[1] == ':')
+#endif /* defined(_WIN32) */
+	)
+    {
+	return (Str_New(name));
+    }
+    MallocCheck(key, strlen(dirCacheCwd) + 1 + strlen(name) + 1);
+    sprintf(key, "%s/%s", dirCacheCwd, name);
+    return (key);
+}
+
+
+/***********************************************************************
+ *				DirCacheLoad
+ ***********************************************************************
+ * SYNOPSIS:	    Read the directory listings saved by earlier runs.
+ * CALLED BY:	    (INTERNAL) Dir_Init
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    dirCacheFile, dirCacheCwd and dirCache are set up if
+ *		    PMAKE_DIRCACHE is set.
+ *
+ * STRATEGY:	    The file holds a line with the magic string, then for
+ *		    each directory a line
+ *			D <mtime> <number of files> <directory>
+ *		    followed by one line for each file. A file that's
+ *		    missing or damaged just leaves the cache empty, to be
+ *		    filled in as directories are read.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+DirCacheLoad(void)
+{
+    char    	cwd[DIR_CACHE_LINE];
+    char    	line[DIR_CACHE_LINE];
+    FILE    	*f;
+    char    	*cp;
+
+    cp = getenv("PMAKE_DIRCACHE");
+    if (cp == NULL || *cp == '\0' || getcwd(cwd, sizeof(cwd)) == NULL) {
+	return;
+    }
+    dirCacheFile = Str_New(cp);
+    dirCacheCwd = Str_New(cwd);
+#if !defined(__HIGHC__) && !defined(__WATCOMC__)
+    Hash_InitTable(&dirCache, 0, HASH_STRING_KEYS);
+#else
+    Hash_InitTable(&dirCache, 0, HASH_STRING_KEYS, 0);
+#endif    
+
+    f = fopen(dirCacheFile, "r");
+    if (f == NULL) {
+	return;
+    }
+    if (fgets(line, sizeof(line), f) == NULL ||
+	strncmp(line, DIR_CACHE_MAGIC, sizeof(DIR_CACHE_MAGIC)-1) != 0)
+    {
+	fclose(f);
+	return;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+	DirListing  *dl;
+	Hash_Entry  *he;
+	Boolean	    new;
+	long	    mtime;
+	int 	    numFiles, i, len;
+
+	len = strlen(line);
+	if (len == 0 || line[len-1] != '\n' ||
+	    sscanf(line, "D %ld %d %n", &mtime, &numFiles, &i) != 2 ||
+	    numFiles < 0)
+	{
+	    break;
+	}
+	line[len-1] = '\0';
+
+	MallocCheck(dl, sizeof(DirListing));
+	dl->mtime = (time_t)mtime;
+	dl->numFiles = 0;
+	dl->size = 0;
+	dl->files = NULL;
+	he = Hash_CreateEntry(&dirCache, (Address)&line[i], &new);
+	if (!new) {
+	    DirListing	*old = (DirListing *)Hash_GetValue(he);
+
+	    free(old->files);
+	    free((char *)old);
+	}
+	Hash_SetValue(he, dl);
+
+	while (dl->numFiles < numFiles) {
+	    if (fgets(line, sizeof(line), f) == NULL) {
+		break;
+	    }
+	    len = strlen(line);
+	    if (len == 0 || line[len-1] != '\n') {
+		break;
+	    }
+	    dl->files = (char *)realloc(dl->files, dl->size + len);
+	    if (dl->files == NULL) {
+		printf("MALLOC FAILED");
+		exit(1);
+	    }
+	    bcopy(line, dl->files + dl->size, len - 1);
+	    dl->files[dl->size + len - 1] = '\0';
+	    dl->size += len;
+	    dl->numFiles += 1;
+	}
+	if (dl->numFiles != numFiles) {
+	    /*
+	     * Truncated -- make sure the partial listing's never used.
+	     */
+	    dl->mtime = 0;
+	    break;
+	}
+    }
+    fclose(f);
+}
+
+
+/***********************************************************************
+ *				DirCacheFetch
+ ***********************************************************************
+ * SYNOPSIS:	    Create the Path for a directory from its saved listing,
+ *		    if the listing's still good.
+ * CALLED BY:	    (INTERNAL) DirAddDir
+ * RETURN:	    the new Path, or NULL if the directory must be read.
+ *		    *timePtr is set to the directory's mtime, or 0 if it
+ *		    isn't known.
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:	    Creating or removing a file in the directory changes
+ *		    the directory's mtime, so the listing is good if the
+ *		    mtime is as it was when the listing was made.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Path *
+DirCacheFetch(char *name, time_t *timePtr)
+{
+    struct stat	stb;
+    Hash_Entry	*he;
+    DirListing	*dl;
+    Path    	*p;
+    char    	*key;
+    char    	*cp;
+    int	    	i;
+
+    *timePtr = 0;
+    if (dirCacheFile == NULL || stat(name, &stb) < 0) {
+	return ((Path *)NULL);
+    }
+    *timePtr = stb.st_mtime;
+
+    key = DirCacheKey(name);
+    he = Hash_FindEntry(&dirCache, (Address)key);
+    free(key);
+    if (he == (Hash_Entry *)NULL) {
+	return ((Path *)NULL);
+    }
+    dl = (DirListing *)Hash_GetValue(he);
+    if (dl->mtime == 0 || dl->mtime != stb.st_mtime) {
+	return ((Path *)NULL);
+    }
+
+    MallocCheck (p, sizeof (Path));
+    p->name = Str_New (name);
+    p->hits = 0;
+    p->refCount = 1;
+#if !defined(__HIGHC__) && !defined(__WATCOMC__)
+    Hash_InitTable (&p->files, -1, HASH_STRING_KEYS);
+#else
+    Hash_InitTable (&p->files, -1, HASH_STRING_KEYS, 0);
+#endif
+    for (i = 0, cp = dl->files; i < dl->numFiles; i++) {
+	Hash_CreateEntry(&p->files, (Address)cp, NULL);
+	cp += strlen(cp) + 1;
+    }
+    dirCacheHits += 1;
+    return (p);
+}
+
+
+/***********************************************************************
+ *				DirCacheStore
+ ***********************************************************************
+ * SYNOPSIS:	    Record the listing of a directory just read.
+ * CALLED BY:	    (INTERNAL) DirAddDir
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the listing replaces any in dirCache and the cache is
+ *		    marked as needing to be saved.
+ *
+ * Arguments:
+ *      Path   *p     : The directory just read
+ *      time_t mtime  : Its mtime before it was read (0 if unknown)
+ *
+ * STRATEGY:	    The mtime was taken before the directory was read, so
+ *		    any change during the read will show as a different
+ *		    mtime next time. A change later in the same second as
+ *		    the mtime wouldn't, though, so a directory modified
+ *		    this very second isn't saved.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+DirCacheStore(Path *p, time_t mtime)
+{
+    Hash_Search	search;
+    Hash_Entry	*entry;
+    Hash_Entry	*he;
+    DirListing	*dl;
+    Boolean 	new;
+    char    	*key;
+    char    	*cp;
+    int	    	size;
+
+    dirCacheReads += 1;
+    if (dirCacheFile == NULL || mtime == 0 || mtime >= time((time_t *)NULL)) {
+	return;
+    }
+
+    size = 0;
+    for (entry = Hash_EnumFirst(&p->files, &search);
+	 entry != (Hash_Entry *)NULL;
+	 entry = Hash_EnumNext(&search))
+    {
+	if (strchr(entry->key.name, '\n') != NULL) {
+	    /*
+	     * Can't be represented in the cache file.
+	     */
+	    return;
+	}
+	size += strlen(entry->key.name) + 1;
+    }
+
+    MallocCheck(dl, sizeof(DirListing));
+    dl->mtime = mtime;
+    dl->numFiles = p->files.numEntries;
+    dl->size = size;
+    MallocCheck(dl->files, size ? size : 1);
+    for (cp = dl->files, entry = Hash_EnumFirst(&p->files, &search);
+	 entry != (Hash_Entry *)NULL;
+	 entry = Hash_EnumNext(&search))
+    {
+	strcpy(cp, entry->key.name);
+	cp += strlen(cp) + 1;
+    }
+
+    key = DirCacheKey(p->name);
+    he = Hash_CreateEntry(&dirCache, (Address)key, &new);
+    free(key);
+    if (!new) {
+	DirListing  *old = (DirListing *)Hash_GetValue(he);
+
+	free(old->files);
+	free((char *)old);
+    }
+    Hash_SetValue(he, dl);
+    dirCacheDirty = TRUE;
+}
+
+
+/***********************************************************************
+ *				Dir_SaveCache
+ ***********************************************************************
+ * SYNOPSIS:	    Write the directory listings out for the next run.
+ * CALLED BY:	    (EXTERNAL) main
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the cache file is replaced.
+ *
+ * STRATEGY:	    Several pmakes may be finishing at once, so each
+ *		    writes a file of its own and renames it over the cache
+ *		    file. The last one wins, but each file written is
+ *		    complete and correct, so nothing's lost but the
+ *		    listings the others read.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Dir_SaveCache(void)
+{
+    Hash_Search	search;
+    Hash_Entry	*he;
+    FILE    	*f;
+    char    	*tmp;
+    Boolean 	ok;
+
+    if (dirCacheFile == NULL || !dirCacheDirty) {
+	return;
+    }
+
+    MallocCheck(tmp, strlen(dirCacheFile) + 16);
+    sprintf(tmp, "%s.%d", dirCacheFile, (int)getpid());
+    f = fopen(tmp, "w");
+    if (f == NULL) {
+	free(tmp);
+	return;
+    }
+
+    fprintf(f, "%s\n", DIR_CACHE_MAGIC);
+    for (he = Hash_EnumFirst(&dirCache, &search);
+	 he != (Hash_Entry *)NULL;
+	 he = Hash_EnumNext(&search))
+    {
+	DirListing  *dl = (DirListing *)Hash_GetValue(he);
+	char	    *cp;
+	int 	    i;
+
+	if (dl->mtime == 0) {
+	    continue;
+	}
+	fprintf(f, "D %ld %d %s\n", (long)dl->mtime, dl->numFiles,
+		he->key.name);
+	for (i = 0, cp = dl->files; i < dl->numFiles; i++) {
+	    fprintf(f, "%s\n", cp);
+	    cp += strlen(cp) + 1;
+	}
+    }
+
+    ok = !ferror(f);
+    if (fclose(f) != 0) {
+	ok = FALSE;
+    }
+#if defined(_WIN32)
+    if (ok) {
+	(void)unlink(dirCacheFile);
+    }
+#endif /* defined(_WIN32) */
+    if (!ok || rename(tmp, dirCacheFile) < 0) {
+	(void)unlink(tmp);
+    }
+    free(tmp);
+    dirCacheDirty = FALSE;
+}
+
 
 /***********************************************************************
  *				DirAddDir
@@ -1102,6 +1535,8 @@ DirAddDir(Lst path, char *name)
     LstNode       ln;	      /* node in case Path structure is found */
     register Path *p;	      /* pointer to new Path structure */
     DIR     	  *d;	      /* for reading directory */
+    Path    	  *cached;    /* Path made from saved listing */
+    time_t  	  dirTime;    /* directory's mtime before reading */
 
 #if defined(_WIN32)
     const struct   direct *dp;
@@ -1196,12 +1631,21 @@ DirAddDir(Lst path, char *name)
 		printf("Caching %s...", name);
 		fflush(stdout);
 	    }
-	    d = opendir(name);
+	    cached = DirCacheFetch(name, &dirTime);
+	    d = (cached == (Path *)NULL) ? opendir(name) : NULL;
 	} else {
+	    cached = (Path *)NULL;
 	    d = NULL;
 	}
 
-	if (d != NULL) {
+	if (cached != (Path *)NULL) {
+	    p = cached;
+	    (void)Lst_AtEnd (openDirectories, (ClientData)p);
+	    (void)Lst_AtEnd (path, (ClientData)p);
+	    if (DEBUG(DIR)) {
+		printf("saved listing\n");
+	    }
+	} else if (d != NULL) {
 	    MallocCheck (p, sizeof (Path));
 	    p->name = Str_New (name);
 	    p->hits = 0;
@@ -1270,6 +1714,7 @@ DirAddDir(Lst path, char *name)
 
 	    }
 	    (void) closedir (d);
+	    DirCacheStore(p, dirTime);
 	    (void)Lst_AtEnd (openDirectories, (ClientData)p);
 	    (void)Lst_AtEnd (path, (ClientData)p);
 	    if (DEBUG(DIR)) {
@@ -1488,6 +1933,10 @@ Dir_PrintDirectories(void)
 	      hits, misses, nearmisses, bigmisses,
 	      (hits+bigmisses+nearmisses ?
 	       hits * 100 / (hits + bigmisses + nearmisses) : 0));
+    if (dirCacheFile != NULL) {
+	printf ("# %d directories from %s, %d read\n",
+		dirCacheHits, dirCacheFile, dirCacheReads);
+    }
     printf ("# %-20s referenced\thits\n", "directory");
     if (Lst_Open (openDirectories) == SUCCESS) {
 	while ((ln = Lst_Next (openDirectories)) != NILLNODE) {
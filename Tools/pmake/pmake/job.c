@@ -64,6 +64,13 @@
  *	Job_Touch 	    	Update a target without really updating it.
  *
  *	Job_Wait  	    	Wait for all currently-running jobs to finish.
+ *
+ * With -O, a line describing each shell run is appended to traceFile in
+ * the Trace Event format understood by chrome://tracing and Perfetto: an
+ * array of events, whose closing bracket may be left off. The file is
+ * opened for appending and each event goes out in a single write, so all
+ * the makes of a recursive build can share it. Remove the file before the
+ * build to start afresh.
  */
 #include <config.h>
 
@@ -96,6 +103,7 @@ extern char *getenv (const char *name);
 #	include    <sys/signal.h>
 #	include	   <sys/unistd.h>
 #	include    <sys/time.h>
+#	include    <sys/resource.h>   /* for wait4() for -O */
 #	include    <sys/wait.h>
 #elif defined(_LINUX)
 #	include    <signal.h>
@@ -118,6 +126,7 @@ extern int  errno;
 #endif /* __HIGHC__ */
 
 #include    "make.h"
+#include    "buf.h"
 #include    "job.h"
 
 #if defined (unix) || defined(_LINUX)
@@ -375,6 +384,17 @@ char 	    	*targFmt;   	/* Format string to use to head output from a
 
 static char 	*bannerPrefix;	/* Prefix we received from our parent make */
 
+static int  	traceFd = -1;	/* Descriptor open to traceFile */
+static char 	*traceBusy; 	/* Non-zero for each row of the timeline
+				 * showing a running job */
+static int  	traceRows;  	/* Number of entries in traceBusy */
+#define TRACE_CMD_MAX	2048	/* Most of a job's commands to record */
+#if defined(_WIN32)
+#    define JobTracePid()	((int)GetCurrentProcessId())
+#else
+#    define JobTracePid()	((int)getpid())
+#endif /* defined(_WIN32) */
+
 /*
  * When JobStart attempts to run a job remotely but can't, and isn't allowed
  * to run the job locally, or when Job_CatchChildren detects a job that has
@@ -401,6 +421,11 @@ static void JobRestart(Job *job);
 #endif /* defined(unix) */
 
 static int  JobStart(GNode *gn, short flags, Job *previous);
+static double JobTraceNow(void);
+static void JobTraceQuote(Buffer buf, char *str, int max);
+static void JobTraceOpen(void);
+static void JobTraceStart(Job *job);
+static void JobTraceEnd(Job *job, int code, int sig, long cpu, long rss);
 
 #if defined(unix)
 static void JobInterrupt(int runINTERRUPT);
@@ -1418,6 +1443,293 @@ JobLocalInput(int stream, Job *job)
 #endif /* RMT_WILL_WATCH */
 #endif /* defined(unix) */
 
+/***********************************************************************
+ *				JobTraceNow
+ ***********************************************************************
+ * SYNOPSIS:	    Return the time of day for the timeline.
+ * CALLED BY:	    (INTERNAL) JobTraceStart, JobTraceEnd
+ * RETURN:	    microseconds since 1970
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:	    All the makes writing the timeline must agree on the
+ *		    time, so this is absolute, unlike Make_Clock. A double
+ *		    holds it exactly.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static double
+JobTraceNow(void)
+{
+#if defined(_WIN32)
+    FILETIME	ft;
+
+    /*
+     * FILETIMEs count 100ns units from 1601, 11644473600 seconds before
+     * 1970.
+     */
+    GetSystemTimeAsFileTime(&ft);
+    return ((ft.dwHighDateTime * 4294967296.0 + ft.dwLowDateTime) / 10.0 -
+	    11644473600000000.0);
+#elif defined(unix) || defined(_LINUX)
+    struct timeval  tv;
+
+    gettimeofday(&tv, (struct timezone *)NULL);
+    return (tv.tv_sec * 1000000.0 + tv.tv_usec);
+#else
+    return (time((time_t *)NULL) * 1000000.0);
+#endif /* defined(_WIN32) */
+}
+
+/***********************************************************************
+ *				JobTraceQuote
+ ***********************************************************************
+ * SYNOPSIS:	    Add a string to an event as a JSON string.
+ * CALLED BY:	    (INTERNAL) JobTraceOpen, JobTraceEnd
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the quoted string is added to the buffer
+ *
+ * Arguments:
+ *      Buffer buf : Event being formed
+ *      char  *str : String to add
+ *      int    max : Most characters of str to add
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+JobTraceQuote(Buffer buf, char *str, int max)
+{
+    char    esc[8];
+
+    Buf_AddByte(buf, (Byte)'"');
+    for (; *str != '\0' && max > 0; str++, max--) {
+	switch (*str) {
+	    case '"':
+	    case '\\':
+		Buf_AddByte(buf, (Byte)'\\');
+		Buf_AddByte(buf, (Byte)*str);
+		break;
+	    case '\n':
+		Buf_AddBytes(buf, 2, (Byte *)"\\n");
+		break;
+	    case '\t':
+		Buf_AddBytes(buf, 2, (Byte *)"\\t");
+		break;
+	    default:
+		if ((unsigned char)*str < ' ') {
+		    sprintf(esc, "\\u%04x", (unsigned char)*str);
+		    Buf_AddBytes(buf, strlen(esc), (Byte *)esc);
+		} else {
+		    Buf_AddByte(buf, (Byte)*str);
+		}
+		break;
+	}
+    }
+    Buf_AddByte(buf, (Byte)'"');
+}
+
+/***********************************************************************
+ *				JobTraceOpen
+ ***********************************************************************
+ * SYNOPSIS:	    Open traceFile for the first job.
+ * CALLED BY:	    (INTERNAL) JobTraceStart
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    traceFd is set. If we create the file, the array is
+ *		    begun. An event naming this make's row of the
+ *		    timeline is written.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+JobTraceOpen(void)
+{
+    Buffer  buf;
+    char    head[128];
+    char    cwd[TRACE_CMD_MAX];
+    Byte    *data;
+    int	    len;
+
+    traceFd = open(traceFile, O_WRONLY|O_CREAT|O_EXCL|O_APPEND, 0666);
+    if (traceFd >= 0) {
+	(void)write(traceFd, "[\n", 2);
+    } else {
+	traceFd = open(traceFile, O_WRONLY|O_APPEND, 0666);
+	if (traceFd < 0) {
+	    Error("Could not open %s for timeline", (unsigned long)traceFile,
+		  0, 0);
+	    traceFile = NULL;
+	    return;
+	}
+    }
+
+    buf = Buf_Init(0);
+    sprintf(head,
+	    "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":",
+	    JobTracePid());
+    Buf_AddBytes(buf, strlen(head), (Byte *)head);
+    if (getcwd(cwd, sizeof(cwd)) == NULL) {
+	strcpy(cwd, "pmake");
+    }
+    JobTraceQuote(buf, cwd, TRACE_CMD_MAX);
+    Buf_AddBytes(buf, 4, (Byte *)"}},\n");
+    data = Buf_GetAll(buf, &len);
+    (void)write(traceFd, (char *)data, len);
+    Buf_Destroy(buf, TRUE);
+}
+
+/***********************************************************************
+ *				JobTraceStart
+ ***********************************************************************
+ * SYNOPSIS:	    Note the start of a job's shell for the timeline.
+ * CALLED BY:	    (INTERNAL) JobExec
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the job is given the start time and a free row
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+JobTraceStart(Job *job)
+{
+    int	    row;
+
+    if (traceFile == NULL) {
+	return;
+    }
+    if (traceFd < 0) {
+	JobTraceOpen();
+	if (traceFile == NULL) {
+	    return;
+	}
+    }
+
+    for (row = 0; row < traceRows && traceBusy[row]; row++) {
+	;
+    }
+    if (row == traceRows) {
+	traceRows = traceRows ? traceRows * 2 : 8;
+	traceBusy = (char *)realloc(traceBusy, traceRows);
+	if (traceBusy == NULL) {
+	    Punt("Out of memory for timeline");
+	}
+	bzero(traceBusy + row, traceRows - row);
+    }
+    traceBusy[row] = 1;
+    job->traceRow = row;
+    job->traceStart = JobTraceNow();
+}
+
+/***********************************************************************
+ *				JobTraceEnd
+ ***********************************************************************
+ * SYNOPSIS:	    Write the timeline event for a shell that has exited.
+ * CALLED BY:	    (INTERNAL) Job_CatchChildren, Job_NTCatchChildren
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    an event is appended to traceFile and the job's row
+ *		    freed
+ *
+ * Arguments:
+ *      Job  *job  : The job whose shell exited
+ *      int   code : Its exit status
+ *      int   sig  : The signal that killed it, or 0
+ *      long  cpu  : User+system CPU time, in ms, or -1 if unknown
+ *      long  rss  : Maximum resident set size, in KB, or -1 if unknown
+ *
+ * STRATEGY:	    Each job is a complete ("X") event named for the
+ *		    target, with the commands and the figures above as
+ *		    its arguments.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+JobTraceEnd(Job *job, int code, int sig, long cpu, long rss)
+{
+    Buffer  buf;
+    Buffer  cmds;
+    LstNode ln;
+    char    num[128];
+    Byte    *data;
+    int	    len;
+    int	    room;
+
+    if (traceFile == NULL || traceFd < 0) {
+	return;
+    }
+    traceBusy[job->traceRow] = 0;
+
+    buf = Buf_Init(0);
+    Buf_AddBytes(buf, 9, (Byte *)"{\"name\":");
+    JobTraceQuote(buf, job->node->name, TRACE_CMD_MAX);
+    sprintf(num, ",\"cat\":\"job\",\"ph\":\"X\",\"ts\":%.0f,\"dur\":%.0f,",
+	    job->traceStart, JobTraceNow() - job->traceStart);
+    Buf_AddBytes(buf, strlen(num), (Byte *)num);
+    sprintf(num, "\"pid\":%d,\"tid\":%d,\"args\":{\"exit\":%d",
+	    JobTracePid(), job->traceRow, code);
+    Buf_AddBytes(buf, strlen(num), (Byte *)num);
+    if (sig != 0) {
+	sprintf(num, ",\"signal\":%d", sig);
+	Buf_AddBytes(buf, strlen(num), (Byte *)num);
+    }
+    if (cpu >= 0) {
+	sprintf(num, ",\"cpu_ms\":%ld", cpu);
+	Buf_AddBytes(buf, strlen(num), (Byte *)num);
+    }
+    if (rss >= 0) {
+	sprintf(num, ",\"max_rss_kb\":%ld", rss);
+	Buf_AddBytes(buf, strlen(num), (Byte *)num);
+    }
+
+    /*
+     * The commands, expanded as they were given to the shell.
+     */
+    cmds = Buf_Init(0);
+    room = TRACE_CMD_MAX;
+    for (ln = Lst_First(job->node->commands);
+	 ln != NILLNODE && room > 0;
+	 ln = Lst_Succ(ln))
+    {
+	char    *cmd = Var_Subst((char *)Lst_Datum(ln), job->node, FALSE);
+
+	len = strlen(cmd);
+	if (len > room) {
+	    len = room;
+	}
+	if (Buf_Size(cmds) != 0) {
+	    Buf_AddByte(cmds, (Byte)'\n');
+	}
+	Buf_AddBytes(cmds, len, (Byte *)cmd);
+	room -= len;
+	free(cmd);
+    }
+    Buf_AddByte(cmds, (Byte)'\0');
+    Buf_AddBytes(buf, 7, (Byte *)",\"cmd\":");
+    JobTraceQuote(buf, (char *)Buf_GetAll(cmds, (int *)NULL), TRACE_CMD_MAX);
+    Buf_Destroy(cmds, TRUE);
+    Buf_AddBytes(buf, 4, (Byte *)"}},\n");
+
+    data = Buf_GetAll(buf, &len);
+    (void)write(traceFd, (char *)data, len);
+    Buf_Destroy(buf, TRUE);
+}
+
 /*-
  *-----------------------------------------------------------------------
  * JobExec --
@@ -1628,6 +1940,8 @@ JobExec(Job *job, ARGV_TYPE argv)
 #if defined(RMT_NO_EXEC)
 jobExecFinish:
 #endif /* defined(RMT_NO_EXEC) */
+    JobTraceStart(job);
+
     /*
      * Now the job is actually running, add it to the table.
      */
@@ -2784,6 +3098,9 @@ Job_CatchChildren (Boolean block)
     register Job *job;	    	/* job descriptor for dead child */
     LstNode       jnode;    	/* list element for finding job */
     WAIT_TYPE     status;   	/* Exit/termination status */
+#if defined(unix)
+    struct rusage ru;	    	/* Resources used by the child, for -O */
+#endif /* defined(unix) */
 
     /*
      * Don't even bother if we know there's no one around.
@@ -2792,7 +3109,12 @@ Job_CatchChildren (Boolean block)
 	return;
     }
 
+#if defined(unix)
+    while ((pid = wait4(-1, &status, (block ? 0 : WNOHANG)|WUNTRACED,
+			&ru)) > 0)
+#else
     while ((pid = waitpid(-1, &status, (block ? 0 : WNOHANG)|WUNTRACED)) > 0)
+#endif /* defined(unix) */
     {
 	if (DEBUG(JOB)) {
 #ifdef Sprite
@@ -2842,6 +3164,23 @@ Job_CatchChildren (Boolean block)
 	    }
 	}
 
+	if (WIFEXITED(status) ||
+	    (WIFSIGNALED(status) && WTERMSIG(status) != SIGCONT))
+	{
+#if defined(unix)
+	    JobTraceEnd(job,
+			WIFEXITED(status) ? WEXITSTATUS(status) : 0,
+			WIFSIGNALED(status) ? WTERMSIG(status) : 0,
+			(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000L +
+			(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1000L,
+			(long)ru.ru_maxrss);
+#else
+	    JobTraceEnd(job,
+			WIFEXITED(status) ? WEXITSTATUS(status) : 0,
+			WIFSIGNALED(status) ? WTERMSIG(status) : 0,
+			-1L, -1L);
+#endif /* defined(unix) */
+	}
 	JobFinish (job, status);
     }
 }
@@ -2977,6 +3316,20 @@ Job_NTCatchChildren (unsigned long block)
 	    jobFull = FALSE;
 	}
 
+	if (traceFile != NULL) {
+	    FILETIME	created, exited, kernel, user;
+	    long    	cpu = -1;
+
+	    if (GetProcessTimes(job->pid.hProcess, &created, &exited,
+				&kernel, &user))
+	    {
+		cpu = (long)(((kernel.dwHighDateTime + user.dwHighDateTime) *
+			      4294967296.0 +
+			      (double)kernel.dwLowDateTime +
+			      (double)user.dwLowDateTime) / 10000.0);
+	    }
+	    JobTraceEnd(job, (int)status, 0, cpu, -1L);
+	}
 	JobNTFinish(job, status);
     }
 }	/* End of Job_NTCatchChildren.	*/
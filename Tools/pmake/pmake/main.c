@@ -110,6 +110,10 @@ extern int errno;
 #    include <windows.h>
 #endif /* defined(_WIN32) */
 
+#if defined(unix) || defined(_LINUX)
+#    include <unistd.h>	    /* for sysconf() for -J0 */
+#endif /* defined(unix) || defined(_LINUX) */
+
 int    idfile;
 
 #if defined(DEFMAXJOBS) && !defined(DEFMAXLOCAL)
@@ -126,6 +130,9 @@ static Boolean	  	lockSet;    	/* TRUE if we set the lock file */
 
 Lst			create;	    	/* Targets to be made */
 time_t			now;	    	/* Time at start of make */
+char	    	    	*timesFile; 	/* -T argument */
+char	    	    	*traceFile; 	/* -O argument */
+char	    	    	*cacheDir;  	/* -A argument */
 GNode			*DEFAULT;   	/* .DEFAULT node */
 Boolean	    	    	allPrecious;	/* .PRECIOUS given on line by itself */
 
@@ -170,12 +177,14 @@ static void 		MainParseArgs(int argc, char **argv);
 static int  	initOptInd;
 
 #ifdef CAN_EXPORT
-#define OPTSTR "BCD:I:J:L:MNPSUVWXd:ef:iklnp:qrstuvxh"
+#define OPTSTR "A:BCD:I:J:L:MNO:PST:UVWXd:ef:iklnp:qrstuvxh"
 #else
-#define OPTSTR "BCD:I:J:L:MNPSUVWd:ef:iklnp:qrstuvh"
+#define OPTSTR "A:BCD:I:J:L:MNO:PST:UVWd:ef:iklnp:qrstuvh"
 #endif
 
 static char 	    *help[] = {
+"-A<dir>	Save the files made for .CACHE targets in <dir>, and\n\
+		restore them from there rather than remaking them.",
 "-B	    	Be as backwards-compatible with make as possible without\n\
 		being make.",
 "-C	    	Cancel any current indications of compatibility.",
@@ -183,12 +192,17 @@ static char 	    *help[] = {
 "-I<dir>	Specify another directory in which to search for included\n\
 		makefiles.",
 #ifdef unix
-"-J<num>	Specify maximum overall concurrency.",
+"-J<num>	Specify maximum overall concurrency (0 for one job per\n\
+		processor).",
 "-L<num>	Specify maximum local concurrency.",
 "-M		Be Make as closely as possible.",
 "-P		Don't use pipes to catch the output of jobs, use files.",
 #endif
+"-O<file>	Append a timeline of the jobs run to <file>, for viewing\n\
+		with chrome://tracing, and print the critical path.",
 "-S	    	Turn off the -k flag (see below).",
+"-T<file>	Start the jobs on the longest path to the end first, using\n\
+		(and updating) the job times recorded in <file>.",
 #ifndef POSIX
 "-V		Use old-style variable substitution.",
 #endif
@@ -300,6 +314,11 @@ MainParseArgs (int argc, char** argv)
 
     while((char)(c = getopt(argc, argv, OPTSTR)) != (char)-1) {
 	switch(c) {
+	    case 'A':
+		cacheDir = Make_AbsName(optarg);
+		Var_Append(MAKEFLAGS, "-A", VAR_GLOBAL);
+		Var_Append(MAKEFLAGS, cacheDir, VAR_GLOBAL);
+		break;
 	    case 'B':
 		backwards = oldVars = TRUE;
 		Var_Append(MAKEFLAGS, "-B", VAR_GLOBAL);
@@ -322,9 +341,22 @@ MainParseArgs (int argc, char** argv)
 		amMake = TRUE;
 		Var_Append(MAKEFLAGS, "-M", VAR_GLOBAL);
 		break;
+	    case 'O':
+		traceFile = Make_AbsName(optarg);
+		Var_Append(MAKEFLAGS, "-O", VAR_GLOBAL);
+		Var_Append(MAKEFLAGS, traceFile, VAR_GLOBAL);
+		break;
 #if defined(unix) || defined(_LINUX)
 	    case 'J':
 		maxJobs = atoi(optarg);
+#if defined(_SC_NPROCESSORS_ONLN)
+		if (maxJobs <= 0) {
+		    maxJobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+		}
+#endif /* defined(_SC_NPROCESSORS_ONLN) */
+		if (maxJobs <= 0) {
+		    maxJobs = 1;
+		}
 		Var_Append(MAKEFLAGS, "-J", VAR_GLOBAL);
 		Var_Append(MAKEFLAGS, optarg, VAR_GLOBAL);
 		break;
@@ -342,6 +374,15 @@ MainParseArgs (int argc, char** argv)
 		keepgoing = FALSE;
 		Var_Append(MAKEFLAGS, "-S", VAR_GLOBAL);
 		break;
+	    case 'T':
+		/*
+		 * Pass the absolute name on, so makes in other directories
+		 * share the file.
+		 */
+		timesFile = Make_AbsName(optarg);
+		Var_Append(MAKEFLAGS, "-T", VAR_GLOBAL);
+		Var_Append(MAKEFLAGS, timesFile, VAR_GLOBAL);
+		break;
 	    case 'V':
 		oldVars = TRUE;
 		Var_Append(MAKEFLAGS, "-V", VAR_GLOBAL);
@@ -1019,6 +1060,8 @@ main (int argc, char** argv)
 	Targ_PrintGraph (2);
     }
 
+    Dir_SaveCache();
+
     if (queryFlag && outOfDate) {
 	exit (1);
     } else {
@@ -40,6 +40,12 @@
  *
  *	Make_HandleUse	    	See if a child is a .USE node for a parent
  *				and perform the .USE actions if so.
+ *
+ *	Make_Clock  	    	Return the time in milliseconds, for timing
+ *				jobs.
+ *
+ *	Make_AbsName	    	Return the absolute form of a file name
+ *				given on the command line.
  */
 #include <config.h>
 
@@ -51,9 +57,22 @@ static char     *rcsid = "$Id: make.c,v 1.7 96/06/24 15:06:06 tbradley Exp $ SPR
 #include <sys/stat.h>
 #endif
 #include <malloc.h>
+#include    <stdio.h>
+#include    <time.h>
 #include    "make.h"
+#include    "hash.h"
 #include    "pmjob.h"
 
+#if defined(_WIN32)
+#    include    <direct.h>
+#    include    <process.h>
+#    define getcwd	_getcwd
+#    define getpid	_getpid
+#elif defined(unix) || defined(_LINUX)
+#    include    <unistd.h>
+#    include    <sys/time.h>
+#endif /* defined(_WIN32) */
+
 #if defined(unix)
 #    include    "arch.h"
 #endif /* defined(unix) */
@@ -67,11 +86,31 @@ static int  	numNodes;   	/* Number of nodes to be processed. If this
 				 * is non-zero when Job_Empty() returns
 				 * TRUE, there's a cycle in the graph */
 
+/*
+ * With -T, jobs are started in order of their priority: the longest time
+ * from starting the job to finishing everything that must wait for it,
+ * judged by how long each job took before. The durations are kept in
+ * timesFile, which is shared by makes in all directories, so targets are
+ * known by their absolute names.
+ */
+#define MAKE_TIMES_MAGIC    "pmake-times 1"
+#define MAKE_TIMES_LINE	    1024    /* Longest line in timesFile */
+
+static char 	*makeCwd;   	/* Directory in which we were started */
+static Hash_Table makeTimes;	/* Known durations (ms), by absolute name */
+static Hash_Table makeNewTimes;	/* Durations measured this run */
+static Boolean	makeTimesLoaded;/* TRUE once timesFile has been read */
+static long 	makeTimeGuess;	/* Duration assumed for a target with
+				 * commands that hasn't been timed: the
+				 * mean of the known durations */
+
 /*********************prototypes for static routines******************/
 static int	MakeAddChild(GNode *gn, Lst l);
 static int	MakeAddAllSrc(GNode *cgn, GNode *pgn);
 
-#if defined(unix) || defined (_WIN32)
+#if defined(unix) || defined (_WIN32) || defined(_LINUX)
+static long	MakePriority(GNode *gn);
+static GNode	*MakeNextNode(void);
 static Boolean	MakeStartJobs(void);
 #endif /* defined(unix) */
 
@@ -80,6 +119,12 @@ static Boolean	MakeStartLowlyDosWorldJobs(void);
 #endif /* defined(_MSDOS) */
 
 static int	MakePrintStatus(GNode *gn, Boolean cycle);
+static char	*MakeTimeKey(GNode *gn);
+static void	MakeReadTimes(void);
+static void	MakeSaveTimes(void);
+static void	MakeNoteTime(GNode *gn);
+static GNode	*MakeLastFinished(Lst l, GNode *gn, Lst seen, GNode *next);
+static void	MakePrintCriticalPath(Lst targs);
 
 /*-
  *-----------------------------------------------------------------------
@@ -242,6 +287,17 @@ Make_OODate (register GNode *gn)
 #endif /* defined(_WIN32) */
     }
 
+    /*
+     * An out-of-date .CACHE target whose file, for the same commands and
+     * sources, is in the cache needn't be remade, just copied back.
+     */
+    if (oodate && Cache_Restore(gn)) {
+	if (DEBUG(MAKE)) {
+	    printf("restored from cache...");
+	}
+	oodate = FALSE;
+    }
+
     /*
      * If the target isn't out-of-date, the parents need to know its
      * modification time. Note that targets that appear to be out-of-date
@@ -391,12 +447,22 @@ Make_Update (register GNode *cgn)
     register LstNode	ln; 	/* Element in parents and iParents lists */
 
     cname = Var_Value (TARGET, cgn);
+    cgn->endTime = Make_Clock();
 
     /*
      * If the child was actually made, see what its modification time is
      * now -- some rules won't actually update the file. If the file still
      * doesn't exist, make its mtime now.
      */
+    if (cgn->made == MADE && cgn->startTime >= 0 && timesFile != NULL &&
+	!noExecute && !touchFlag)
+    {
+	MakeNoteTime(cgn);
+    }
+    if (cgn->made == MADE && cacheDir != NULL) {
+	Cache_Save(cgn);
+    }
+
     if (cgn->made != UPTODATE) {
 #if !defined(RECHECK)
 	/*
@@ -617,8 +683,546 @@ Make_DoAllVar (GNode *gn)
     }
 
 }
+
+/***********************************************************************
+ *				Make_Clock
+ ***********************************************************************
+ * SYNOPSIS:	    Return the current time in milliseconds, for timing
+ *		    jobs.
+ * CALLED BY:	    (EXTERNAL) MakeStartJobs, Make_Update
+ * RETURN:	    milliseconds since the first call
+ * SIDE EFFECTS:    the base time is recorded on the first call
+ *
+ * STRATEGY:	    Counting from the first call keeps the value well
+ *		    within a long.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+long
+Make_Clock(void)
+{
+#if defined(_WIN32)
+    static DWORD    base;
+    static Boolean  haveBase = FALSE;
+    DWORD   	    ticks = GetTickCount();
+
+    if (!haveBase) {
+	base = ticks;
+	haveBase = TRUE;
+    }
+    return ((long)(ticks - base));
+#elif defined(unix) || defined(_LINUX)
+    static long	    base = -1;
+    struct timeval  tv;
+
+    gettimeofday(&tv, (struct timezone *)NULL);
+    if (base < 0) {
+	base = tv.tv_sec;
+    }
+    return ((tv.tv_sec - base) * 1000 + tv.tv_usec / 1000);
+#else
+    static time_t   base = -1;
+    time_t  	    t = time((time_t *)NULL);
+
+    if (base < 0) {
+	base = t;
+    }
+    return ((long)(t - base) * 1000);
+#endif /* defined(_WIN32) */
+}
+
+/***********************************************************************
+ *				Make_AbsName
+ ***********************************************************************
+ * SYNOPSIS:	    Return the absolute form of a file name given on the
+ *		    command line, so makes in other directories can be
+ *		    given the same file through MAKEFLAGS.
+ * CALLED BY:	    (EXTERNAL) MainParseArgs
+ * RETURN:	    the absolute name, in malloc'd memory
+ * SIDE EFFECTS:    makeCwd is set
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+char *
+Make_AbsName(char *name)
+{
+    char    cwd[MAKE_TIMES_LINE];
+    char    *result;
+
+    if (makeCwd == NULL) {
+#if defined(unix) || defined(_WIN32) || defined(_LINUX)
+	if (getcwd(cwd, sizeof(cwd)) == NULL) {
+	    strcpy(cwd, ".");
+	}
+#else
+	strcpy(cwd, ".");
+#endif /* defined(unix) || defined(_WIN32) || defined(_LINUX) */
+	makeCwd = Str_New(cwd);
+    }
+    if (IS_PATHSEP(name[0])
+#if defined(_WIN32)
+	|| (name[0] != '\0' && name[1] == ':')
+#endif /* defined(_WIN32) */
+	)
+    {
+	return (Str_New(name));
+    }
+    MallocCheck(result, strlen(makeCwd) + 1 + strlen(name) + 1);
+    sprintf(result, "%s/%s", makeCwd, name);
+    return (result);
+}
+
+/***********************************************************************
+ *				MakeTimeKey
+ ***********************************************************************
+ * SYNOPSIS:	    Form the name under which a target's duration is
+ *		    recorded.
+ * CALLED BY:	    (INTERNAL) MakePriority, MakeNoteTime
+ * RETURN:	    the name, which the caller must free
+ * SIDE EFFECTS:    none
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static char *
+MakeTimeKey(GNode *gn)
+{
+    char    *key;
+
+    if (IS_PATHSEP(gn->name[0])) {
+	return (Str_New(gn->name));
+    }
+    MallocCheck(key, strlen(makeCwd) + 1 + strlen(gn->name) + 1);
+    sprintf(key, "%s/%s", makeCwd, gn->name);
+    return (key);
+}
+
+/***********************************************************************
+ *				MakeReadTimes
+ ***********************************************************************
+ * SYNOPSIS:	    Read the durations recorded in timesFile into
+ *		    makeTimes.
+ * CALLED BY:	    (INTERNAL) MakePriority, MakeSaveTimes
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    makeTimes and makeTimeGuess are updated
+ *
+ * STRATEGY:	    The file holds a line with the magic string, then a
+ *		    line for each target:
+ *			<milliseconds> <absolute target name>
+ *		    A missing or damaged file simply leaves us without
+ *		    (some) durations.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+MakeReadTimes(void)
+{
+    FILE    *f;
+    char    line[MAKE_TIMES_LINE];
+    long    total = 0;
+    int	    count = 0;
+
+    if (!makeTimesLoaded) {
+#if !defined(__HIGHC__) && !defined(__WATCOMC__)
+	Hash_InitTable(&makeTimes, 0, HASH_STRING_KEYS);
+	Hash_InitTable(&makeNewTimes, 0, HASH_STRING_KEYS);
+#else
+	Hash_InitTable(&makeTimes, 0, HASH_STRING_KEYS, 0);
+	Hash_InitTable(&makeNewTimes, 0, HASH_STRING_KEYS, 0);
+#endif
+	makeTimesLoaded = TRUE;
+    }
+
+    f = fopen(timesFile, "r");
+    if (f == NULL) {
+	return;
+    }
+    if (fgets(line, sizeof(line), f) == NULL ||
+	strncmp(line, MAKE_TIMES_MAGIC, sizeof(MAKE_TIMES_MAGIC)-1) != 0)
+    {
+	fclose(f);
+	return;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+	Hash_Entry  *he;
+	Boolean	    new;
+	long	    ms;
+	int 	    len, n;
+
+	len = strlen(line);
+	if (len == 0 || line[len-1] != '\n' ||
+	    sscanf(line, "%ld %n", &ms, &n) != 1 || ms < 0)
+	{
+	    break;
+	}
+	line[len-1] = '\0';
+	he = Hash_CreateEntry(&makeTimes, (Address)&line[n], &new);
+	Hash_SetValue(he, ms);
+	total += ms;
+	count += 1;
+    }
+    fclose(f);
+
+    if (count != 0) {
+	makeTimeGuess = total / count;
+    }
+}
+
+/***********************************************************************
+ *				MakeNoteTime
+ ***********************************************************************
+ * SYNOPSIS:	    Record how long a target's job took.
+ * CALLED BY:	    (INTERNAL) Make_Update
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the duration goes in makeNewTimes
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+MakeNoteTime(GNode *gn)
+{
+    Hash_Entry	*he;
+    Boolean 	new;
+    char    	*key;
+
+    if (!makeTimesLoaded) {
+	MakeReadTimes();
+    }
+    key = MakeTimeKey(gn);
+    he = Hash_CreateEntry(&makeNewTimes, (Address)key, &new);
+    Hash_SetValue(he, Make_Clock() - gn->startTime);
+    free(key);
+}
+
+/***********************************************************************
+ *				MakeSaveTimes
+ ***********************************************************************
+ * SYNOPSIS:	    Write the durations measured this run to timesFile.
+ * CALLED BY:	    (INTERNAL) Make_Run
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    timesFile is replaced
+ *
+ * STRATEGY:	    Makes in other directories may have written the file
+ *		    since we read it, so it's read again and our
+ *		    durations laid over what's there. The result goes to
+ *		    a file of our own that is then renamed over timesFile,
+ *		    so the file is never seen half-written.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+MakeSaveTimes(void)
+{
+    Hash_Search	search;
+    Hash_Entry	*he;
+    FILE    	*f;
+    char    	*tmp;
+    Boolean 	ok;
+
+    if (!makeTimesLoaded || makeNewTimes.numEntries == 0) {
+	return;
+    }
+
+    MakeReadTimes();
+    for (he = Hash_EnumFirst(&makeNewTimes, &search);
+	 he != (Hash_Entry *)NULL;
+	 he = Hash_EnumNext(&search))
+    {
+	Boolean	new;
+
+	Hash_SetValue(Hash_CreateEntry(&makeTimes, he->key.name, &new),
+		      Hash_GetValue(he));
+    }
+
+    MallocCheck(tmp, strlen(timesFile) + 16);
+    sprintf(tmp, "%s.%d", timesFile, (int)getpid());
+    f = fopen(tmp, "w");
+    if (f == NULL) {
+	free(tmp);
+	return;
+    }
+    fprintf(f, "%s\n", MAKE_TIMES_MAGIC);
+    for (he = Hash_EnumFirst(&makeTimes, &search);
+	 he != (Hash_Entry *)NULL;
+	 he = Hash_EnumNext(&search))
+    {
+	if (strchr(he->key.name, '\n') == NULL) {
+	    fprintf(f, "%ld %s\n", (long)Hash_GetValue(he), he->key.name);
+	}
+    }
+    ok = !ferror(f);
+    if (fclose(f) != 0) {
+	ok = FALSE;
+    }
+#if defined(_WIN32)
+    if (ok) {
+	(void)unlink(timesFile);
+    }
+#endif /* defined(_WIN32) */
+    if (!ok || rename(tmp, timesFile) < 0) {
+	(void)unlink(tmp);
+    }
+    free(tmp);
+}
 
+/***********************************************************************
+ *				MakeLastFinished
+ ***********************************************************************
+ * SYNOPSIS:	    Find which node in a list of a node's children or
+ *		    predecessors was finished last.
+ * CALLED BY:	    (INTERNAL) MakePrintCriticalPath
+ * RETURN:	    the node, or next if none in the list finished later
+ * SIDE EFFECTS:    none
+ *
+ * Arguments:
+ *      Lst   l	    : The children or predecessors of gn
+ *      GNode *gn   : The node being held up
+ *      Lst   seen  : Nodes already on the path, in case of cycles
+ *      GNode *next : The latest found so far, or NILGNODE
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static GNode *
+MakeLastFinished(Lst l, GNode *gn, Lst seen, GNode *next)
+{
+    LstNode 	ln;
+
+    for (ln = Lst_First(l); ln != NILLNODE; ln = Lst_Succ(ln)) {
+	GNode	*cgn = (GNode *)Lst_Datum(ln);
+
+	if (cgn->make && cgn->endTime >= 0 && cgn->endTime <= gn->endTime &&
+	    (next == NILGNODE || cgn->endTime > next->endTime) &&
+	    Lst_Member(seen, (ClientData)cgn) == NILLNODE)
+	{
+	    next = cgn;
+	}
+    }
+    return (next);
+}
+
+/***********************************************************************
+ *				MakePrintCriticalPath
+ ***********************************************************************
+ * SYNOPSIS:	    Print the chain of jobs that determined how long the
+ *		    make took.
+ * CALLED BY:	    (INTERNAL) Make_Run
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:	    Start from the target finished last. The thing that
+ *		    held up each node is whichever of its children and
+ *		    predecessors was finished last, so follow those down
+ *		    until a node with none is reached. The jobs along the
+ *		    way are the critical path: shortening anything else
+ *		    won't make the make any quicker.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+MakePrintCriticalPath(Lst targs)
+{
+    Lst	    	path;	    /* Nodes with jobs on the path */
+    Lst	    	seen;	    /* All nodes on the path */
+    LstNode 	ln;
+    GNode   	*gn;
+    long    	total;
+    long    	elapsed;
+
+    gn = NILGNODE;
+    for (ln = Lst_First(targs); ln != NILLNODE; ln = Lst_Succ(ln)) {
+	GNode	*tgn = (GNode *)Lst_Datum(ln);
+
+	if (gn == NILGNODE || tgn->endTime > gn->endTime) {
+	    gn = tgn;
+	}
+    }
+    if (gn == NILGNODE || gn->endTime < 0) {
+	return;
+    }
+
+    path = Lst_Init(FALSE);
+    seen = Lst_Init(FALSE);
+    total = 0;
+    while (gn != NILGNODE) {
+	(void)Lst_AtEnd(seen, (ClientData)gn);
+	if (gn->startTime >= 0) {
+	    (void)Lst_AtFront(path, (ClientData)gn);
+	    total += gn->endTime - gn->startTime;
+	}
+	gn = MakeLastFinished(gn->preds, gn, seen,
+			      MakeLastFinished(gn->children, gn, seen,
+					       NILGNODE));
+    }
+
+    elapsed = Make_Clock();
+    printf("*** Critical path: %ld.%ld s of jobs in %ld.%ld s\n",
+	   total / 1000, (total % 1000) / 100,
+	   elapsed / 1000, (elapsed % 1000) / 100);
+    for (ln = Lst_First(path); ln != NILLNODE; ln = Lst_Succ(ln)) {
+	long	ms;
+
+	gn = (GNode *)Lst_Datum(ln);
+	ms = gn->endTime - gn->startTime;
+	printf("\t%6ld.%ld s  %s\n", ms / 1000, (ms % 1000) / 100, gn->name);
+    }
+    fflush(stdout);
+    Lst_Destroy(path, NOFREE);
+    Lst_Destroy(seen, NOFREE);
+}
+
 #if defined(unix) || defined (_WIN32) || defined(_LINUX)
+/***********************************************************************
+ *				MakePriority
+ ***********************************************************************
+ * SYNOPSIS:	    Figure the priority of a node: the longest time from
+ *		    starting it to finishing all the nodes that must wait
+ *		    for it.
+ * CALLED BY:	    (INTERNAL) MakeNextNode, MakePriority
+ * RETURN:	    the priority, in milliseconds
+ * SIDE EFFECTS:    the priority is stored in the node, as are those of
+ *		    the nodes above it
+ *
+ * STRATEGY:	    The node's own duration is what it took last time, or
+ *		    makeTimeGuess if it has commands but has never been
+ *		    timed. To that is added the largest priority of the
+ *		    parents and successors that are being made. A node
+ *		    reached again while its priority is being figured is
+ *		    on a cycle and counts as nothing.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static long
+MakePriority(GNode *gn)
+{
+    Hash_Entry	*he;
+    LstNode 	ln;
+    long    	best;
+    long    	own;
+    char    	*key;
+
+    if (gn->priority >= 0) {
+	return (gn->priority);
+    } else if (gn->priority == -2) {
+	return (0);
+    }
+    gn->priority = -2;
+
+    best = 0;
+    for (ln = Lst_First(gn->parents); ln != NILLNODE; ln = Lst_Succ(ln)) {
+	GNode	*pgn = (GNode *)Lst_Datum(ln);
+
+	if (pgn->make && MakePriority(pgn) > best) {
+	    best = pgn->priority;
+	}
+    }
+    for (ln = Lst_First(gn->successors); ln != NILLNODE; ln = Lst_Succ(ln)) {
+	GNode	*sgn = (GNode *)Lst_Datum(ln);
+
+	if (sgn->make && MakePriority(sgn) > best) {
+	    best = sgn->priority;
+	}
+    }
+
+    if (!makeTimesLoaded) {
+	MakeReadTimes();
+    }
+    key = MakeTimeKey(gn);
+    he = Hash_FindEntry(&makeTimes, (Address)key);
+    free(key);
+    if (he != (Hash_Entry *)NULL) {
+	own = (long)Hash_GetValue(he);
+    } else if (Lst_IsEmpty(gn->commands)) {
+	own = 0;
+    } else {
+	own = makeTimeGuess;
+    }
+
+    gn->priority = best + own;
+    return (gn->priority);
+}
+
+/***********************************************************************
+ *				MakeNextNode
+ ***********************************************************************
+ * SYNOPSIS:	    Take the next node to examine from toBeMade.
+ * CALLED BY:	    (INTERNAL) MakeStartJobs
+ * RETURN:	    the node
+ * SIDE EFFECTS:    the node is removed from toBeMade
+ *
+ * STRATEGY:	    Without -T, the queue is first-come-first-served.
+ *		    With it, the node with the highest priority is taken,
+ *		    the earliest queued winning any tie, so the longest
+ *		    chains of work get going first and don't leave the
+ *		    end of the make waiting on one long job.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static GNode *
+MakeNextNode(void)
+{
+    LstNode 	ln;
+    LstNode 	best;
+    long    	bestPri;
+    GNode   	*gn;
+
+    if (timesFile == NULL) {
+	return ((GNode *)Lst_DeQueue(toBeMade));
+    }
+
+    best = NILLNODE;
+    bestPri = -1;
+    for (ln = Lst_First(toBeMade); ln != NILLNODE; ln = Lst_Succ(ln)) {
+	long	pri = MakePriority((GNode *)Lst_Datum(ln));
+
+	if (pri > bestPri) {
+	    best = ln;
+	    bestPri = pri;
+	}
+    }
+    gn = (GNode *)Lst_Datum(best);
+    (void)Lst_Remove(toBeMade, best);
+    return (gn);
+}
+
 /*-
  *-----------------------------------------------------------------------
  * MakeStartJobs --
@@ -641,7 +1245,7 @@ MakeStartJobs (void)
     register GNode	*gn;
 
     while (!Job_Full() && !Lst_IsEmpty (toBeMade)) {
-	gn = (GNode *) Lst_DeQueue (toBeMade);
+	gn = MakeNextNode();
 	if (DEBUG(MAKE)) {
 	    printf ("Examining %s...", gn->name);
 	}
@@ -682,6 +1286,7 @@ MakeStartJobs (void)
 		return (TRUE);
 	    }
 	    Make_DoAllVar (gn);
+	    gn->startTime = Make_Clock();
 	    Job_Make (gn);
 	} else {
 	    if (DEBUG(MAKE)) {
@@ -894,6 +1499,7 @@ Make_Run (Lst targs)
 
 
     toBeMade = Lst_Init (FALSE);
+    (void)Make_Clock();	    	/* Start the clock for timing jobs */
 
     examine = Lst_Duplicate(targs, NOCOPY);
     numNodes = 0;
@@ -980,6 +1586,12 @@ Make_Run (Lst targs)
 	(void)MakeStartJobs();
     }
     errors = Job_End();
+    if (timesFile != NULL) {
+	MakeSaveTimes();
+    }
+    if (traceFile != NULL) {
+	MakePrintCriticalPath(targs);
+    }
 #else /* MSDOS */
     /*
      * since running many jobs isn't an option, we just go through
@@ -125,6 +125,16 @@ typedef struct GNode {
     long             mtime;     	/* Its modification time */
     long       	    cmtime;    	/* The modification time of its youngest
 				 * child */
+    long    	    startTime;	/* Make_Clock when its job was started, or
+				 * -1 if none has been */
+    long    	    endTime;	/* Make_Clock when it was finished with, or
+				 * -1 if it hasn't been */
+    long    	    priority;	/* With -T, the longest time (ms) from
+				 * starting it to finishing everything that
+				 * must wait for it, or -1 if not yet
+				 * figured */
+    char    	    *cacheKey;	/* With -A, the key under which its file
+				 * is filed in the cache, or NULL */
 
     Lst     	    iParents;  	/* Links to parents for which this is an
 				 * implied source, if any */
@@ -194,6 +204,8 @@ typedef struct GNode {
 				     * target' processing in parse.c */
 /*XXX*/
 #define OP_M68020   	0x00010000  /* Command must be run on a 68020 */
+#define OP_CACHE	0x00020000  /* Target's file may be saved in and
+				     * restored from the cache (-A) */
 /* Attributes applied by PMake */
 #define OP_TRANSFORM	0x80000000  /* The node is a transformation rule */
 #define OP_MEMBER 	0x40000000  /* Target is a member of an archive */
@@ -330,6 +342,12 @@ extern char    	var_Error[];   	/* Value returned by Var_Parse when an error
 
 extern time_t 	now;	    	/* The time at the start of this whole
 				 * process */
+extern char    	*timesFile; 	/* File holding the durations of jobs from
+				 * earlier runs (-T), or NULL */
+extern char    	*traceFile; 	/* File to which a timeline of the jobs
+				 * is written (-O), or NULL */
+extern char    	*cacheDir;  	/* Directory holding the files of .CACHE
+				 * targets (-A), or NULL */
 
 /*
  * Three levels of compatibility. amMake incorporates backwards and oldVars,
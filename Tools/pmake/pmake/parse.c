@@ -204,6 +204,7 @@ static struct {
     int	    	  op;	    	/* Operator when used as a source */
 } parseKeywords[] = {
 { ".BEGIN", 	  Begin,    	0 },
+{ ".CACHE",	  Attribute,   	OP_CACHE },
 { ".DEFAULT",	  Default,  	0 },
 { ".DONTCARE",	  Attribute,   	OP_DONTCARE },
 { ".END",   	  End,	    	0 },
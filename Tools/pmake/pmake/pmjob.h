@@ -81,6 +81,9 @@ typedef struct Job {
     GNode               *node;       /* The target the child is making */
     LstNode              tailCmds;   /* The node of the first command to be
 				      * saved when the job has been run */
+    double               traceStart; /* When the shell was started, in
+				      * microseconds since 1970 (-O) */
+    int                  traceRow;   /* Row of the timeline it's shown in */
 #if defined(unix) || defined(_LINUX)
     FILE                *cmdFILE;    /* When creating the shell script, this is
 				      * where the commands go */
@@ -60,6 +60,12 @@ extern  char *          getenv(const char *__name);
 
 #endif /*!defined(unix)*/
 
+/*********************************************************************
+  	    	    	CACHE MODULE
+**********************************************************************/
+extern Boolean	Cache_Restore (GNode *gn);
+extern void	Cache_Save (GNode *gn);
+
 /*********************************************************************
   	    	    	COMPAT MODULE
 **********************************************************************/
@@ -90,6 +96,7 @@ extern void	    Dir_ClearPath        (Lst path);
 extern void	    Dir_Concat           (Lst path1, Lst path2);
 extern void	    Dir_PrintDirectories (void);
 extern void	    Dir_PrintPath        (Lst path);
+extern void	    Dir_SaveCache        (void);
 
 
 /*********************************************************************
@@ -101,6 +108,8 @@ extern void	    Make_Update    (register GNode *cgn);
 extern void	    Make_DoAllVar  (GNode *gn);
 extern Boolean	    Make_Run       (Lst targs);
 extern int	    Make_HandleUse (register GNode *cgn, register GNode *pgn);
+extern long	    Make_Clock     (void);
+extern char	   *Make_AbsName   (char *name);
 
 /*********************************************************************
 			PARSE MODULE
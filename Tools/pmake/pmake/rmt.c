@@ -478,7 +478,9 @@ Rmt_Signal(job, signo)
     bzero(&server, sizeof(server));
     server.sin_family =     AF_INET;
     server.sin_addr = 	    pdata->permit.addr;
-    server.sin_port = 	    customs_AgentAddr.sin_port;
+    server.sin_port = 	    (pdata->permit.port != 0 ?
+			     pdata->permit.port :
+			     customs_AgentAddr.sin_port);
 
     packet.id =     	    pdata->permit.id;
     packet.signo =  	    signo;
@@ -136,6 +136,8 @@ Targ_NewGN (char *name)
     gn->made = 	    	UNMADE;
     gn->childMade = 	FALSE;
     gn->mtime = gn->cmtime = 0;
+    gn->startTime = gn->endTime = gn->priority = -1;
+    gn->cacheKey =  	NULL;
     gn->iParents =  	Lst_Init (FALSE);
     gn->cohorts =   	Lst_Init (FALSE);
     gn->parents =   	Lst_Init (FALSE);
@@ -49,6 +49,15 @@
  *	    	  	    context.
  *
  * XXX: There's a lot of duplication in these functions.
+ *
+ * The VAR_GLOBAL and VAR_CMD contexts, which hold nearly all the variables,
+ * are indexed by hash tables as well as being kept on their context lists.
+ * Targets' contexts hold only the handful of local variables, so they're
+ * just searched.
+ *
+ * The expanded value of a global or command-line variable is remembered
+ * when the expansion involved only other global or command-line variables,
+ * and reused until any global or command-line variable changes.
  */
 #include <config.h>
 
@@ -66,6 +75,7 @@ static char     *rcsid = "$Id: var.c,v 1.7 96/06/24 15:07:50 tbradley Exp $ SPRI
 #include    <compat/string.h>
 
 #include    "make.h"
+#include    "hash.h"
 #include    "buf.h"
 
 #if !defined(__WATCOMC__)
@@ -79,6 +89,11 @@ typedef Boolean VarModifyCallback(char *, Boolean, Buffer, ClientData);
 typedef struct Var {
     char          *name;	/* the variable's name */
     Buffer	  val;	    	/* its value */
+    char    	  *exp;	    	/* remembered expansion of val, if any */
+    unsigned long expGen;   	/* varGeneration when exp was formed */
+    Boolean	  expGlobal;	/* TRUE if exp was formed in VAR_GLOBAL,
+				 * where globals hide command-line
+				 * variables rather than the reverse */
     int	    	  flags;    	/* miscellaneous status flags */
 #define VAR_IN_USE	1   	    /* Variable's value currently being used.
 				     * Used to avoid recursion */
@@ -87,6 +102,8 @@ typedef struct Var {
 				     * should be destroyed when done with
 				     * it. Used by Var_Parse for undefined,
 				     * modified variables */
+#define VAR_SHARED	8   	    /* Variable is in VAR_GLOBAL or VAR_CMD, so
+				     * its expansion may be remembered */
 }  Var;
 
 typedef struct {
@@ -105,6 +122,7 @@ typedef struct {
 /***********************protoypes for static routines**********************/
 static Var	*VarAlloc      (char *name);
 static int	 VarCmp        (Var *v, char *name);
+static Var	*VarLookup     (char *name, GNode *ctxt);
 static Var	*VarFind       (char *name, GNode *ctxt, int flags);
 static void	 VarAdd        (char *name, char *val, GNode *ctxt);
 static Boolean	 VarHead       (char *myword, Boolean addSpace, Buffer buf,
@@ -162,6 +180,28 @@ GNode          *VAR_CMD;      /* variables defined on the command-line */
 #define FIND_GLOBAL	0x2   /* look in VAR_GLOBAL as well */
 #define FIND_ENV  	0x4   /* look in the environment also */
 
+static Hash_Table   varGlobalIndex; /* Variables in VAR_GLOBAL, by name */
+static Hash_Table   varCmdIndex;    /* Variables in VAR_CMD, by name */
+
+#define VarIndex(ctxt) \
+    ((ctxt) == VAR_GLOBAL ? &varGlobalIndex : \
+     ((ctxt) == VAR_CMD ? &varCmdIndex : (Hash_Table *)NULL))
+
+/*
+ * varGeneration changes whenever a variable in VAR_GLOBAL or VAR_CMD does,
+ * invalidating all remembered expansions. varLocalRefs is bumped whenever
+ * VarFind produces a result that could differ from one target to another
+ * (a local variable, an environment variable or an undefined one), so
+ * Var_Parse can tell if an expansion may be remembered.
+ */
+static unsigned long	varGeneration = 1;
+static unsigned long	varLocalRefs = 0;
+static int  	    	varExpHits = 0;
+static int  	    	varExpMisses = 0;
+
+#define VarChanged(ctxt) \
+    if ((ctxt) == VAR_GLOBAL || (ctxt) == VAR_CMD) varGeneration++
+
 
 /*-
  *-----------------------------------------------------------------------
@@ -187,6 +227,9 @@ VarAlloc(char *name)
     strcpy(v->name, name);
     v->flags = 0;
     v->val = (Buffer)0;
+    v->exp = (char *)NULL;
+    v->expGen = 0;
+    v->expGlobal = FALSE;
 
     return(v);
 }
@@ -213,6 +256,36 @@ VarCmp (Var *v, char *name)
 {
     return (strcmp (name, v->name));
 }
+
+/*-
+ *-----------------------------------------------------------------------
+ * VarLookup --
+ *	Find a variable in a single context, using the index for the
+ *	VAR_GLOBAL and VAR_CMD contexts.
+ *
+ * Results:
+ *	The Var structure, or NIL if it's not in the context.
+ *
+ * Side Effects:
+ *	None
+ *-----------------------------------------------------------------------
+ */
+static Var *
+VarLookup (char *name, GNode *ctxt)
+{
+    Hash_Table	*index = VarIndex(ctxt);
+    LstNode 	ln;
+
+    if (index != (Hash_Table *)NULL) {
+	Hash_Entry  *he = Hash_FindEntry(index, (Address)name);
+
+	return ((he == (Hash_Entry *)NULL) ? (Var *)NIL :
+		(Var *)Hash_GetValue(he));
+    }
+
+    ln = Lst_Find (ctxt->context, (ClientData)name, VarCmp);
+    return ((ln == NILLNODE) ? (Var *)NIL : (Var *)Lst_Datum(ln));
+}
 
 /*-
  *-----------------------------------------------------------------------
@@ -239,7 +312,6 @@ VarCmp (Var *v, char *name)
 static Var *
 VarFind (char *name, GNode *ctxt, int flags)
 {
-    LstNode         	var;
     Var		  	*v;
 
     /*
@@ -266,22 +338,33 @@ VarFind (char *name, GNode *ctxt, int flags)
 	}	    
     }
 
+    /*
+     * The local variables have single-character names. Whatever becomes
+     * of the search, the result depends on the target.
+     */
+    if (name[0] != '\0' && name[1] == '\0' && strchr("@?><*!%", name[0])) {
+	varLocalRefs++;
+    }
+
     /*
      * First look for the variable in the given context. If it's not there,
      * look for it in VAR_CMD, VAR_GLOBAL and the environment, in that order,
      * depending on the FIND_* flags in 'flags'
      */
-    var = Lst_Find (ctxt->context, (ClientData)name, VarCmp);
+    v = VarLookup (name, ctxt);
 
-    if ((var == NILLNODE) && (flags & FIND_CMD) && (ctxt != VAR_CMD)) {
-	var = Lst_Find (VAR_CMD->context, (ClientData)name, VarCmp);
+    if ((v != (Var *)NIL) && !(v->flags & VAR_SHARED)) {
+	varLocalRefs++;
     }
-    if (!checkEnvFirst && (var == NILLNODE) && (flags & FIND_GLOBAL) &&
+    if ((v == (Var *)NIL) && (flags & FIND_CMD) && (ctxt != VAR_CMD)) {
+	v = VarLookup (name, VAR_CMD);
+    }
+    if (!checkEnvFirst && (v == (Var *)NIL) && (flags & FIND_GLOBAL) &&
 	(ctxt != VAR_GLOBAL))
     {
-	var = Lst_Find (VAR_GLOBAL->context, (ClientData)name, VarCmp);
+	v = VarLookup (name, VAR_GLOBAL);
     }
-    if ((var == NILLNODE) && (flags & FIND_ENV)) {
+    if ((v == (Var *)NIL) && (flags & FIND_ENV)) {
 	char *env;
         if ((env = getenv(name)) != NULL) {
 	    /*
@@ -302,23 +385,27 @@ VarFind (char *name, GNode *ctxt, int flags)
 	    Buf_AddBytes(v->val, len, (Byte *)env);
 	    
 	    v->flags = VAR_FROM_ENV;
+	    varLocalRefs++;
 	    return (v);
 	} else if (checkEnvFirst && (flags & FIND_GLOBAL) &&
 		   (ctxt != VAR_GLOBAL))
 	{
-	    var = Lst_Find (VAR_GLOBAL->context, (ClientData)name, VarCmp);
-	    if (var == NILLNODE) {
-		return ((Var *) NIL);
-	    } else {
-		return ((Var *)Lst_Datum(var));
-	    }
+	    /*
+	     * The environment may yet change to hide this one, so it's
+	     * not a sure thing either.
+	     */
+	    v = VarLookup (name, VAR_GLOBAL);
+	    varLocalRefs++;
+	    return (v);
 	} else {
+	    varLocalRefs++;
 	    return((Var *)NIL);
 	}
-    } else if (var == NILLNODE) {
+    } else if (v == (Var *)NIL) {
+	varLocalRefs++;
 	return ((Var *) NIL);
     } else {
-	return ((Var *) Lst_Datum (var));
+	return (v);
     }
 }
 
@@ -356,6 +443,14 @@ VarAdd (char *name, char *val, GNode *ctxt)
     v->flags = 0;
 
     (void) Lst_AtFront (ctxt->context, (ClientData)v);
+    if (VarIndex(ctxt) != (Hash_Table *)NULL) {
+	Boolean	    new;
+
+	Hash_SetValue(Hash_CreateEntry(VarIndex(ctxt), (Address)name, &new),
+		      v);
+	v->flags |= VAR_SHARED;
+	VarChanged(ctxt);
+    }
     if (DEBUG(VAR)) {
 	printf("%s:%s = %s\n", ctxt->name, name, val);
     }
@@ -388,7 +483,15 @@ Var_Delete(char *name, GNode *ctxt)
 
 	v = (Var *)Lst_Datum(ln);
 	Lst_Remove(ctxt->context, ln);
+	if (VarIndex(ctxt) != (Hash_Table *)NULL) {
+	    Hash_DeleteEntry(VarIndex(ctxt),
+			     Hash_FindEntry(VarIndex(ctxt), (Address)name));
+	    VarChanged(ctxt);
+	}
 	Buf_Destroy(v->val, TRUE);
+	if (v->exp != (char *)NULL) {
+	    free(v->exp);
+	}
 	free((char *)v);
     }
 }
@@ -493,6 +596,7 @@ Var_Set (char *name, char *val, GNode *ctxt)
     } else {
 	Buf_Discard(v->val, Buf_Size(v->val));
 	Buf_AddBytes(v->val, strlen(val), (Byte *)val);
+	VarChanged(ctxt);
 
 	if (DEBUG(VAR)) {
 	    printf("%s:%s = %s\n", ctxt->name, name, val);
@@ -659,6 +763,7 @@ Var_Append (char *name, char *val, GNode *ctxt)
     } else {
 	Buf_AddByte(v->val, (Byte)' ');
 	Buf_AddBytes(v->val, strlen(val), (Byte *)val);
+	VarChanged(ctxt);
 
 	if (DEBUG(VAR)) {
 	    printf("%s:%s = %s\n", ctxt->name, name,
@@ -674,6 +779,14 @@ Var_Append (char *name, char *val, GNode *ctxt)
 	     */
 	    v->flags &= ~VAR_FROM_ENV;
 	    Lst_AtFront(ctxt->context, (ClientData)v);
+	    if (VarIndex(ctxt) != (Hash_Table *)NULL) {
+		Boolean	new;
+
+		Hash_SetValue(Hash_CreateEntry(VarIndex(ctxt), (Address)name,
+					       &new),
+			      v);
+		v->flags |= VAR_SHARED;
+	    }
 	}
     }
 }
@@ -1625,7 +1738,35 @@ Var_Parse (char *str, GNode *ctxt, Boolean err, int *lengthPtr,
      */
     str = (char *)Buf_GetAll(v->val, (int *)NULL);
     if (strchr (str, '$') != (char *)NULL) {
-	str = Var_Subst(str, ctxt, err);
+	if ((v->flags & VAR_SHARED) && (v->exp != (char *)NULL) &&
+	    (v->expGen == varGeneration) &&
+	    (v->expGlobal == (ctxt == VAR_GLOBAL)))
+	{
+	    varExpHits++;
+	    str = Str_New(v->exp);
+	} else {
+	    unsigned long   refs = varLocalRefs;
+
+	    str = Var_Subst(str, ctxt, err);
+	    varExpMisses++;
+
+	    /*
+	     * If nothing in the expansion depended on the target, the
+	     * result will be the same for every target until a global
+	     * or command-line variable changes, so remember it. VarFind
+	     * searches VAR_GLOBAL before VAR_CMD when expanding in the
+	     * global context and after it everywhere else, so the
+	     * expansion is only good for the same kind of context.
+	     */
+	    if ((v->flags & VAR_SHARED) && (refs == varLocalRefs)) {
+		if (v->exp != (char *)NULL) {
+		    free(v->exp);
+		}
+		v->exp = Str_New(str);
+		v->expGen = varGeneration;
+		v->expGlobal = (ctxt == VAR_GLOBAL);
+	    }
+	}
 	*freePtr = TRUE;
     }
     
@@ -2269,6 +2410,13 @@ Var_Init (void)
 {
     VAR_GLOBAL = Targ_NewGN ("Global");
     VAR_CMD = Targ_NewGN ("Command");
+#if defined(__HIGHC__) || defined(__WATCOMC__)
+    Hash_InitTable(&varGlobalIndex, 256, HASH_STRING_KEYS, 0);
+    Hash_InitTable(&varCmdIndex, 16, HASH_STRING_KEYS, 0);
+#else
+    Hash_InitTable(&varGlobalIndex, 256, HASH_STRING_KEYS);
+    Hash_InitTable(&varCmdIndex, 16, HASH_STRING_KEYS);
+#endif
 
 }
 
@@ -2290,4 +2438,8 @@ void
 Var_Dump (GNode *ctxt)
 {
     Lst_ForEach (ctxt->context, VarPrintVar, (ClientData)0);
+    if (VarIndex(ctxt) != (Hash_Table *)NULL) {
+	printf ("#*** %d expansions remembered, %d formed\n",
+		varExpHits, varExpMisses);
+    }
 }
@@ -21,6 +21,8 @@
  *	Date	  Name	    Description
  *	----	  ----	    -----------
  *	9/30/88	  ardeb	    Initial version
+ *	10/16/26  agent	    Lower simple Tcl breakpoint conditions to stub
+ *	    	    	    criteria
  *
  * DESCRIPTION:
  * 	Breakpoints are registered for a patient on a handle. When a
@@ -153,13 +155,17 @@ fstatic int BreakUninstallBP(BreakPtr bp);
  */
 typedef struct {
     int	    	  	id; 	    	/* ID number */
-    word 	    	user_enabled:1;	/* TRUE if breakpoint enabled by user */
+    word 	    	user_enabled:1,	/* TRUE if breakpoint enabled by user */
+			lowered:1;  	/* TRUE if the breakpoint's criteria
+					 * were derived from its command by
+					 * BreakLowerCommand */
     char    	    	*delcmd;    	/* Command to execute when the
 					 * breakpoint is deleted */
     char		command[LABEL_IN_STRUCT];   	/* Command to execute */
 } TclBreakRec, *TclBreakPtr;
 
 static void CBreakFinishCriteriaChange(BreakPtr bp);
+static void BreakLowerCommand(Tcl_Interp *interp, BreakPtr bp);
 
 
 /***********************************************************************
@@ -2370,10 +2376,14 @@ BreakGetNextTCLId(void)
  *	Else create a TclBreakRec with a single byte at the end and
  *	initialize the command string for the record to be empty.
  *
+ *	Either way, hand the command to BreakLowerCommand in case the
+ *	stub can check some of it for us.
+ *
  * REVISION HISTORY:
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	2/ 8/89		Initial Revision
+ *	agent	10/16/26	Lowers the command to criteria
  *
  ***********************************************************************/
 static Boolean
@@ -2399,9 +2409,15 @@ BreakInit(Tcl_Interp	*interp,
      */
     tbPtr->id = BreakGetNextTCLId();
     tbPtr->user_enabled = TRUE;
+    tbPtr->lowered = FALSE;
     tbPtr->delcmd = NULL;
 
     bp->data = (Opaque)tbPtr;
+
+    /*
+     * See if the stub can weed out the hits the command would reject.
+     */
+    BreakLowerCommand(interp, bp);
     return(TRUE);
 }
 
@@ -2947,6 +2963,923 @@ CBreakFinishCriteriaChange(BreakPtr 	bp)
 	BreakInstallBP(bp);
     }
 }
+
+
+
+/***********************************************************************
+ *				CBreakRemoveCriteria
+ ***********************************************************************
+ * SYNOPSIS:	    Make a conditional breakpoint unconditional again.
+ * CALLED BY:	    BreakCmd
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the breakpoint is reinstalled without criteria and
+ *		    our interest in its handles is withdrawn.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Broke out of BreakCmd
+ *
+ ***********************************************************************/
+static void
+CBreakRemoveCriteria(BreakPtr	bp)
+{
+    int	    i;
+
+    BreakUninstallBP(bp);
+    bp->isCond = FALSE;
+
+    /*
+     * Remove the call to CBreakInterest since breakpoint now
+     * unconditional.
+     */
+    for (i = 0; i < CB_MAX_HANDLES; i++) {
+	if (bp->cb.handles[i].handle != NullHandle) {
+	    Handle_NoInterest(bp->cb.handles[i].handle,
+			      CBreakInterest,
+			      (Opaque)bp);
+	}
+    }
+
+    BreakInstallBP(bp);
+}
+
+/*
+ * Operands BreakLowerOperand knows how to turn into criteria.
+ */
+#define BLO_CONST   	0   	/* Integer constant */
+#define BLO_REG	    	1   	/* [read-reg <reg>] */
+#define BLO_THREAD  	2   	/* [read-reg curThread] */
+#define BLO_WORD    	3   	/* [value fetch <addr> word] */
+#define BLO_SWORD   	4   	/* [value fetch <addr> sword] */
+#define BLO_HANDLE  	5   	/* [handle segment [handle lookup <id>]] */
+
+typedef struct {
+    int	    	kind;	    	/* BLO_* */
+    long    	value;	    	/* Constant or handle ID */
+    char    	name[128];  	/* Register name or address expression */
+} BreakLowerOp;
+
+/*
+ * Relational operators, in the order BreakLowerTerm finds them. Mirrored
+ * gives the operator to use when the operands are swapped.
+ */
+#define BLR_EQ	    0
+#define BLR_NE	    1
+#define BLR_LT	    2
+#define BLR_LE	    3
+#define BLR_GT	    4
+#define BLR_GE	    5
+static const int breakLowerMirror[] = {
+    BLR_EQ, BLR_NE, BLR_GT, BLR_GE, BLR_LT, BLR_LE
+};
+static const char *breakLowerUnsigned[] = {
+    "=", "!=", "<", "<=", ">", ">="
+};
+static const char *breakLowerSigned[] = {
+    "=", "!=", "+<", "+<=", "+>", "+>="
+};
+
+/*
+ * Registers the stub can check. CS is fixed by the breakpoint's address.
+ */
+static const char *breakLowerRegs[] = {
+    "ax", "bx", "cx", "dx", "si", "di", "bp", "sp",
+    "es", "ds", "ss",
+#if REGS_32
+    "fs", "gs",
+#endif
+    NULL
+};
+#define BL_FIRST_SEG	8   	/* Index of "es" in breakLowerRegs */
+
+#define BL_MAX_CRIT 	16  	/* Most criteria a command can lower to:
+				 * the thread, each register and a word
+				 * of memory */
+
+
+/***********************************************************************
+ *				BreakLowerClose
+ ***********************************************************************
+ * SYNOPSIS:	    Find the character that closes the bracket, brace
+ *		    or parenthesis at cp.
+ * CALLED BY:	    BreakLowerOperand, BreakLowerTerm, BreakLowerExpr,
+ *		    BreakLowerPure
+ * RETURN:	    pointer to the closing character, or NULL if there
+ *		    isn't one before end.
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:
+ *	Nesting is counted across all three kinds of grouping; the
+ *	caller checks the closing character is the one it expected.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static const char *
+BreakLowerClose(const char  *cp,
+		const char  *end)
+{
+    int	    level = 0;
+
+    for (; cp < end; cp++) {
+	switch (*cp) {
+	    case '[': case '{': case '(':
+		level++;
+		break;
+	    case ']': case '}': case ')':
+		if (--level == 0) {
+		    return(cp);
+		}
+		break;
+	}
+    }
+    return(NULL);
+}
+
+
+/***********************************************************************
+ *				BreakLowerTrim
+ ***********************************************************************
+ * SYNOPSIS:	    Strip white space and enclosing parentheses from
+ *		    both ends of a piece of an expression.
+ * CALLED BY:	    BreakLowerOperand, BreakLowerTerm
+ * RETURN:	    *startPtr and *endPtr adjusted
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+BreakLowerTrim(const char   **startPtr,
+	       const char   **endPtr)
+{
+    const char	*start = *startPtr;
+    const char	*end = *endPtr;
+
+    while (1) {
+	while (start < end && isspace(*start)) {
+	    start++;
+	}
+	while (end > start && isspace(end[-1])) {
+	    end--;
+	}
+	if (*start != '(' || BreakLowerClose(start, end) != end-1 ||
+	    end[-1] != ')')
+	{
+	    break;
+	}
+	start++, end--;
+    }
+    *startPtr = start;
+    *endPtr = end;
+}
+
+
+/***********************************************************************
+ *				BreakLowerWords
+ ***********************************************************************
+ * SYNOPSIS:	    Break the inside of a Tcl command substitution into
+ *		    its words.
+ * CALLED BY:	    BreakLowerOperand, BreakLowerPure
+ * RETURN:	    the number of words, or -1 if there are more than max
+ *		    or the grouping is unbalanced.
+ * SIDE EFFECTS:    words[] and lens[] filled in
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+BreakLowerWords(const char  *cp,
+		const char  *end,
+		const char  **words,
+		int 	    *lens,
+		int 	    max)
+{
+    int	    n = 0;
+
+    while (1) {
+	while (cp < end && isspace(*cp)) {
+	    cp++;
+	}
+	if (cp == end) {
+	    return(n);
+	}
+	if (n == max) {
+	    return(-1);
+	}
+	words[n] = cp;
+	while (cp < end && !isspace(*cp)) {
+	    if (*cp == '[' || *cp == '{' || *cp == '(') {
+		cp = BreakLowerClose(cp, end);
+		if (cp == NULL) {
+		    return(-1);
+		}
+	    }
+	    cp++;
+	}
+	lens[n] = cp - words[n];
+	n++;
+    }
+}
+
+#define BreakLowerWordIs(w, len, str) \
+    ((len) == strlen(str) && strncmp((w), (str), (len)) == 0)
+
+
+/***********************************************************************
+ *				BreakLowerPure
+ ***********************************************************************
+ * SYNOPSIS:	    See if evaluating a piece of an expression can't
+ *		    change anything.
+ * CALLED BY:	    BreakLowerExpr, self
+ * RETURN:	    TRUE if the only commands it invokes are read-reg,
+ *		    value fetch and handle.
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:
+ *	Braced strings aren't substituted in an expression, so they're
+ *	skipped. Each command substitution must start with one of the
+ *	allowed commands, and its arguments must be pure as well.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+BreakLowerPure(const char   *cp,
+	       const char   *end)
+{
+    const char	*close;
+    const char	*words[2];
+    int	    	lens[2];
+    int	    	nwords;
+
+    for (; cp < end; cp++) {
+	if (*cp == '\\') {
+	    cp++;
+	} else if (*cp == '{') {
+	    cp = BreakLowerClose(cp, end);
+	    if (cp == NULL) {
+		return(FALSE);
+	    }
+	} else if (*cp == '[') {
+	    close = BreakLowerClose(cp, end);
+	    if (close == NULL) {
+		return(FALSE);
+	    }
+	    /*
+	     * Only the first two words matter; more than that is fine.
+	     */
+	    nwords = BreakLowerWords(cp+1, close, words, lens, 2);
+	    if (nwords < 0) {
+		nwords = 2;
+	    }
+	    if (nwords == 0 ||
+		!(BreakLowerWordIs(words[0], lens[0], "read-reg") ||
+		  BreakLowerWordIs(words[0], lens[0], "handle") ||
+		  (BreakLowerWordIs(words[0], lens[0], "value") &&
+		   nwords > 1 &&
+		   BreakLowerWordIs(words[1], lens[1], "fetch"))) ||
+		!BreakLowerPure(cp+1, close))
+	    {
+		return(FALSE);
+	    }
+	    cp = close;
+	}
+    }
+    return(TRUE);
+}
+
+
+/***********************************************************************
+ *				BreakLowerName
+ ***********************************************************************
+ * SYNOPSIS:	    See if a name in an address expression will mean
+ *		    the same thing when the breakpoint is hit as it
+ *		    does now.
+ * CALLED BY:	    BreakLowerAddress
+ * RETURN:	    TRUE if it will
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:
+ *	Registers change from hit to hit, as do locals and parameters,
+ *	so none of those will do. Anything else must look up to the
+ *	same symbol in the function holding the breakpoint as it does in
+ *	the current scope, which is where the criteria are evaluated.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+BreakLowerName(BreakPtr	    bp,
+	       const char   *name)
+{
+    char    	    lname[64];
+    int	    	    i;
+    Sym	    	    func, here, there;
+    StorageClass    sClass;
+
+    if (strlen(name) >= sizeof(lname)) {
+	return(FALSE);
+    }
+    for (i = 0; name[i] != '\0'; i++) {
+	lname[i] = tolower(name[i]);
+    }
+    lname[i] = '\0';
+    if (Private_GetData(name) != NULL || Private_GetData(lname) != NULL) {
+	return(FALSE);
+    }
+
+    func = Sym_LookupAddr(bp->handle, bp->offset, SYM_FUNCTION);
+    here = Sym_Lookup(name, SYM_VAR|SYM_LOCALVAR, curPatient->scope);
+    if (Sym_IsNull(func)) {
+	return(Sym_IsNull(here));
+    }
+    there = Sym_Lookup(name, SYM_VAR|SYM_LOCALVAR, func);
+
+    if (Sym_IsNull(here) || Sym_IsNull(there)) {
+	return(Sym_IsNull(here) && Sym_IsNull(there));
+    } else if (!Sym_Equal(here, there) || (Sym_Class(here) & SYM_LOCALVAR)) {
+	return(FALSE);
+    }
+    Sym_GetVarData(here, (Type *)NULL, &sClass, (Address *)NULL);
+    return(sClass == SC_Static);
+}
+
+
+/***********************************************************************
+ *				BreakLowerAddress
+ ***********************************************************************
+ * SYNOPSIS:	    See if the address given to "value fetch" in a
+ *		    breakpoint's command can be evaluated once, now,
+ *		    rather than each time the breakpoint is hit.
+ * CALLED BY:	    BreakLowerOperand
+ * RETURN:	    TRUE if it can
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:
+ *	Turn down anything Tcl would substitute, anything that reads
+ *	memory (* and all ^ but ^h<number>), and any name BreakLowerName
+ *	doesn't like. Field names (after a .) and patient or module
+ *	qualifiers (before a ::) are left alone. Handle-relative
+ *	addresses are fine, as CBreakParseCriteria tracks the handle.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+BreakLowerAddress(BreakPtr  bp,
+		  const char *addr)
+{
+    const char	*cp = addr;
+    const char	*start;
+    char    	name[64];
+
+    while (*cp != '\0') {
+	if (index("$[]{}\"\\@*;", *cp) != NULL) {
+	    return(FALSE);
+	} else if (*cp == '^') {
+	    if (cp[1] != 'h' || !isdigit(cp[2])) {
+		return(FALSE);
+	    }
+	    cp += 2;
+	} else if (isdigit(*cp)) {
+	    while (isalnum(*cp)) {
+		cp++;
+	    }
+	} else if (isalpha(*cp) || *cp == '_') {
+	    for (start = cp; isalnum(*cp) || *cp == '_'; cp++) {
+		;
+	    }
+	    if ((start > addr && start[-1] == '.') ||
+		(cp[0] == ':' && cp[1] == ':'))
+	    {
+		continue;
+	    }
+	    if (cp - start >= sizeof(name)) {
+		return(FALSE);
+	    }
+	    bcopy(start, name, cp - start);
+	    name[cp - start] = '\0';
+	    if (!BreakLowerName(bp, name)) {
+		return(FALSE);
+	    }
+	} else {
+	    cp++;
+	}
+    }
+    return(TRUE);
+}
+
+
+/***********************************************************************
+ *				BreakLowerOperand
+ ***********************************************************************
+ * SYNOPSIS:	    Figure out what one side of a comparison in a
+ *		    breakpoint's command is.
+ * CALLED BY:	    BreakLowerTerm
+ * RETURN:	    TRUE if it's something we know how to lower
+ * SIDE EFFECTS:    *op filled in
+ *
+ * STRATEGY:
+ *	The forms accepted are an integer constant and
+ *	    [read-reg <reg>]
+ *	    [read-reg curThread]
+ *	    [value fetch <addr> word|sword|[type word]|[type sword]]
+ *	    [handle segment [handle lookup <id>]]
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+BreakLowerOperand(BreakPtr  	bp,
+		  const char	*start,
+		  const char	*end,
+		  BreakLowerOp	*op)
+{
+    const char	*words[4];
+    int	    	lens[4];
+    int	    	nwords;
+    int	    	i;
+
+    BreakLowerTrim(&start, &end);
+    if (start == end) {
+	return(FALSE);
+    }
+
+    if (*start != '[') {
+	char	num[32];
+	char	*numEnd;
+
+	if (end - start >= sizeof(num)) {
+	    return(FALSE);
+	}
+	bcopy(start, num, end - start);
+	num[end - start] = '\0';
+	op->value = strtol(num, &numEnd, 0);
+	op->kind = BLO_CONST;
+	return(numEnd != num && *numEnd == '\0');
+    }
+
+    if (BreakLowerClose(start, end) != end-1 || end[-1] != ']') {
+	return(FALSE);
+    }
+    nwords = BreakLowerWords(start+1, end-1, words, lens, 4);
+
+    if (nwords == 2 && BreakLowerWordIs(words[0], lens[0], "read-reg")) {
+	if (lens[1] >= sizeof(op->name)) {
+	    return(FALSE);
+	}
+	for (i = 0; i < lens[1]; i++) {
+	    op->name[i] = tolower(words[1][i]);
+	}
+	op->name[i] = '\0';
+	if (strcmp(op->name, "curthread") == 0) {
+	    op->kind = BLO_THREAD;
+	    return(TRUE);
+	}
+	for (i = 0; breakLowerRegs[i] != NULL; i++) {
+	    if (strcmp(op->name, breakLowerRegs[i]) == 0) {
+		op->kind = BLO_REG;
+		op->value = i;
+		return(TRUE);
+	    }
+	}
+    } else if (nwords == 4 && BreakLowerWordIs(words[0], lens[0], "value") &&
+	       BreakLowerWordIs(words[1], lens[1], "fetch"))
+    {
+	const char  *type = words[3];
+	int 	    typeLen = lens[3];
+
+	if (*type == '[') {
+	    const char	*twords[2];
+	    int	    	tlens[2];
+
+	    if (type[typeLen-1] != ']' ||
+		BreakLowerWords(type+1, type+typeLen-1, twords, tlens, 2) != 2 ||
+		!BreakLowerWordIs(twords[0], tlens[0], "type"))
+	    {
+		return(FALSE);
+	    }
+	    type = twords[1];
+	    typeLen = tlens[1];
+	}
+	if (BreakLowerWordIs(type, typeLen, "word")) {
+	    op->kind = BLO_WORD;
+	} else if (BreakLowerWordIs(type, typeLen, "sword")) {
+	    op->kind = BLO_SWORD;
+	} else {
+	    return(FALSE);
+	}
+
+	if (lens[2] >= sizeof(op->name)) {
+	    return(FALSE);
+	}
+	bcopy(words[2], op->name, lens[2]);
+	op->name[lens[2]] = '\0';
+	return(BreakLowerAddress(bp, op->name));
+    } else if (nwords == 3 && BreakLowerWordIs(words[0], lens[0], "handle") &&
+	       BreakLowerWordIs(words[1], lens[1], "segment") &&
+	       words[2][0] == '[')
+    {
+	const char  *hwords[3];
+	int 	    hlens[3];
+	BreakLowerOp id;
+
+	if (words[2][lens[2]-1] != ']' ||
+	    BreakLowerWords(words[2]+1, words[2]+lens[2]-1,
+			    hwords, hlens, 3) != 3 ||
+	    !BreakLowerWordIs(hwords[0], hlens[0], "handle") ||
+	    !BreakLowerWordIs(hwords[1], hlens[1], "lookup") ||
+	    !BreakLowerOperand(bp, hwords[2], hwords[2]+hlens[2], &id) ||
+	    id.kind != BLO_CONST || id.value <= 0 || id.value > 0xffff ||
+	    Handle_Lookup((word)id.value) == NullHandle)
+	{
+	    return(FALSE);
+	}
+	op->kind = BLO_HANDLE;
+	op->value = id.value;
+	return(TRUE);
+    }
+    return(FALSE);
+}
+
+
+/***********************************************************************
+ *				BreakLowerTerm
+ ***********************************************************************
+ * SYNOPSIS:	    Turn one comparison from a breakpoint's command into
+ *		    a criterion for CBreakParseCriteria, if we can.
+ * CALLED BY:	    BreakLowerExpr
+ * RETURN:	    the criterion, in malloc'ed memory, or NULL
+ * SIDE EFFECTS:    *usedPtr gets the bit for the word compared
+ *
+ * STRATEGY:
+ *	The term must be a single relational operator with a register,
+ *	the thread or a word of memory on one side and a constant on the
+ *	other, or a segment register being equal (or not) to the segment
+ *	of a handle. Each word can be checked by the stub only once, so
+ *	a second comparison against the same word is left to Tcl.
+ *
+ *	Constants outside the range the word can hold are left to Tcl
+ *	as well, as are constants for segment registers, since
+ *	CBreakParseCriteria would track the block with that segment,
+ *	which Tcl does not.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static char *
+BreakLowerTerm(BreakPtr	    bp,
+	       const char   *start,
+	       const char   *end,
+	       unsigned long *usedPtr)
+{
+    const char	    *cp;
+    const char	    *opStart = NULL;
+    const char	    *opEnd = NULL;
+    int	    	    rel = BLR_EQ;
+    BreakLowerOp    lhs, rhs, tmp;
+    unsigned long   bit;
+    char    	    *crit;
+    const char	    **ops;
+
+    BreakLowerTrim(&start, &end);
+
+    for (cp = start; cp < end; cp++) {
+	int 	r = -1;
+	int 	len = 1;
+
+	switch (*cp) {
+	    case '[': case '{': case '(':
+		cp = BreakLowerClose(cp, end);
+		if (cp == NULL) {
+		    return(NULL);
+		}
+		continue;
+	    case '=':
+		if (cp[1] != '=') {
+		    return(NULL);
+		}
+		r = BLR_EQ, len = 2;
+		break;
+	    case '!':
+		if (cp[1] == '=') {
+		    r = BLR_NE, len = 2;
+		}
+		break;
+	    case '<':
+	    case '>':
+		if (cp[1] == *cp) {
+		    return(NULL);	/* Shift */
+		} else if (cp[1] == '=') {
+		    r = (*cp == '<' ? BLR_LE : BLR_GE), len = 2;
+		} else {
+		    r = (*cp == '<' ? BLR_LT : BLR_GT);
+		}
+		break;
+	}
+	if (r != -1) {
+	    if (opStart != NULL) {
+		return(NULL);
+	    }
+	    opStart = cp;
+	    opEnd = cp + len;
+	    rel = r;
+	    cp += len-1;
+	}
+    }
+
+    if (opStart == NULL ||
+	!BreakLowerOperand(bp, start, opStart, &lhs) ||
+	!BreakLowerOperand(bp, opEnd, end, &rhs))
+    {
+	return(NULL);
+    }
+
+    /*
+     * Get the thing being compared on the left.
+     */
+    if (lhs.kind == BLO_CONST || lhs.kind == BLO_HANDLE) {
+	tmp = lhs, lhs = rhs, rhs = tmp;
+	rel = breakLowerMirror[rel];
+    }
+
+    crit = (char *)malloc_tagged(sizeof(lhs.name) + 32, TAG_BREAK);
+    ops = breakLowerUnsigned;
+
+    switch (lhs.kind) {
+	case BLO_REG:
+	    bit = 1 << (lhs.value + 2);
+	    if (lhs.value >= BL_FIRST_SEG) {
+		if (rhs.kind != BLO_HANDLE || rel > BLR_NE) {
+		    goto fail;
+		}
+		sprintf(crit, "%s%s^h%ld", lhs.name, ops[rel], rhs.value);
+		break;
+	    }
+	    if (rhs.kind != BLO_CONST || rhs.value < 0 || rhs.value > 0xffff) {
+		goto fail;
+	    }
+	    sprintf(crit, "%s%s%ld", lhs.name, ops[rel], rhs.value);
+	    break;
+	case BLO_THREAD:
+	    bit = 1;
+	    if (rhs.kind != BLO_CONST || rhs.value < 0 || rhs.value > 0xffff) {
+		goto fail;
+	    }
+	    sprintf(crit, "thread%s%ld", ops[rel], rhs.value);
+	    break;
+	case BLO_SWORD:
+	    ops = breakLowerSigned;
+	    if (rhs.kind != BLO_CONST || rhs.value < -32768 ||
+		rhs.value > 32767)
+	    {
+		goto fail;
+	    }
+	    /*FALLTHRU*/
+	case BLO_WORD:
+	    bit = 2;
+	    if (rhs.kind != BLO_CONST || rhs.value < -32768 ||
+		rhs.value > 0xffff ||
+		(lhs.kind == BLO_WORD && rhs.value < 0))
+	    {
+		goto fail;
+	    }
+	    sprintf(crit, "(%s)%s%ld", lhs.name, ops[rel], rhs.value & 0xffff);
+	    break;
+	default:
+	    goto fail;
+    }
+
+    if (*usedPtr & bit) {
+	goto fail;
+    }
+    *usedPtr |= bit;
+    return(crit);
+
+fail:
+    free(crit);
+    return(NULL);
+}
+
+
+/***********************************************************************
+ *				BreakLowerExpr
+ ***********************************************************************
+ * SYNOPSIS:	    Find the criteria implied by a breakpoint command
+ *		    that's an "expr" command.
+ * CALLED BY:	    BreakLowerCommand
+ * RETURN:	    the number of criteria stored in crit[]
+ * SIDE EFFECTS:    crit[] filled with malloc'ed strings
+ *
+ * STRATEGY:
+ *	The command must be nothing but "expr" and its expression. If
+ *	the expression's top level has no || or ?:, the command can only
+ *	be non-zero when each of the &&'ed terms is, so each term we can
+ *	lower becomes a criterion and the rest are simply dropped; the
+ *	command is still evaluated when the stub reports a hit, so they
+ *	still get checked.
+ *
+ *	A hit the stub rejects never gets to Tcl, so nothing in the
+ *	command runs for it. Any term Tcl would have evaluated before
+ *	reaching a false one must therefore have no side effects, unlike
+ *	[incr n] > 10, say. && stops at the first false term, so once a
+ *	term we can't lower has side effects, nothing after it is
+ *	lowered.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+BreakLowerExpr(BreakPtr	    bp,
+	       const char   *command,
+	       char 	    **crit)
+{
+    const char	    *cp = command;
+    const char	    *end;
+    const char	    *start;
+    unsigned long   used = 0;
+    int	    	    ncrit = 0;
+    Boolean 	    impure = FALSE;
+
+    while (isspace(*cp)) {
+	cp++;
+    }
+    if (strncmp(cp, "expr", 4) != 0 || !isspace(cp[4])) {
+	return(0);
+    }
+    for (cp += 4; isspace(*cp); cp++) {
+	;
+    }
+    for (end = cp + strlen(cp); end > cp && isspace(end[-1]); end--) {
+	;
+    }
+    if (cp == end) {
+	return(0);
+    }
+
+    if (*cp == '{' || *cp == '"') {
+	const char  *close = (*cp == '{' ? BreakLowerClose(cp, end) :
+			      index(cp+1, '"'));
+
+	if (close != end-1 || *close != (*cp == '{' ? '}' : '"')) {
+	    return(0);
+	}
+	cp++, end--;
+    } else {
+	for (start = cp; start < end; start++) {
+	    if (*start == ';' || *start == '\n') {
+		return(0);
+	    }
+	}
+    }
+
+    for (start = cp; ncrit < BL_MAX_CRIT; cp++) {
+	if (cp == end || (cp[0] == '&' && cp[1] == '&')) {
+	    if (!impure) {
+		crit[ncrit] = BreakLowerTerm(bp, start, cp, &used);
+		if (crit[ncrit] != NULL) {
+		    ncrit++;
+		} else if (!BreakLowerPure(start, cp)) {
+		    impure = TRUE;
+		}
+	    }
+	    if (cp == end) {
+		break;
+	    }
+	    start = ++cp + 1;
+	} else if (*cp == '[' || *cp == '{' || *cp == '(') {
+	    cp = BreakLowerClose(cp, end);
+	    if (cp == NULL) {
+		break;
+	    }
+	} else if ((cp[0] == '|' && cp[1] == '|') || *cp == '?') {
+	    break;
+	}
+    }
+
+    if (cp != end) {
+	while (ncrit > 0) {
+	    free(crit[--ncrit]);
+	}
+    }
+    return(ncrit);
+}
+
+
+/***********************************************************************
+ *				BreakLowerCommand
+ ***********************************************************************
+ * SYNOPSIS:	    Have the stub check as much of a Tcl breakpoint's
+ *		    command as it can, so the machine needn't stop for
+ *		    Tcl to evaluate it on every hit.
+ * CALLED BY:	    BreakInit, BreakCmd
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the breakpoint may become conditional, with
+ *		    tbPtr->lowered set.
+ *
+ * STRATEGY:
+ *	Commands of the form "expr <term> && <term>..." whose terms
+ *	compare registers, the thread or a word of memory against
+ *	constants are turned by BreakLowerExpr into the same criteria
+ *	"brk cond" takes. The command itself is left alone: the criteria
+ *	are only ever looser than it is, so the stub never holds back a
+ *	hit Tcl would have taken, and Tcl still has the final say on the
+ *	hits the stub lets through, including for terms (counters and
+ *	the like) it can't lower.
+ *
+ *	Breakpoints that already have criteria, are specific to a
+ *	patient, or can't be conditional are left alone.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+BreakLowerCommand(Tcl_Interp	*interp,
+		  BreakPtr  	bp)
+{
+    TclBreakPtr	tbPtr = (TclBreakPtr)bp->data;
+    char    	*crit[BL_MAX_CRIT+1];
+    int	    	ncrit;
+    int	    	i;
+
+    if (bp->isCond || bp->patient != NullPatient ||
+	bp->handle == NullHandle || bp->offset > (Address)0xffff ||
+	tbPtr->command[0] == '\0')
+    {
+	return;
+    }
+
+    ncrit = BreakLowerExpr(bp, tbPtr->command, crit);
+    if (ncrit == 0) {
+	return;
+    }
+    crit[ncrit] = NULL;
+
+    bzero(&bp->cb.handles, sizeof(bp->cb.handles));
+
+    if (CBreakParseCriteria(interp, &bp->cb, bp, 0, crit) == TCL_OK) {
+	tbPtr->lowered = TRUE;
+	CBreakFinishCriteriaChange(bp);
+	if (breakDebug) {
+	    Message("brk%d: stub checks", tbPtr->id);
+	    for (i = 0; i < ncrit; i++) {
+		Message(" %s", crit[i]);
+	    }
+	    Message("\n");
+	}
+    } else {
+	/*
+	 * Shouldn't happen, but leave the breakpoint as it was, with Tcl
+	 * doing all the checking. The criteria may have registered
+	 * interest in handles before failing, so give that up.
+	 */
+	CBreakRemoveCriteria(bp);
+	bzero(&bp->cb.handles, sizeof(bp->cb.handles));
+	Tcl_Return(interp, NULL, TCL_STATIC);
+    }
+
+    for (i = 0; i < ncrit; i++) {
+	free(crit[i]);
+    }
+}
     
 
 /***********************************************************************
@@ -3003,6 +3936,7 @@ CBreakInit(Tcl_Interp	*interp,
 
     tbPtr->id = BreakGetNextTCLId();
     tbPtr->user_enabled = TRUE;
+    tbPtr->lowered = FALSE;
 
     CBreakFinishCriteriaChange(bp);
 
@@ -3281,6 +4215,16 @@ Notes:\n\
       cmd\" command. If you give no <command> argument, then no command\n\
       will be executed and the breakpoint will always be taken, so long as\n\
       any associated condition is also met.\n\
+\n\
+    * If a breakpoint set by \"brk\" or \"brk aset\" has no condition and its\n\
+      <command> is an \"expr\" whose top level is only terms joined by &&,\n\
+      each term that compares\n\
+      [read-reg <reg>], [read-reg curThread] or [value fetch <addr> word]\n\
+      (or sword) with a constant, or a segment register with\n\
+      [handle segment [handle lookup <id>]], is given to the PC as a\n\
+      condition, so the machine need only stop when those terms are true.\n\
+      The command is still evaluated then, and has the final say. \"brk cmd\"\n\
+      redoes this for the new command; \"brk cond\" replaces it.\n\
 \n\
     * If a breakpoint has both a condition and a command, the command will\n\
       not be executed until the condition has been met, unless there's another\n\
@@ -3731,8 +4675,6 @@ set_brk:
 	tbPtr = (TclBreakPtr)bp->data;
 	
 	if (argc == 3 || strcmp(argv[3], "none") == 0) {
-	    int	    i;
-	    
 	    /*
 	     * Remove the breakpoint's condition.
 	     */
@@ -3740,22 +4682,8 @@ set_brk:
 		Tcl_RetPrintf(interp, "%s: not conditional", argv[2]);
 		return(TCL_ERROR);
 	    }
-	    BreakUninstallBP(bp);
-	    bp->isCond = FALSE;
-
-	    /*
-	     * Remove the call to CBreakInterest since breakpoint now
-	     * unconditional.
-	     */
-	    for (i = 0; i < CB_MAX_HANDLES; i++) {
-		if (bp->cb.handles[i].handle != NullHandle) {
-		    Handle_NoInterest(bp->cb.handles[i].handle,
-				      CBreakInterest,
-				      (Opaque)bp);
-		}
-	    }
-
-	    BreakInstallBP(bp);
+	    CBreakRemoveCriteria(bp);
+	    tbPtr->lowered = FALSE;
 	} else {
 	    if (!bp->handle) {
 		Tcl_Error(interp,
@@ -3769,6 +4697,7 @@ set_brk:
 	    if (CBreakParseCriteria(interp, &bp->cb, bp, 3, argv) != TCL_OK) {
 		return(TCL_ERROR);
 	    }
+	    tbPtr->lowered = FALSE;
 	    
 	    CBreakFinishCriteriaChange(bp);
 	}
@@ -3784,6 +4713,15 @@ set_brk:
 
 	tbPtr = (TclBreakPtr)bp->data;
 
+	/*
+	 * Criteria lowered from the old command may be tighter than the
+	 * new one, so get rid of them.
+	 */
+	if (tbPtr->lowered) {
+	    CBreakRemoveCriteria(bp);
+	    tbPtr->lowered = FALSE;
+	}
+
 	if (argc == 3) {
 	    /*
 	     * Remove command from breakpoint by storing a null byte at the
@@ -3796,6 +4734,7 @@ set_brk:
 				     sizeof(TclBreakRec)+strlen(argv[3])+1);
 	    bp->data = (Opaque)tbPtr;
 	    strcpy(tbPtr->command, argv[3]);
+	    BreakLowerCommand(interp, bp);
 	}
 	break;
     }
@@ -153,6 +153,35 @@ static unsigned	    generation = 0;
 static HandlePtr    handleAddrCache[HANDLE_MAX_ADDR_CACHE];
 static int  	    handleACLen = 0;
 
+/*
+ * Index of all handles with a non-zero size, ordered by the address of the
+ * block, so Handle_Find can binary-search for the few handles that might
+ * cover an address instead of enumerating the whole hash table. A handle's
+ * segment and size may only be altered through HandleSetBounds, which keeps
+ * the handle's slot in the index in sync.
+ *
+ * No block managed by the heap exceeds 64K, so the backward scan from the
+ * search point need only cover HANDLE_INDEX_MAX_SPAN bytes. The rare
+ * handle that's larger (e.g. the kernel's BIOS resource) goes in the
+ * unsorted handleBigIndex instead, which is searched linearly.
+ */
+typedef struct {
+    Address 	    start;  	/* Segment of the handle when entered */
+    HandlePtr	    hp;	    	/* The handle itself */
+} HandleIndexRec;
+
+typedef struct {
+    HandleIndexRec  *entries;	/* Array of entries */
+    int	    	    num;    	/* Number of entries in use */
+    int	    	    max;    	/* Number of entries allocated */
+} HandleIndex;
+
+#define HANDLE_INDEX_MAX_SPAN	0x10000
+#define HANDLE_INDEX_INCR   	256
+
+static HandleIndex  handleIndex;    /* Blocks <= 64K, sorted by start */
+static HandleIndex  handleBigIndex; /* Blocks > 64K, unsorted */
+
 /*
  * Communication types
  */
@@ -163,6 +192,241 @@ static Type 	    type2WordArg;   /* Type for BLOCK_IN, BLOCK_OUT,
 				     * BLOCK_LOAD, and BLOCK_CHANGE args */
 static Type 	    typeReallocArg; /* Type for BLOCK_REALLOC */
 
+/***********************************************************************
+ *				HandleIndexSearch
+ ***********************************************************************
+ * SYNOPSIS:	    Locate the first entry in the sorted index whose
+ *	    	    block starts after the given address.
+ * CALLED BY:	    HandleIndexInsert, HandleIndexFind
+ * RETURN:	    Index of the entry (handleIndex.num if none)
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:	    Binary search.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+HandleIndexSearch(Address   address)
+{
+    int	    lo = 0;
+    int	    hi = handleIndex.num;
+
+    while (lo < hi) {
+	int mid = (lo + hi) >> 1;
+
+	if (handleIndex.entries[mid].start <= address) {
+	    lo = mid + 1;
+	} else {
+	    hi = mid;
+	}
+    }
+    return(lo);
+}
+
+/***********************************************************************
+ *				HandleIndexInsert
+ ***********************************************************************
+ * SYNOPSIS:	    Enter a handle into the by-address index.
+ * CALLED BY:	    HandleSetBounds
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The index may be enlarged.
+ *
+ * STRATEGY:	    Handles of size 0 can't cover anything, so they're not
+ *	    	    entered at all.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+HandleIndexInsert(HandlePtr hp)
+{
+    HandleIndex	*hi;
+    int	    	i;
+
+    if (hp->size == 0) {
+	return;
+    }
+
+    hi = (hp->size > HANDLE_INDEX_MAX_SPAN) ? &handleBigIndex : &handleIndex;
+
+    if (hi->num == hi->max) {
+	hi->max += HANDLE_INDEX_INCR;
+	if (hi->entries == NULL) {
+	    hi->entries =
+		(HandleIndexRec *)malloc_tagged(hi->max*sizeof(HandleIndexRec),
+						TAG_HANDLE);
+	} else {
+	    hi->entries =
+		(HandleIndexRec *)realloc_tagged((char *)hi->entries,
+						 hi->max*sizeof(HandleIndexRec));
+	}
+    }
+
+    if (hi == &handleIndex) {
+	/*
+	 * Place it after all the entries that start at or before it, so
+	 * the index remains sorted.
+	 */
+	i = HandleIndexSearch(hp->segment);
+	if (i != hi->num) {
+	    bcopy(&hi->entries[i], &hi->entries[i+1],
+		  (hi->num - i) * sizeof(HandleIndexRec));
+	}
+    } else {
+	i = hi->num;
+    }
+    hi->entries[i].start = hp->segment;
+    hi->entries[i].hp = hp;
+    hi->num += 1;
+}
+
+/***********************************************************************
+ *				HandleIndexRemove
+ ***********************************************************************
+ * SYNOPSIS:	    Remove a handle from the by-address index.
+ * CALLED BY:	    HandleSetBounds, Handle_Free
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The entry for the handle is removed.
+ *
+ * STRATEGY:	    The handle's segment and size are still those under
+ *	    	    which it was entered, so we know which index it's in
+ *	    	    and, for the sorted one, where to start looking.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+HandleIndexRemove(HandlePtr hp)
+{
+    HandleIndex	*hi;
+    int	    	i;
+
+    if (hp->size == 0) {
+	return;
+    }
+
+    if (hp->size > HANDLE_INDEX_MAX_SPAN) {
+	hi = &handleBigIndex;
+	i = hi->num;
+    } else {
+	hi = &handleIndex;
+	/*
+	 * Search returns the slot after the last entry with this start, so
+	 * work backward from there to find the handle.
+	 */
+	i = HandleIndexSearch(hp->segment);
+    }
+
+    while (--i >= 0) {
+	if (hi->entries[i].hp == hp) {
+	    hi->num -= 1;
+	    if (i != hi->num) {
+		if (hi == &handleIndex) {
+		    bcopy(&hi->entries[i+1], &hi->entries[i],
+			  (hi->num - i) * sizeof(HandleIndexRec));
+		} else {
+		    hi->entries[i] = hi->entries[hi->num];
+		}
+	    }
+	    return;
+	}
+	assert(hi != &handleIndex || hi->entries[i].start == hp->segment);
+    }
+    assert(0);
+}
+
+/***********************************************************************
+ *				HandleSetBounds
+ ***********************************************************************
+ * SYNOPSIS:	    Change the address and/or size of a handle's block.
+ * CALLED BY:	    INTERNAL
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    hp->segment and hp->size are set and the handle is
+ *	    	    moved within the by-address index.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+HandleSetBounds(HandlePtr   hp,
+		Address	    segment,
+		dword	    size)
+{
+    if ((hp->segment != segment) || (hp->size != size)) {
+	HandleIndexRemove(hp);
+	hp->segment = segment;
+	hp->size = size;
+	HandleIndexInsert(hp);
+    }
+}
+
+/***********************************************************************
+ *				HandleIndexFind
+ ***********************************************************************
+ * SYNOPSIS:	    Find a valid, resident handle covering an address
+ *	    	    among those we already know about.
+ * CALLED BY:	    Handle_Find
+ * RETURN:	    The HandlePtr, or NULL if none known.
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:	    Binary-search for the first block starting beyond
+ *	    	    the address, then work backward until the blocks
+ *	    	    start too far below the address to possibly cover
+ *	    	    it. Stale handles (those not valid for the current
+ *	    	    generation) may overlap current ones, so each must
+ *	    	    be checked. Failing that, try the big blocks.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+#define HandleCovers(hp, address) \
+	(HandleValid(hp) && ((hp)->state & HANDLE_IN) && \
+	 ((hp)->segment <= (address)) && \
+	 ((address) < (hp)->segment + (hp)->size) && \
+	 ((hp)->xipPage == curXIPPage || (hp)->xipPage == HANDLE_NOT_XIP))
+
+static HandlePtr
+HandleIndexFind(Address	address)
+{
+    int	    	    i;
+    HandleIndexRec  *hir;
+
+    for (i = HandleIndexSearch(address) - 1; i >= 0; i--) {
+	hir = &handleIndex.entries[i];
+	if (hir->start + HANDLE_INDEX_MAX_SPAN <= address) {
+	    break;
+	}
+	if (HandleCovers(hir->hp, address)) {
+	    return(hir->hp);
+	}
+    }
+
+    for (i = 0, hir = handleBigIndex.entries; i < handleBigIndex.num; i++, hir++) {
+	if (HandleCovers(hir->hp, address)) {
+	    return(hir->hp);
+	}
+    }
+    return((HandlePtr)NULL);
+}
+
 /***********************************************************************
  *				HandleAttach
  ***********************************************************************
@@ -375,8 +639,7 @@ Handle
 Handle_Find(Address 	address)    /* Address that the handle should contain.
 				     * This is a 32-bit address. */
 {
-    Hash_Search	  	search;	    /* Thing used to traverse the table */
-    Hash_Entry	  	*entry;	    /* Current entry in table */
+    Hash_Entry	  	*entry;	    /* Entry in table */
     HandlePtr	  	hp; 	    /* Current handle */
     FindReply	  	fr; 	    /* Reply from BLOCK_FIND rpc */
     FindArgs	    	fa; 	    /* args to BLOCK_FIND */
@@ -403,21 +666,12 @@ Handle_Find(Address 	address)    /* Address that the handle should contain.
     }
 
     /*
-     * Traverse the table looking for a handle that covers the address
-     * range.
+     * Consult the by-address index for a known handle that covers the
+     * address range.
      */
-    for (entry = Hash_EnumFirst(&handles, &search);
-	 entry != (Hash_Entry *)NULL;
-	 entry = Hash_EnumNext(&search))
-    {
-	hp = (HandlePtr)Hash_GetValue(entry);
-	if (HandleValid(hp) &&
-	    (hp->state & HANDLE_IN) && (hp->segment <= address) &&
-	    (address < hp->segment + hp->size) && 
-	    (hp->xipPage == curXIPPage || hp->xipPage == HANDLE_NOT_XIP))
-	{
-	    goto done;
-	}
+    hp = HandleIndexFind(address);
+    if (hp != (HandlePtr)NULL) {
+	goto done;
     }
 
     /*
@@ -501,7 +755,7 @@ Handle_Find(Address 	address)    /* Address that the handle should contain.
 	 * appropriate thing...jimmy 5/94
 	 */
 	if (!fr.fr_flags) {
-	    hp->size = 0;
+	    HandleSetBounds(hp, hp->segment, 0);
 	}
     }
     /*
@@ -1065,6 +1319,7 @@ Handle_Free(Handle  handle)
 {
     HandlePtr	    hp = (HandlePtr)handle;
     Hash_Entry	    *entry = (Hash_Entry *)NULL; /* Init for GCC */
+    int	    	    i;
     
     assert(VALIDTPTR(handle, TAG_HANDLE));
     
@@ -1104,6 +1359,22 @@ Handle_Free(Handle  handle)
 	Hash_DeleteEntry(&handles, entry);
     }
 
+    HandleIndexRemove(hp);
+
+    /*
+     * Make sure it doesn't linger in the by-address cache either.
+     */
+    for (i = 0; i < handleACLen; i++) {
+	if (handleAddrCache[i] == hp) {
+	    handleACLen -= 1;
+	    if (i != handleACLen) {
+		bcopy(&handleAddrCache[i+1], &handleAddrCache[i],
+		      (handleACLen - i) * sizeof(HandlePtr));
+	    }
+	    break;
+	}
+    }
+
     free((char *)hp);
 }
 
@@ -1701,6 +1972,7 @@ Handle_Create(Patient	patient,    	/* Patient that owns the handle */
 	 * XXX: This isn't strictly true....
 	 */
 	hp = (HandlePtr)malloc_tagged(sizeof(HandleRec), TAG_HANDLE);
+	new = TRUE;
     }
 
     hp->id = id;
@@ -1718,11 +1990,19 @@ Handle_Create(Patient	patient,    	/* Patient that owns the handle */
 	assert(hp->patient->resources != NULL);
     }
 
+    if (!new) {
+	/*
+	 * Reusing an existing record, so get it out of the index before
+	 * we biff its bounds.
+	 */
+	HandleIndexRemove(hp);
+    }
     hp->segment = address;
     hp->size = size;
     hp->state = flags;
     hp->gen = generation;
     hp->xipPage = xipPage;
+    HandleIndexInsert(hp);
     
     /*
      * Verify the state of the passed bits:
@@ -1826,20 +2106,15 @@ Handle_Change(Handle  	handle,	    /* Handle to "alter" */
 	}
     }
     
-    if (which & HANDLE_ADDRESS) {
-	if (hp->segment != address) {
-	    hp->segment = address;
-	} else {
-	    which &= ~HANDLE_ADDRESS;
-	}
+    if ((which & HANDLE_ADDRESS) && (hp->segment == address)) {
+	which &= ~HANDLE_ADDRESS;
     }
-    if (which & HANDLE_SIZE) {
-	if (hp->size != size) {
-	    hp->size = size;
-	} else {
-	    which &= ~HANDLE_SIZE;
-	}
+    if ((which & HANDLE_SIZE) && (hp->size == size)) {
+	which &= ~HANDLE_SIZE;
     }
+    HandleSetBounds(hp,
+		    (which & HANDLE_ADDRESS) ? address : hp->segment,
+		    (which & HANDLE_SIZE) ? size : hp->size);
     if (which & HANDLE_FLAGS) {
 	hp->state = flags;
 	/*
@@ -1963,7 +2238,7 @@ HandleOut(Rpc_Message		msg,	    /* Message to which to reply */
 	 * that a swapped block can be discarded, so we clear out the
 	 * HANDLE_SWAPPED bit too.
 	 */
-	hp->segment = 0;
+	HandleSetBounds(hp, 0, hp->size);
 	hp->state &= ~(HANDLE_IN|HANDLE_SWAPPED);
 	
 	if (oa->oa_discarded) {
@@ -2028,7 +2303,7 @@ HandleLoad(Rpc_Message	    msg,	/* Message for reply */
      * loaded, even if we've never expressed interest in the handle)
      */
     if (HandleValid(hp)) {
-        hp->segment = MakeAddress(la->la_dataAddress, 0) ;
+        HandleSetBounds(hp, MakeAddress(la->la_dataAddress, 0), hp->size);
 	hp->state |= (HANDLE_IN);
 	hp->state &= ~HANDLE_SWAPPED;
 	
@@ -2085,7 +2360,7 @@ HandleResLoad(Rpc_Message   msg,    	    /* Message to which to reply */
      * loaded, even if we've never expressed interest in the handle)
      */
     if (HandleValid(hp)) {
-	hp->segment = (Address)(la->la_dataAddress << 4);
+	HandleSetBounds(hp, (Address)(la->la_dataAddress << 4), hp->size);
 	hp->state |= HANDLE_IN;
 	hp->state &= ~HANDLE_DISCARDED;
 	
@@ -2151,7 +2426,7 @@ HandleMove(Rpc_Message	  	msg,
 	 * moved, even if we've never expressed interest in the handle)
 	 */
 	if (HandleValid(hp)) {
-            hp->segment = MakeAddress(ma->ma_dataAddress, 0) ;
+            HandleSetBounds(hp, MakeAddress(ma->ma_dataAddress, 0), hp->size);
 	    
 	    dprintf("Handle %xh moved to %xh\n", hp->id, ma->ma_dataAddress);
 	    
@@ -2207,8 +2482,8 @@ HandleRealloc(Rpc_Message   msg,
      * realloced, even if we've never expressed interest in the handle)
      */
     if(HandleValid(hp)) {
-        hp->segment = MakeAddress(rea->rea_dataAddress, 0) ;
-	hp->size = rea->rea_paraSize << 4;
+        HandleSetBounds(hp, MakeAddress(rea->rea_dataAddress, 0),
+			rea->rea_paraSize << 4);
 	hp->state |= HANDLE_IN;
 	hp->state &= ~(HANDLE_DISCARDED|HANDLE_SWAPPED);
 	
@@ -2428,7 +2703,7 @@ HandleExit(Event    	event,
 			     * should the kernel not have changed.
 			     */
 			    HandleCallInterest(hp, HANDLE_DISCARD);
-			    hp->segment = 0;
+			    HandleSetBounds(hp, 0, hp->size);
 			    hp->state &= ~(HANDLE_IN|HANDLE_ATTACHED);
 			    hp->state |= HANDLE_DISCARDED;
 			} else {
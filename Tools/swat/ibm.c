@@ -57,6 +57,7 @@ static char *rcsid =
 #include "ibmInt.h"
 #include "private.h"
 #include "sym.h"
+#include "symCache.h"
 #include "type.h"
 #include "ui.h"
 #include "var.h"
@@ -1961,6 +1962,7 @@ IbmBiffPatient(Patient patient)
 	VMClose(patient->symFile);
     }
     patient->symFile = (Opaque)NULL;
+    SymCache_Close(patient);
 	
     /*
      * If the patient's a driver, remove it from the array of libraries of the
@@ -26,11 +26,14 @@
  *	Ibm86SetBreak	    Set a breakpoint at an address
  *	Ibm86ClearBreak	    Clear a breakpoint
  *	Ibm86Decode 	    Decode a machine instruction.
+ *	Ibm86_InvalidateDecode Forget decoded instructions that were
+ *	    	    	    written over
  *
  * REVISION HISTORY:
  *	Date	  Name	    Description
  *	----	  ----	    -----------
  *	6/22/88	  ardeb	    Initial version
+ *	10/16/26  agent	    Added the decoded-instruction cache
  *
  * DESCRIPTION:
  *	Machine-dependent code for the 8086 on an IBM PC.
@@ -44,10 +47,12 @@ static char *rcsid =
 
 #include <config.h>
 #include "swat.h"
+#include "cache.h"
 #include "cmd.h"
 #include "event.h"
 #include "i86Opc.h"
 #include "ibm.h"
+#include "ibm86.h"
 #include "private.h"
 #include "src.h"
 #include "sym.h"
@@ -113,6 +118,41 @@ static int  stackBotOff;    /* Offset in ThreadPrivateData of TPD_stackBot
  */
 static SegAddr pcfom, pcfomPascal, pcfomCdecl;
 
+/*
+ * Instructions Ibm86Decode has decoded, keyed by handle and offset, so
+ * listing or stepping through the same code again needn't look up the same
+ * opcodes and symbols again. Only the instruction itself is kept, as the
+ * values of its args change with the registers. Entries are only made for
+ * resource and kernel handles, which stick around across continues, and
+ * are checked against the bytes now in memory before being used.
+ */
+typedef struct {
+    Handle  	handle;	    	/* Handle of instruction */
+    Address 	offset;	    	/* Offset of same */
+} DecodeKey;
+
+typedef struct {
+    int	    	size;	    	/* Size of the instruction */
+    byte    	bytes[MAXINST];	/* Bytes from which it was decoded */
+    char    	text[LABEL_IN_STRUCT];	/* Decoded instruction */
+} DecodeRec, *DecodePtr;
+
+#define DECODE_CACHE_LENGTH 512	    /* Default number of instructions
+				     * cached */
+
+static Cache	decodeCache = NullCache;
+static Boolean	decodeCacheOn = TRUE;
+static Boolean	decodeFar;  	    /* Set by Ibm86DecodeInt if the
+				     * instruction holds a segment, as the
+				     * block at that segment can change
+				     * without our hearing of it */
+static int  	decodeRefs; 	    /* Number of times the cache was
+				     * examined */
+static int  	decodeHits; 	    /* Number of times the instruction was
+				     * found there */
+static int  	decodeStale;	    /* Number of times it was found, but
+				     * the bytes had changed */
+
 /*
  * registers contains the name -> number mapping for all the 8086 registers.
  * May at some time want the '286 protected mode registers in here as well,
@@ -4200,6 +4240,7 @@ Ibm86DecodeInt(byte	*ibuf,	    	/* Buffer of bytes to decode */
     if (decode) {
 	*decode = '\0';
     }
+    decodeFar = FALSE;
     
 
     ip = ibuf ;
@@ -5219,6 +5260,7 @@ Ibm86DecodeInt(byte	*ibuf,	    	/* Buffer of bytes to decode */
 		} else {
 		    ea.offset = next;
 		}
+		decodeFar = TRUE;
 
 		if (buffer) {
 		    PrintAddress(&buffer, ea.handle, ea.offset);
@@ -5616,6 +5658,115 @@ Ibm86DecodeInt(byte	*ibuf,	    	/* Buffer of bytes to decode */
     return(1);
 }
 
+/***********************************************************************
+ *				Ibm86DecodeInterest
+ ***********************************************************************
+ * SYNOPSIS:	    Forget a decoded instruction when its handle changes
+ * CALLED BY:	    Handle module
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the entry is removed from decodeCache
+ *
+ * STRATEGY:
+ *	Any change will do, as instructions that refer to the block
+ *	without a symbol show its segment.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+Ibm86DecodeInterest(Handle handle, Handle_Status status, Opaque clientData)
+{
+    Cache_InvalidateOne(decodeCache, (Cache_Entry)clientData);
+}
+
+
+/***********************************************************************
+ *				Ibm86DecodeFree
+ ***********************************************************************
+ * SYNOPSIS:	    Throw out a decoded instruction
+ * CALLED BY:	    Cache module
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    our interest in the handle is withdrawn and the
+ *		    DecodeRec freed
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+Ibm86DecodeFree(Cache	    cache,
+		Cache_Entry entry)
+{
+    DecodeKey	*keyPtr = (DecodeKey *)entry->key.words;
+
+    Handle_NoInterest(keyPtr->handle, Ibm86DecodeInterest, (Opaque)entry);
+    free((malloc_t)Cache_GetValue(entry));
+}
+
+
+/***********************************************************************
+ *				Ibm86_InvalidateDecode
+ ***********************************************************************
+ * SYNOPSIS:	    Forget any decoded instruction that overlaps bytes
+ *		    being written to the PC.
+ * CALLED BY:	    Ibm_WriteBytes
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    entries may be removed from decodeCache
+ *
+ * STRATEGY:
+ *	Ibm86Decode would notice the bytes had changed anyway, but
+ *	there's no point keeping the entries around till then.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+Ibm86_InvalidateDecode(Handle	handle,	    /* Handle written to, or
+					     * NullHandle */
+		       Address	offset,	    /* Offset or absolute address */
+		       int  	len)	    /* Number of bytes written */
+{
+    Cache_Search    search;
+    Cache_Entry	    entry;
+
+    if (decodeCache == NullCache || Cache_Size(decodeCache) == 0) {
+	return;
+    }
+    if (handle == NullHandle) {
+	handle = Handle_Find(offset);
+	if (handle == NullHandle) {
+	    return;
+	}
+	offset -= (dword)Handle_Address(handle);
+    }
+
+    for (entry = Cache_EnumFirst(decodeCache, &search);
+	 entry != NullEntry;
+	 entry = Cache_EnumNext(&search))
+    {
+	DecodeKey   *keyPtr = (DecodeKey *)entry->key.words;
+	DecodePtr   dp = (DecodePtr)Cache_GetValue(entry);
+
+	if ((keyPtr->handle == handle) &&
+	    (keyPtr->offset < offset + len) &&
+	    (keyPtr->offset + dp->size > offset))
+	{
+	    Cache_InvalidateOne(decodeCache, entry);
+	}
+    }
+}
+
+
 /***********************************************************************
  *				Ibm86Decode
  ***********************************************************************
@@ -5628,14 +5779,19 @@ Ibm86DecodeInt(byte	*ibuf,	    	/* Buffer of bytes to decode */
  *	    	size of the instruction.
  *	    	If decode is non-null, it is filled with the actual
  *	    	operands of the instruction.
- * SIDE EFFECTS:  None.
+ * SIDE EFFECTS:  The instruction may be entered in decodeCache.
  *
  * STRATEGY:
+ *	If the args aren't wanted and decodeCache has the instruction,
+ *	decoded from the bytes that are there now, use that. Else
+ *	decode the thing and, if it's in a block that can be cached,
+ *	remember it.
  *
  * REVISION HISTORY:
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	6/22/88		Initial Revision
+ *	agent	10/16/26	Added decodeCache
  *
  ***********************************************************************/
 static int
@@ -5651,6 +5807,13 @@ Ibm86Decode(Handle    	handle,    	/* Handle of data to decode */
     byte		ibuf[MAXINST];	/* Place to store instruction and
 					 * following bytes so we don't need
 					 * to keep calling ReadBytes */
+    DecodeKey	    	key;	    	/* Key for decodeCache */
+    Cache_Entry	    	entry;	    	/* Entry in same */
+    DecodePtr	    	dp; 	    	/* Instruction in same */
+    Boolean 	    	new;
+    char    	    	text[256];  	/* Instruction, if buffer is null */
+    int	    	    	size;	    	/* Size of instruction */
+
     /*
      * Fetch all the bytes we may need from the curPatient
      */
@@ -5660,8 +5823,64 @@ Ibm86Decode(Handle    	handle,    	/* Handle of data to decode */
 	return (FALSE);
     }
 
-    return (Ibm86DecodeInt(ibuf, sizeof(ibuf), handle, offset, buffer,
-			   instSizePtr, decode));
+    if (!decodeCacheOn || (handle == NullHandle) ||
+	!(Handle_State(handle) & HANDLE_SYM) || (offset > (Address)0xffff))
+    {
+	return (Ibm86DecodeInt(ibuf, sizeof(ibuf), handle, offset, buffer,
+			       instSizePtr, decode));
+    }
+
+    key.handle = handle;
+    key.offset = offset;
+
+    if (decode == NULL) {
+	decodeRefs++;
+	entry = Cache_Lookup(decodeCache, (Address)&key);
+	if (entry != NullEntry) {
+	    dp = (DecodePtr)Cache_GetValue(entry);
+	    if (bcmp((genptr)dp->bytes, (genptr)ibuf, dp->size) == 0) {
+		decodeHits++;
+		if (buffer) {
+		    strcpy(buffer, dp->text);
+		}
+		if (instSizePtr) {
+		    *instSizePtr = dp->size;
+		}
+		return (TRUE);
+	    }
+	    decodeStale++;
+	    Cache_InvalidateOne(decodeCache, entry);
+	}
+    }
+
+    if (!Ibm86DecodeInt(ibuf, sizeof(ibuf), handle, offset, text, &size,
+			decode))
+    {
+	return (FALSE);
+    }
+    if (buffer) {
+	strcpy(buffer, text);
+    }
+    if (instSizePtr) {
+	*instSizePtr = size;
+    }
+
+    if (!decodeFar) {
+	dp = (DecodePtr)malloc_tagged(sizeof(DecodeRec) + strlen(text) + 1,
+				      TAG_MD);
+	dp->size = size;
+	bcopy((genptr)ibuf, (genptr)dp->bytes, sizeof(dp->bytes));
+	strcpy(dp->text, text);
+
+	entry = Cache_Enter(decodeCache, (Address)&key, &new);
+	if (new) {
+	    Handle_Interest(handle, Ibm86DecodeInterest, (Opaque)entry);
+	} else {
+	    free((malloc_t)Cache_GetValue(entry));
+	}
+	Cache_SetValue(entry, (Opaque)dp);
+    }
+    return (TRUE);
 }
 
 
@@ -6526,6 +6745,109 @@ to decode the instruction, inst is returned as empty.")
     return(TCL_OK);
 }
 	    
+
+/***********************************************************************
+ *				Ibm86ICacheCmd
+ ***********************************************************************
+ * SYNOPSIS:	    Control the decoded-instruction cache
+ * CALLED BY:	    Tcl
+ * RETURN:	    TCL_OK
+ * SIDE EFFECTS:    Cache may be flushed or resized.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+#define ICACHE_STATS 	(ClientData)0
+#define ICACHE_LEN   	(ClientData)1
+#define ICACHE_FLUSH	(ClientData)2
+#define ICACHE_ON   	(ClientData)3
+#define ICACHE_OFF  	(ClientData)4
+static const CmdSubRec	icacheCmds[] = {
+    {"stats",	ICACHE_STATS,	0, 0,	""},
+    {"length",	ICACHE_LEN,	0, 1,	"[<# instructions cached>]"},
+    {"flush",	ICACHE_FLUSH,	0, 0,	""},
+    {"on",   	ICACHE_ON,  	0, 0, 	""},
+    {"off",  	ICACHE_OFF, 	0, 0,	""},
+    {NULL,   	0,  	    	0, 0,	NULL}
+};
+DEFCMD(icache,Ibm86ICache,TCL_EXACT,icacheCmds,swat_prog,
+"Usage:\n\
+    icache stats\n\
+    icache length [<numInsts>]\n\
+    icache flush\n\
+    icache (on|off)\n\
+\n\
+Examples:\n\
+    \"icache stats\"	    Print how well the cache is doing.\n\
+    \"icache length 2048\"   Keep up to 2048 decoded instructions.\n\
+    \"icache off\"    	    Decode every instruction from scratch.\n\
+\n\
+Synopsis:\n\
+    Controls the cache Swat uses to hold instructions it has decoded, so\n\
+    listing or stepping through the same code again is quicker.\n\
+\n\
+Notes:\n\
+    * Only instructions in resources and the kernel are cached, and only\n\
+      the instruction itself, not the values of its args (\"unassemble\n\
+      <addr> 1\"), as those change with the registers.\n\
+\n\
+    * A cached instruction is used only if the bytes in memory are still\n\
+      the ones it was decoded from. It is thrown out if its block moves,\n\
+      is discarded or swapped, or is freed, or if Swat writes over it.\n\
+\n\
+    * The default cache length is 512 instructions. With no argument,\n\
+      \"icache length\" returns the current length.\n\
+\n\
+    * The \"icache stats\" command prints statistics giving some indication\n\
+      of the efficacy of the cache, then resets them. It does not return\n\
+      anything.\n\
+\n\
+See also:\n\
+    dcache, unassemble\n\
+")
+{
+    switch((int)clientData) {
+	case (int)ICACHE_STATS:
+	    Message("INSTRUCTION CACHE STATISTICS:\n");
+	    Message("Referenced: %d times, Hit %d times (%d%%), %d stale\n",
+		    decodeRefs, decodeHits,
+		    decodeRefs ? decodeHits * 100 / decodeRefs : 0,
+		    decodeStale);
+	    Message("Cache size: %d instructions, Contains %d instructions\n",
+		    Cache_MaxSize(decodeCache), Cache_Size(decodeCache));
+	    decodeRefs = decodeHits = decodeStale = 0;
+	    break;
+	case (int)ICACHE_LEN:
+	    if (argc == 3) {
+		int clen = atoi(argv[2]);
+
+		if (clen <= 0) {
+		    Tcl_Error(interp,
+			      "illegal cache size (must be at least 1)");
+		}
+		Cache_SetMaxSize(decodeCache, clen);
+	    }
+	    Tcl_RetPrintf(interp, "%d", Cache_MaxSize(decodeCache));
+	    break;
+	case (int)ICACHE_FLUSH:
+	    Cache_InvalidateAll(decodeCache, TRUE);
+	    break;
+	case (int)ICACHE_ON:
+	    decodeCacheOn = TRUE;
+	    break;
+	case (int)ICACHE_OFF:
+	    decodeCacheOn = FALSE;
+	    Cache_InvalidateAll(decodeCache, TRUE);
+	    break;
+    }
+    return(TCL_OK);
+}
+
 
 /***********************************************************************
  *				Ibm86_Init
@@ -6591,7 +6913,12 @@ Ibm86_Init(Patient  patient)
 	(void)Event_Handle(EVENT_CHANGE, 0, Ibm86HandleChange,
 			   (ClientData)NULL);
 
+	decodeCache = Cache_Create(CACHE_LRU, DECODE_CACHE_LENGTH,
+				   CACHE_THIS(DecodeKey), Ibm86DecodeFree);
+	decodeRefs = decodeHits = decodeStale = 0;
+
 	Cmd_Create(&Ibm86FindOpcodeCmdRec);
+	Cmd_Create(&Ibm86ICacheCmdRec);
 /*	Cmd_Create(&Ibm86InvalidateFramesCmdRec); */
 	initialized = TRUE;
     }
@@ -12,6 +12,7 @@
  *	Name	Date		Description
  *	----	----		-----------
  *	DB	5/ 6/96   	Initial version
+ *	agent	10/16/26	Added Ibm86_InvalidateDecode
  *
  * DESCRIPTION:
  *	Header file for machine-dependent code for the 8086 on an IBM PC.
@@ -23,5 +24,6 @@
 #define _IBM86_H_
 
 extern void Ibm86_Init(Patient patient);
+extern void Ibm86_InvalidateDecode(Handle handle, Address offset, int len);
 
 #endif /* _IBM86_H_ */
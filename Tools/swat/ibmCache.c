@@ -20,6 +20,7 @@
  *	Date	  Name	    Description
  *	----	  ----	    -----------
  *	5/18/89	  ardeb	    Initial version
+ *	10/16/26  agent	    Ibm_WriteBytes invalidates decoded instructions
  *
  * DESCRIPTION:
  *	Functions implementing the data cache
@@ -35,6 +36,7 @@ static char *rcsid =
 #include "cache.h"
 #include "cmd.h"
 #include "ibmInt.h"
+#include "ibm86.h"
 #include "rpc.h"
 #include "ui.h"
 #include <compat/stdlib.h>
@@ -62,6 +64,10 @@ int  	cacheRefs;	    	    /* Number of times the cache was
 				     * examined */
 int  	cacheHits;	    	    /* Number of times the block was found
 				     * in the cache. */
+int 	cacheRpcs;  	    	    /* Number of RPC calls made to fill
+				     * the cache */
+int 	cacheBlocksBatched; 	    /* Number of blocks fetched by a call
+				     * made on behalf of another block */
 
 #define CACHE_BLOCK_SIZE    32	    /* Default size of each cache block */
 #define CACHE_LENGTH	    64	    /* Default number of blocks in the cache */
@@ -73,6 +79,10 @@ Cache   dataCache;	    	    /* Cached blocks */
 
 Boolean	cacheOn = TRUE;
 
+int 	cacheReadAhead = 0; 	    /* Number of blocks beyond those asked
+				     * for to fetch from a handle when we
+				     * have to go to the PC anyway */
+
 
 /***********************************************************************
  *				IbmDecomposeAddress
@@ -165,6 +175,182 @@ IbmCacheInterestProc(Handle handle, Handle_Status status, Opaque clientData)
 }
 
 
+/***********************************************************************
+ *				IbmRunLength
+ ***********************************************************************
+ * SYNOPSIS:	    Figure how many consecutive blocks, starting with a
+ *	    	    block that's not in the cache, to fetch in a single
+ *	    	    call.
+ * CALLED BY:	    IbmFindBlock
+ * RETURN:	    The number of blocks (at least 1)
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:	    Extend the run over the following blocks the caller
+ *	    	    will want, so long as:
+ *	    	    	- they're not already in the cache (they might be
+ *			  dirty, and we'd just be refetching them anyway)
+ *	    	    	- the run fits in a single RPC reply
+ *	    	    	- the run doesn't take up more than half the cache,
+ *			  lest we throw out the start of it before the
+ *			  caller gets to it
+ *	    	    	- the run doesn't go beyond "limit" bytes from the
+ *			  key's offset (the end of the segment, for example)
+ *	    	    	- for handle-relative reads, the run doesn't extend
+ *			  past the end of the block.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+IbmRunLength(IbmKey 	*keyPtr,    /* Key for the first block */
+	     int    	numBlocks,  /* Number of blocks desired */
+	     dword  	limit)	    /* Max bytes from keyPtr->offset to the
+				     * end of the addressable range */
+{
+    int	    runLen;
+    int	    max;
+    IbmKey  key;
+
+    max = (RPC_MAX_DATA - 2*sizeof(RpcHeader)) / cacheBlockSize;
+    if (numBlocks > max) {
+	numBlocks = max;
+    }
+    if (numBlocks > Cache_MaxSize(dataCache) / 2) {
+	numBlocks = Cache_MaxSize(dataCache) / 2;
+    }
+    if (numBlocks * cacheBlockSize > limit) {
+	numBlocks = limit / cacheBlockSize;
+    }
+    if ((keyPtr->handle != NullHandle) &&
+	!Handle_IsThread(Handle_State(keyPtr->handle)))
+    {
+	dword	size = Handle_Size(keyPtr->handle);
+
+	if ((dword)keyPtr->offset >= size) {
+	    numBlocks = 1;
+	} else if ((dword)keyPtr->offset + numBlocks * cacheBlockSize > size) {
+	    numBlocks = (size - (dword)keyPtr->offset + cacheBlockSize - 1) /
+		cacheBlockSize;
+	}
+    }
+
+    key = *keyPtr;
+    for (runLen = 1; runLen < numBlocks; runLen++) {
+	key.offset += cacheBlockSize;
+	if (Cache_Lookup(dataCache, (Address)&key) != NullEntry) {
+	    break;
+	}
+    }
+    return(runLen);
+}
+
+/***********************************************************************
+ *				IbmRunBuffer
+ ***********************************************************************
+ * SYNOPSIS:	    Return a buffer big enough to hold a run of blocks.
+ * CALLED BY:	    IbmFindBlock
+ * RETURN:	    The block itself if the run is a single block, else
+ *	    	    a new buffer.
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static genptr
+IbmRunBuffer(genptr block, int runLen)
+{
+    genptr  run;
+
+    if (runLen == 1) {
+	return(block);
+    }
+    run = (genptr)malloc(runLen * cacheBlockSize);
+    memset(run, 0xCC, runLen * cacheBlockSize);
+    return(run);
+}
+
+/***********************************************************************
+ *				IbmRunFree
+ ***********************************************************************
+ * SYNOPSIS:	    Free a buffer returned by IbmRunBuffer
+ * CALLED BY:	    IbmFindBlock
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+IbmRunFree(genptr block, genptr run)
+{
+    if (run != block) {
+	free((malloc_t)run);
+    }
+}
+
+/***********************************************************************
+ *				IbmEnterRun
+ ***********************************************************************
+ * SYNOPSIS:	    Enter all but the first block of a run into the
+ *	    	    cache.
+ * CALLED BY:	    IbmFindBlock
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    Blocks may be thrown out of the cache.
+ *
+ * STRATEGY:	    The blocks are entered last-to-first so the ones the
+ *	    	    caller wants soonest are the most-recently used.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+IbmEnterRun(IbmKey  *keyPtr,
+	    genptr  run,
+	    int	    runLen)
+{
+    IbmKey  	key;
+    int	    	i;
+
+    key.handle = keyPtr->handle;
+
+    for (i = runLen - 1; i > 0; i--) {
+	Cache_Entry entry;
+	Boolean	    new;
+	genptr	    block;
+
+	key.offset = keyPtr->offset + i * cacheBlockSize;
+
+	entry = Cache_Enter(dataCache, (Address)&key, &new);
+	if (!new) {
+	    continue;
+	}
+	block = (genptr)malloc_tagged(cacheBlockSize, TAG_CBLOCK);
+	bcopy(run + i * cacheBlockSize, block, cacheBlockSize);
+	Cache_SetValue(entry, (Opaque)block);
+	cacheBlocksBatched++;
+
+	if (key.handle != NullHandle) {
+	    Handle_Interest(key.handle, IbmCacheInterestProc, (Opaque)entry);
+	}
+    }
+}
+
 /***********************************************************************
  *				IbmFindBlock
  ***********************************************************************
@@ -174,6 +360,8 @@ IbmCacheInterestProc(Handle handle, Handle_Status status, Opaque clientData)
  *	    	  block couldn't be obtained.
  * SIDE EFFECTS:  A block may be thrown out of the cache. keyPtr->offset
  *	is adjusted to the offset of the start of the block returned.
+ *	If the block must be fetched, as many of the following numBlocks-1
+ *	blocks as are also missing are fetched with it in a single call.
  *
  * STRATEGY:
  *	The blocks in the cache are keyed on a <handle,offset> pair,
@@ -190,11 +378,17 @@ IbmCacheInterestProc(Handle handle, Handle_Status status, Opaque clientData)
  ***********************************************************************/
 static genptr
 IbmFindBlock(IbmKey	    *keyPtr,	/* Key under which to look/enter */
-	     Cache_Entry    *entryPtr)	/* Place to store entry for block
+	     Cache_Entry    *entryPtr,	/* Place to store entry for block
 					 * if desired. */
+	     int    	    numBlocks)	/* Number of consecutive blocks,
+					 * starting with this one, the
+					 * caller will want */
 {
     genptr 	  	block;	    	/* Block found/read */
     Cache_Entry		entry;
+    genptr  	    	run = NULL; 	/* Data for the blocks following
+					 * this one, if fetched with it */
+    int	    	    	runLen = 1; 	/* Number of blocks in the run */
 
     assert(VALIDTPTR(keyPtr->handle, TAG_HANDLE) || keyPtr->handle==NULL);
     
@@ -219,6 +413,11 @@ IbmFindBlock(IbmKey	    *keyPtr,	/* Key under which to look/enter */
         /* Clear with CC's */
         memset(block, 0xCC, cacheBlockSize) ;
 
+	/*
+	 * Until a branch below fetches a run, the block is its own run.
+	 */
+	run = block;
+
 	if (keyPtr->handle != NullHandle) {
 	    /*
 	     * Need to read the data from the host in a handle-relative way.
@@ -282,41 +481,51 @@ IbmFindBlock(IbmKey	    *keyPtr,	/* Key under which to look/enter */
 		 */
 		AbsReadArgs	ara;
 		
+		runLen = IbmRunLength(keyPtr, numBlocks, 0x10000);
+		
 		ara.ara_segment = Handle_Segment(keyPtr->handle);
 		ara.ara_offset = (word)keyPtr->offset;
-		ara.ara_numBytes = cacheBlockSize;
+		ara.ara_numBytes = runLen * cacheBlockSize;
 		
+		run = IbmRunBuffer(block, runLen);
+		cacheRpcs++;
 		if (Rpc_Call(RPC_READ_ABS,
 			     sizeof(AbsReadArgs), typeAbsReadArgs, &ara,
-			     cacheBlockSize, NullType, block))
+			     runLen * cacheBlockSize, NullType, run))
 		{
+		    IbmRunFree(block, run);
 		    free((malloc_t)block);
 		    Warning("Couldn't read from kernel: %s",
 			    Rpc_LastError());
 		    return((genptr)NULL);
 		}
-		bytesFromPC += cacheBlockSize;
+		bytesFromPC += runLen * cacheBlockSize;
 	    } else {
 		ReadArgs    ra;
 
 		/*XXX*/
 		IbmCheckPatient(Handle_Patient(keyPtr->handle));
 
+		runLen = IbmRunLength(keyPtr, numBlocks, 0x10000);
+
 		ra.ra_handle = Handle_ID(keyPtr->handle);
 		ra.ra_offset = (word)keyPtr->offset;
-		ra.ra_numBytes = cacheBlockSize;
+		ra.ra_numBytes = runLen * cacheBlockSize;
 
+		run = IbmRunBuffer(block, runLen);
+		cacheRpcs++;
 		if (Rpc_Call(RPC_READ_MEM,
 			     sizeof(ReadArgs), typeReadArgs, (Opaque)&ra,
-			     cacheBlockSize, NullType, block))
+			     runLen * cacheBlockSize, NullType, run))
 		{
+		    IbmRunFree(block, run);
 		    free((malloc_t)block);
 		    Warning("Couldn't read block from ^h%04xh:%04xh: %s",
 			    Handle_ID(keyPtr->handle), keyPtr->offset,
 			    Rpc_LastError());
 		    return((genptr)NULL);
 		}
-		bytesFromPC += cacheBlockSize;
+		bytesFromPC += runLen * cacheBlockSize;
 	    }
 	} else {
 	    AbsReadArgs ara;
@@ -324,12 +533,20 @@ IbmFindBlock(IbmKey	    *keyPtr,	/* Key under which to look/enter */
 	    IbmDecomposeAddress(keyPtr->offset,
 				&ara.ara_segment,
 				&ara.ara_offset);
-	    ara.ara_numBytes = cacheBlockSize;
+	    /*
+	     * Don't let the run wrap around the end of the segment we'll be
+	     * reading from.
+	     */
+	    runLen = IbmRunLength(keyPtr, numBlocks, 0x10000 - ara.ara_offset);
+	    ara.ara_numBytes = runLen * cacheBlockSize;
 
+	    run = IbmRunBuffer(block, runLen);
+	    cacheRpcs++;
 	    if (Rpc_Call(RPC_READ_ABS,
 			 sizeof(AbsReadArgs), typeAbsReadArgs, &ara,
-			 cacheBlockSize, NullType, block))
+			 runLen * cacheBlockSize, NullType, run))
 	    {
+		IbmRunFree(block, run);
 		free((malloc_t)block);
 		Warning("Couldn't read from absolute mem %04xh:%04xh %s",
 			swaps(ara.ara_segment),
@@ -337,8 +554,19 @@ IbmFindBlock(IbmKey	    *keyPtr,	/* Key under which to look/enter */
 			Rpc_LastError());
 		return((genptr)NULL);
 	    }
-	    bytesFromPC += cacheBlockSize;
+	    bytesFromPC += runLen * cacheBlockSize;
 	}
+
+	if (run != block) {
+	    /*
+	     * Fetched more than one block: the first is ours, and the rest
+	     * get entered into the cache on their own.
+	     */
+	    bcopy(run, block, cacheBlockSize);
+	    IbmEnterRun(keyPtr, run, runLen);
+	    IbmRunFree(block, run);
+	}
+
 	entry = Cache_Enter(dataCache, (Address)keyPtr, &new);
 	assert(new);
 	Cache_SetValue(entry, (Opaque)block);
@@ -527,7 +755,11 @@ Ibm_ReadBytes(int    	numBytes,   	/* Number of bytes to read */
 	    }
 	    
 	    key.offset = patientAddress;
-	    block = IbmFindBlock(&key, &entry);
+	    block = IbmFindBlock(&key, &entry,
+				 ((patientAddress - (Address)((dword)patientAddress &
+							     ~(cacheBlockSize-1))) +
+				  numBytes + cacheBlockSize - 1) / cacheBlockSize +
+				 ((handle != NullHandle) ? cacheReadAhead : 0));
 	    
 	    if (block == (genptr)NULL) {
 		break;
@@ -696,7 +928,8 @@ Ibm_ReadBytes(int    	numBytes,   	/* Number of bytes to read */
  * CALLED BY:	  GLOBAL
  * RETURN:	  The number of bytes written.
  * SIDE EFFECTS:  Blocks may be added to the cache and placed on the
- *	dirtyBlocks list.
+ *	dirtyBlocks list. Decoded instructions the bytes overlap are
+ *	forgotten.
  *
  * STRATEGY:
  *	Bytes are only written into the cache, not to the PC. Any modified
@@ -708,6 +941,7 @@ Ibm_ReadBytes(int    	numBytes,   	/* Number of bytes to read */
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	9/13/88		Initial Revision
+ *	agent	10/16/26	Calls Ibm86_InvalidateDecode
  *
  ***********************************************************************/
 int
@@ -728,6 +962,11 @@ Ibm_WriteBytes(int   	numBytes,   	/* Number of bytes to write */
 					 * time */
     int	    	    	i;
 
+    /*
+     * Make sure the disassembler doesn't hang onto what was there.
+     */
+    Ibm86_InvalidateDecode(handle, patientAddress, numBytes);
+
     if (handle != NullHandle && patientAddress >= (Address)65536) {
 	/*
 	 * If the address is beyond the 64k that can be in a handle, convert
@@ -748,7 +987,7 @@ Ibm_WriteBytes(int   	numBytes,   	/* Number of bytes to write */
 	    /*
 	     * First find the block in the cache
 	     */
-	    block = IbmFindBlock(&key, &entry);
+	    block = IbmFindBlock(&key, &entry, 1);
 	    
 	    if (block == (genptr)NULL) {
 		/*
@@ -898,6 +1137,7 @@ Ibm_WriteBytes(int   	numBytes,   	/* Number of bytes to write */
 #define DCACHE_STATS 	(ClientData)3
 #define DCACHE_ON   	(ClientData)4
 #define DCACHE_OFF  	(ClientData)5
+#define DCACHE_READAHEAD (ClientData)6
 static const CmdSubRec	dcacheCmds[] = {
     {"bsize",	DCACHE_BSIZE,	1, 1,	"<block size>"},
     {"length",	DCACHE_LEN,	1, 1,	"<# blocks cached>"},
@@ -905,6 +1145,7 @@ static const CmdSubRec	dcacheCmds[] = {
     {"stats",	DCACHE_STATS,	0, 0,	""},
     {"on",   	DCACHE_ON,  	0, 0, 	""},
     {"off",  	DCACHE_OFF, 	0, 0,	""},
+    {"readahead",DCACHE_READAHEAD,0, 1,	"[<# blocks>]"},
     {NULL,   	0,  	    	0, 0,	NULL}
 };
 DEFCMD(dcache,IbmDCache,TCL_EXACT,dcacheCmds,swat_prog,
@@ -914,12 +1155,15 @@ DEFCMD(dcache,IbmDCache,TCL_EXACT,dcacheCmds,swat_prog,
     dcache stats\n\
     dcache params\n\
     dcache (on|off)\n\
+    dcache readahead [<numBlocks>]\n\
 \n\
 Examples:\n\
     \"dcache bsize 16\"	    Set the number of bytes fetched at a time to 16.\n\
     \"dcache length 1024\"    Allow 1024 blocks of the current block size to\n\
 			    be in the cache at a time.\n\
     \"dcache off\"    	    Disables the Swat data cache.\n\
+    \"dcache readahead 4\"   When fetching data from a block on the PC, fetch\n\
+			    up to 4 more blocks of it in the same call.\n\
 \n\
 Synopsis:\n\
     Controls the cache Swat uses to hold data read from the PC while the\n\
@@ -947,6 +1191,13 @@ Notes:\n\
 \n\
     * The \"dcache stats\" command prints statistics giving some indication of\n\
       the efficacy of the data cache. It does not return anything.\n\
+\n\
+    * When several consecutive blocks must be fetched from the PC, they are\n\
+      fetched in a single call. \"dcache readahead\" sets the number of\n\
+      additional blocks past the end of a read from a handle that are\n\
+      fetched in the same call, in anticipation of their being wanted\n\
+      next. It defaults to 0. With no argument, it returns the current\n\
+      setting.\n\
 \n\
     * The \"dcache params\" command returns a list {<blockSize> <numBlocks>}\n\
       giving the current parameters of the data cache. There are some\n\
@@ -967,6 +1218,10 @@ See also:\n\
 		    bytesToPC, bytesToCache);
 	    Message("\nReferenced: %d times, Hit %d times\n", cacheRefs,
 		    cacheHits);
+	    Message("Fetched with %d calls (%d bytes/call), %d blocks batched\n",
+		    cacheRpcs,
+		    cacheRpcs ? bytesFromPC / cacheRpcs : 0,
+		    cacheBlocksBatched);
 	    Message("Ratios: read %d%%, write %d%%, overall %d%%\n",
 		    bytesFromPC ? bytesFromCache * 100 / bytesFromPC : 0,
 		    bytesToPC ? bytesToCache * 100 / bytesToPC : 0,
@@ -1031,12 +1286,23 @@ See also:\n\
 	case (int)DCACHE_OFF:
 	    cacheOn = FALSE;
 	    return(TCL_OK);
+	case (int)DCACHE_READAHEAD:
+	    if (argc == 3) {
+		int ra = atoi(argv[2]);
+
+		if (ra < 0) {
+		    Tcl_Error(interp, "read-ahead must be non-negative");
+		}
+		cacheReadAhead = ra;
+	    }
+	    Tcl_RetPrintf(interp, "%d", cacheReadAhead);
+	    return(TCL_OK);
     }
     /*
      * Reset cache statistics
      */
     bytesFromPC = bytesFromCache = bytesToPC = bytesToCache = cacheRefs =
-	cacheHits = 0;
+	cacheHits = cacheRpcs = cacheBlocksBatched = 0;
     return(TCL_OK);
 }
 
@@ -1064,7 +1330,7 @@ IbmCache_Init()
     dataCache = Cache_Create(CACHE_LRU, CACHE_LENGTH, CACHE_THIS(IbmKey),
 			     IbmFreeBlock);
     cacheRefs = cacheHits = bytesFromPC = bytesFromCache =
-	bytesToPC = bytesToCache = 0;
+	bytesToPC = bytesToCache = cacheRpcs = cacheBlocksBatched = 0;
     cacheBlockSize = CACHE_BLOCK_SIZE;
 
     Cmd_Create(&IbmDCacheCmdRec);
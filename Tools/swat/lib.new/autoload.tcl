@@ -69,6 +69,7 @@
 
 [autoload showcalls 1 showcall]
 
+[autoload sim-bench 1 simbench]
 [autoload slist 0 srclist]
 [autoload smatch 1 smatch]
 [autoload spawn 0 process]
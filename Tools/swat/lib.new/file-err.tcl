@@ -205,8 +205,12 @@ Notes:
 
     * When searching, both <file> and <file>.tcl are checked for.
 
+    * If there's no up-to-date .tlc file for the file found, it is loaded
+      through the byte-code cache (see "bc-cache"), so it's only parsed
+      again once it changes.
+
 See also:
-    autoload, source
+    autoload, source, bc-cache
 }
 {
     #
@@ -243,7 +247,7 @@ See also:
     	    if {[file isfile $cf] && [file newer $cf $f]} {
 	    	return [uplevel 0 bc fload $cf]
 	    } else {
-	    	return [uplevel 0 source $f]
+	    	return [uplevel 0 bc-cache load $f]
     	    }
     	} elif {[file isfile $f.tcl] && [file readable $f.tcl]}
     	{
@@ -254,7 +258,7 @@ See also:
 	    if {[file isfile $f.tlc] && [file newer $f.tlc $f.tcl]} {
 	    	return [uplevel 0 bc fload $f.tlc]
     	    } else {
-	    	return [uplevel 0 source $f.tcl]
+	    	return [uplevel 0 bc-cache load $f.tcl]
     	    }
     	} elif {[file isfile $cf] && [file readable $cf]} {
     	    # if there is only a tlc file the use it
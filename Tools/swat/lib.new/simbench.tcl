@@ -0,0 +1,95 @@
+##############################################################################
+#
+# 	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+#
+# PROJECT:	PC GEOS
+# MODULE:	Swat -- System Library
+# FILE: 	simbench.tcl
+# AUTHOR: 	agent, Oct 16, 2026
+#
+# COMMANDS:
+# 	Name			Description
+#	----			-----------
+#   	sim-bench   	    	Time attach, backtrace and heap walk
+#
+# REVISION HISTORY:
+#	Name	Date		Description
+#	----	----		-----------
+#	agent	10/16/26	Initial Revision
+#
+# DESCRIPTION:
+#	A fixed workload for timing Swat's communication, caching and
+#	symbol code against swatsim, the simulated stub in
+#	Tools/swatsim. Record it once against a real PC with
+#	"sim-bench -r <file>", then replay it as often as needed with
+#
+#	    swat -T '!swatsim [-l <ms>] [-b <bps>] <file>'
+#
+#	(or, where swat can't start the simulator itself, run
+#	"swatsim -p <port> <file>" and give swat "-T [<host>:]<port>")
+#	and "sim-bench" at the prompt.
+#
+#	$Id$
+#
+###############################################################################
+
+[defcommand sim-bench {args} obscure
+{Usage:
+    sim-bench [-r <file>] [<count>]
+
+Examples:
+    "sim-bench"	    	    time each step 5 times and print the averages
+    "sim-bench 20"  	    time each step 20 times
+    "sim-bench -r att.rpc"  run each step once, recording the RPC traffic
+			    to att.rpc for swatsim to play back
+
+Synopsis:
+    Times re-attaching to GEOS, printing a backtrace of the current thread,
+    and walking the heap, in microseconds per iteration.
+
+Notes:
+    * GEOS must be stopped. It is left stopped ("detach leave") before each
+      attach.
+
+    * Because swatsim answers each call with what the stub answered the same
+      call during recording, the timings are reproducible from run to run
+      and the output of each step matches what the PC gave.
+
+    * Recording runs each step only once, as later iterations would only
+      repeat the same calls.
+
+See also:
+    rpc, time, where, hwalk.
+}
+{
+    var count 5 record {}
+    if {[string c [index $args 0] -r] == 0} {
+	var record [index $args 1] args [range $args 2 end]
+	var count 1
+    }
+    if {![null $args]} {
+	var count [index $args 0]
+    }
+
+    if {![null $record]} {
+	rpc record $record
+    }
+    protect {
+	var total 0
+	for {var i 0} {$i < $count} {var i [expr $i+1]} {
+	    detach leave
+	    var total [expr $total+[index [time {att -c}] 0] f]
+	}
+	var attach [expr $total/$count f]
+	var backtrace [index [time {where} $count] 0]
+	var heapwalk [index [time {hwalk} $count] 0]
+    } {
+	if {![null $record]} {
+	    rpc record
+	}
+    }
+
+    echo [format {attach	%12.0f us} $attach]
+    echo [format {backtrace	%12.0f us} $backtrace]
+    echo [format {heap walk	%12.0f us} $heapwalk]
+}]
@@ -32,6 +32,8 @@
  *	Date	  Name	    Description
  *	----	  ----	    -----------
  *	8/19/88	  ardeb	    Initial version
+ *	10/16/26  agent	    Added "rpc record" and -T for the swatsim
+ *	    	    	    simulated stub
  *
  * DESCRIPTION:
  *	The functions in this module implement the RPC protocol
@@ -125,6 +127,10 @@ static char *rcsid =
 # include <sys/file.h>
 # include <sys/uio.h>
 # include <sys/signal.h>
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
+# include <netdb.h>
 #endif
 
 #if defined(_WIN32)
@@ -439,12 +445,16 @@ static char ttyName[64];
 static int  isModem=0;
 #elif defined(_WIN32)
 # include "npipe.h"
+# include "simsock.h"
 extern HANDLE cntlcEvent;
 HANDLE hCommunication = NULL;
 OVERLAPPED overlapRead, overlapWrite;
 
 static char npipeName[256];
 static char ttysetting[25];
+static char simAddr[256];   	    	  /* swatsim's address, if
+					   * hCommunication is a socket to
+					   * it rather than a serial port */
 
 static BOOL incomingRead = FALSE;   	  /* incoming data has been read */
 static CHAR incomingBuf[RPC_MAX_DATA];	
@@ -1055,6 +1065,46 @@ void DebugRpcCall(RpcCall *p_call)
 #define DebugRpcCall(p_call)   ((void)0)
 #endif  /* DEBUG_OUTPUT_RPC_DATA_TO_FILE */
 
+static FILE *rpcRecord = NULL;	/* Snapshot being written by "rpc record" */
+
+
+/***********************************************************************
+ *				RpcRecord
+ ***********************************************************************
+ * SYNOPSIS:	    Append a message to the snapshot being recorded
+ * CALLED BY:	    Rpc_Call, RpcProcessMessage
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    a line is written to rpcRecord, if it's open
+ *
+ * STRATEGY:	    One line per message: a tag (C for our calls, R and
+ *	    	    E for the stub's replies and errors, S for the
+ *	    	    stub's calls), the id, the procedure and the data in
+ *	    	    hex, as they are on the wire. Resends aren't recorded.
+ *	    	    Tools/swatsim plays the file back.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+RpcRecord(char	    	tag,
+	  RpcHeader 	*header,
+	  const byte	*data)
+{
+    int	    i;
+
+    if (rpcRecord == NULL) {
+	return;
+    }
+    fprintf(rpcRecord, "%c %d %d ", tag, header->rh_id, header->rh_procNum);
+    for (i = 0; i < header->rh_length; i++) {
+	fprintf(rpcRecord, "%02x", data[i]);
+    }
+    putc('\n', rpcRecord);
+}
+
 
 
 /***********************************************************************
@@ -1132,6 +1182,9 @@ RpcProcessMessage(int		stream,
 	msg.header = &messagePtr->header;
 
 	if (isNew) {
+	    RpcRecord('S', &messagePtr->header,
+		      &messagePtr->buf[sizeof(RpcHeader)]);
+
 	    /*
 	     * Must copy the passed message to local space in case the server
 	     * needs to call something, which could well overwrite the global
@@ -1292,6 +1345,10 @@ RpcProcessMessage(int		stream,
 		    }
 		    return;
 	    }
+	    RpcRecord(RpcIsReply(&messagePtr->header) ? 'R' : 'E',
+		      &messagePtr->header,
+		      &messagePtr->buf[sizeof(RpcHeader)]);
+
 	    /*
 	     * Cleanup: If the message got a real reply, (RPC_REPLY or
 	     * RPC_ERROR), we'll get down here. We first remove the call
@@ -1677,7 +1734,16 @@ RpcHandleStream(int	    stream, /* Stream that's ready */
 # if !defined(_WIN32)	    
 		(void) close(stream);
 # else
-		Ntserial_Exit(&hCommunication, &overlapRead, &overlapWrite);
+		if (simAddr[0] != '\0') {
+		    SimSock_ClientExit(&hCommunication, &overlapRead,
+				       &overlapWrite);
+		    geosFD = -1;    /* So Rpc_Connect reconnects */
+		} else {
+		    Ntserial_Exit(&hCommunication, &overlapRead,
+				  &overlapWrite);
+		    geosFD = -1;    /* So RpcExitNtSerial doesn't close it
+				     * again */
+		}
 # endif
 	    }
 	}
@@ -3196,6 +3262,7 @@ Rpc_Call(Rpc_Proc	procNum,    /* Procedure number to call */
 
     /* We might trap the call and it's data to a file. */
     DebugRpcCall(&call) ;
+    RpcRecord('C', &header, (byte *)inData);
 
     /*
      * Set to catch responses and send initial packet.
@@ -4156,6 +4223,7 @@ RpcTclEvent(Rpc_Opaque	clientData,
 #define RPC_DEBUGCMD	(ClientData)4
 #define RPC_TIMEOUTCMD	(ClientData)5
 #define RPC_WAITCMD 	(ClientData)6
+#define RPC_RECORDCMD	(ClientData)7
 static const CmdSubRec rpcCmds[] = {
     {"call", 	RPC_CALLCMD,	4, 4,	"<proc> <argType> <args> <repType>"},
     {"serve",	RPC_SERVECMD,	4, 5,	"<proc> <argType> <repType> <procName> [<data>]"},
@@ -4164,6 +4232,7 @@ static const CmdSubRec rpcCmds[] = {
     {"debug",	RPC_DEBUGCMD,	0, TCL_CMD_NOCHECK,	"(+<flag>|-<flag>)*"},
     {"timeout",	RPC_TIMEOUTCMD,	0, 1,	"[(on|off|1|0)]"},
     {"wait", 	RPC_WAITCMD,	0, 0,	""},
+    {"record",	RPC_RECORDCMD,	0, 1,	"[<file>]"},
     {NULL,   	0,  	    	0, 0, 	NULL}
 };
 
@@ -4176,6 +4245,7 @@ DEFCMD(rpc,Rpc,1,rpcCmds,swat_prog.obscure,
     rpc debug (+<flag>|-<flag>)*\n\
     rpc timeout [(on|off|1|0)]\n\
     rpc wait \n\
+    rpc record [<file>]\n\
 \n\
 Examples:\n\
     \"var e [rpc event 1.5 puffball]\"	Registers a timed event to call\n\
@@ -4184,6 +4254,8 @@ Examples:\n\
     \"rpc wait\"				Allows input etc. to be handled while\n\
 					in a Tcl procedure.\n\
     \"rpc delete $e\" 	    	    	Nuke the event registered before.\n\
+    \"rpc record /tmp/where.rpc\"		Save all calls to and from the stub\n\
+					in /tmp/where.rpc.\n\
 \n\
 Synopsis:\n\
     This command provides access to the RPC system by which Swat communicates\n\
@@ -4252,6 +4324,12 @@ Notes:\n\
       called in a loop until a particular condition has been met. Without\n\
       this, all timed-events, keyboard input, and RPC service is suspended\n\
       until control returns to the top-level interpreter loop.\n\
+\n\
+    * \"rpc record\" writes every call made to the stub, every call the stub\n\
+      makes, and the replies to Swat's calls, to <file>, until \"rpc record\"\n\
+      is given again. With no <file>, recording just stops. The result can\n\
+      be played back by swatsim, a simulated stub, for reproducible timing\n\
+      without a PC (see \"swat -T\").\n\
 \n\
 See also:\n\
     rpc-dbg, value.\n\
@@ -4535,6 +4613,22 @@ See also:\n\
 	case (int)RPC_WAITCMD:
 	    Rpc_Wait();
 	    break;
+	case (int)RPC_RECORDCMD:
+	    if (rpcRecord != NULL) {
+		fclose(rpcRecord);
+		rpcRecord = NULL;
+	    }
+	    if (argc == 3) {
+		rpcRecord = fopen(argv[2], "w");
+		if (rpcRecord == NULL) {
+		    Tcl_RetPrintf(interp, "rpc record: can't open %s",
+				  argv[2]);
+		    return(TCL_ERROR);
+		}
+		fprintf(rpcRecord, "# swat rpc snapshot: <tag> <id> <proc> "
+			"<data>\n");
+	    }
+	    break;
     }
     return(TCL_OK);
 }
@@ -4596,6 +4690,154 @@ RpcOpenModem(char   *modem)
 	    
     isModem = TRUE; /* Don't close connection between sessions */
 }
+
+
+/***********************************************************************
+ *				RpcOpenSim
+ ***********************************************************************
+ * SYNOPSIS:	    Connect to a simulated stub instead of a PC
+ * CALLED BY:	    Rpc_Init
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    geosFD is set if successful. isModem and noSig are
+ *	    	    set so the connection stays up across detach and no
+ *	    	    one is sent signals.
+ *
+ * STRATEGY:	    "!<command>" runs <command> (normally swatsim) with
+ *	    	    its standard input and output on one end of a socket
+ *	    	    pair. Anything else is [<host>:]<port>, to which we
+ *	    	    open a TCP connection. Either way the stream carries
+ *	    	    the same framed messages as a serial line, so
+ *	    	    everything past here treats it as CM_SERIAL.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+RpcOpenSim(char	*sim)
+{
+    if (*sim == '!') {
+	int 	sv[2];
+	int 	pid;
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+	    perror("socketpair");
+	    return;
+	}
+	/*
+	 * The simulator exits when it reads end-of-file, i.e. when we do.
+	 */
+	pid = fork();
+	if (pid == 0) {
+	    (void)close(sv[0]);
+	    (void)dup2(sv[1], 0);
+	    (void)dup2(sv[1], 1);
+	    (void)close(sv[1]);
+	    execl("/bin/sh", "sh", "-c", sim+1, (char *)0);
+	    _exit(127);
+	}
+	(void)close(sv[1]);
+	if (pid < 0) {
+	    perror("fork");
+	    (void)close(sv[0]);
+	    return;
+	}
+	geosFD = sv[0];
+    } else {
+	struct sockaddr_in  sin;
+	struct hostent	    *he;
+	char	    	    host[64];
+	char	    	    *colon;
+	int 	    	    on = 1;
+
+	bzero((char *)&sin, sizeof(sin));
+	sin.sin_family = AF_INET;
+
+	colon = index(sim, ':');
+	if (colon == NULL) {
+	    strcpy(host, "localhost");
+	    sin.sin_port = htons(atoi(sim));
+	} else {
+	    int	    len = colon - sim;
+
+	    if (len >= sizeof(host)) {
+		len = sizeof(host)-1;
+	    }
+	    sprintf(host, "%.*s", len, sim);
+	    sin.sin_port = htons(atoi(colon+1));
+	}
+	he = gethostbyname(host);
+	if (he == NULL) {
+	    MessageFlush("Unknown host %s\n", host);
+	    return;
+	}
+	bcopy(he->h_addr, (char *)&sin.sin_addr, he->h_length);
+
+	geosFD = socket(AF_INET, SOCK_STREAM, 0);
+	if (geosFD < 0) {
+	    perror("socket");
+	    return;
+	}
+	if (connect(geosFD, (struct sockaddr *)&sin, sizeof(sin)) < 0) {
+	    perror(sim);
+	    (void)close(geosFD);
+	    geosFD = -1;
+	    return;
+	}
+	/*
+	 * Messages are small and each waits on the last; don't let them
+	 * sit in the stack waiting for company.
+	 */
+	(void)setsockopt(geosFD, IPPROTO_TCP, TCP_NODELAY, (char *)&on,
+			 sizeof(on));
+    }
+    isModem = TRUE;
+    noSig = TRUE;
+}
+#elif defined(_WIN32)
+/***********************************************************************
+ *				RpcOpenSim
+ ***********************************************************************
+ * SYNOPSIS:	    Connect to a simulated stub instead of a PC
+ * CALLED BY:	    Rpc_Init
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    geosFD, hCommunication and simAddr are set if
+ *	    	    successful.
+ *
+ * STRATEGY:	    Only [<host>:]<port> is supported here; run swatsim
+ *	    	    with -p <port> on the same or another machine. The
+ *	    	    connection is then treated as a serial port, since
+ *	    	    swatsim frames its messages the same way.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+RpcOpenSim(char	*sim)
+{
+    int	    err;
+
+    if (*sim == '!') {
+	MessageFlush("-T !<command> is not supported here; start swatsim "
+		     "with -p <port> and give -T [<host>:]<port>\n");
+	return;
+    }
+    err = SimSock_ClientInit(sim, &hCommunication, &overlapRead,
+			     &overlapWrite);
+    if (err != 0) {
+	MessageFlush("Can't contact swatsim at %s (error %d)\n", sim, err);
+	return;
+    }
+    strncpy(simAddr, sim, sizeof(simAddr)-1);
+    geosFD = 1;	    /* Fake descriptor number that won't interfere
+		     * with anything... in theory. */
+    commMode = CM_SERIAL;
+}
 #endif /* unix */
 
 
@@ -4634,6 +4876,9 @@ Rpc_Init(int		*argcPtr,
 #elif defined(unix)
     char    	    	*modem=0;
 #endif
+#if defined(unix) || defined(_WIN32)
+    char    	    	*sim=0;
+#endif
 
     for (av = nav = &argv[1], ac = *argcPtr-1; ac > 0; ac--, av++) {
 	if (strncmp(*av, "-t", 2) == 0) {           /* look for tty arg */
@@ -4670,6 +4915,17 @@ Rpc_Init(int		*argcPtr,
 	    *argcPtr -= 1;
 	}
 #endif /* unix */
+#if defined(unix) || defined(_WIN32)
+	else if (strcmp(*av, "-T") == 0) {	    /* look for simulator arg */
+	    if (ac == 1) {
+		MessageFlush("-T needs an argument\n");
+		exit(1);
+	    }
+	    sim = av[1];
+	    av++, ac--;
+	    *argcPtr -= 2;
+	}
+#endif
 #if !defined(_WIN32)
 	else if (strcmp(*av, "-net") == 0) {       /* look for net arg */
 	    av++, ac--;
@@ -4734,7 +4990,12 @@ Rpc_Init(int		*argcPtr,
 	 */
 	commMode = CM_SERIAL;
 # if defined(unix)
-	if (modem != 0) {
+	if (sim == 0 && tty == 0 && modem == 0) {
+	    sim = (char *)getenv("SWAT_SIM");
+	}
+	if (sim != 0) {
+	    RpcOpenSim(sim);
+	} else if (modem != 0) {
 	    noSig = TRUE;   	/* Assume noone using the modem, so noone to
 				 * which to send signals */
 	    RpcOpenModem(modem);
@@ -4828,6 +5089,17 @@ Rpc_Init(int		*argcPtr,
 # endif
     }
 #else /* now handle _WIN32 */
+    if (sim == 0 && tty == 0 && npipe == 0) {
+	sim = (char *)getenv("SWAT_SIM");
+    }
+    if (sim != 0) {
+	RpcOpenSim(sim);
+	if (geosFD < 0) {
+	    Swat_Death();
+	}
+	goto connected;
+    }
+
     if (commMode == CM_NONE) {
 	returnCode = Registry_FindStringValue(Tcl_GetVar(interp, 
 							 "file-reg-swat",
@@ -4953,6 +5225,8 @@ Rpc_Init(int		*argcPtr,
 		     "check the setup\n");
 	Swat_Death();
     }
+connected:
+    ;
 #endif
     
 #if defined(_MSDOS)
@@ -5174,6 +5448,21 @@ Rpc_Connect(void)
 	 */
 	rpcServers[geosFD] = geosServers;
     }
+    if ((geosFD < 0) && (simAddr[0] != '\0')) {
+	/*
+	 * Lost the connection to swatsim; try once to get it back.
+	 */
+	if (SimSock_ClientInit(simAddr, &hCommunication, &overlapRead,
+			       &overlapWrite) != 0)
+	{
+	    MessageFlush("Couldn't contact swatsim at %s\n", simAddr);
+	    return FALSE;
+	}
+	geosFD = 1;
+	incomingRead = FALSE;
+	outstandingRead = FALSE;
+	rpcServers[geosFD] = geosServers;
+    }
     if ((geosFD < 0) && (commMode == CM_SERIAL)) {
 	Ntserial_Exit(&hCommunication, &overlapRead, &overlapWrite);
 
@@ -5315,9 +5604,12 @@ Rpc_Disconnect(int wakeup)
 	geosFD = -1;
 	incomingRead = FALSE;
 	outstandingRead = FALSE;
-    } else if ((geosFD >= 0) && (commMode == CM_SERIAL)) {
+    } else if ((geosFD >= 0) && (commMode == CM_SERIAL) &&
+	       (simAddr[0] == '\0'))
+    {
 	/*
 	 * Save all the servers registered for the stream for re-attach.
+	 * (A connection to swatsim stays open, like a modem line.)
 	 */
 	rpcServers[geosFD] = (RpcServer *)0;
 	/*
@@ -5458,20 +5750,31 @@ Rpc_Send(Rpc_Proc   exitProcNum)    	/* Procedure to call for the exit */
  * SYNOPSIS:	    calls exit routine for nt serial with handle
  * CALLED BY:	    atexit
  * RETURN:	    void
- * SIDE EFFECTS:    closes serial port
+ * SIDE EFFECTS:    closes serial port, or the connection to swatsim
  *
- * STRATEGY:	    
+ * STRATEGY:	    Nothing to do if the connection has already been
+ *		    shut down (geosFD < 0). A -T connection is a
+ *		    socket, not a com port, so it goes to SimSock.
  *
  * REVISION HISTORY:
  *	Name	Date		Description
  *	----	----		-----------
  *	dbaumann	12/02/96   	Initial Revision
+ *	agent	10/16/26	Handle swatsim and closed connections
  *
  ***********************************************************************/
 void 
 RpcExitNtSerial(void)
 {
-    Ntserial_Exit(&hCommunication, &overlapRead, &overlapWrite);
+    if (geosFD < 0) {
+	return;
+    }
+    if (simAddr[0] != '\0') {
+	SimSock_ClientExit(&hCommunication, &overlapRead, &overlapWrite);
+    } else {
+	Ntserial_Exit(&hCommunication, &overlapRead, &overlapWrite);
+    }
+    geosFD = -1;
 }	/* End of RpcExitNtSerial.	*/
 #endif
 
@@ -63,7 +63,14 @@
 # include    <sys/time.h>
 #endif
 
+/*
+ * Programs that only speak the protocol (swatsim) define RPC_PROTOCOL_ONLY
+ * and their own byte, word and dword before including this, so they get
+ * the constants and structures without needing all of swat.h.
+ */
+#if !defined(RPC_PROTOCOL_ONLY)
 #include    <objfmt.h>
+#endif
 
 #if defined(_MSDOS) || defined(_WIN32)
 struct timeval {
@@ -130,6 +137,7 @@ typedef byte		Rpc_Stat;   	/* Call status */
 #define CM_NETWARE   2
 #define CM_NPIPE     3
 
+#if !defined(RPC_PROTOCOL_ONLY)
 /*
  * Function definitions for Swat
  */
@@ -188,6 +196,7 @@ extern Boolean 	Rpc_Pop(int stream);
 #if defined(_WIN32)
 extern Boolean  Rpc_NtserialInit(const char *tty);
 #endif
+#endif /* !RPC_PROTOCOL_ONLY */
 
 /*
  * C defines REGS_32, while assembly defines _Regs_32.  We define and use the
@@ -0,0 +1,30 @@
+/***********************************************************************
+ *
+ *	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * PROJECT:	  PCGEOS
+ * MODULE:	  Swat -- Win32 connection to swatsim
+ * FILE:	  simsock.h
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial version
+ *
+ * DESCRIPTION:
+ *	Interface to the TCP connection to swatsim under WIN32
+ *
+ * 	$Id$
+ *
+ ***********************************************************************/
+#ifndef _SIMSOCK_H_
+#define _SIMSOCK_H_
+
+extern int SimSock_ClientInit(char *addr, HANDLE *sock, LPOVERLAPPED ovlpR,
+			      LPOVERLAPPED ovlpW);
+extern void SimSock_ClientExit(HANDLE *sock, LPOVERLAPPED ovlpR,
+			       LPOVERLAPPED ovlpW);
+
+#endif /* _SIMSOCK_H_ */
@@ -745,6 +745,13 @@ Usage(void)
     printf("-N is used to start up the NON-EC version of GEOS\n");
     printf("-C is used to disable symbol file path caching\n");
     printf("-net <net address> is used to run swat over the network\n");
+#if defined(unix)
+    printf("-T [<host>:]<port> or -T '!<command>' is used to run swat against\n");
+    printf("	swatsim, the simulated stub, rather than a PC\n");
+#elif defined(_WIN32)
+    printf("-T [<host>:]<port> is used to run swat against swatsim, the\n");
+    printf("	simulated stub, rather than a PC\n");
+#endif
     printf("If geos is already running, or you want to run the EC version\n");
     printf("	no flag is needed\n");
 }
@@ -54,7 +54,7 @@ BSC32=bscmake.exe
 # ADD BSC32 /nologo
 LINK32=link.exe
 # ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib /nologo /subsystem:console /machine:I386
-# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib /nologo /subsystem:console /map /machine:I386 /libpath:"..\vc++\lib"
+# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib ws2_32.lib /nologo /subsystem:console /map /machine:I386 /libpath:"..\vc++\lib"
 
 !ELSEIF  "$(CFG)" == "swat - Win32 Debug"
 
@@ -78,7 +78,7 @@ BSC32=bscmake.exe
 # ADD BSC32 /nologo
 LINK32=link.exe
 # ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib /nologo /subsystem:console /debug /machine:I386 /pdbtype:sept
-# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compatd.lib utilsd.lib ntcursesd.lib tcld.lib lstd.lib winutild.lib libc.lib /nologo /subsystem:console /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /pdbtype:sept /libpath:"..\vc++\lib"
+# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compatd.lib utilsd.lib ntcursesd.lib tcld.lib lstd.lib winutild.lib ws2_32.lib libc.lib /nologo /subsystem:console /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /pdbtype:sept /libpath:"..\vc++\lib"
 # SUBTRACT LINK32 /pdb:none
 
 !ELSEIF  "$(CFG)" == "swat - Win32 Debug 32bit"
@@ -103,9 +103,9 @@ BSC32=bscmake.exe
 # ADD BASE BSC32 /nologo
 # ADD BSC32 /nologo
 LINK32=link.exe
-# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compatd.lib utilsd.lib ntcursesd.lib tcld.lib lstd.lib winutild.lib libc.lib /nologo /subsystem:console /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /pdbtype:sept
+# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compatd.lib utilsd.lib ntcursesd.lib tcld.lib lstd.lib winutild.lib ws2_32.lib libc.lib /nologo /subsystem:console /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /pdbtype:sept
 # SUBTRACT BASE LINK32 /pdb:none
-# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compatd.lib utilsd.lib ntcursesd.lib tcld.lib lstd.lib winutild.lib libc.lib /nologo /subsystem:console /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /out:"Debug32/swat32.exe" /pdbtype:sept /libpath:"..\vc++\lib"
+# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compatd.lib utilsd.lib ntcursesd.lib tcld.lib lstd.lib winutild.lib ws2_32.lib libc.lib /nologo /subsystem:console /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /out:"Debug32/swat32.exe" /pdbtype:sept /libpath:"..\vc++\lib"
 # SUBTRACT LINK32 /pdb:none /map
 
 !ELSEIF  "$(CFG)" == "swat - Win32 Release 32bit"
@@ -129,8 +129,8 @@ BSC32=bscmake.exe
 # ADD BASE BSC32 /nologo
 # ADD BSC32 /nologo
 LINK32=link.exe
-# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib /nologo /subsystem:console /machine:I386
-# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib /nologo /subsystem:console /map /machine:I386 /out:"Release32/swat32.exe" /libpath:"..\vc++\lib"
+# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib ws2_32.lib /nologo /subsystem:console /machine:I386
+# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib ws2_32.lib /nologo /subsystem:console /map /machine:I386 /out:"Release32/swat32.exe" /libpath:"..\vc++\lib"
 
 !ELSEIF  "$(CFG)" == "swat - Win32 Debug PM"
 
@@ -154,9 +154,9 @@ BSC32=bscmake.exe
 # ADD BASE BSC32 /nologo
 # ADD BSC32 /nologo
 LINK32=link.exe
-# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compatd.lib utilsd.lib ntcursesd.lib tcld.lib lstd.lib winutild.lib libc.lib /nologo /subsystem:console /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /out:"Debug32/swat32.exe" /pdbtype:sept
+# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compatd.lib utilsd.lib ntcursesd.lib tcld.lib lstd.lib winutild.lib ws2_32.lib libc.lib /nologo /subsystem:console /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /out:"Debug32/swat32.exe" /pdbtype:sept
 # SUBTRACT BASE LINK32 /pdb:none /map
-# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compatd.lib utilsd.lib ntcursesd.lib tcld.lib lstd.lib winutild.lib libc.lib /nologo /subsystem:console /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /out:"DebugPM/swat32.exe" /pdbtype:sept /libpath:"..\vc++\lib"
+# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compatd.lib utilsd.lib ntcursesd.lib tcld.lib lstd.lib winutild.lib ws2_32.lib libc.lib /nologo /subsystem:console /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /out:"DebugPM/swat32.exe" /pdbtype:sept /libpath:"..\vc++\lib"
 # SUBTRACT LINK32 /pdb:none /map
 
 !ELSEIF  "$(CFG)" == "swat - Win32 Release PM"
@@ -181,8 +181,8 @@ BSC32=bscmake.exe
 # ADD BASE BSC32 /nologo
 # ADD BSC32 /nologo
 LINK32=link.exe
-# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib /nologo /subsystem:console /map /machine:I386 /out:"Release32/swat32.exe"
-# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib /nologo /subsystem:console /map /machine:I386 /out:"ReleasePM/swat32.exe" /libpath:"..\vc++\lib"
+# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib ws2_32.lib /nologo /subsystem:console /map /machine:I386 /out:"Release32/swat32.exe"
+# ADD LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib ws2_32.lib /nologo /subsystem:console /map /machine:I386 /out:"ReleasePM/swat32.exe" /libpath:"..\vc++\lib"
 
 !ENDIF 
 
@@ -358,6 +358,10 @@ SOURCE=.\shell.c
 # End Source File
 # Begin Source File
 
+SOURCE=.\win32.md\simsock.c
+# End Source File
+# Begin Source File
+
 SOURCE=.\src.c
 # End Source File
 # Begin Source File
@@ -370,6 +374,10 @@ SOURCE=.\sym.c
 # End Source File
 # Begin Source File
 
+SOURCE=.\symCache.c
+# End Source File
+# Begin Source File
+
 SOURCE=.\table.c
 # End Source File
 # Begin Source File
@@ -538,6 +546,10 @@ SOURCE=.\shell.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\simsock.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\src.h
 # End Source File
 # Begin Source File
@@ -550,6 +562,10 @@ SOURCE=.\sym.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\symCache.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\table.h
 # End Source File
 # Begin Source File
@@ -389,7 +389,8 @@ typedef struct _Patient {
     Opaque  	mdPriv;   	    	/* Data private to machine-dependent
 					 * interface */
     Opaque  	sourcePriv;	    	/* Data private to source.c */
-    Opaque  	symPriv;    	    	/* Data private to sym.c */
+    Opaque  	symPriv;    	    	/* Data private to sym.c (the
+					 * patient's symbol name cache) */
 } PatientRec;
 
 /*
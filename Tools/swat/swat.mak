@@ -75,9 +75,11 @@ CLEAN :
 	-@erase "$(INTDIR)\patient.obj"
 	-@erase "$(INTDIR)\rpc.obj"
 	-@erase "$(INTDIR)\shell.obj"
+	-@erase "$(INTDIR)\simsock.obj"
 	-@erase "$(INTDIR)\src.obj"
 	-@erase "$(INTDIR)\swat.obj"
 	-@erase "$(INTDIR)\sym.obj"
+	-@erase "$(INTDIR)\symCache.obj"
 	-@erase "$(INTDIR)\table.obj"
 	-@erase "$(INTDIR)\tclDebug.obj"
 	-@erase "$(INTDIR)\type.obj"
@@ -98,7 +100,7 @@ BSC32_FLAGS=/nologo /o"$(OUTDIR)\swat.bsc"
 BSC32_SBRS= \
 	
 LINK32=link.exe
-LINK32_FLAGS=kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib /nologo /subsystem:console /incremental:no /pdb:"$(OUTDIR)\swat.pdb" /machine:I386 /out:"$(OUTDIR)\swat.exe" $(LIB_INCLUDES)
+LINK32_FLAGS=kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib ws2_32.lib /nologo /subsystem:console /incremental:no /pdb:"$(OUTDIR)\swat.pdb" /machine:I386 /out:"$(OUTDIR)\swat.exe" $(LIB_INCLUDES)
 LINK32_OBJS= \
 	"$(INTDIR)\break.obj" \
 	"$(INTDIR)\buf.obj" \
@@ -126,9 +128,11 @@ LINK32_OBJS= \
 	"$(INTDIR)\patient.obj" \
 	"$(INTDIR)\rpc.obj" \
 	"$(INTDIR)\shell.obj" \
+	"$(INTDIR)\simsock.obj" \
 	"$(INTDIR)\src.obj" \
 	"$(INTDIR)\swat.obj" \
 	"$(INTDIR)\sym.obj" \
+	"$(INTDIR)\symCache.obj" \
 	"$(INTDIR)\table.obj" \
 	"$(INTDIR)\tclDebug.obj" \
 	"$(INTDIR)\type.obj" \
@@ -181,9 +185,11 @@ CLEAN :
 	-@erase "$(INTDIR)\patient.obj"
 	-@erase "$(INTDIR)\rpc.obj"
 	-@erase "$(INTDIR)\shell.obj"
+	-@erase "$(INTDIR)\simsock.obj"
 	-@erase "$(INTDIR)\src.obj"
 	-@erase "$(INTDIR)\swat.obj"
 	-@erase "$(INTDIR)\sym.obj"
+	-@erase "$(INTDIR)\symCache.obj"
 	-@erase "$(INTDIR)\table.obj"
 	-@erase "$(INTDIR)\tclDebug.obj"
 	-@erase "$(INTDIR)\type.obj"
@@ -207,7 +213,7 @@ BSC32_FLAGS=/nologo /o"$(OUTDIR)\swat.bsc"
 BSC32_SBRS= \
 	
 LINK32=link.exe
-LINK32_FLAGS=kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib libc.lib /nologo /subsystem:console /incremental:yes /pdb:"$(OUTDIR)\swat.pdb" /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /out:"$(OUTDIR)\swat.exe" /pdbtype:sept $(LIB_INCLUDES)
+LINK32_FLAGS=kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib compat.lib utils.lib ntcurses.lib tcl.lib lst.lib winutil.lib ws2_32.lib libc.lib /nologo /subsystem:console /incremental:yes /pdb:"$(OUTDIR)\swat.pdb" /debug /machine:I386 /nodefaultlib:"library" /nodefaultlib:"libcd" /out:"$(OUTDIR)\swat.exe" /pdbtype:sept $(LIB_INCLUDES)
 LINK32_OBJS= \
 	"$(INTDIR)\break.obj" \
 	"$(INTDIR)\buf.obj" \
@@ -235,9 +241,11 @@ LINK32_OBJS= \
 	"$(INTDIR)\patient.obj" \
 	"$(INTDIR)\rpc.obj" \
 	"$(INTDIR)\shell.obj" \
+	"$(INTDIR)\simsock.obj" \
 	"$(INTDIR)\src.obj" \
 	"$(INTDIR)\swat.obj" \
 	"$(INTDIR)\sym.obj" \
+	"$(INTDIR)\symCache.obj" \
 	"$(INTDIR)\table.obj" \
 	"$(INTDIR)\tclDebug.obj" \
 	"$(INTDIR)\type.obj" \
@@ -427,6 +435,12 @@ SOURCE=.\shell.c
 "$(INTDIR)\shell.obj" : $(SOURCE) "$(INTDIR)"
 
 
+SOURCE=.\win32.md\simsock.c
+
+"$(INTDIR)\simsock.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 SOURCE=.\src.c
 
 "$(INTDIR)\src.obj" : $(SOURCE) "$(INTDIR)"
@@ -442,6 +456,11 @@ SOURCE=.\sym.c
 "$(INTDIR)\sym.obj" : $(SOURCE) "$(INTDIR)"
 
 
+SOURCE=.\symCache.c
+
+"$(INTDIR)\symCache.obj" : $(SOURCE) "$(INTDIR)"
+
+
 SOURCE=.\table.c
 
 "$(INTDIR)\table.obj" : $(SOURCE) "$(INTDIR)"
@@ -83,6 +83,7 @@ static char *rcsid =
 #include "ui.h"
 #include "vector.h"
 #include "vmsym.h"
+#include "symCache.h"
 #include "rpc.h"
 #include "expr.h"
 #include "var.h"
@@ -104,6 +105,7 @@ extern int  gymResources;
 extern char wrongNumArgsString[];
 extern Sym  	Sym_LookupAddrExact (Handle handle, Address addr, int class);
 extern Sym  	SymLookupAddr (Handle handle, Address addr, int class, int wantExact);
+static int  	SymAddrFlush(Event event, Opaque callData, Opaque clientData);
 
  	/* a place to cache the address of a class::msg lookup if the
 	 * sym returned from Sym_LookupAddr is to some previous routine,
@@ -810,6 +812,114 @@ SymLookup(ID   	    	id,	    /* Identifier of symbol to find */
 }
 
 
+/***********************************************************************
+ *				SymLookupInCache
+ ***********************************************************************
+ * SYNOPSIS:	    Look for a global symbol in a patient using its
+ *	    	    persistent name cache.
+ * CALLED BY:	    SymRealLookupInPatient
+ * RETURN:	    TRUE if the cache could be consulted, with *symPtr
+ *	    	    set to the symbol found (NullSym if none).
+ *	    	    FALSE if the patient has no cache.
+ * SIDE EFFECTS:    The cache may be built.
+ *
+ * STRATEGY:	    Must produce the same answer as searching each
+ *	    	    module's hash table with the ID SymLookupIDLen would
+ *	    	    give us. If the name itself has global symbols, it's
+ *	    	    in the string table and that's the ID. If not, the
+ *	    	    ID could be that of one of the decorated forms of the
+ *	    	    name SymLookupIDLen tries, but only if the exact name
+ *	    	    isn't in the string table at all, so when one of
+ *	    	    those forms is in the cache we let SymLookupIDLen
+ *	    	    decide which name is meant. This is rare, so the
+ *	    	    common cases (hit, or miss in a library) never touch
+ *	    	    the .sym file's string table.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+SymLookupInCache(const Patient	patient,
+		 const char 	*name,
+		 const int  	len,
+		 const int  	class,
+		 Sym	    	*symPtr)
+{
+    SymCache	    	cache;
+    const SymCacheEntry	*sce;
+    ID	    	    	id = NullID;
+
+    cache = SymCache_Get(patient);
+    if (cache == NULL) {
+	return(FALSE);
+    }
+
+    *symPtr = NullSym;
+
+    sce = SymCache_First(cache, name, len);
+    if (sce == NULL) {
+	char	*newname = (char *)malloc(len+2);
+	char	*idname;
+	int 	i;
+
+	newname[0] = '_';
+	bcopy((char *)name, (char *)newname+1, len);
+	sce = SymCache_First(cache, newname, len+1);
+	if (sce == NULL) {
+	    for (i = 0; i < len; i++) {
+		newname[i] = islower(name[i]) ? toupper(name[i]) : name[i];
+	    }
+	    sce = SymCache_First(cache, newname, len);
+	}
+	if (sce == NULL) {
+	    newname[0] = '@';
+	    bcopy((char *)name, (char *)newname+1, len);
+	    sce = SymCache_First(cache, newname, len+1);
+	}
+	free((malloc_t)newname);
+
+	if (sce == NULL) {
+	    return(TRUE);
+	}
+
+	id = SymLookupIDLen(name, len, patient->global);
+	if (id == NullID) {
+	    return(TRUE);
+	}
+	idname = SymLockID(patient->global, id);
+	sce = SymCache_First(cache, idname, strlen(idname));
+	SymUnlockID(patient->global, id);
+    }
+
+    for (; sce != NULL; sce = SymCache_Next(cache, sce)) {
+	SymToken    fsym;
+	ObjSym	    *s;
+	Boolean	    match;
+
+	fsym.file = (VMHandle)patient->symFile;
+	fsym.block = sce->block;
+	fsym.offset = sce->offset;
+
+	/*
+	 * Same as SymLookup: if the symbol's not of an acceptable class,
+	 * we go on to the next module.
+	 */
+	s = SymLock(SymCast(fsym));
+	match = symMap[s->type].class & class;
+	SymUnlock(SymCast(fsym));
+
+	if (match) {
+	    *symPtr = SymCast(fsym);
+	    break;
+	}
+    }
+    return(TRUE);
+}
+
+
 /***********************************************************************
  *				SymRealLookupInPatient
  ***********************************************************************
@@ -863,7 +973,13 @@ SymRealLookupInPatient(const Patient	patient,
      */
     Vector_Add(patientsScanned, VECTOR_END, (void *)&patient);
 
-    if (patient->symFile != NULL) {
+    if (patient->symFile != NULL &&
+	SymLookupInCache(patient, name, len, class, &sym))
+    {
+	if (!Sym_IsNull(sym)) {
+	    return(sym);
+	}
+    } else if (patient->symFile != NULL) {
 	/*
 	 * First map the string into an ID for the patient's symbol file. If
 	 * there's no mapping, the thing can't possibly be here.
@@ -1043,6 +1159,12 @@ Sym_Init(Patient patient)   	/* Patient being initialized */
     ObjSym  	    *os;
     word    	    numRes;
 
+    /*
+     * Any flattened address maps we have could be keyed by the handle
+     * of a symbol file that's since been closed, so nuke them.
+     */
+    (void)SymAddrFlush(NullEvent, NullOpaque, NullOpaque);
+
     fsym.file = (VMHandle)patient->symFile;
     map = VMGetMapBlock(fsym.file);
 
@@ -1100,6 +1222,7 @@ Sym_Init(Patient patient)   	/* Patient being initialized */
     if (resetEvent == NullEvent) {
 	resetEvent = Event_Handle(EVENT_RESET, 0, SymResetHandler,
 				  NullOpaque);
+	(void)Event_Handle(EVENT_DETACH, 0, SymAddrFlush, NullOpaque);
     }
 }
 
@@ -3623,6 +3746,450 @@ Sym_GetCachedMethod(void)
     return &cachedMethod;
 }
  
+/*
+ * Flattened address maps. Walking a segment's address map means locking
+ * the map and then each symbol block in turn, converting the entries as
+ * we go, for every instruction the disassembler prints and every frame
+ * the stack decoder examines. Instead we build, once per module, an
+ * array of the address-bearing symbols of each block in the map, sorted
+ * by address, and keep the maps for the last few modules we've looked
+ * in. SymAddrMapLookup then makes precisely the same choice as the
+ * search in SymLookupAddr with a pair of binary searches and no VM
+ * locking at all.
+ *
+ * Modules whose symbols still carry OSYM_ENTRY indices (i.e. those
+ * coming from a .gym file) aren't flattened, as converting the indices
+ * requires a call to the stub for each one; those continue to be
+ * searched the old way.
+ */
+typedef struct {
+    word    	    address;	/* Segment offset of the symbol */
+    word    	    offset; 	/* Offset of the symbol w/in its block */
+    byte    	    type;   	/* OSYM_* type of the symbol */
+    byte    	    flags;  	/* OSYM_* flags of the symbol */
+} SymAddrEntry;
+
+typedef struct {
+    VMBlockHandle   block;  	/* Symbol block */
+    word    	    last;   	/* Offset of last address-bearing symbol */
+    int	    	    first;  	/* Index of block's first SymAddrEntry */
+    int	    	    num;    	/* Number of entries for the block */
+} SymAddrBlock;
+
+typedef struct {
+    Sym	    	    module; 	/* Module whose map this is */
+    Boolean 	    usable; 	/* FALSE if module must be searched the
+				 * slow way */
+    Boolean 	    sorted; 	/* TRUE if blocks are in ascending order
+				 * of last address, so we can binary-search
+				 * them */
+    int	    	    numBlocks;	/* Number of blocks in the map */
+    SymAddrBlock    *blocks;	/* Blocks, in map order */
+    SymAddrEntry    *entries;	/* Entries for all blocks */
+} SymAddrMapRec, *SymAddrMapPtr;
+
+#define SYM_ADDR_CACHE_SIZE 8
+
+static SymAddrMapPtr	symAddrCache[SYM_ADDR_CACHE_SIZE];
+static int  	    	symAddrCacheLen = 0;
+
+
+/***********************************************************************
+ *				SymAddrMapFree
+ ***********************************************************************
+ * SYNOPSIS:	    Free a flattened address map.
+ * CALLED BY:	    SymAddrMapGet, SymAddrFlush
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The map is freed
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+SymAddrMapFree(SymAddrMapPtr	sam)
+{
+    if (sam->blocks != NULL) {
+	free((malloc_t)sam->blocks);
+    }
+    if (sam->entries != NULL) {
+	free((malloc_t)sam->entries);
+    }
+    free((malloc_t)sam);
+}
+
+/***********************************************************************
+ *				SymAddrFlush
+ ***********************************************************************
+ * SYNOPSIS:	    Throw away all the flattened address maps.
+ * CALLED BY:	    Sym_Init, EVENT_DETACH
+ * RETURN:	    EVENT_HANDLED
+ * SIDE EFFECTS:    symAddrCache emptied
+ *
+ * STRATEGY:	    The maps are keyed by Sym token, which includes the
+ *	    	    VMHandle of the symbol file. A symbol file opened
+ *	    	    after another has been closed may well get the same
+ *	    	    handle, so we flush whenever a new symbol file comes
+ *	    	    into play (it's always passed to Sym_Init).
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+SymAddrFlush(Event  event,
+	     Opaque callData,
+	     Opaque clientData)
+{
+    while (symAddrCacheLen > 0) {
+	SymAddrMapFree(symAddrCache[--symAddrCacheLen]);
+    }
+    return(EVENT_HANDLED);
+}
+
+/***********************************************************************
+ *				SymAddrEntryCmp
+ ***********************************************************************
+ * SYNOPSIS:	    Compare two entries for qsort
+ * CALLED BY:	    SymAddrMapBuild via qsort
+ * RETURN:	    <0, 0, >0
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:	    Order by address, then by position in the block, so
+ *	    	    scanning backward from a point in the array visits
+ *	    	    symbols with the same address in the same order as
+ *	    	    the block search in SymLookupAddr.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+SymAddrEntryCmp(const void *v1, const void *v2)
+{
+    const SymAddrEntry	*e1 = (const SymAddrEntry *)v1;
+    const SymAddrEntry	*e2 = (const SymAddrEntry *)v2;
+
+    if (e1->address != e2->address) {
+	return((e1->address < e2->address) ? -1 : 1);
+    }
+    return((int)e1->offset - (int)e2->offset);
+}
+
+/***********************************************************************
+ *				SymAddrMapBuild
+ ***********************************************************************
+ * SYNOPSIS:	    Flatten the address map for a module.
+ * CALLED BY:	    SymAddrMapGet
+ * RETURN:	    The new map (usable is FALSE if the module can't be
+ *	    	    flattened).
+ * SIDE EFFECTS:    Memory is allocated
+ *
+ * STRATEGY:	    Only symbols that SymLookupAddr could ever return
+ *	    	    (i.e. those in one of the classes it allows) are
+ *	    	    recorded.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static SymAddrMapPtr
+SymAddrMapBuild(Patient	patient,
+		Sym 	module)
+{
+    SymAddrMapPtr   	sam;
+    VMBlockHandle   	map;
+    ObjHeader	    	*hdr;
+    ObjSym  	    	*os;
+    ObjSegment	    	*s;
+    ObjAddrMapHeader	*oamh;
+    ObjAddrMapEntry 	*oame;
+    int	    	    	i, j;
+    int	    	    	numSyms;
+
+    sam = (SymAddrMapPtr)calloc(1, sizeof(SymAddrMapRec));
+    sam->module = module;
+    sam->usable = TRUE;
+    sam->sorted = TRUE;
+
+    map = VMGetMapBlock(patient->symFile);
+    hdr = (ObjHeader *)VMLock(patient->symFile, map, (MemHandle *)NULL);
+    os = SymLock(module);
+    s = (ObjSegment *)((genptr)hdr + os->u.module.offset);
+    SymUnlock(module);
+
+    if (s->addrMap == 0) {
+	/*
+	 * No address map, so no symbols. An empty map gives the right
+	 * answer.
+	 */
+	VMUnlock(patient->symFile, map);
+	return(sam);
+    }
+
+    oamh = (ObjAddrMapHeader *)VMLock(patient->symFile, s->addrMap,
+				      (MemHandle *)NULL);
+
+    /*
+     * First pass to size things and make sure there are no unconverted
+     * entry points.
+     */
+    numSyms = 0;
+    for (i = oamh->numEntries, oame = (ObjAddrMapEntry *)(oamh+1);
+	 i > 0 && sam->usable;
+	 i--, oame++)
+    {
+	ObjSymHeader	*osh;
+
+	osh = (ObjSymHeader *)VMLock(patient->symFile, oame->block,
+				     (MemHandle *)NULL);
+	for (j = osh->num, os = (ObjSym *)(osh+1); j > 0; j--, os++) {
+	    if (os->flags & OSYM_ENTRY) {
+		sam->usable = FALSE;
+		break;
+	    }
+	    numSyms++;
+	}
+	VMUnlock(patient->symFile, oame->block);
+    }
+
+    if (sam->usable) {
+	SymAddrEntry	*sae;
+	SymAddrBlock	*sab;
+
+	sam->numBlocks = oamh->numEntries;
+	sam->blocks = (SymAddrBlock *)malloc((sam->numBlocks|1) *
+					     sizeof(SymAddrBlock));
+	sam->entries = (SymAddrEntry *)malloc((numSyms|1) *
+					      sizeof(SymAddrEntry));
+	sae = sam->entries;
+
+	for (i = 0, oame = (ObjAddrMapEntry *)(oamh+1), sab = sam->blocks;
+	     i < sam->numBlocks;
+	     i++, oame++, sab++)
+	{
+	    ObjSymHeader    *osh;
+
+	    sab->block = oame->block;
+	    sab->last = oame->last;
+	    sab->first = sae - sam->entries;
+	    if (i > 0 && sab->last < sab[-1].last) {
+		sam->sorted = FALSE;
+	    }
+
+	    osh = (ObjSymHeader *)VMLock(patient->symFile, oame->block,
+					 (MemHandle *)NULL);
+	    for (j = osh->num, os = (ObjSym *)(osh+1); j > 0; j--, os++) {
+		if (symMap[os->type].class &
+		    (SYM_VAR|SYM_MODULE|SYM_FUNCTION|SYM_LABEL|SYM_ONSTACK|
+		     SYM_SCOPE))
+		{
+		    sae->address = os->u.addrSym.address;
+		    sae->offset = (genptr)os - (genptr)osh;
+		    sae->type = os->type;
+		    sae->flags = os->flags;
+		    sae++;
+		}
+	    }
+	    VMUnlock(patient->symFile, oame->block);
+
+	    sab->num = (sae - sam->entries) - sab->first;
+	    qsort(&sam->entries[sab->first], sab->num, sizeof(SymAddrEntry),
+		  SymAddrEntryCmp);
+	}
+    }
+
+    VMUnlock(patient->symFile, s->addrMap);
+    VMUnlock(patient->symFile, map);
+    return(sam);
+}
+
+/***********************************************************************
+ *				SymAddrMapGet
+ ***********************************************************************
+ * SYNOPSIS:	    Fetch the flattened address map for a module.
+ * CALLED BY:	    SymLookupAddr
+ * RETURN:	    The map, or NULL if the module must be searched the
+ *	    	    slow way.
+ * SIDE EFFECTS:    The map is built if not in the cache and moved to
+ *	    	    the front of the cache. The least-recently used map
+ *	    	    may be freed.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static SymAddrMapPtr
+SymAddrMapGet(Patient	patient,
+	      Sym   	module)
+{
+    SymAddrMapPtr   sam;
+    int	    	    i;
+
+    for (i = 0; i < symAddrCacheLen; i++) {
+	if (Sym_Equal(symAddrCache[i]->module, module)) {
+	    break;
+	}
+    }
+
+    if (i < symAddrCacheLen) {
+	sam = symAddrCache[i];
+    } else {
+	sam = SymAddrMapBuild(patient, module);
+	if (symAddrCacheLen == SYM_ADDR_CACHE_SIZE) {
+	    SymAddrMapFree(symAddrCache[--symAddrCacheLen]);
+	}
+	i = symAddrCacheLen++;
+    }
+
+    /*
+     * Shift the others down and put this one at the front.
+     */
+    while (i > 0) {
+	symAddrCache[i] = symAddrCache[i-1];
+	i--;
+    }
+    symAddrCache[0] = sam;
+
+    return(sam->usable ? sam : (SymAddrMapPtr)NULL);
+}
+
+/***********************************************************************
+ *				SymAddrMapLookup
+ ***********************************************************************
+ * SYNOPSIS:	    Find a symbol by address in a flattened map.
+ * CALLED BY:	    SymLookupAddr
+ * RETURN:	    The symbol found, or NullSym.
+ * SIDE EFFECTS:    cachedMethod may be set, as for SymLookupAddr.
+ *
+ * STRATEGY:	    Find the block whose last address is the first one
+ *	    	    greater than the address, then search it for the
+ *	    	    acceptable symbol with the greatest address not
+ *	    	    above the one sought. Of several at that address,
+ *	    	    the one latest in the block is chosen, unless the
+ *	    	    address is an exact match and one of them is a
+ *	    	    procedure. If the block has nothing, move to the one
+ *	    	    before it in the map, and so on.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Sym
+SymAddrMapLookup(SymAddrMapPtr	sam,
+		 Patient    	patient,
+		 Handle	    	handle,
+		 Address    	addr,
+		 int	    	class,
+		 int	    	wantExact)
+{
+    Sym	    	    sym = NullSym;
+    int	    	    k;
+    int	    	    lo, hi;
+    word    	    off = (word)addr;
+
+    if (sam->numBlocks == 0) {
+	return(sym);
+    }
+
+    if (sam->sorted) {
+	lo = 0; hi = sam->numBlocks;
+	while (lo < hi) {
+	    int	mid = (lo + hi) >> 1;
+
+	    if (sam->blocks[mid].last > off) {
+		hi = mid;
+	    } else {
+		lo = mid + 1;
+	    }
+	}
+	k = lo;
+    } else {
+	for (k = 0; k < sam->numBlocks; k++) {
+	    if (sam->blocks[k].last > off) {
+		break;
+	    }
+	}
+    }
+    if (k == sam->numBlocks) {
+	k--;
+    }
+
+    for (; k >= 0; k--) {
+	SymAddrBlock	*sab = &sam->blocks[k];
+	SymAddrEntry	*e = &sam->entries[sab->first];
+	SymAddrEntry	*best = (SymAddrEntry *)NULL;
+	int 	    	x;
+
+	/*
+	 * Locate the first entry beyond the address.
+	 */
+	lo = 0; hi = sab->num;
+	while (lo < hi) {
+	    int mid = (lo + hi) >> 1;
+
+	    if (e[mid].address <= off) {
+		lo = mid + 1;
+	    } else {
+		hi = mid;
+	    }
+	}
+
+	for (x = lo - 1; x >= 0; x--) {
+	    if ((e[x].flags & OSYM_NAMELESS) && !(class & SYM_NAMELESS)) {
+		continue;
+	    }
+	    if (!(symMap[e[x].type].class & class)) {
+		continue;
+	    }
+	    if (best == (SymAddrEntry *)NULL) {
+		best = &e[x];
+		if ((best->address != off) || (best->type == OSYM_PROC)) {
+		    break;
+		}
+	    } else if (e[x].address != best->address) {
+		break;
+	    } else if (e[x].type == OSYM_PROC) {
+		best = &e[x];
+		break;
+	    }
+	}
+
+	if (best != (SymAddrEntry *)NULL) {
+	    if (!wantExact || (best->address == off)) {
+		SymFile(sym) = patient->symFile;
+		SymBlock(sym) = sab->block;
+		SymOffset(sym) = best->offset;
+		break;
+	    }
+	    /*
+	     * Found the thing, but not at the exact address, so we must be
+	     * doing a class::msg lookup. Cache the address, as the block
+	     * search does.
+	     */
+	    cachedMethod.handle = handle;
+	    cachedMethod.offset = addr;
+	}
+    }
+    return(sym);
+}
+
 /*-
  *-----------------------------------------------------------------------
  * SymLookupAddr --
@@ -3661,6 +4228,7 @@ SymLookupAddr(Handle	handle,	    /* Handle in which address resides */
 	Patient	    	patient;    /* Patient to which handle belongs */
 	ObjSegment  	*s; 	    /* Segment descriptor for getting
 				     * address map */
+	SymAddrMapPtr	sam;	    /* Flattened address map */
 
 	/*
 	 * Find the patient and module symbol for the block
@@ -3672,7 +4240,13 @@ SymLookupAddr(Handle	handle,	    /* Handle in which address resides */
 	 * Lock down the symbol file's header and point s at the segment
 	 * descriptor for the module so we can get to the address map.
 	 */
-	if (patient->symFile != (Opaque)NULL)
+	if ((patient->symFile != (Opaque)NULL) && (class != SYM_MODULE) &&
+	    ((sam = SymAddrMapGet(patient, module)) != NULL))
+	{
+	    sym = SymAddrMapLookup(sam, patient, handle, addr, class,
+				   wantExact);
+	}
+	else if (patient->symFile != (Opaque)NULL)
 	{
 	map = VMGetMapBlock(patient->symFile);
 	hdr = (ObjHeader *)VMLock(patient->symFile, map, (MemHandle *)NULL);
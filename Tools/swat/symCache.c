@@ -0,0 +1,667 @@
+/***********************************************************************
+ *
+ *	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * PROJECT:	  PCGEOS
+ * MODULE:	  Swat -- Persistent symbol name cache.
+ * FILE:	  symCache.c
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * ROUTINES:
+ *	Name	  	    Description
+ *	----	  	    -----------
+ *	SymCache_Get	    Return the name cache for a patient, building
+ *	    	    	    or loading it as necessary.
+ *	SymCache_Close	    Release the name cache for a patient.
+ *	SymCache_First	    Find the first global symbol with a name.
+ *	SymCache_Next	    Find the next global symbol with the same name.
+ *
+ * REVISION HISTORY:
+ *	Date	  Name	    Description
+ *	----	  ----	    -----------
+ *	10/16/26  agent	    Initial version
+ *
+ * DESCRIPTION:
+ *	Looking up a name in a patient requires mapping the string to an ID
+ *	through the .sym file's string table, then searching the hash table
+ *	of every module in the patient, locking a VM block or two for each.
+ *	As a symbol not found in a patient is sought in all its libraries
+ *	too, this is most of the work swat does for a symbol lookup.
+ *
+ *	This module flattens the names of all symbols in all of a patient's
+ *	module hash tables into a single hash table that lives in a file
+ *	under the cache directory. The file is validated against the size
+ *	and modification time of the .sym file and, if still good, mapped
+ *	in with a single mmap, so a subsequent attach need read nothing
+ *	until a name is actually looked up, and a lookup touches nothing
+ *	but the mapped pages.
+ *
+ *	The cache directory is given by the SWAT_SYMCACHE environment
+ *	variable, defaulting to ~/.swat/symcache. Setting SWAT_SYMCACHE
+ *	to the empty string disables the cache entirely. If the cache
+ *	can't be written, the table is still built in memory and used for
+ *	the life of the patient.
+ *
+ *	The cache is only maintained on UNIX hosts.
+ *
+ ***********************************************************************/
+#ifndef lint
+static char *rcsid =
+"$Id$";
+#endif lint
+
+#include <config.h>
+#include "swat.h"
+#include "sym.h"
+#include "vector.h"
+#include "vmsym.h"
+#include "symCache.h"
+#include <compat/stdlib.h>
+#include <compat/file.h>
+
+#if defined(unix)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Header at the start of each cache file. It is followed by the bucket
+ * array (numBuckets dwords, each holding the index+1 of the first entry
+ * in the bucket, or 0), the entries themselves, and finally the names.
+ */
+typedef struct {
+    dword   	magic;	    	/* SYMCACHE_MAGIC */
+    dword   	version;    	/* SYMCACHE_VERSION */
+    dword   	symSize;    	/* Size of the .sym file */
+    dword   	symMTime;   	/* Modification time of the .sym file */
+    dword   	numRes;	    	/* Number of resources in the patient */
+    dword   	numBuckets; 	/* Number of hash buckets */
+    dword   	numEntries; 	/* Number of SymCacheEntry records */
+    dword   	stringSize; 	/* Number of bytes of names */
+} SymCacheHeader;
+
+#define SYMCACHE_MAGIC	    0x53584331	/* SXC1 */
+#define SYMCACHE_VERSION    1
+#define SYMCACHE_SUFFIX	    ".sxc"
+
+typedef struct {
+    VMHandle	    file;   	/* Symbol file for which it was made */
+    Boolean 	    mapped; 	/* TRUE if data is mmapped, not malloced */
+    genptr  	    data;   	/* Base of the cache (NULL if none) */
+    long    	    size;   	/* Number of bytes at data */
+    SymCacheHeader  *hdr;   	/* Header of the cache */
+    dword   	    *buckets;	/* Hash buckets */
+    SymCacheEntry   *entries;	/* All entries */
+    char    	    *strings;	/* All names */
+} SymCacheRec, *SymCachePtr;
+
+
+/***********************************************************************
+ *				SymCacheHash
+ ***********************************************************************
+ * SYNOPSIS:	    Hash a name for the cache.
+ * CALLED BY:	    INTERNAL
+ * RETURN:	    32-bit hash value
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:	    FNV-1a, which is cheap and spreads identifiers that
+ *	    	    differ only in their last character (MSG_FOO_1,
+ *	    	    MSG_FOO_2...) well.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static dword
+SymCacheHash(const char *name, int len)
+{
+    dword   	h = 2166136261UL;
+
+    while (len-- > 0) {
+	h ^= (byte)*name++;
+	h *= 16777619UL;
+    }
+    return(h);
+}
+
+/***********************************************************************
+ *				SymCache_First
+ ***********************************************************************
+ * SYNOPSIS:	    Locate the first global symbol with the given name.
+ * CALLED BY:	    SymLookupInCache
+ * RETURN:	    The entry, or NULL if no global symbol by that name.
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+const SymCacheEntry *
+SymCache_First(SymCache	    cache,
+	       const char   *name,
+	       int  	    len)
+{
+    SymCachePtr	    scp = (SymCachePtr)cache;
+    dword   	    hash = SymCacheHash(name, len);
+    dword   	    i;
+    SymCacheEntry   *sce;
+
+    for (i = scp->buckets[hash % scp->hdr->numBuckets]; i != 0; i = sce->next)
+    {
+	sce = &scp->entries[i-1];
+	if ((sce->hash == hash) && (sce->nameLen == len) &&
+	    (bcmp(scp->strings + sce->nameOff, name, len) == 0))
+	{
+	    return(sce);
+	}
+    }
+    return((const SymCacheEntry *)NULL);
+}
+
+/***********************************************************************
+ *				SymCache_Next
+ ***********************************************************************
+ * SYNOPSIS:	    Locate the next global symbol with the same name as
+ *	    	    the given one.
+ * CALLED BY:	    SymLookupInCache
+ * RETURN:	    The entry, or NULL if no more.
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:	    Entries for a name are in the bucket in the order in
+ *	    	    which the modules are searched, so just keep going
+ *	    	    down the bucket.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+const SymCacheEntry *
+SymCache_Next(SymCache	    	    cache,
+	      const SymCacheEntry   *prev)
+{
+    SymCachePtr	    scp = (SymCachePtr)cache;
+    dword   	    i;
+    SymCacheEntry   *sce;
+
+    for (i = prev->next; i != 0; i = sce->next) {
+	sce = &scp->entries[i-1];
+	if ((sce->hash == prev->hash) && (sce->nameLen == prev->nameLen) &&
+	    (bcmp(scp->strings + sce->nameOff, scp->strings + prev->nameOff,
+		  prev->nameLen) == 0))
+	{
+	    return(sce);
+	}
+    }
+    return((const SymCacheEntry *)NULL);
+}
+
+#if defined(unix)
+
+/***********************************************************************
+ *				SymCacheSetup
+ ***********************************************************************
+ * SYNOPSIS:	    Point the pieces of the cache record at the
+ *	    	    various parts of the cache data, making sure it's
+ *	    	    all consistent.
+ * CALLED BY:	    SymCacheLoad, SymCacheBuild
+ * RETURN:	    TRUE if the data are sane
+ * SIDE EFFECTS:    hdr, buckets, entries and strings set
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+SymCacheSetup(SymCachePtr   scp)
+{
+    SymCacheHeader  *hdr = (SymCacheHeader *)scp->data;
+
+    if ((scp->size < sizeof(SymCacheHeader)) ||
+	(hdr->magic != SYMCACHE_MAGIC) ||
+	(hdr->version != SYMCACHE_VERSION) ||
+	(hdr->numBuckets == 0) ||
+	(scp->size != (sizeof(SymCacheHeader) +
+		       hdr->numBuckets * sizeof(dword) +
+		       hdr->numEntries * sizeof(SymCacheEntry) +
+		       hdr->stringSize)))
+    {
+	return(FALSE);
+    }
+    scp->hdr = hdr;
+    scp->buckets = (dword *)(hdr+1);
+    scp->entries = (SymCacheEntry *)(scp->buckets + hdr->numBuckets);
+    scp->strings = (char *)(scp->entries + hdr->numEntries);
+    return(TRUE);
+}
+
+/***********************************************************************
+ *				SymCacheLoad
+ ***********************************************************************
+ * SYNOPSIS:	    Map in an existing cache file, if it's still valid
+ * CALLED BY:	    SymCache_Get
+ * RETURN:	    TRUE if the cache was mapped in
+ * SIDE EFFECTS:    scp->data etc. set on success
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+SymCacheLoad(SymCachePtr    scp,
+	     const char	    *cachePath,
+	     struct stat    *symStat,
+	     int    	    numRes)
+{
+    int	    	    fd;
+    struct stat	    stb;
+    caddr_t 	    base;
+
+    fd = open(cachePath, O_RDONLY);
+    if (fd < 0) {
+	return(FALSE);
+    }
+    if ((fstat(fd, &stb) < 0) || (stb.st_size < sizeof(SymCacheHeader))) {
+	(void)close(fd);
+	return(FALSE);
+    }
+
+    base = mmap((caddr_t)0, stb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    (void)close(fd);
+
+    if (base == (caddr_t)MAP_FAILED) {
+	return(FALSE);
+    }
+
+    scp->data = (genptr)base;
+    scp->size = stb.st_size;
+    scp->mapped = TRUE;
+
+    if (!SymCacheSetup(scp) ||
+	(scp->hdr->symSize != (dword)symStat->st_size) ||
+	(scp->hdr->symMTime != (dword)symStat->st_mtime) ||
+	(scp->hdr->numRes != numRes))
+    {
+	(void)munmap(base, stb.st_size);
+	scp->data = (genptr)NULL;
+	return(FALSE);
+    }
+    return(TRUE);
+}
+
+/***********************************************************************
+ *				SymCacheBuild
+ ***********************************************************************
+ * SYNOPSIS:	    Build the cache for a patient from its .sym file.
+ * CALLED BY:	    SymCache_Get
+ * RETURN:	    TRUE if the cache could be built
+ * SIDE EFFECTS:    scp->data points to malloced memory holding the
+ *	    	    cache image.
+ *
+ * STRATEGY:	    Walk every chain of every module's hash table, in the
+ *	    	    order SymRealLookupInPatient visits the modules,
+ *	    	    recording the name and location of each symbol. The
+ *	    	    buckets are then threaded back-to-front so each
+ *	    	    bucket lists its entries in that same order.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static Boolean
+SymCacheBuild(SymCachePtr   scp,
+	      Patient	    patient,
+	      struct stat   *symStat)
+{
+    Vector  	    entries;
+    Vector  	    strings;
+    SymCacheEntry   sce;
+    SymCacheHeader  *hdr;
+    int	    	    i;
+    dword   	    n;
+    int	    	    numChains;
+    VMHandle	    file = (VMHandle)patient->symFile;
+
+    numChains = (patient->symfileFormat == SYMFILE_FORMAT_OLD) ?
+	OBJ_HASH_CHAINS : OBJ_HASH_CHAINS_NEW_FORMAT;
+
+    entries = Vector_Create(sizeof(SymCacheEntry), ADJUST_MULTIPLY, 2, 1024);
+    strings = Vector_Create(sizeof(char), ADJUST_MULTIPLY, 2, 16384);
+
+    bzero(&sce, sizeof(sce));
+
+    for (i = 0; i < patient->numRes; i++) {
+	Sym 	    	mod = patient->resources[i].sym;
+	ObjSym	    	*os;
+	VMBlockHandle	table;
+	VMBlockHandle	*chains;
+	int 	    	c;
+
+	if (Sym_IsNull(mod)) {
+	    continue;
+	}
+	os = SymLock(mod);
+	table = os->u.module.table;
+	SymUnlock(mod);
+
+	if (table == 0) {
+	    continue;
+	}
+
+	chains = (VMBlockHandle *)VMLock(file, table, (MemHandle *)NULL);
+	for (c = 0; c < numChains; c++) {
+	    VMBlockHandle   cur, next;
+
+	    for (cur = chains[c]; cur != 0; cur = next) {
+		ObjHashBlock	*hb;
+		ObjHashEntry	*he;
+
+		/*
+		 * The two formats differ only in the number of entries per
+		 * block, so we can treat the new as the old here.
+		 */
+		hb = (ObjHashBlock *)VMLock(file, cur, (MemHandle *)NULL);
+		next = hb->next;
+
+		for (he = hb->entries; he < &hb->entries[hb->nextEnt]; he++) {
+		    char    *name = SymLockID(mod, he->name);
+		    int	    len = strlen(name);
+
+		    sce.hash = SymCacheHash(name, len);
+		    sce.nameOff = Vector_Length(strings);
+		    sce.nameLen = len;
+		    sce.id = he->name;
+		    sce.block = he->block;
+		    sce.offset = he->offset;
+
+		    while (*name != '\0') {
+			Vector_Add(strings, VECTOR_END, name);
+			name++;
+		    }
+		    SymUnlockID(mod, he->name);
+		    Vector_Add(entries, VECTOR_END, &sce);
+		}
+		VMUnlock(file, cur);
+	    }
+	}
+	VMUnlock(file, table);
+    }
+
+    n = Vector_Length(entries);
+
+    scp->size = sizeof(SymCacheHeader) +
+	(n|1) * sizeof(dword) +
+	n * sizeof(SymCacheEntry) +
+	Vector_Length(strings);
+    scp->data = (genptr)malloc(scp->size);
+    scp->mapped = FALSE;
+
+    hdr = (SymCacheHeader *)scp->data;
+    hdr->magic = SYMCACHE_MAGIC;
+    hdr->version = SYMCACHE_VERSION;
+    hdr->symSize = symStat->st_size;
+    hdr->symMTime = symStat->st_mtime;
+    hdr->numRes = patient->numRes;
+    hdr->numBuckets = n|1;  	    /* Odd, and never zero */
+    hdr->numEntries = n;
+    hdr->stringSize = Vector_Length(strings);
+
+    (void)SymCacheSetup(scp);
+
+    bzero(scp->buckets, hdr->numBuckets * sizeof(dword));
+    if (n != 0) {
+	bcopy(Vector_Data(entries), scp->entries, n * sizeof(SymCacheEntry));
+    }
+    if (hdr->stringSize != 0) {
+	bcopy(Vector_Data(strings), scp->strings, hdr->stringSize);
+    }
+
+    while (n > 0) {
+	SymCacheEntry	*e = &scp->entries[n-1];
+	dword	    	*b = &scp->buckets[e->hash % hdr->numBuckets];
+
+	e->next = *b;
+	*b = n;
+	n--;
+    }
+
+    Vector_Destroy(entries);
+    Vector_Destroy(strings);
+    return(TRUE);
+}
+
+/***********************************************************************
+ *				SymCacheWrite
+ ***********************************************************************
+ * SYNOPSIS:	    Write a freshly-built cache out to disk.
+ * CALLED BY:	    SymCache_Get
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The cache directory is created if necessary.
+ *
+ * STRATEGY:	    Write to a temporary file and rename it into place,
+ *	    	    so another swat mapping the old file is unaffected and
+ *	    	    one reading the new never sees it half-written.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+SymCacheWrite(SymCachePtr   scp,
+	      const char    *cacheDir,
+	      const char    *cachePath)
+{
+    char    *tmpPath;
+    int	    fd;
+    char    *cp;
+
+    /*
+     * Create the directory and any missing parents. Failure is detected
+     * when we try to create the file.
+     */
+    cp = (char *)malloc(strlen(cacheDir) + 1);
+    strcpy(cp, cacheDir);
+    for (tmpPath = index(cp+1, '/'); tmpPath != NULL;
+	 tmpPath = index(tmpPath+1, '/'))
+    {
+	*tmpPath = '\0';
+	(void)mkdir(cp, 0777);
+	*tmpPath = '/';
+    }
+    (void)mkdir(cp, 0777);
+    free(cp);
+
+    tmpPath = (char *)malloc(strlen(cachePath) + 16);
+    sprintf(tmpPath, "%s.%d", cachePath, (int)getpid());
+
+    fd = open(tmpPath, O_WRONLY|O_CREAT|O_TRUNC, 0666);
+    if (fd < 0) {
+	free(tmpPath);
+	return;
+    }
+    if ((write(fd, scp->data, scp->size) != scp->size) ||
+	(close(fd) < 0) ||
+	(rename(tmpPath, cachePath) < 0))
+    {
+	dprintf("Couldn't write symbol cache %s\n", cachePath);
+	(void)unlink(tmpPath);
+    }
+    free(tmpPath);
+}
+#endif /* unix */
+
+/***********************************************************************
+ *				SymCache_Get
+ ***********************************************************************
+ * SYNOPSIS:	    Fetch the name cache for a patient.
+ * CALLED BY:	    SymLookupInCache
+ * RETURN:	    The cache, or NULL if there isn't one.
+ * SIDE EFFECTS:    The cache may be loaded or built and saved.
+ *
+ * STRATEGY:	    The cache record is hung off the patient's symPriv
+ *	    	    field and remembers the VM file for which it was
+ *	    	    made, so a patient whose symbol file was reopened
+ *	    	    gets its cache revalidated. A record with no data
+ *	    	    means we already failed for this file, so we don't
+ *	    	    try again on every lookup.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+SymCache
+SymCache_Get(Patient	patient)
+{
+    SymCachePtr	    scp = (SymCachePtr)patient->symPriv;
+
+    if (patient->symFile == NULL) {
+	return((SymCache)NULL);
+    }
+
+    if ((scp != NULL) && (scp->file != (VMHandle)patient->symFile)) {
+	SymCache_Close(patient);
+	scp = NULL;
+    }
+
+    if (scp == NULL) {
+	scp = (SymCachePtr)calloc(1, sizeof(SymCacheRec));
+	scp->file = (VMHandle)patient->symFile;
+	patient->symPriv = (Opaque)scp;
+
+#if defined(unix)
+	{
+	    char    	*cacheDir = getenv("SWAT_SYMCACHE");
+	    char    	*home = getenv("HOME");
+	    char    	*symPath;
+	    char    	*cachePath;
+	    char    	*base;
+	    char    	*suffix;
+	    struct stat	stb;
+
+	    if ((cacheDir != NULL) && (*cacheDir == '\0')) {
+		/*
+		 * Explicitly disabled.
+		 */
+		return((SymCache)NULL);
+	    }
+
+	    /*
+	     * Form the name of the symbol file the same way IbmOpenObject
+	     * does.
+	     */
+	    symPath = (char *)malloc(strlen(patient->path) + 4 + 1);
+	    strcpy(symPath, patient->path);
+	    suffix = rindex(symPath, '.');
+	    if ((suffix != NULL) &&
+		(!strcmp(suffix, ".geo") || !strcmp(suffix, ".GEO") ||
+		 !strcmp(suffix, ".exe") || !strcmp(suffix, ".EXE")))
+	    {
+		strcpy(suffix, ".sym");
+	    }
+
+	    if (stat(symPath, &stb) < 0) {
+		free(symPath);
+		return((SymCache)NULL);
+	    }
+
+	    if (cacheDir == NULL) {
+		if (home == NULL) {
+		    free(symPath);
+		    return((SymCache)NULL);
+		}
+		cacheDir = (char *)malloc(strlen(home) + sizeof("/.swat/symcache"));
+		sprintf(cacheDir, "%s/.swat/symcache", home);
+	    } else {
+		cacheDir = strcpy((char *)malloc(strlen(cacheDir)+1), cacheDir);
+	    }
+
+	    /*
+	     * Name the cache after the final component of the symbol file,
+	     * qualified by a hash of the full path so identically-named
+	     * geodes from different trees don't collide.
+	     */
+	    base = rindex(symPath, '/');
+	    base = (base == NULL) ? symPath : base + 1;
+	    cachePath = (char *)malloc(strlen(cacheDir) + 1 + strlen(base) +
+				       1 + 8 + sizeof(SYMCACHE_SUFFIX));
+	    sprintf(cachePath, "%s/%s-%08lx%s", cacheDir, base,
+		    (unsigned long)SymCacheHash(symPath, strlen(symPath)),
+		    SYMCACHE_SUFFIX);
+
+	    if (!SymCacheLoad(scp, cachePath, &stb, patient->numRes)) {
+		if (SymCacheBuild(scp, patient, &stb)) {
+		    SymCacheWrite(scp, cacheDir, cachePath);
+		}
+	    }
+
+	    free(cachePath);
+	    free(cacheDir);
+	    free(symPath);
+	}
+#endif /* unix */
+    }
+
+    return((scp->data != NULL) ? (SymCache)scp : (SymCache)NULL);
+}
+
+/***********************************************************************
+ *				SymCache_Close
+ ***********************************************************************
+ * SYNOPSIS:	    Release the name cache for a patient.
+ * CALLED BY:	    SymCache_Get, IbmBiffPatient
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The cache is unmapped or freed, symPriv zeroed.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+SymCache_Close(Patient	patient)
+{
+    SymCachePtr	    scp = (SymCachePtr)patient->symPriv;
+
+    if (scp != NULL) {
+	if (scp->data != NULL) {
+#if defined(unix)
+	    if (scp->mapped) {
+		(void)munmap((caddr_t)scp->data, scp->size);
+	    } else
+#endif
+	    {
+		free((malloc_t)scp->data);
+	    }
+	}
+	free((malloc_t)scp);
+	patient->symPriv = NullOpaque;
+    }
+}
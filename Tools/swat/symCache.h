@@ -0,0 +1,48 @@
+/***********************************************************************
+ *
+ *	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * PROJECT:	  PCGEOS
+ * MODULE:	  Swat -- Persistent symbol name cache.
+ * FILE:	  symCache.h
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * REVISION HISTORY:
+ *	Date	  Name	    Description
+ *	----	  ----	    -----------
+ *	10/16/26  agent	    Initial version
+ *
+ * DESCRIPTION:
+ *	Interface to the on-disk cache of a patient's global symbol names.
+ *
+ ***********************************************************************/
+#ifndef _SYMCACHE_H
+#define _SYMCACHE_H
+
+typedef Opaque	    SymCache;
+
+/*
+ * One global symbol, as recorded in the cache. Entries for the same name
+ * appear in the order of the patient's resources, just as SymLookup would
+ * encounter them.
+ */
+typedef struct {
+    dword   	    hash;   	/* Hash value of the name */
+    dword   	    next;   	/* Index+1 of next entry in the bucket */
+    dword   	    nameOff;	/* Offset of the name in the string area */
+    dword   	    id;	    	/* Identifier in the .sym file */
+    word    	    nameLen;	/* Length of the name */
+    VMBlockHandle   block;  	/* Symbol block holding the symbol */
+    word    	    offset; 	/* Offset of the symbol w/in the block */
+    word    	    pad;    	/* Keep entries dword-aligned */
+} SymCacheEntry;
+
+extern SymCache	    	    SymCache_Get(Patient patient);
+extern void 	    	    SymCache_Close(Patient patient);
+extern const SymCacheEntry  *SymCache_First(SymCache cache,
+					    const char *name, int len);
+extern const SymCacheEntry  *SymCache_Next(SymCache cache,
+					   const SymCacheEntry *sce);
+
+#endif /* _SYMCACHE_H */
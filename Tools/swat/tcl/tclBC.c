@@ -54,6 +54,7 @@ static char *rcsid =
 #include <sys/signal.h>
 #include <sys/file.h>
 #include <sys/unistd.h>
+#include <sys/stat.h>
 #define O_TEXT	    0
 #define O_BINARY    0
 #endif /* unix */
@@ -79,11 +80,49 @@ static char *rcsid =
 
 #endif /* _MSDOS || _WIN32 */
 
+#if defined(_WIN32)
+#include <direct.h>
+#include <process.h>
+#endif /* _WIN32 */
+
 #include "tclInt.h"
 
 static int bcDebug = 0;	    	/* If non-zero, then trace procedures will
 				 * be called when possible during evaluation */
 
+/*
+ * Inline caches for TBOP_CALL and TBOP_PUSHV. Each call site (the address
+ * of its opcode) hashes to a slot that remembers what the site last
+ * resolved to. A command entry is good so long as no command has been
+ * created or deleted since (tclCmdEpoch); a variable entry so long as the
+ * variable frame is the same one (VarFrame serial). As code buffers can
+ * be freed and their addresses reused, the name is checked too, which is
+ * still much cheaper than the full lookup.
+ */
+#define TBC_ICACHE_SIZE	    512	    /* Must be a power of 2 */
+#define TBC_ICACHE_SLOT(site) \
+    ((((unsigned long)(site)) ^ (((unsigned long)(site)) >> 9)) & \
+     (TBC_ICACHE_SIZE-1))
+
+typedef struct {
+    const unsigned char	*site;	    /* Opcode address */
+    Interp  	    	*iPtr;	    /* Interpreter in which it was found */
+    unsigned long   	epoch;	    /* tclCmdEpoch when found */
+    Command 	    	*cmdPtr;    /* Command found */
+} TBCCmdCache;
+
+typedef struct {
+    const unsigned char	*site;	    /* Opcode address */
+    unsigned long   	serial;	    /* Serial number of VarFrame searched */
+    Var	    	    	*varPtr;    /* Variable found */
+} TBCVarCache;
+
+static TBCCmdCache  bcCmdCache[TBC_ICACHE_SIZE];
+static TBCVarCache  bcVarCache[TBC_ICACHE_SIZE];
+
+static int  bcCmdCacheHits = 0, bcCmdCacheMisses = 0;
+static int  bcVarCacheHits = 0, bcVarCacheMisses = 0;
+
 
 typedef enum {
     TBOP_PUSH,	    /* args: string
@@ -777,10 +816,40 @@ TclByteCodeEval(Tcl_Interp    	    *interp,
 	{
 	    /* args: varname
 	     * stack: -- varval-string */
+	    const unsigned char	*site = p-1;
 	    const char *varname = TclByteCodeFetchString(iPtr, &p, NULL);
 	    const char *val;
+	    TBCVarCache	*vc = &bcVarCache[TBC_ICACHE_SLOT(site)];
+	    VarFrame	*vf = iPtr->top->localPtr;
+	    Var	    	*varPtr;
 
-	    val = Tcl_GetVar(interp, varname, 0);
+	    if ((vc->site == site) && (vc->serial == vf->serial) &&
+		(vc->varPtr->name[0] == varname[0]) &&
+		(strcmp(vc->varPtr->name, varname) == 0))
+	    {
+		bcVarCacheHits++;
+		varPtr = vc->varPtr;
+	    } else {
+		bcVarCacheMisses++;
+		varPtr = TclProcFindVar(vf, varname);
+		if (varPtr != NULL) {
+		    vc->site = site;
+		    vc->serial = vf->serial;
+		    vc->varPtr = varPtr;
+		}
+	    }
+
+	    /*
+	     * Fetch the value as Tcl_GetVar would.
+	     */
+	    if (varPtr != NULL && (varPtr->flags & VAR_GLOBAL)) {
+		varPtr = varPtr->globalPtr;
+	    }
+	    if (varPtr == NULL || varPtr->value == NULL) {
+		val = "";
+	    } else {
+		val = varPtr->value;
+	    }
 
 	    TclByteCodePush(iPtr, TBSET_STRING, 0, strlen(val), val);
 	    continue;
@@ -820,6 +889,7 @@ TclByteCodeEval(Tcl_Interp    	    *interp,
 	    Tcl_CmdProc	    *proc;
 	    ClientData	    clientData;
 	    unsigned	    extra = 0;
+	    const unsigned char	*site = p-1;
 
 	    /*
 	     * Make sure there are enough arguments on the operand stack.
@@ -863,7 +933,33 @@ TclByteCodeEval(Tcl_Interp    	    *interp,
 		    procname = ELT(nargs)->eltData;
 		}
 
-		cmd = TclFindCmd(iPtr, procname, 0);
+		if (extra) {
+		    cmd = TclFindCmd(iPtr, procname, 0);
+		} else {
+		    TBCCmdCache	*cc = &bcCmdCache[TBC_ICACHE_SLOT(site)];
+
+		    if ((cc->site == site) && (cc->iPtr == iPtr) &&
+			(cc->epoch == tclCmdEpoch) &&
+			(strcmp(cc->cmdPtr->name, procname) == 0))
+		    {
+			bcCmdCacheHits++;
+			cmd = cc->cmdPtr;
+		    } else {
+			bcCmdCacheMisses++;
+			cmd = TclFindCmd(iPtr, procname, 0);
+			/*
+			 * Only remember exact matches, so the name check
+			 * above is sufficient.
+			 */
+			if ((cmd != NULL) && (strcmp(cmd->name, procname) == 0))
+			{
+			    cc->site = site;
+			    cc->iPtr = iPtr;
+			    cc->epoch = tclCmdEpoch;
+			    cc->cmdPtr = cmd;
+			}
+		    }
+		}
 
 		if (cmd == NULL) {
 		    result = TCL_ERROR;
@@ -5315,6 +5411,528 @@ TBCReadFile(Tcl_Interp *interp, const char *inname, unsigned long *sizePtr)
 }
 
 
+/*
+ * Persistent cache of compiled library files. Each source file loaded
+ * through "bc-cache load" has its compiled form kept in a file in the
+ * cache directory, named for the final component of the source file and
+ * a hash of its full path. The cache file is used so long as the source
+ * file's modification time and size, and the interpreter's list of
+ * built-in commands (whose indices are stored in the code), are unchanged.
+ *
+ * The directory is given by the SWAT_BCCACHE environment variable,
+ * defaulting to ~/.swat/bccache (%USERPROFILE%/.swat/bccache on NT).
+ * Setting SWAT_BCCACHE to the empty string disables the cache, in which
+ * case files are evaluated from source as "source" would, without paying
+ * to compile them.
+ */
+#define TBC_CACHE_VERSION   1
+#define TBC_CACHE_SUFFIX    ".tbc"
+
+typedef struct {
+    unsigned char   magic[4];	    /* TBC_CACHE_MAGIC */
+    unsigned long   version;	    /* TBC_CACHE_VERSION */
+    unsigned long   numCmds;	    /* numBuiltInCmds when compiled */
+    unsigned long   srcMTime;	    /* Modification time of source file */
+    unsigned long   srcSize;	    /* Size of source file */
+    unsigned long   pathLen;	    /* Length of source path that follows */
+    unsigned long   codeSize;	    /* Length of code that follows path */
+} TBCCacheHeader;
+
+static const unsigned char tbcCacheMagic[4] = { 0, 0xad, 0xb0, 'C' };
+
+static int  bcCacheHits = 0;	    /* Files loaded from the cache */
+static int  bcCacheMisses = 0;	    /* Files compiled and (re)cached */
+static int  bcCacheUncached = 0;    /* Files evaluated from source because
+				     * they couldn't be compiled or there's
+				     * no cache */
+static char *bcCacheDir = 0;	    /* Cache directory (0 if not yet set,
+				     * "" if disabled) */
+
+#if defined(unix) || defined(_WIN32)
+
+#if defined(_WIN32)
+#define TBCCacheIsSep(c)    	((c) == '/' || (c) == '\\')
+#define TBCCacheIsAbs(p)    	(TBCCacheIsSep((p)[0]) || \
+				 (isalpha((p)[0]) && (p)[1] == ':'))
+#define TBCCacheMkdir(p)    	_mkdir(p)
+#define TBCCacheGetPid()    	_getpid()
+#define TBCCacheGetCwd(b,n) 	_getcwd(b,n)
+#else
+#define TBCCacheIsSep(c)    	((c) == '/')
+#define TBCCacheIsAbs(p)    	((p)[0] == '/')
+#define TBCCacheMkdir(p)    	mkdir(p, 0777)
+#define TBCCacheGetPid()    	getpid()
+#define TBCCacheGetCwd(b,n) 	getcwd(b,n)
+#endif /* _WIN32 */
+
+/***********************************************************************
+ *				TBCCacheGetDir
+ ***********************************************************************
+ * SYNOPSIS:	    Return the directory holding cached byte-code
+ * CALLED BY:	    TBCCacheLoad, Tcl_BCCacheCmd
+ * RETURN:	    the directory ("" if caching is disabled)
+ * SIDE EFFECTS:    bcCacheDir is set on the first call
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static const char *
+TBCCacheGetDir(void)
+{
+    if (bcCacheDir == 0) {
+	char	*dir = (char *)getenv("SWAT_BCCACHE");
+	char	*home = (char *)getenv("HOME");
+
+#if defined(_WIN32)
+	if (home == 0) {
+	    home = (char *)getenv("USERPROFILE");
+	}
+#endif /* _WIN32 */
+
+	if (dir != 0) {
+	    bcCacheDir = (char *)malloc(strlen(dir) + 1);
+	    strcpy(bcCacheDir, dir);
+	} else if (home != 0) {
+	    bcCacheDir = (char *)malloc(strlen(home) +
+					sizeof("/.swat/bccache"));
+	    sprintf(bcCacheDir, "%s/.swat/bccache", home);
+	} else {
+	    bcCacheDir = (char *)malloc(1);
+	    *bcCacheDir = '\0';
+	}
+    }
+    return (bcCacheDir);
+}
+
+/***********************************************************************
+ *				TBCCacheHash
+ ***********************************************************************
+ * SYNOPSIS:	    Hash a source path to qualify its cache file name
+ * CALLED BY:	    TBCCacheLoad
+ * RETURN:	    the hash value
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:	    FNV-1a
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static unsigned long
+TBCCacheHash(const char *path)
+{
+    unsigned long   h = 0x811c9dc5;
+
+    while (*path != '\0') {
+	h = ((h ^ (unsigned char)*path++) * 0x01000193) & 0xffffffff;
+    }
+    return (h);
+}
+
+/***********************************************************************
+ *				TBCCacheRead
+ ***********************************************************************
+ * SYNOPSIS:	    Fetch the compiled form of a source file from the
+ *		    cache, if it's there and current.
+ * CALLED BY:	    TBCCacheLoad
+ * RETURN:	    malloced buffer holding the header, path and code,
+ *		    or 0 if the cache file is missing or stale.
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static unsigned char *
+TBCCacheRead(const char *cachePath,
+	     const char *path,
+	     struct stat *stbPtr)
+{
+    int	    	    fd;
+    TBCCacheHeader  hdr;
+    unsigned char   *contents;
+    unsigned long   size;
+
+    fd = open(cachePath, O_RDONLY | O_BINARY, 0);
+    if (fd < 0) {
+	return (0);
+    }
+    if ((read(fd, (char *)&hdr, sizeof(hdr)) != sizeof(hdr)) ||
+	(bcmp(hdr.magic, tbcCacheMagic, sizeof(tbcCacheMagic)) != 0) ||
+	(hdr.version != TBC_CACHE_VERSION) ||
+	(hdr.numCmds != numBuiltInCmds) ||
+	(hdr.srcMTime != (unsigned long)stbPtr->st_mtime) ||
+	(hdr.srcSize != (unsigned long)stbPtr->st_size) ||
+	(hdr.pathLen != strlen(path)))
+    {
+	(void)close(fd);
+	return (0);
+    }
+
+    size = sizeof(hdr) + hdr.pathLen + hdr.codeSize;
+    contents = (unsigned char *)malloc(size);
+    bcopy((char *)&hdr, contents, sizeof(hdr));
+    if ((read(fd, contents + sizeof(hdr), size - sizeof(hdr)) !=
+	 size - sizeof(hdr)) ||
+	(bcmp(contents + sizeof(hdr), path, hdr.pathLen) != 0))
+    {
+	/*
+	 * Truncated, or a different file whose path hashes the same.
+	 */
+	(void)close(fd);
+	free((char *)contents);
+	return (0);
+    }
+    (void)close(fd);
+    return (contents);
+}
+
+/***********************************************************************
+ *				TBCCacheWrite
+ ***********************************************************************
+ * SYNOPSIS:	    Save the compiled form of a source file in the cache
+ * CALLED BY:	    TBCCacheLoad
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the cache directory is created if necessary
+ *
+ * STRATEGY:	    Write to a temporary file and rename it into place so
+ *		    another swat loading the same file never sees it
+ *		    half-written. Failure just means we'll compile the
+ *		    thing again next time.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+TBCCacheWrite(const char    	    *cacheDir,
+	      const char    	    *cachePath,
+	      const char    	    *path,
+	      struct stat   	    *stbPtr,
+	      const unsigned char   *code,
+	      unsigned long 	    codeSize)
+{
+    TBCCacheHeader  hdr;
+    char    	    *tmpPath;
+    char    	    *cp;
+    int	    	    fd;
+
+    /*
+     * Create the directory and any missing parents. Failure is detected
+     * when we try to create the file.
+     */
+    cp = (char *)malloc(strlen(cacheDir) + 1);
+    strcpy(cp, cacheDir);
+    for (tmpPath = cp+1; *tmpPath != '\0'; tmpPath++) {
+	if (TBCCacheIsSep(*tmpPath)) {
+	    char    sep = *tmpPath;
+
+	    *tmpPath = '\0';
+	    (void)TBCCacheMkdir(cp);
+	    *tmpPath = sep;
+	}
+    }
+    (void)TBCCacheMkdir(cp);
+    free(cp);
+
+    bcopy(tbcCacheMagic, hdr.magic, sizeof(tbcCacheMagic));
+    hdr.version = TBC_CACHE_VERSION;
+    hdr.numCmds = numBuiltInCmds;
+    hdr.srcMTime = (unsigned long)stbPtr->st_mtime;
+    hdr.srcSize = (unsigned long)stbPtr->st_size;
+    hdr.pathLen = strlen(path);
+    hdr.codeSize = codeSize;
+
+    tmpPath = (char *)malloc(strlen(cachePath) + 16);
+    sprintf(tmpPath, "%s.%d", cachePath, (int)TBCCacheGetPid());
+
+    fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0666);
+    if (fd < 0) {
+	free(tmpPath);
+	return;
+    }
+    if ((write(fd, (char *)&hdr, sizeof(hdr)) != sizeof(hdr)) ||
+	(write(fd, path, hdr.pathLen) != hdr.pathLen) ||
+	(write(fd, code, codeSize) != codeSize) ||
+	(close(fd) < 0))
+    {
+	(void)unlink(tmpPath);
+	free(tmpPath);
+	return;
+    }
+#if defined(_WIN32)
+    /*
+     * NT won't rename over an existing file. Another swat may slip its
+     * copy in between, in which case the rename fails and we just toss
+     * ours.
+     */
+    (void)unlink(cachePath);
+#endif /* _WIN32 */
+    if (rename(tmpPath, cachePath) < 0) {
+	(void)unlink(tmpPath);
+    }
+    free(tmpPath);
+}
+#endif /* unix || _WIN32 */
+
+/***********************************************************************
+ *				TBCCacheLoad
+ ***********************************************************************
+ * SYNOPSIS:	    Evaluate a Tcl source file, using its cached compiled
+ *		    form if possible.
+ * CALLED BY:	    Tcl_BCCacheCmd
+ * RETURN:	    result of evaluating the file
+ * SIDE EFFECTS:    the file's compiled form may be written to the cache
+ *
+ * STRATEGY:	    If the cache has current code for the file, evaluate
+ *		    that. Else read and compile the file as "bc fcompile"
+ *		    would, save the result, and evaluate it. If there's no
+ *		    cache to save it in, or the file won't compile,
+ *		    evaluate its source as "source" would, so it costs no
+ *		    more than "source" and any error is reported the same
+ *		    way.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+TBCCacheLoad(Tcl_Interp *interp, const char *file)
+{
+    int	    	    fd;
+    char    	    *contents;
+    long    	    bytesRead;
+    unsigned long   size;
+    unsigned char   *code;
+    int	    	    result;
+    char    	    *cachePath = 0;
+#if defined(unix) || defined(_WIN32)
+    const char	    *cacheDir = TBCCacheGetDir();
+    char    	    *path;
+    const char	    *base;
+    const char	    *cp;
+    struct stat	    stb;
+
+    /*
+     * Key the cache on the absolute path, so loads relative to different
+     * directories don't get confused.
+     */
+    if (TBCCacheIsAbs(file)) {
+	path = (char *)malloc(strlen(file) + 1);
+	strcpy(path, file);
+    } else {
+	char	cwd[1024];
+
+	if (TBCCacheGetCwd(cwd, sizeof(cwd)) == 0) {
+	    cwd[0] = '\0';
+	}
+	path = (char *)malloc(strlen(cwd) + 1 + strlen(file) + 1);
+	sprintf(path, "%s/%s", cwd, file);
+    }
+
+    if ((*cacheDir != '\0') && (stat(path, &stb) == 0)) {
+	unsigned char	*cached;
+
+	for (base = cp = path; *cp != '\0'; cp++) {
+	    if (TBCCacheIsSep(*cp)) {
+		base = cp + 1;
+	    }
+	}
+	cachePath = (char *)malloc(strlen(cacheDir) + 1 + strlen(base) + 1 +
+				   8 + sizeof(TBC_CACHE_SUFFIX));
+	sprintf(cachePath, "%s/%s-%08lx%s", cacheDir, base,
+		TBCCacheHash(path), TBC_CACHE_SUFFIX);
+
+	cached = TBCCacheRead(cachePath, path, &stb);
+	if (cached != 0) {
+	    TBCCacheHeader *hdr = (TBCCacheHeader *)cached;
+
+	    bcCacheHits++;
+	    result = TclByteCodeEval(interp, hdr->codeSize,
+				     cached + sizeof(*hdr) + hdr->pathLen);
+	    free((char *)cached);
+	    free(cachePath);
+	    free(path);
+	    return (result);
+	}
+    }
+#endif /* unix || _WIN32 */
+
+    fd = open((char *)file, O_RDONLY | O_TEXT, 0);
+    if (fd < 0) {
+	Tcl_RetPrintf(interp, "couldn't open file \"%.50s\"", file);
+	result = TCL_ERROR;
+	goto done;
+    }
+    size = lseek(fd, 0L, SEEK_END);
+    contents = (char *)malloc(size + 1);
+    (void)lseek(fd, 0L, SEEK_SET);
+    /*
+     * Don't check the count against size, as CR-LF -> LF compression will
+     * cause fewer bytes to be read.
+     */
+    bytesRead = read(fd, contents, size);
+    (void)close(fd);
+    if (bytesRead < 0) {
+	free(contents);
+	Tcl_RetPrintf(interp, "error reading in file \"%.50s\"", file);
+	result = TCL_ERROR;
+	goto done;
+    }
+    contents[bytesRead] = '\0';
+
+    /*
+     * Compiling only pays if the result is kept.
+     */
+    code = 0;
+    if (cachePath != 0) {
+	code = TclByteCodeCompile(interp, contents, 0, TBCC_DISCARD, 0,
+				  &size);
+    }
+    if (code == 0) {
+	bcCacheUncached++;
+	result = Tcl_Eval(interp, contents, 0, (const char **)NULL);
+	free(contents);
+	goto done;
+    }
+    free(contents);
+
+#if defined(unix) || defined(_WIN32)
+    bcCacheMisses++;
+    TBCCacheWrite(cacheDir, cachePath, path, &stb, code, size);
+#endif /* unix || _WIN32 */
+
+    result = TclByteCodeEval(interp, size, code);
+    free((char *)code);
+
+done:
+    if (cachePath != 0) {
+	free(cachePath);
+    }
+#if defined(unix) || defined(_WIN32)
+    free(path);
+#endif /* unix || _WIN32 */
+    return (result);
+}
+
+
+/***********************************************************************
+ *				Tcl_BCCacheCmd
+ ***********************************************************************
+ * SYNOPSIS:	    Load files through, and report on, the byte-code
+ *		    cache.
+ * CALLED BY:	    Tcl
+ * RETURN:	    TCL_OK or TCL_ERROR
+ * SIDE EFFECTS:    see above
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+#define BCC_LOAD    (ClientData)0
+#define BCC_STATS   (ClientData)1
+#define BCC_RESET   (ClientData)2
+#define BCC_DIR	    (ClientData)3
+
+static const Tcl_SubCommandRec bcCacheCmds[] = {
+    {"load", 	BCC_LOAD,   1, 1, "<file>"},
+    {"stats",	BCC_STATS,  0, 0, ""},
+    {"reset",	BCC_RESET,  0, 0, ""},
+    {"dir",	BCC_DIR,    0, 1, "[<dir>]"},
+    {TCL_CMD_END}
+};
+
+DEFCMD(bc-cache,Tcl_BCCache,TCL_EXACT,bcCacheCmds,swat_prog.byte_code|swat_prog.load,
+"Usage:\n\
+    bc-cache load <file>\n\
+    bc-cache stats\n\
+    bc-cache reset\n\
+    bc-cache dir [<dir>]\n\
+\n\
+Examples:\n\
+    \"bc-cache load /s/swat/lib/print.tcl\"\n\
+			    Evaluates print.tcl using the compiled form\n\
+			    saved from an earlier load, compiling and saving\n\
+			    it first if needed.\n\
+    \"bc-cache stats\"	    Returns the number of files loaded from the\n\
+			    cache, compiled into it, and loaded without it.\n\
+\n\
+Synopsis:\n\
+    Maintains a directory of compiled forms of the Tcl files that make up\n\
+    the Swat library, so they needn't be parsed again each time Swat starts.\n\
+\n\
+Notes:\n\
+    * A cached file is used only if the source file's modification time and\n\
+      size are unchanged and it was compiled by a Swat with the same set of\n\
+      built-in commands. Otherwise the source is compiled again and the\n\
+      cache updated.\n\
+\n\
+    * The cache lives in the directory given by the SWAT_BCCACHE environment\n\
+      variable, or ~/.swat/bccache if that's not set. If SWAT_BCCACHE is\n\
+      set to the empty string, or \"bc-cache dir {}\" is given, files are\n\
+      evaluated from source, as \"source\" would. On NT the default is\n\
+      .swat/bccache under %USERPROFILE% if HOME isn't set.\n\
+\n\
+    * \"bc-cache stats\" returns a three-element list: the number of cache\n\
+      hits, misses, and files loaded without the cache (including those that\n\
+      could not be compiled, which are evaluated as \"source\" would).\n\
+      \"bc-cache reset\" zeroes these counts.\n\
+\n\
+    * The \"load\" command uses this to read files for which there's no\n\
+      up-to-date .tlc file.\n\
+\n\
+See also:\n\
+    bc, load, source\n\
+")
+{
+    switch ((int)clientData) {
+    case BCC_LOAD:
+	return (TBCCacheLoad(interp, argv[2]));
+    case BCC_STATS:
+	Tcl_RetPrintf(interp, "%d %d %d", bcCacheHits, bcCacheMisses,
+		      bcCacheUncached);
+	break;
+    case BCC_RESET:
+	bcCacheHits = bcCacheMisses = bcCacheUncached = 0;
+	Tcl_Return(interp, NULL, TCL_STATIC);
+	break;
+    case BCC_DIR:
+#if defined(unix) || defined(_WIN32)
+	if (argc == 3) {
+	    (void)TBCCacheGetDir();
+	    free(bcCacheDir);
+	    bcCacheDir = (char *)malloc(strlen(argv[2]) + 1);
+	    strcpy(bcCacheDir, argv[2]);
+	}
+	Tcl_Return(interp, (char *)TBCCacheGetDir(), TCL_VOLATILE);
+#else
+	Tcl_Return(interp, NULL, TCL_STATIC);
+#endif /* unix || _WIN32 */
+	break;
+    }
+    return (TCL_OK);
+}
+
+
 /***********************************************************************
  *				Tcl_BCCmd
  ***********************************************************************
@@ -5338,6 +5956,7 @@ TBCReadFile(Tcl_Interp *interp, const char *inname, unsigned long *sizePtr)
 #define BC_FLOAD    (ClientData)4
 #define BC_FDISASM  (ClientData)5
 #define BC_DEBUG    (ClientData)6
+#define BC_ICACHE   (ClientData)7
 
 static const Tcl_SubCommandRec bcCmds[] = {
     {"list", 	BC_LIST,    1, 1, "<proc>"},
@@ -5347,6 +5966,7 @@ static const Tcl_SubCommandRec bcCmds[] = {
     {"fload",	BC_FLOAD,   1, 1, "<file>"},
     {"fdisasm",	BC_FDISASM, 1, 1, "<file>"},
     {"debug", 	BC_DEBUG,   0, 1, "[1|0]"},
+    {"icache",	BC_ICACHE,  0, 1, "[reset]"},
     {TCL_CMD_END}
 };
 
@@ -5359,6 +5979,7 @@ DEFCMD(bc,Tcl_BC,TCL_EXACT,bcCmds,swat_prog.byte_code,
     bc fload <file>\n\
     bc fdisasm <file>\n\
     bc debug [1|0]\n\
+    bc icache [reset]\n\
 \n\
 Examples:\n\
     \"bc compile poof\"	    Compiles the body of the procedure \"poof\" and\n\
@@ -5371,6 +5992,8 @@ Examples:\n\
 			    Tcl.\n\
     \"bc fload bptutils.tlc\" Loads a file containing a stream of compiled Tcl\n\
 			    code.\n\
+    \"bc icache\"	    Returns the hits and misses of the command and\n\
+			    variable lookup caches used by compiled code.\n\
 \n\
 Synopsis:\n\
     The \"bc\" command allows you to create and examine compiled Tcl code.\n\
@@ -5381,6 +6004,11 @@ Notes:\n\
     * The \"list\" subcommand doesn't work as yet. Eventually it will attempt to\n\
       construct a more readable form of compiled code. For now, the raw\n\
       opcodes will have to do.\n\
+\n\
+    * Compiled code remembers, at each place it calls a command or fetches\n\
+      a variable, what it found the last time. \"bc icache\" returns a\n\
+      four-element list: command cache hits and misses, then variable cache\n\
+      hits and misses. \"bc icache reset\" zeroes the counts.\n\
 \n\
     *\n\
 See also:\n\
@@ -5592,6 +6220,18 @@ See also:\n\
 	    bcDebug = atoi(argv[2]);
 	}
 	return (TCL_OK);
+    case BC_ICACHE:
+	if (argc == 3) {
+	    if (strcmp(argv[2], "reset") != 0) {
+		Tcl_RetPrintf(interp, "bc icache: unknown option %s", argv[2]);
+		return (TCL_ERROR);
+	    }
+	    bcCmdCacheHits = bcCmdCacheMisses = 0;
+	    bcVarCacheHits = bcVarCacheMisses = 0;
+	}
+	Tcl_RetPrintf(interp, "%d %d %d %d", bcCmdCacheHits, bcCmdCacheMisses,
+		      bcVarCacheHits, bcVarCacheMisses);
+	return (TCL_OK);
     }
     return (TCL_OK);
 }
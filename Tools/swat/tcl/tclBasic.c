@@ -70,12 +70,15 @@ const Tcl_CommandRec *const builtInCmds[] = {
     &Tcl_UplevelCmdRec,
     &Tcl_VarCmdRec,
 #if defined(_WIN32)
-    &Tcl_ElispSendCmdRec
+    &Tcl_ElispSendCmdRec,
 #endif
+    &Tcl_BCCacheCmdRec
 };
 
 const unsigned numBuiltInCmds = sizeof(builtInCmds)/sizeof(builtInCmds[0]);
 
+unsigned long tclCmdEpoch = 0;
+
 
 /*
  *----------------------------------------------------------------------
@@ -111,6 +114,7 @@ Tcl_CreateInterp(void)
     iPtr = (Interp *) calloc(1, sizeof(Interp));
     iPtr->result = iPtr->resultSpace;
     iPtr->output = printf;
+    TCL_VARFRAME_NEW_SERIAL(&iPtr->globalFrame);
 
     /*
      * Create the built-in commands.  Do it here, rather than calling
@@ -206,6 +210,7 @@ Tcl_TopLevel(Tcl_Interp	*interp)
 	    TclDeleteVars(frame->localPtr->vars);
 
 	    frame->localPtr->vars = (Var *)NULL;
+	    TCL_VARFRAME_NEW_SERIAL(frame->localPtr);
 	}
 
 	/*
@@ -295,8 +300,10 @@ Tcl_DeleteInterp(Tcl_Interp *interp)	/* Token for command interpreter
 	}
 	iPtr->commands[i] = NULL;
     }
+    tclCmdEpoch++;
 
     TclDeleteVars(iPtr->globalFrame.vars);
+    TCL_VARFRAME_NEW_SERIAL(&iPtr->globalFrame);
     for (tracePtr=iPtr->tracePtr; tracePtr!=NULL; tracePtr=tracePtr->nextPtr) {
 	free((char *) tracePtr);
     }
@@ -387,6 +394,11 @@ Tcl_CreateCommand(Tcl_Interp	*interp,	/* Token for command
     cmdPtr->nextPtr = iPtr->commands[TCL_CMD_GET_CHAIN(cmdName)];
     iPtr->commands[TCL_CMD_GET_CHAIN(cmdName)] = cmdPtr;
     bcopy(cmdName, cmdPtr->name, nameLength+1);
+
+    /*
+     * The new command may now be what an abbreviation resolves to.
+     */
+    tclCmdEpoch++;
 }
 
 
@@ -567,6 +579,7 @@ Tcl_DeleteCommand(Tcl_Interp	*interp,    /* Token for command interpreter
 	 */
 	iPtr->commands[TCL_CMD_GET_CHAIN(cmdName)] = cmdPtr->nextPtr;
 	free((char *) cmdPtr);
+	tclCmdEpoch++;
     }
 }
 
@@ -72,6 +72,7 @@ const Tcl_CommandRec FuncPref##CmdRec = { #string, #class, FuncPref##Cmd, 0, cmd
 
 extern int TclCmdCheckUsage(ClientData, Tcl_Interp *, int argc, char **argv);
 extern const Tcl_CommandRec	Tcl_BCCmdRec;
+extern const Tcl_CommandRec	Tcl_BCCacheCmdRec;
 extern const Tcl_CommandRec	Tcl_BreakCmdRec;
 extern const Tcl_CommandRec  	Tcl_CaseCmdRec;
 extern const Tcl_CommandRec	Tcl_CatchCmdRec;
@@ -218,8 +219,22 @@ typedef struct Trace {
 typedef struct _VarFrame {
     Var	    	    	*vars;
     struct _VarFrame	*next;
+    unsigned long   	serial;	    /* Unique number for the frame, changed
+				     * whenever a variable found in it might
+				     * have gone away or been shadowed, so
+				     * cached variable lookups can tell
+				     * they're stale */
 } VarFrame;
 
+extern unsigned long	tclVarFrameSerial;  /* Last serial number given to
+					     * a VarFrame */
+#define TCL_VARFRAME_NEW_SERIAL(vf) ((vf)->serial = ++tclVarFrameSerial)
+
+extern unsigned long	tclCmdEpoch;	    /* Incremented whenever a command
+					     * is created or deleted, so cached
+					     * command lookups can tell
+					     * they're stale */
+
 
 /*
  * Internal version of Tcl_Frame, with added fields for local variables, etc.
@@ -366,6 +381,9 @@ extern int  	    	TclProcBindArgs(Interp *iPtr,
 					int argc,
 					VarFrame *framePtr);
 
+extern Var	    	*TclProcFindVar(VarFrame *vf,
+					const char *varName);
+
 extern const char   	*TclProcScanVar(Tcl_Interp *interp,
 					const char *string,
 					int *lenPtr,
@@ -35,6 +35,8 @@ static char *rcsid = "$Id: tclProc.c,v 1.40 97/04/18 12:26:35 dbaumann Exp $ SPR
  */
 
 static Var *	FindVar(VarFrame *vf, const char *varName);
+
+unsigned long	tclVarFrameSerial = 0;
 static int	InterpProc(); /* parms: register Proc *procPtr,
 			       *        Tcl_Interp    *interp,
 			       *        int           argc,
@@ -332,6 +334,7 @@ TclProcBindArgs(Interp *iPtr,
      */
     framePtr->vars = NULL;
     framePtr->next = iPtr->top->localPtr;
+    TCL_VARFRAME_NEW_SERIAL(framePtr);
     iPtr->top->localPtr = framePtr;
 
     /*
@@ -753,6 +756,10 @@ See also:\n\
 	varPtr->flags |= VAR_GLOBAL;
 	varPtr->globalPtr = gVarPtr;
     }
+    /*
+     * The new variables may shadow locals of the same name.
+     */
+    TCL_VARFRAME_NEW_SERIAL(iPtr->top->localPtr);
     return TCL_OK;
 }
 
@@ -974,6 +981,30 @@ FindVar(VarFrame *vf,	    	/* Pointer to frame to search */
     return NULL;
 }
 
+/*
+ *----------------------------------------------------------------------
+ *
+ * TclProcFindVar --
+ *
+ *	Locate the Var structure for varName in a frame, for those
+ *	outside this module that want to hang onto it.
+ *
+ * Results:
+ *	As for FindVar.
+ *
+ * Side effects:
+ *	As for FindVar.
+ *
+ *----------------------------------------------------------------------
+ */
+
+Var *
+TclProcFindVar(VarFrame *vf,	    	/* Pointer to frame to search */
+	       const char *varName)	/* Desired variable. */
+{
+    return FindVar(vf, varName);
+}
+
 /*
  *----------------------------------------------------------------------
  *
@@ -0,0 +1,171 @@
+/***********************************************************************
+ *
+ *	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * PROJECT:	  PCGEOS
+ * MODULE:	  Swat -- Win32 connection to swatsim
+ * FILE:	  simsock.c
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * ROUTINES:
+ *	Name	  	    Description
+ *	----	  	    -----------
+ *	SimSock_ClientInit  Connect to swatsim over TCP
+ *	SimSock_ClientExit  Close the connection
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial version
+ *
+ * DESCRIPTION:
+ *	"swat -T [<host>:]<port>" under WIN32. swatsim frames its
+ *	messages just as the stub does on a serial line, and a socket
+ *	opened for overlapped I/O can be given to ReadFile and WriteFile
+ *	like any other handle, so Rpc treats the connection as a serial
+ *	port and reads and writes it with Ntserial_Read and
+ *	Ntserial_WriteV.
+ *
+ *	This is kept out of rpc.c because winsock2.h's fd_set and
+ *	timeval clash with the ones Swat defines for itself.
+ *
+ ***********************************************************************/
+#ifndef lint
+static char *rcsid =
+"$Id$";
+#endif lint
+
+#include <compat/windows.h>
+#include <winsock2.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simsock.h"
+
+
+/***********************************************************************
+ *				SimSock_ClientInit
+ ***********************************************************************
+ *
+ * SYNOPSIS:	    Open a TCP connection to swatsim
+ * CALLED BY:	    RpcOpenSim, Rpc_Connect
+ * RETURN:	    0 if connected, else the Winsock error code
+ * SIDE EFFECTS:    *sock is the socket, as a HANDLE, if successful.
+ *	    	    The events for the two OVERLAPPED structures are
+ *	    	    created.
+ *
+ * STRATEGY:	    addr is [<host>:]<port>, the host defaulting to
+ *	    	    the local machine.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+int
+SimSock_ClientInit(char *addr, HANDLE *sock, LPOVERLAPPED ovlpR,
+		   LPOVERLAPPED ovlpW)
+{
+    WSADATA 	    	wsaData;
+    struct sockaddr_in	sin;
+    struct hostent  	*he;
+    char    	    	host[64];
+    char    	    	*colon;
+    SOCKET  	    	s;
+    BOOL    	    	on = TRUE;
+    int	    	    	err;
+
+    err = WSAStartup(MAKEWORD(2, 0), &wsaData);
+    if (err != 0) {
+	return (err);
+    }
+
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+
+    colon = strchr(addr, ':');
+    if (colon == NULL) {
+	strcpy(host, "localhost");
+	sin.sin_port = htons((u_short)atoi(addr));
+    } else {
+	int len = colon - addr;
+
+	if (len >= sizeof(host)) {
+	    len = sizeof(host)-1;
+	}
+	sprintf(host, "%.*s", len, addr);
+	sin.sin_port = htons((u_short)atoi(colon+1));
+    }
+
+    he = gethostbyname(host);
+    if (he == NULL) {
+	err = WSAGetLastError();
+	WSACleanup();
+	return (err);
+    }
+    memcpy(&sin.sin_addr, he->h_addr, he->h_length);
+
+    s = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, NULL, 0,
+		  WSA_FLAG_OVERLAPPED);
+    if (s == INVALID_SOCKET) {
+	err = WSAGetLastError();
+	WSACleanup();
+	return (err);
+    }
+    if (connect(s, (struct sockaddr *)&sin, sizeof(sin)) == SOCKET_ERROR) {
+	err = WSAGetLastError();
+	closesocket(s);
+	WSACleanup();
+	return (err);
+    }
+
+    /*
+     * Messages are small and each waits on the last; don't let them
+     * sit in the stack waiting for company.
+     */
+    (void)setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (char *)&on, sizeof(on));
+
+    *sock = (HANDLE)s;
+
+    ovlpR->Offset = ovlpR->OffsetHigh = 0;
+    ovlpR->hEvent = CreateEvent(0, TRUE, TRUE, 0);
+    ovlpW->Offset = ovlpW->OffsetHigh = 0;
+    ovlpW->hEvent = CreateEvent(0, TRUE, TRUE, 0);
+
+    return (0);
+}	/* End of SimSock_ClientInit.	*/
+
+
+/***********************************************************************
+ *				SimSock_ClientExit
+ ***********************************************************************
+ *
+ * SYNOPSIS:	    Close the connection to swatsim
+ * CALLED BY:	    Rpc_HandleStream, Rpc_Connect
+ * RETURN:	    void
+ * SIDE EFFECTS:    *sock is set to NULL and the events are closed.
+ *
+ * STRATEGY:	    
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+SimSock_ClientExit(HANDLE *sock, LPOVERLAPPED ovlpR, LPOVERLAPPED ovlpW)
+{
+    if (*sock == NULL) {
+	return;
+    }
+    closesocket((SOCKET)*sock);
+    *sock = NULL;
+
+    CloseHandle(ovlpR->hEvent);
+    CloseHandle(ovlpW->hEvent);
+
+    WSACleanup();
+}	/* End of SimSock_ClientExit.	*/
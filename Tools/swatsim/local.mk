@@ -0,0 +1,30 @@
+##############################################################################
+#
+# 	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+#
+# PROJECT:	PC GEOS
+# MODULE:	swatsim -- special definitions
+# FILE: 	local.mk
+# AUTHOR: 	agent, Fri Oct 16 12:00:00 PDT 2026
+#
+# TARGETS:
+# 	Name			Description
+#	----			-----------
+#
+# REVISION HISTORY:
+#	Name	Date		Description
+#	----	----		-----------
+#	agent	10/16/26	Initial Revision
+#
+# DESCRIPTION:
+#	Special definitions for swatsim, which takes the protocol
+#	definitions from Swat's rpc.h.
+#
+#	$Id$
+#
+###############################################################################
+
+.PATH.h		: . $(INSTALL_DIR) \
+                  ../swat $(INSTALL_DIR:H)/swat
+
+#include    <$(SYSMAKEFILE)>
@@ -0,0 +1,1043 @@
+/***********************************************************************
+ *
+ *	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * PROJECT:	  PCGEOS
+ * MODULE:	  swatsim -- Simulated debugging stub
+ * FILE:	  swatsim.c
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * ROUTINES:
+ *	Name	  	    Description
+ *	----	  	    -----------
+ *	main	    	    Parse arguments and serve connections
+ *	SimLoad	    	    Read a snapshot recorded with "rpc record"
+ *	SimReset    	    Rewind the snapshot for a new connection
+ *	SimServe    	    Handle one connection until end-of-file
+ *	SimCall	    	    Answer one call from Swat
+ *	SimSend	    	    Frame and send one message, with delay
+ *
+ * REVISION HISTORY:
+ *	Date	  Name	    Description
+ *	----	  ----	    -----------
+ *	10/16/26  agent	    Initial version
+ *
+ * DESCRIPTION:
+ *	A host-side stand-in for the debugging stub in Tools/swat/Stub,
+ *	so Swat's RPC, caching and symbol code can be run and timed
+ *	without a PC on the other end of a serial line.
+ *
+ *	The snapshot is the text file Swat writes under "rpc record".
+ *	Each line is
+ *
+ *	    <tag> <id> <proc> <hex data>
+ *
+ *	where <tag> is C for a call Swat made, R or E for the stub's
+ *	reply or error reply to it, and S for a call the stub made to
+ *	Swat (RPC_HALT and friends). The data are exactly as they went
+ *	over the wire, in the PC's byte order.
+ *
+ *	A call is answered by looking it up by procedure number and
+ *	argument bytes. The n'th time a given call is made, it gets the
+ *	reply recorded for the n'th time it was made, or the last one
+ *	if it was made fewer times than that, so memory and registers
+ *	change across a "continue" just as they did during recording.
+ *	Any stub calls that followed the recorded call are then sent
+ *	in order.
+ *
+ *	Reads that don't match a recorded call exactly (different
+ *	length or alignment, e.g. after a change to Swat's data cache)
+ *	are served from a memory image assembled from every read in
+ *	the snapshot, one for absolute memory and one per handle.
+ *	Writes and fills update that image. Anything else gets
+ *	RPC_NOPROC, and is counted as a miss.
+ *
+ *	Link latency is injected with -l (milliseconds per message)
+ *	and -b (bits per second, ten bits to the byte as on a serial
+ *	line) so the cost of a round trip can be dialled up to match a
+ *	real machine.
+ *
+ *	With no -p, the simulator talks over its standard input and
+ *	output, which is how "swat -T !<command>" runs it. With -p, it
+ *	accepts TCP connections on the given port, one at a time,
+ *	starting each from the beginning of the snapshot; this is how
+ *	Swat on win32, which can't start it, connects to it.
+ *
+ ***********************************************************************/
+#ifndef lint
+static char *rcsid =
+"$Id$";
+#endif lint
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+typedef unsigned char	byte;
+typedef unsigned short	word;
+typedef unsigned long	dword;
+
+/*
+ * Protocol definitions. Swat's prototypes need all of swat.h, so ask
+ * for just the protocol.
+ */
+#define RPC_PROTOCOL_ONLY
+#include "rpc.h"
+
+#define RpcTypeMask	(RPC_CALL|RPC_REPLY|RPC_ERROR|RPC_ACK)
+#define RPC_HEADER_SIZE	((int)sizeof(RpcHeader))
+
+/*
+ * One message from the snapshot.
+ */
+typedef struct {
+    byte    	tag;	    	/* 'C', 'R', 'E' or 'S' */
+    byte    	id; 	    	/* rh_id as recorded */
+    byte    	proc;	    	/* rh_procNum */
+    byte    	len;	    	/* rh_length */
+    byte    	*data;	    	/* The message's data */
+    int	    	reply;	    	/* C: index of the R or E entry answering
+				 * it, or -1 if it went unanswered */
+    int	    	nextSame;   	/* C: next call with the same procedure
+				 * and arguments, or -1 */
+    int	    	stubs;	    	/* C: first stub call to send after the
+				 * reply, or -1 */
+    int	    	nextStub;   	/* S: next stub call to send, or -1 */
+} SimEntry;
+
+static SimEntry	*entries;
+static int  	numEntries;
+static int  	preStubs = -1;	/* Stub calls recorded before Swat made any
+				 * call of its own. Sent after the first
+				 * reply on each connection */
+
+/*
+ * Calls are found by hashing their procedure number and arguments.
+ * Each slot holds the first and the next-to-replay of the calls
+ * with that key.
+ */
+typedef struct {
+    int	    	first;	    	/* Index of first such call, -1 if empty */
+    int	    	cur;	    	/* Index of call to replay next */
+} SimKey;
+
+static SimKey	*keys;
+static unsigned	keyMask;
+
+/*
+ * The memory image. Absolute memory covers the first megabyte plus
+ * the HMA; handle memory is kept per handle, each up to 64K.
+ */
+#define SIM_ABS_SIZE	0x110000
+
+typedef struct {
+    byte    	data[65536];
+    byte    	valid[65536];
+} SimBlock;
+
+static byte 	*absData;
+static byte 	*absValid;
+static SimBlock	*blocks[65536];
+
+/*
+ * Replies to the last few calls, so a call Swat resends because the
+ * reply was slow to arrive is answered again rather than replayed
+ * twice.
+ */
+#define SIM_RECENT  8
+static struct {
+    int	    	valid;
+    byte    	id;
+    byte    	proc;
+    byte    	flags;
+    byte    	len;
+    byte    	data[RPC_MAX_DATA];
+} recent[SIM_RECENT];
+static int  	recentNext;
+
+static int  	simIn = 0;  	/* Descriptor for reading from Swat */
+static int  	simOut = 1; 	/* Descriptor for writing to Swat */
+static long 	latency;    	/* Microseconds added to each message */
+static long 	baud;	    	/* Simulated line speed (0 => none) */
+static int  	verbose;
+static byte 	nextStubID; 	/* ID for the next call we make */
+static int  	started;    	/* Non-zero once preStubs have gone out */
+
+static struct {
+    long    	calls;	    	/* Calls received (not counting resends) */
+    long    	replayed;   	/* Answered from a recorded reply */
+    long    	image;	    	/* Answered from the memory image */
+    long    	misses;	    	/* Answered with RPC_NOPROC */
+    long    	resends;    	/* Resent calls answered from recent[] */
+    long    	bytesIn;    	/* Bytes read from Swat */
+    long    	bytesOut;   	/* Bytes written to Swat */
+} stats;
+
+#define SimWord(p)  ((p)[0] | ((p)[1] << 8))
+
+
+/***********************************************************************
+ *				SimHash
+ ***********************************************************************
+ * SYNOPSIS:	    Hash a call's procedure number and arguments
+ * CALLED BY:	    SimFindKey
+ * RETURN:	    the hash value
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:	    FNV-1a
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static unsigned
+SimHash(byte proc, byte *data, int len)
+{
+    unsigned	h = 2166136261U;
+
+    h = (h ^ proc) * 16777619U;
+    h = (h ^ len) * 16777619U;
+    while (len-- > 0) {
+	h = (h ^ *data++) * 16777619U;
+    }
+    return(h);
+}
+
+
+/***********************************************************************
+ *				SimFindKey
+ ***********************************************************************
+ * SYNOPSIS:	    Locate the slot for a call in the key table
+ * CALLED BY:	    SimLoad, SimCall
+ * RETURN:	    the slot, which has first == -1 if the call isn't
+ *		    in the snapshot
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:	    linear probing
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static SimKey *
+SimFindKey(byte proc, byte *data, int len)
+{
+    unsigned	i;
+    SimEntry	*e;
+
+    for (i = SimHash(proc, data, len) & keyMask;
+	 keys[i].first != -1;
+	 i = (i + 1) & keyMask)
+    {
+	e = &entries[keys[i].first];
+	if (e->proc == proc && e->len == len &&
+	    memcmp(e->data, data, len) == 0)
+	{
+	    break;
+	}
+    }
+    return(&keys[i]);
+}
+
+
+/***********************************************************************
+ *				SimImageStore
+ ***********************************************************************
+ * SYNOPSIS:	    Copy bytes into the memory image
+ * CALLED BY:	    SimReset, SimWrite
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the bytes are marked valid
+ *
+ * STRATEGY:	    absolute addresses past the HMA and handle offsets
+ *		    past 64K are dropped, as the stub would refuse them
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+SimImageStore(int	abs,	    /* Non-zero if base is a segment */
+	      word	base,	    /* Segment or handle */
+	      word	offset,
+	      byte	*data,
+	      int	len,
+	      int	fill)	    /* Non-zero if data is a 1- or 2-byte
+				     * pattern to repeat for len bytes */
+{
+    byte    *mem, *valid;
+    long    start, limit;
+    int	    i;
+
+    if (abs) {
+	mem = absData;
+	valid = absValid;
+	start = ((long)base << 4) + offset;
+	limit = SIM_ABS_SIZE;
+    } else {
+	if (blocks[base] == NULL) {
+	    blocks[base] = (SimBlock *)calloc(1, sizeof(SimBlock));
+	}
+	mem = blocks[base]->data;
+	valid = blocks[base]->valid;
+	start = offset;
+	limit = 65536;
+    }
+    if (start + len > limit) {
+	len = limit - start;
+    }
+    for (i = 0; i < len; i++) {
+	mem[start + i] = fill ? data[i % fill] : data[i];
+	valid[start + i] = 1;
+    }
+}
+
+
+/***********************************************************************
+ *				SimImageFetch
+ ***********************************************************************
+ * SYNOPSIS:	    Copy bytes out of the memory image
+ * CALLED BY:	    SimCall
+ * RETURN:	    non-zero if every byte requested was in the image
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+SimImageFetch(int	abs,
+	      word	base,
+	      word	offset,
+	      byte	*buf,
+	      int	len)
+{
+    byte    *mem, *valid;
+    long    start, limit;
+    int	    i;
+
+    if (abs) {
+	mem = absData;
+	valid = absValid;
+	start = ((long)base << 4) + offset;
+	limit = SIM_ABS_SIZE;
+    } else {
+	if (blocks[base] == NULL) {
+	    return(0);
+	}
+	mem = blocks[base]->data;
+	valid = blocks[base]->valid;
+	start = offset;
+	limit = 65536;
+    }
+    if (start + len > limit) {
+	return(0);
+    }
+    for (i = 0; i < len; i++) {
+	if (!valid[start + i]) {
+	    return(0);
+	}
+	buf[i] = mem[start + i];
+    }
+    return(1);
+}
+
+
+/***********************************************************************
+ *				SimWrite
+ ***********************************************************************
+ * SYNOPSIS:	    Apply a write or fill call to the memory image
+ * CALLED BY:	    SimCall
+ * RETURN:	    non-zero if the call was a write or fill
+ * SIDE EFFECTS:    the image is updated
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+SimWrite(byte proc, byte *data, int len)
+{
+    switch (proc) {
+	case RPC_WRITE_MEM:
+	case RPC_WRITE_ABS:
+	    /* offset, handle/segment, then the bytes */
+	    if (len >= 4) {
+		SimImageStore(proc == RPC_WRITE_ABS, SimWord(data+2),
+			      SimWord(data), data+4, len-4, 0);
+	    }
+	    return(1);
+	case RPC_FILL_MEM8:
+	case RPC_FILL_MEM16:
+	case RPC_FILL_ABS8:
+	case RPC_FILL_ABS16:
+	{
+	    /* offset, handle/segment, count, value */
+	    int	    count;
+	    int	    wide;
+
+	    if (len < 8) {
+		return(1);
+	    }
+	    wide = (proc == RPC_FILL_MEM16 || proc == RPC_FILL_ABS16);
+	    count = SimWord(data+4);
+	    SimImageStore(proc == RPC_FILL_ABS8 || proc == RPC_FILL_ABS16,
+			  SimWord(data+2), SimWord(data),
+			  data+6, wide ? count * 2 : count, wide ? 2 : 1);
+	    return(1);
+	}
+    }
+    return(0);
+}
+
+
+/***********************************************************************
+ *				SimLoad
+ ***********************************************************************
+ * SYNOPSIS:	    Read in a snapshot
+ * CALLED BY:	    main
+ * RETURN:	    non-zero if successful
+ * SIDE EFFECTS:    entries and keys are filled in
+ *
+ * STRATEGY:	    Read every line into entries[], then pair each
+ *		    reply with the call it answers (the nearest earlier
+ *		    unanswered call with the same id and procedure),
+ *		    chain each stub call onto the last call Swat made
+ *		    before it, and chain calls with equal arguments
+ *		    together under one key.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+SimLoad(const char *file)
+{
+    FILE    	*f;
+    char    	line[1024];
+    int	    	maxEntries = 0;
+    int	    	lineNum = 0;
+    int	    	*lastStub = &preStubs;
+    int	    	i, j;
+
+    f = fopen(file, "r");
+    if (f == NULL) {
+	perror(file);
+	return(0);
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+	SimEntry    *e;
+	char	    tag;
+	unsigned    id, proc;
+	int	    n;
+	char	    *cp;
+	byte	    buf[RPC_MAX_DATA];
+	int	    len;
+
+	lineNum++;
+	if (line[0] == '#' || line[0] == '\n') {
+	    continue;
+	}
+	if (sscanf(line, "%c %u %u%n", &tag, &id, &proc, &n) != 3 ||
+	    strchr("CRES", tag) == NULL)
+	{
+	    fprintf(stderr, "%s:%d: malformed line\n", file, lineNum);
+	    fclose(f);
+	    return(0);
+	}
+	for (cp = &line[n], len = 0; *cp != '\0'; ) {
+	    unsigned	b;
+
+	    if (isspace(*cp)) {
+		cp++;
+	    } else if (len < RPC_MAX_DATA && sscanf(cp, "%2x", &b) == 1) {
+		buf[len++] = b;
+		cp += 2;
+	    } else {
+		fprintf(stderr, "%s:%d: bad data\n", file, lineNum);
+		fclose(f);
+		return(0);
+	    }
+	}
+
+	if (numEntries == maxEntries) {
+	    maxEntries = maxEntries ? maxEntries * 2 : 1024;
+	    entries = (SimEntry *)realloc(entries,
+					  maxEntries * sizeof(SimEntry));
+	}
+	e = &entries[numEntries];
+	e->tag = tag;
+	e->id = id;
+	e->proc = proc;
+	e->len = len;
+	e->data = (byte *)malloc(len ? len : 1);
+	memcpy(e->data, buf, len);
+	e->reply = e->nextSame = e->stubs = e->nextStub = -1;
+
+	switch (tag) {
+	    case 'C':
+		lastStub = &e->stubs;
+		break;
+	    case 'R':
+	    case 'E':
+		for (j = numEntries-1; j >= 0; j--) {
+		    if (entries[j].tag == 'C' && entries[j].id == e->id &&
+			entries[j].proc == e->proc)
+		    {
+			break;
+		    }
+		}
+		if (j >= 0 && entries[j].reply == -1) {
+		    entries[j].reply = numEntries;
+		}
+		break;
+	    case 'S':
+		*lastStub = numEntries;
+		lastStub = &e->nextStub;
+		break;
+	}
+	numEntries++;
+    }
+    fclose(f);
+
+    /*
+     * Build the key table, at most half full.
+     */
+    for (keyMask = 1023; keyMask < numEntries * 2; keyMask = keyMask*2 + 1) {
+	;
+    }
+    keys = (SimKey *)malloc((keyMask + 1) * sizeof(SimKey));
+    for (i = 0; i <= keyMask; i++) {
+	keys[i].first = keys[i].cur = -1;
+    }
+    for (i = numEntries-1; i >= 0; i--) {
+	SimKey	*k;
+
+	if (entries[i].tag != 'C') {
+	    continue;
+	}
+	k = SimFindKey(entries[i].proc, entries[i].data, entries[i].len);
+	entries[i].nextSame = k->first;
+	k->first = i;
+    }
+
+    absData = (byte *)malloc(SIM_ABS_SIZE);
+    absValid = (byte *)malloc(SIM_ABS_SIZE);
+
+    if (verbose) {
+	fprintf(stderr, "swatsim: %d messages in %s\n", numEntries, file);
+    }
+    return(1);
+}
+
+
+/***********************************************************************
+ *				SimReset
+ ***********************************************************************
+ * SYNOPSIS:	    Rewind the snapshot for a new connection
+ * CALLED BY:	    main
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    every key replays from its first call, and the
+ *		    memory image is rebuilt from the recorded reads
+ *
+ * STRATEGY:	    Reads are stored in snapshot order, so the image
+ *		    holds the last value recorded for each byte.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+SimReset(void)
+{
+    int	    i;
+
+    for (i = 0; i <= keyMask; i++) {
+	keys[i].cur = keys[i].first;
+    }
+
+    memset(absValid, 0, SIM_ABS_SIZE);
+    for (i = 0; i < 65536; i++) {
+	if (blocks[i] != NULL) {
+	    free((char *)blocks[i]);
+	    blocks[i] = NULL;
+	}
+    }
+    for (i = 0; i < numEntries; i++) {
+	SimEntry    *e = &entries[i];
+	SimEntry    *r;
+
+	if (e->tag != 'C' || e->reply == -1 || e->len < 6 ||
+	    (e->proc != RPC_READ_MEM && e->proc != RPC_READ_ABS))
+	{
+	    continue;
+	}
+	r = &entries[e->reply];
+	if (r->tag == 'R') {
+	    /* offset, handle/segment, count */
+	    SimImageStore(e->proc == RPC_READ_ABS, SimWord(e->data+2),
+			  SimWord(e->data), r->data, r->len, 0);
+	}
+    }
+
+    memset(recent, 0, sizeof(recent));
+    memset(&stats, 0, sizeof(stats));
+    started = 0;
+}
+
+
+/***********************************************************************
+ *				SimDelay
+ ***********************************************************************
+ * SYNOPSIS:	    Wait as long as the simulated link would take to
+ *		    carry a message
+ * CALLED BY:	    SimSend
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    time passes
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+SimDelay(int numBytes)
+{
+    long    	    usec = latency;
+    struct timeval  tv;
+
+    if (baud != 0) {
+	usec += (long)((double)numBytes * 10 * 1000000 / baud);
+    }
+    if (usec > 0) {
+	tv.tv_sec = usec / 1000000;
+	tv.tv_usec = usec % 1000000;
+	(void)select(0, NULL, NULL, NULL, &tv);
+    }
+}
+
+
+/***********************************************************************
+ *				SimSend
+ ***********************************************************************
+ * SYNOPSIS:	    Send a message to Swat
+ * CALLED BY:	    SimReply, SimCall
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    the message goes out after the link delay
+ *
+ * STRATEGY:	    Same framing as RpcSendV in Tools/swat/rpc.c:
+ *		    RPC_MSG_START, the header and data with the three
+ *		    special bytes quoted, a checksum making the bytes
+ *		    sum to 0, and RPC_MSG_END.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+SimSend(byte flags, byte proc, byte id, byte *data, int len)
+{
+    byte    msg[RPC_HEADER_SIZE + RPC_MAX_DATA + 1];
+    byte    frame[2 * sizeof(msg) + 2];
+    int	    n, i, w;
+    byte    checksum;
+
+    msg[0] = flags;
+    msg[1] = proc;
+    msg[2] = len;
+    msg[3] = id;
+    memcpy(&msg[RPC_HEADER_SIZE], data, len);
+    len += RPC_HEADER_SIZE;
+
+    for (checksum = 0, i = 0; i < len; i++) {
+	checksum += msg[i];
+    }
+    msg[len++] = ~checksum + 1;
+
+    n = 0;
+    frame[n++] = RPC_MSG_START;
+    for (i = 0; i < len; i++) {
+	switch (msg[i]) {
+	    case RPC_MSG_START:
+		frame[n++] = RPC_MSG_QUOTE;
+		frame[n++] = RPC_MSG_QUOTE_START;
+		break;
+	    case RPC_MSG_END:
+		frame[n++] = RPC_MSG_QUOTE;
+		frame[n++] = RPC_MSG_QUOTE_END;
+		break;
+	    case RPC_MSG_QUOTE:
+		frame[n++] = RPC_MSG_QUOTE;
+		frame[n++] = RPC_MSG_QUOTE_QUOTE;
+		break;
+	    default:
+		frame[n++] = msg[i];
+		break;
+	}
+    }
+    frame[n++] = RPC_MSG_END;
+
+    SimDelay(n);
+
+    for (i = 0; i < n; i += w) {
+	w = write(simOut, &frame[i], n - i);
+	if (w < 0) {
+	    if (errno == EINTR) {
+		w = 0;
+		continue;
+	    }
+	    perror("swatsim: write");
+	    return;
+	}
+    }
+    stats.bytesOut += n;
+}
+
+
+/***********************************************************************
+ *				SimReply
+ ***********************************************************************
+ * SYNOPSIS:	    Answer a call from Swat, remembering the answer in
+ *		    case the call is resent
+ * CALLED BY:	    SimCall
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    an entry in recent[] is overwritten
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+SimReply(byte *header, byte flags, byte *data, int len)
+{
+    recent[recentNext].valid = 1;
+    recent[recentNext].id = header[3];
+    recent[recentNext].proc = header[1];
+    recent[recentNext].flags = flags;
+    recent[recentNext].len = len;
+    memcpy(recent[recentNext].data, data, len);
+    recentNext = (recentNext + 1) % SIM_RECENT;
+
+    SimSend(flags, header[1], header[3], data, len);
+}
+
+
+/***********************************************************************
+ *				SimCall
+ ***********************************************************************
+ * SYNOPSIS:	    Handle a call from Swat
+ * CALLED BY:	    SimMessage
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    a reply, and perhaps some calls, are sent
+ *
+ * STRATEGY:	    see the file header
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+SimCall(byte *header, byte *data)
+{
+    byte    proc = header[1];
+    int	    len = header[2];
+    SimKey  *k;
+    int	    i, s;
+
+    for (i = 0; i < SIM_RECENT; i++) {
+	if (recent[i].valid && recent[i].id == header[3] &&
+	    recent[i].proc == proc)
+	{
+	    stats.resends++;
+	    SimSend(recent[i].flags, proc, header[3], recent[i].data,
+		    recent[i].len);
+	    return;
+	}
+    }
+    stats.calls++;
+
+    k = SimFindKey(proc, data, len);
+    if (k->first != -1) {
+	SimEntry    *e = &entries[k->cur];
+
+	if (e->nextSame != -1) {
+	    k->cur = e->nextSame;
+	}
+	stats.replayed++;
+	(void)SimWrite(proc, data, len);
+	if (e->reply != -1) {
+	    SimEntry	*r = &entries[e->reply];
+
+	    SimReply(header, r->tag == 'R' ? RPC_REPLY : RPC_ERROR,
+		     r->data, r->len);
+	}
+	s = e->stubs;
+    } else {
+	byte	buf[RPC_MAX_DATA];
+
+	if ((proc == RPC_READ_MEM || proc == RPC_READ_ABS) && len >= 6 &&
+	    SimWord(data+4) <= RPC_MAX_DATA &&
+	    SimImageFetch(proc == RPC_READ_ABS, SimWord(data+2),
+			  SimWord(data), buf, SimWord(data+4)))
+	{
+	    stats.image++;
+	    SimReply(header, RPC_REPLY, buf, SimWord(data+4));
+	} else if (SimWrite(proc, data, len)) {
+	    stats.image++;
+	    SimReply(header, RPC_REPLY, buf, 0);
+	} else {
+	    if (verbose) {
+		fprintf(stderr, "swatsim: no reply for procedure %d "
+			"(%d bytes)\n", proc, len);
+	    }
+	    stats.misses++;
+	    buf[0] = (proc == RPC_READ_MEM) ? RPC_NOHANDLE : RPC_NOPROC;
+	    SimReply(header, RPC_ERROR, buf, 1);
+	}
+	s = -1;
+    }
+
+    if (!started) {
+	started = 1;
+	for (i = preStubs; i != -1; i = entries[i].nextStub) {
+	    SimSend(RPC_CALL, entries[i].proc, nextStubID++,
+		    entries[i].data, entries[i].len);
+	}
+    }
+    for (; s != -1; s = entries[s].nextStub) {
+	SimSend(RPC_CALL, entries[s].proc, nextStubID++,
+		entries[s].data, entries[s].len);
+    }
+}
+
+
+/***********************************************************************
+ *				SimServe
+ ***********************************************************************
+ * SYNOPSIS:	    Handle one connection until Swat goes away
+ * CALLED BY:	    main
+ * RETURN:	    nothing
+ * SIDE EFFECTS:    lots
+ *
+ * STRATEGY:	    Unframe incoming bytes exactly as RpcHandleStream
+ *		    does. Replies and acknowledgements from Swat, to
+ *		    the calls we make, need nothing further, so only
+ *		    calls are acted on.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+SimServe(void)
+{
+    byte    inbuf[4096];
+    byte    msg[RPC_HEADER_SIZE + RPC_MAX_DATA + 1];
+    int	    msgLen = 0;
+    enum { SYNC, BASE, QUOTE } state = SYNC;
+    int	    n, i;
+
+    while ((n = read(simIn, inbuf, sizeof(inbuf))) != 0) {
+	if (n < 0) {
+	    if (errno == EINTR) {
+		continue;
+	    }
+	    perror("swatsim: read");
+	    break;
+	}
+	stats.bytesIn += n;
+
+	for (i = 0; i < n; i++) {
+	    byte    b = inbuf[i];
+
+	    if (b == RPC_MSG_START) {
+		state = BASE;
+		msgLen = 0;
+		continue;
+	    }
+	    if (state == SYNC) {
+		continue;
+	    }
+	    if (b == RPC_MSG_END) {
+		byte	checksum;
+		int	j;
+
+		state = SYNC;
+		for (checksum = 0, j = 0; j < msgLen; j++) {
+		    checksum += msg[j];
+		}
+		/*
+		 * Drop anything mangled, or not an RPC at all (the
+		 * "ESC R S" restart sequence Swat sends the stub).
+		 */
+		if (checksum == 0 && msgLen > RPC_HEADER_SIZE &&
+		    msg[2] + RPC_HEADER_SIZE == msgLen - 1 &&
+		    (msg[0] & RpcTypeMask) == RPC_CALL)
+		{
+		    SimCall(msg, &msg[RPC_HEADER_SIZE]);
+		}
+		continue;
+	    }
+	    if (state == QUOTE) {
+		switch (b) {
+		    case RPC_MSG_QUOTE_START: b = RPC_MSG_START; break;
+		    case RPC_MSG_QUOTE_END: b = RPC_MSG_END; break;
+		    case RPC_MSG_QUOTE_QUOTE: b = RPC_MSG_QUOTE; break;
+		    default: state = SYNC; continue;
+		}
+		state = BASE;
+	    } else if (b == RPC_MSG_QUOTE) {
+		state = QUOTE;
+		continue;
+	    }
+	    msg[msgLen++] = b;
+	    if (msgLen == sizeof(msg)) {
+		state = SYNC;
+	    }
+	}
+    }
+
+    if (verbose) {
+	fprintf(stderr, "swatsim: %ld calls: %ld replayed, %ld from image, "
+		"%ld missed, %ld resent; %ld bytes in, %ld out\n",
+		stats.calls, stats.replayed, stats.image, stats.misses,
+		stats.resends, stats.bytesIn, stats.bytesOut);
+    }
+}
+
+
+/***********************************************************************
+ *				main
+ ***********************************************************************
+ * SYNOPSIS:	    Parse arguments and serve connections
+ * CALLED BY:	    the system
+ * RETURN:	    exit status
+ * SIDE EFFECTS:    none
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+int
+main(int argc, char **argv)
+{
+    int	    port = 0;
+    int	    c;
+
+    while ((c = getopt(argc, argv, "l:b:p:v")) != EOF) {
+	switch (c) {
+	    case 'l':
+		latency = (long)(atof(optarg) * 1000);
+		break;
+	    case 'b':
+		baud = atol(optarg);
+		break;
+	    case 'p':
+		port = atoi(optarg);
+		break;
+	    case 'v':
+		verbose = 1;
+		break;
+	    default:
+		goto usage;
+	}
+    }
+    if (optind != argc - 1) {
+    usage:
+	fprintf(stderr,
+		"usage: swatsim [-l <ms>] [-b <bps>] [-p <port>] [-v] "
+		"<snapshot>\n");
+	exit(2);
+    }
+
+    if (!SimLoad(argv[optind])) {
+	exit(1);
+    }
+
+    if (port == 0) {
+	SimReset();
+	SimServe();
+    } else {
+	struct sockaddr_in  sin;
+	int 	    	    s, on = 1;
+
+	s = socket(AF_INET, SOCK_STREAM, 0);
+	if (s < 0) {
+	    perror("swatsim: socket");
+	    exit(1);
+	}
+	(void)setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (char *)&on,
+			 sizeof(on));
+	memset(&sin, 0, sizeof(sin));
+	sin.sin_family = AF_INET;
+	sin.sin_addr.s_addr = htonl(INADDR_ANY);
+	sin.sin_port = htons(port);
+	if (bind(s, (struct sockaddr *)&sin, sizeof(sin)) < 0 ||
+	    listen(s, 1) < 0)
+	{
+	    perror("swatsim: bind");
+	    exit(1);
+	}
+	while (1) {
+	    int	    fd = accept(s, NULL, NULL);
+
+	    if (fd < 0) {
+		if (errno != EINTR) {
+		    perror("swatsim: accept");
+		}
+		continue;
+	    }
+	    (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (char *)&on,
+			     sizeof(on));
+	    simIn = simOut = fd;
+	    SimReset();
+	    SimServe();
+	    close(fd);
+	}
+    }
+    exit(0);
+}
@@ -23,6 +23,9 @@ Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
 
 typedef unsigned char U_CHAR;
 
+/* For memchr, as compat/string.h has only strings.h on unix. Ahead of
+   config.h, whose strerror macro would mangle the declaration.  */
+#include <string.h>
 #include <config.h>
 #include "tm-i386.h"
 
@@ -65,6 +68,7 @@ int do_define (), do_line (), do_include (), do_undef (), do_error (),
   do_elif (), do_endif (), do_sccs (), do_once ();
 
 struct hashnode *lookup ();
+int hashf ();
 
 char *xmalloc (int), *xrealloc (), *xcalloc (), *savestring ();
 void fatal (), fancy_abort (), pfatal_with_name (), perror_with_name ();
@@ -362,6 +366,7 @@ struct hashnode {
 				   of the chain and gets deleted. */
   enum node_type type;		/* type of special token */
   int length;			/* length of token, for quick comparison */
+  int hash;			/* whole hash code, from hashf () */
   U_CHAR *name;			/* the actual name */
   union hashval value;		/* pointer to expansion, or whatever */
 };
@@ -373,12 +378,23 @@ typedef struct hashnode HASHNODE;
    loop computes the hash value `on the fly' for most tokens,
    in order to avoid the overhead of a lot of procedure calls to
    the hashf () function.  Hashf () only exists for the sake of
-   politeness, for use when speed isn't so important. */
-
-#define HASHSIZE 1403
-HASHNODE *hashtab[HASHSIZE];
-#define HASHSTEP(old, c) ((old << 2) + c)
+   politeness, for use when speed isn't so important.
+
+   Each node keeps its whole hash code, not just the bucket number, so
+   a chain can be searched by comparing codes before names and the table
+   can be grown without hashing any name again.  The table starts with
+   HASHSIZE buckets and doubles whenever it holds more than two nodes a
+   bucket; the size is always a power of two.  */
+
+#define HASHSIZE 1024
+HASHNODE **hashtab;		/* the buckets, made by grow_hashtab () */
+int hashtab_size;		/* number of buckets */
+int hashtab_count;		/* number of nodes in the table */
+#define HASHSTEP(old, c) (((old) << 5) + (old) + (c))
 #define MAKE_POS(v) (v & ~0x80000000) /* make number positive */
+/* Fold the high bits in, as the low bits of the code depend mostly
+   on the last few characters of the name.  */
+#define HASHBUCKET(h) (((h) ^ ((h) >> 10) ^ ((h) >> 20)) & (hashtab_size - 1))
 
 /* Symbols to predefine.  */
 
@@ -461,10 +477,22 @@ struct if_stack {
   int if_succeeded;		/* true if a leg of this if-group
 				    has been passed through rescan */
   enum node_type type;		/* type of last directive seen in this group */
+  U_CHAR *control_macro;	/* macro tested, if this is a #ifndef at the
+				   start of a file and has no #else */
 };
 typedef struct if_stack IF_STACK_FRAME;
 IF_STACK_FRAME *if_stack = NULL;
 
+/* Where the `#' of the directive being handled is.  */
+U_CHAR *directive_start;
+
+/* Files found to be all inside a #ifndef, with the macro it tests.
+   While that macro is defined, including the file again would produce
+   nothing, so it isn't even opened.  The name of each node is the file
+   name and its value the macro name.  */
+#define GUARD_HASHSIZE 64
+HASHNODE *guard_table[GUARD_HASHSIZE];
+
 /* Buffer of -M output.  */
 
 char *deps_buffer;
@@ -1254,7 +1282,7 @@ rescan (op, output_marks)
   register int ident_length = 0;
 
   /* Hash code of pending accumulated identifier.  */
-  register int hash = 0;
+  register unsigned int hash = 0;
 
   /* Current input level (&instack[indepth]).  */
   FILE_BUF *ip;
@@ -1508,15 +1536,15 @@ do { ip = &instack[indepth];		\
 	}
 	{
 	  U_CHAR *before_bp = ibp+2;
+	  U_CHAR *nl = (U_CHAR *) memchr (ibp, '\n', limit - ibp);
 
-	  while (ibp < limit) {
-	    if (*ibp++ == '\n') {
-	      ibp--;
-	      if (put_out_comments) {
-		bcopy (before_bp, obp, ibp - before_bp);
-		obp += ibp - before_bp;
-	      }
-	      break;
+	  if (nl == NULL)
+	    ibp = limit;
+	  else {
+	    ibp = nl;
+	    if (put_out_comments) {
+	      bcopy (before_bp, obp, ibp - before_bp);
+	      obp += ibp - before_bp;
 	    }
 	  }
 	  break;
@@ -1551,6 +1579,26 @@ do { ip = &instack[indepth];		\
 	U_CHAR *before_bp = ibp;
 
 	while (ibp < limit) {
+	  if (!warn_comments) {
+	    /* Only a star can end the comment, so let memchr find the
+	       next one rather than looking at every character, then
+	       account for the newlines passed on the way.  */
+	    U_CHAR *star = (U_CHAR *) memchr (ibp, '*', limit - ibp);
+	    U_CHAR *nl;
+
+	    if (star == NULL)
+	      star = limit;
+	    while ((nl = (U_CHAR *) memchr (ibp, '\n', star - ibp)) != NULL) {
+	      ++ip->lineno;
+	      if (!put_out_comments)
+		*obp++ = '\n';
+	      ++op->lineno;
+	      ibp = nl + 1;
+	    }
+	    ibp = star;
+	    if (ibp >= limit)
+	      break;
+	  }
 	  switch (*ibp++) {
 	  case '/':
 	    if (warn_comments && ibp < limit && *ibp == '*')
@@ -1634,6 +1682,15 @@ do { ip = &instack[indepth];		\
       ident_length++;
       /* Compute step of hash function, to avoid a proc call on every token */
       hash = HASHSTEP (hash, c);
+      /* Take the rest of the identifier here rather than going round
+	 the main loop for each character.  A backslash-newline or
+	 newline mark inside it stops this, and the loop deals with it.  */
+      while (is_idchar[*ibp]) {
+	c = *ibp++;
+	*obp++ = c;
+	ident_length++;
+	hash = HASHSTEP (hash, c);
+      }
       break;
 
     case '\n':
@@ -1771,10 +1828,11 @@ randomchar:
 	   If REDO_CHAR is 1, the terminating char has already been
 	   backed over.  OBP-IDENT_LENGTH points to the identifier.  */
 
-	for (hp = hashtab[MAKE_POS (hash) % HASHSIZE]; hp != NULL;
+	hash = MAKE_POS (hash);
+	for (hp = hashtab[HASHBUCKET (hash)]; hp != NULL;
 	     hp = hp->next) {
 
-	  if (hp->length == ident_length) {
+	  if (hp->hash == hash && hp->length == ident_length) {
 	    U_CHAR *obufp_before_macroname;
 	    int op_lineno_before_macroname;
 	    register int i = ident_length;
@@ -2056,6 +2114,7 @@ handle_directive (ip, op)
 #endif
 
   bp = ip->bufp;
+  directive_start = bp - 1;
   /* Skip whitespace and \-newline.  */
   while (1) {
     if (is_hor_space[*bp])
@@ -2443,6 +2502,82 @@ oops:
 
 /* Routines to handle #directives */
 
+/*
+ * Return nonzero if there is nothing but whitespace, backslash-newlines
+ * and comments from P up to LIMIT.
+ */
+int
+only_white_space (p, limit)
+     register U_CHAR *p, *limit;
+{
+  while (p < limit) {
+    if (is_space[*p])
+      p++;
+    else if (*p == '\\' && p[1] == '\n')
+      p += 2;
+    else if (*p == '/' && p[1] == '*') {
+      for (p += 2; p < limit; p++)
+	if (*p == '*' && p[1] == '/')
+	  break;
+      if (p >= limit)
+	return 0;
+      p += 2;
+    } else if (cplusplus && *p == '/' && p[1] == '/') {
+      while (p < limit && *p != '\n')
+	p++;
+    } else
+      return 0;
+  }
+  return 1;
+}
+
+/*
+ * Remember that the file FNAME is all inside a #ifndef MACRO, so it
+ * need not be read again while MACRO is defined.
+ */
+void
+record_control_macro (fname, macro)
+     char *fname;
+     U_CHAR *macro;
+{
+  HASHNODE *hp, **hash_bucket;
+  int len = strlen (fname);
+
+  hash_bucket = &guard_table[hashf ((U_CHAR *) fname, len) % GUARD_HASHSIZE];
+  for (hp = *hash_bucket; hp != NULL; hp = hp->next)
+    if (hp->length == len && strcmp ((char *) hp->name, fname) == 0) {
+      hp->value.cpval = (char *) macro;
+      return;
+    }
+
+  hp = (HASHNODE *) xcalloc (1, sizeof (HASHNODE) + len + 1);
+  hp->next = *hash_bucket;
+  *hash_bucket = hp;
+  hp->length = len;
+  hp->name = ((U_CHAR *) hp) + sizeof (HASHNODE);
+  strcpy ((char *) hp->name, fname);
+  hp->value.cpval = (char *) macro;
+}
+
+/*
+ * Return nonzero if the file FNAME was found to be all inside a #ifndef
+ * whose macro is now defined, so including it again would produce
+ * nothing.
+ */
+int
+guarded_file_p (fname)
+     char *fname;
+{
+  HASHNODE *hp;
+  int len = strlen (fname);
+
+  for (hp = guard_table[hashf ((U_CHAR *) fname, len) % GUARD_HASHSIZE];
+       hp != NULL; hp = hp->next)
+    if (hp->length == len && strcmp ((char *) hp->name, fname) == 0)
+      return lookup ((U_CHAR *) hp->value.cpval, -1, -1) != NULL;
+  return 0;
+}
+
 /*
  * Process include file by reading it in and calling rescan.
  * Expects to see "fname" or <fname> on the input.
@@ -2567,6 +2702,8 @@ get_filename:
   if (*fbeg == '/') {
     strncpy (fname, fbeg, flen);
     fname[flen] = 0;
+    if (guarded_file_p (fname))
+      return;
     f = open (fname, O_RDONLY, 0666);
   } else {
     /* Search directory path, trying to open the file.
@@ -2593,6 +2730,11 @@ get_filename:
 	fname[flen] = 0;
       }
 #endif /* VMS */
+      /* A guarded file seen before needn't be opened.  It would be
+	 found at this point on the path, as every directory tried
+	 before didn't have it.  */
+      if (guarded_file_p (fname))
+	return;
       if ((f = open (fname, O_RDONLY, 0666)) >= 0)
 	break;
     }
@@ -2910,7 +3052,7 @@ do_define (buf, limit, op, keyword)
     defn->argnames = (U_CHAR *) "";
   }
 
-  hashcode = hashf (symname, sym_length, HASHSIZE);
+  hashcode = hashf (symname, sym_length);
 
   {
     HASHNODE *hp;
@@ -3355,7 +3497,7 @@ do_line (buf, limit, op, keyword)
     }
 
     hash_bucket =
-      &fname_table[hashf (fname, fname_length, FNAME_HASHSIZE)];
+      &fname_table[hashf (fname, fname_length) % FNAME_HASHSIZE];
     for (hp = *hash_bucket; hp != NULL; hp = hp->next)
       if (hp->length == fname_length &&
 	  strncmp (hp->value.cpval, fname, fname_length) == 0) {
@@ -3513,7 +3655,7 @@ do_if (buf, limit, op, keyword)
   FILE_BUF *ip = &instack[indepth];
 
   value = eval_if_expression (buf, limit - buf);
-  conditional_skip (ip, value == 0, T_IF);
+  conditional_skip (ip, value == 0, T_IF, (U_CHAR *) 0);
 }
 
 /*
@@ -3542,6 +3684,7 @@ do_elif (buf, limit, op, keyword)
       fprintf (stderr, ")\n");
     }
     if_stack->type = T_ELIF;
+    if_stack->control_macro = 0;
   }
 
   if (if_stack->if_succeeded)
@@ -3594,6 +3737,7 @@ do_xifdef (buf, limit, op, keyword)
   int skip;
   FILE_BUF *ip = &instack[indepth];
   U_CHAR *end;
+  U_CHAR *control_macro = 0;
 
   /* Discard leading and trailing whitespace.  */
   SKIP_WHITE_SPACE (buf);
@@ -3615,19 +3759,31 @@ do_xifdef (buf, limit, op, keyword)
       warning2 ("garbage at end of #%s argument", keyword->name);
 
     skip = (lookup (buf, end-buf, -1) == NULL) ^ (keyword->type == T_IFNDEF);
+
+    /* A #ifndef with nothing before it in the file may be guarding
+       the whole file against being included twice.  */
+    if (keyword->type == T_IFNDEF && !skip && ip->fname != 0
+	&& only_white_space (ip->buf, directive_start)) {
+      control_macro = (U_CHAR *) xmalloc (end - buf + 1);
+      bcopy (buf, control_macro, end - buf);
+      control_macro[end - buf] = 0;
+    }
   }
 
-  conditional_skip (ip, skip, T_IF);
+  conditional_skip (ip, skip, T_IF, control_macro);
 }
 
 /*
  * push TYPE on stack; then, if SKIP is nonzero, skip ahead.
+ * CONTROL_MACRO, if nonzero, is the macro tested by a #ifndef at the
+ * start of the file.
  */
 void
-conditional_skip (ip, skip, type)
+conditional_skip (ip, skip, type, control_macro)
      FILE_BUF *ip;
      int skip;
      enum node_type type;
+     U_CHAR *control_macro;
 {
   IF_STACK_FRAME *temp;
 
@@ -3638,6 +3794,7 @@ conditional_skip (ip, skip, type)
   if_stack = temp;
 
   if_stack->type = type;
+  if_stack->control_macro = control_macro;
 
   if (skip != 0) {
     skip_if_group (ip, 0);
@@ -3840,6 +3997,7 @@ do_else (buf, limit, op, keyword)
       fprintf (stderr, ")\n");
     }
     if_stack->type = T_ELSE;
+    if_stack->control_macro = 0;
   }
 
   if (if_stack->if_succeeded)
@@ -3868,6 +4026,14 @@ do_endif (buf, limit, op, keyword)
     error ("unbalanced #endif");
   else {
     IF_STACK_FRAME *temp = if_stack;
+    FILE_BUF *ip = &instack[indepth];
+
+    /* If this ends a #ifndef at the start of the file and there's
+       nothing after it, the file needn't be read again while the
+       macro is defined.  */
+    if (temp->control_macro != 0
+	&& only_white_space (ip->bufp, ip->buf + ip->length))
+      record_control_macro (ip->fname, temp->control_macro);
     if_stack = if_stack->next;
     free ((char*) temp);
     output_line_command (&instack[indepth], op, 1, same_file);
@@ -3949,17 +4115,31 @@ skip_to_end_of_comment (ip, line_counter)
       *op->bufp++ = '/';
       *op->bufp++ = '\n';
     } else {
-      while (bp < limit) {
-	if (*bp++ == '\n') {
-	  bp--;
-	  break;
-	}
-      }
+      U_CHAR *nl = (U_CHAR *) memchr (bp, '\n', limit - bp);
+
+      bp = nl != NULL ? nl : limit;
     }
     ip->bufp = bp;
     return bp;
   }
   while (bp < limit) {
+    if (!output) {
+      /* Nothing to copy, so go straight to the next star, counting
+	 the newlines passed.  */
+      U_CHAR *star = (U_CHAR *) memchr (bp, '*', limit - bp);
+      U_CHAR *nl;
+
+      if (star == NULL)
+	star = limit;
+      if (line_counter != NULL)
+	while ((nl = (U_CHAR *) memchr (bp, '\n', star - bp)) != NULL) {
+	  ++*line_counter;
+	  bp = nl + 1;
+	}
+      bp = star;
+      if (bp >= limit)
+	break;
+    }
     if (output)
       *op->bufp++ = *bp;
     switch (*bp++) {
@@ -4916,6 +5096,43 @@ grow_outbuf (obuf, needed)
 
 /* Symbol table for macro names and special symbols */
 
+/*
+ * Double the number of buckets in the hash table, or make the first
+ * ones, and move every node to its new chain.  Nodes with the same name
+ * must stay newest first, so each old chain is moved from its tail.
+ */
+void
+grow_hashtab ()
+{
+  HASHNODE **old_tab = hashtab;
+  int old_size = hashtab_size;
+  int i;
+
+  hashtab_size = old_size ? old_size * 2 : HASHSIZE;
+  hashtab = (HASHNODE **) xcalloc (hashtab_size, sizeof (HASHNODE *));
+
+  for (i = 0; i < old_size; i++) {
+    register HASHNODE *hp, *prev, **bucket;
+
+    if ((hp = old_tab[i]) == NULL)
+      continue;
+    while (hp->next != NULL)
+      hp = hp->next;
+    for (; hp != NULL; hp = prev) {
+      prev = hp->prev;
+      bucket = &hashtab[HASHBUCKET (hp->hash)];
+      hp->bucket_hdr = bucket;
+      hp->prev = NULL;
+      hp->next = *bucket;
+      if (hp->next != NULL)
+	hp->next->prev = hp;
+      *bucket = hp;
+    }
+  }
+  if (old_tab != NULL)
+    free ((char *) old_tab);
+}
+
 /*
  * install a name in the main hash table, even if it is already there.
  *   name stops with first non alphanumeric, except leading '#'.
@@ -4951,11 +5168,16 @@ install (name, len, type, value, hash)
   }
 
   if (hash < 0)
-    hash = hashf (name, len, HASHSIZE);
+    hash = hashf (name, len);
+
+  if (hashtab_count >= 2 * hashtab_size)
+    grow_hashtab ();
+  hashtab_count++;
 
   i = sizeof (HASHNODE) + len + 1;
   hp = (HASHNODE *) xmalloc (i);
-  bucket = hash;
+  bucket = HASHBUCKET (hash);
+  hp->hash = hash;
   hp->bucket_hdr = &hashtab[bucket];
   hp->next = hashtab[bucket];
   hashtab[bucket] = hp;
@@ -4998,12 +5220,16 @@ lookup (name, len, hash)
     len = bp - name;
   }
 
+  if (hashtab == NULL)
+    return NULL;
+
   if (hash < 0)
-    hash = hashf (name, len, HASHSIZE);
+    hash = hashf (name, len);
 
-  bucket = hashtab[hash];
+  bucket = hashtab[HASHBUCKET (hash)];
   while (bucket) {
-    if (bucket->length == len && strncmp (bucket->name, name, len) == 0)
+    if (bucket->hash == hash && bucket->length == len
+	&& strncmp (bucket->name, name, len) == 0)
       return bucket;
     bucket = bucket->next;
   }
@@ -5037,6 +5263,7 @@ delete_macro (hp)
      the deleted guy was on points to the right thing afterwards. */
   if (hp == *hp->bucket_hdr)
     *hp->bucket_hdr = hp->next;
+  hashtab_count--;
 
 #if 0
   if (hp->type == T_MACRO) {
@@ -5055,20 +5282,20 @@ delete_macro (hp)
 
 /*
  * return hash function on name.  must be compatible with the one
- * computed a step at a time, elsewhere
+ * computed a step at a time, elsewhere.  The whole code is returned;
+ * take it modulo the size of the table it's for.
  */
 int
-hashf (name, len, hashsize)
+hashf (name, len)
      register U_CHAR *name;
      register int len;
-     int hashsize;
 {
-  register int r = 0;
+  register unsigned int r = 0;
 
   while (len--)
     r = HASHSTEP (r, *name++);
 
-  return MAKE_POS (r) % hashsize;
+  return MAKE_POS (r);
 }
 
 /* Dump all macro definitions as #defines to stdout.  */
@@ -5078,7 +5305,7 @@ dump_all_macros ()
 {
   int bucket;
 
-  for (bucket = 0; bucket < HASHSIZE; bucket++) {
+  for (bucket = 0; bucket < hashtab_size; bucket++) {
     register HASHNODE *hp;
 
     for (hp = hashtab[bucket]; hp; hp= hp->next) {
@@ -77,6 +77,14 @@ extern MemHandle    MemAllocAndLock(short   numBytes,
 				    short   typeFlags,
 				    short   allocFlags,
 				    void    **addrPtr);
+/*
+ * Make a handle for memory that belongs to the caller, such as part of a
+ * mapped file. The memory isn't freed with the handle, and is copied to
+ * memory of our own should the block be resized.
+ */
+extern MemHandle    MemAllocExternal(void	*addr,
+				     word	numBytes);
+
 /*
  * Change the size of a block. Only HAF_ZERO_INIT is valid for allocFlags.
  * Returns non-zero if successful.
@@ -115,6 +123,20 @@ extern void 	    *MemLock(MemHandle	handle);
 extern void 	    MemInfo(MemHandle	handle,
 			    genptr    	*addrPtr,
 			    word    	*sizePtr);
+/*
+ * Free every block and handle at once, for when a tool is done with all
+ * its memory (and all its VM files). Much faster than freeing each.
+ */
+extern void 	    MemFreeAll(void);
+
+/*
+ * Print allocation statistics through printFunc, which is called like
+ * fprintf with data as its first argument.
+ */
+typedef void MemPrintFunc(void *data, const char *fmt, ...);
+extern void 	    MemPrintStats(MemPrintFunc	*printFunc,
+				  void	    	*data);
+
 /*
  * Other routines from PC/GEOS will be implemented as needed.
  */
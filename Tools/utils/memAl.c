@@ -12,6 +12,7 @@
  *	Name	  	    Description
  *	----	  	    -----------
  *	MemAlloc    	    Allocate a block and return its handle
+ *	MemAllocExternal    Make a handle for memory the caller owns
  *
  * REVISION HISTORY:
  *	Date	  Name	    Description
@@ -45,13 +46,14 @@ static char *rcsid =
  *
  * STRATEGY:
  *	- Allocate a handle
- *	- Allocate a block of memory
+ *	- Allocate a block of memory (from a slab if it's small)
  *	- Store the address in the handle
  *
  * REVISION HISTORY:
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	8/ 1/89		Initial Revision
+ *	agent	10/16/26	Use MemBlockAlloc
  *
  ***********************************************************************/
 MemHandle
@@ -63,16 +65,13 @@ MemAlloc(word	    numBytes,	    /* Number of bytes to allocate */
     void    	    *block;
 
     handle = MemAllocHandle();
-    block = (void *)malloc(numBytes);
+    block = MemBlockAlloc(numBytes);
 
     if (block == 0) {
     	if (allocFlags & HAF_NO_ERR) {
 	    MemAllocErr();
 	} else {
-	    /*
-	     * No need to free the handle -- it's not really allocated until
-	     * we store an address in it...
-	     */
+	    MemFreeHandle(handle);
 	    return((MemHandle)0);
 	}
     }
@@ -95,3 +94,37 @@ MemAlloc(word	    numBytes,	    /* Number of bytes to allocate */
      */
     return (handle);
 }
+
+
+/***********************************************************************
+ *				MemAllocExternal
+ ***********************************************************************
+ * SYNOPSIS:	    Make a handle for memory that belongs to the caller.
+ * CALLED BY:	    VMAllocAndRead
+ * RETURN:	    The handle allocated
+ * SIDE EFFECTS:    The handle is marked MEM_EXTERNAL, so MemFree won't
+ *	    	    free the memory and MemReAlloc will move it to a
+ *	    	    block of our own.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+MemHandle
+MemAllocExternal(void	*addr,	    /* Start of the memory */
+		 word	numBytes)   /* Number of bytes there */
+{
+    MemHandle	    handle;
+
+    handle = MemAllocHandle();
+
+    memHandleTable[handle].addr = addr;
+    memHandleTable[handle].size = numBytes;
+    memHandleTable[handle].flags = MEM_EXTERNAL;
+
+    return (handle);
+}
@@ -46,6 +46,8 @@ static char *rcsid =
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	8/ 2/89		Initial Revision
+ *	agent	10/16/26	Use MemBlockFree
+ *	agent	10/16/26	Leave external memory alone
  *
  ***********************************************************************/
 void
@@ -55,7 +57,10 @@ MemFree(MemHandle   handle)
     assert(handle > 0 && handle < memNumHandles &&
 	   memHandleTable[handle].addr != 0);
     
-    free((char *)memHandleTable[handle].addr);
+    if (!(memHandleTable[handle].flags & MEM_EXTERNAL)) {
+	MemBlockFree(memHandleTable[handle].addr,
+		     memHandleTable[handle].size);
+    }
 
     MemFreeHandle(handle);
 }
@@ -23,7 +23,10 @@
  *
  *	There is a single handle table that contains a pointer and a
  *	size for each handle. As for PC/GEOS, a MemHandle is an index
- *	into this table.
+ *	into this table. The memory for small blocks is carved from
+ *	slabs by size class (see memSlab.c); a free handle's pointer is
+ *	null. A handle made by MemAllocExternal points at memory the
+ *	caller owns (a mapped VM file, say), which is never freed here.
  *
  * 	$Id: memInt.h,v 1.5 91/04/26 11:48:10 adam Exp $
  *
@@ -38,13 +41,26 @@
 typedef struct {
     void    	*addr;	    /* Where data be located */
     int	    	size;	    /* Size of block allocated */
+    int	    	flags;	    /* Flags for block: */
+#define MEM_EXTERNAL	0x0001	/* Memory belongs to the creator of the
+				 * handle and isn't to be freed */
 } MemHandleRec, *MemHandlePtr;
 
 extern MemHandlePtr memHandleTable;
 extern int  	    memNumHandles;
+extern int  	    memHandlesInUse;	/* For MemPrintStats */
+extern int  	    memHandlesPeak;
 
 extern MemHandle    MemAllocHandle(void);
 extern void 	    MemFreeHandle(MemHandle handle);
+extern void 	    MemFreeHandleTable(void);
+
+/*
+ * Allocation of the memory for blocks, by size class.
+ */
+extern void 	    *MemBlockAlloc(int size);
+extern void 	    *MemBlockReAlloc(void *block, int oldSize, int newSize);
+extern void 	    MemBlockFree(void *block, int size);
 
 /*
  * Error message when can't allocate memory. Doesn't return
@@ -48,6 +48,8 @@ static char *rcsid =
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	8/ 2/89		Initial Revision
+ *	agent	10/16/26	Use MemBlockReAlloc
+ *	agent	10/16/26	Move external memory to a block of our own
  *
  ***********************************************************************/
 int
@@ -61,8 +63,23 @@ MemReAlloc(MemHandle	    handle,
     assert(handle > 0 && handle < memNumHandles &&
 	   memHandleTable[handle].addr != 0);
     
-    newBlock = (void *)realloc(memHandleTable[handle].addr,
-			       numBytes);
+    if (memHandleTable[handle].flags & MEM_EXTERNAL) {
+	/*
+	 * The memory isn't ours to resize, so move the contents to a block
+	 * that is. From here on, the block is like any other.
+	 */
+	newBlock = MemBlockAlloc(numBytes);
+	if (newBlock != (void *)0) {
+	    bcopy(memHandleTable[handle].addr, newBlock,
+		  (numBytes < memHandleTable[handle].size ?
+		   numBytes : memHandleTable[handle].size));
+	    memHandleTable[handle].flags &= ~MEM_EXTERNAL;
+	}
+    } else {
+	newBlock = MemBlockReAlloc(memHandleTable[handle].addr,
+				   memHandleTable[handle].size,
+				   numBytes);
+    }
 
     /*
      * Deal with allocation failure.
@@ -0,0 +1,411 @@
+/***********************************************************************
+ *
+ *	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * PROJECT:	  PCGEOS
+ * MODULE:	  Tools Library -- Memory Allocation: size-class slabs
+ * FILE:	  memSlab.c
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * ROUTINES:
+ *	Name	  	    Description
+ *	----	  	    -----------
+ *	MemBlockAlloc	    Allocate the memory for a block
+ *	MemBlockReAlloc	    Change the size of a block's memory
+ *	MemBlockFree	    Release the memory for a block
+ *	MemFreeAll  	    Free every block and handle at once
+ *	MemPrintStats	    Print allocation statistics
+ *
+ * REVISION HISTORY:
+ *	Date	  Name	    Description
+ *	----	  ----	    -----------
+ *	10/16/26  agent	    Initial version
+ *
+ * DESCRIPTION:
+ *	The VM code makes a great many small blocks, and sending each on
+ *	its own trip through malloc costs time and leaves the heap in
+ *	tatters. Blocks of up to MEM_SLAB_MAX bytes are instead rounded up
+ *	to one of a few size classes and carved from slabs of MEM_SLAB_SIZE
+ *	bytes, each class keeping a list of the blocks freed from it. Slabs
+ *	go back to malloc only when MemFreeAll throws everything away.
+ *	Larger blocks still come from malloc.
+ *
+ *	The size recorded in the handle says which class a block came
+ *	from, so nothing else need be kept with the block.
+ *
+ ***********************************************************************/
+#ifndef lint
+static char *rcsid =
+"$Id$";
+#endif lint
+
+#include <config.h>
+#include <compat/string.h>
+#include <compat/stdlib.h>
+
+#include "malloc.h"
+#include "memInt.h"
+
+#define MEM_SLAB_SIZE	16384	/* Bytes carved up at once for a class */
+#define MEM_SLAB_MAX	1024	/* Largest block that comes from a slab */
+
+/*
+ * The sizes of the classes. All are multiples of 8, so every block is
+ * aligned for any type, and each is a third or a half again the size of
+ * the one before, so at most a third of a block goes to waste.
+ */
+static const int memClassSizes[] = {
+    8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+};
+#define MEM_NUM_CLASSES	(sizeof(memClassSizes)/sizeof(memClassSizes[0]))
+
+/*
+ * The class for each size, indexed by the size in 8-byte units, rounded
+ * up. Filled in by MemInitClasses.
+ */
+static byte 	memSizeClass[(MEM_SLAB_MAX / 8) + 1];
+static int  	memClassesReady = 0;
+#define MEM_CLASS(size)	    memSizeClass[((size) + 7) >> 3]
+
+/*
+ * A free block is linked through its first bytes.
+ */
+typedef struct _MemFreeBlock {
+    struct _MemFreeBlock    *next;
+} MemFreeBlock;
+
+/*
+ * Header at the start of each slab. The blocks follow it.
+ */
+typedef union _MemSlab {
+    union _MemSlab  *next;  	/* Next slab made, for MemFreeAll */
+    double  	    align;  	/* Keep the blocks after us aligned */
+} MemSlab;
+
+typedef struct {
+    MemFreeBlock    *free;  	/* Blocks freed back to this class */
+    char    	    *next;  	/* Next block never yet handed out... */
+    char    	    *end;   	/* ...and the end of the slab it's in */
+    long    	    slabs;  	/* Number of slabs carved up */
+    long    	    inUse;  	/* Number of blocks in use */
+    long    	    peak;   	/* Most blocks ever in use at once */
+    long    	    allocs; 	/* Number of blocks ever handed out */
+} MemClass;
+
+static MemClass	memClasses[MEM_NUM_CLASSES];
+static MemSlab	*memSlabs = (MemSlab *)0;   /* Every slab made */
+
+/*
+ * Totals for MemPrintStats
+ */
+static long 	memAllocs, memFrees, memReAllocs, memReAllocsInPlace;
+static long 	memLargeInUse, memLargePeak;
+static long 	memBytesInUse, memBytesPeak;
+
+
+/***********************************************************************
+ *				MemInitClasses
+ ***********************************************************************
+ * SYNOPSIS:	    Fill in the size-to-class table
+ * CALLED BY:	    MemBlockAlloc
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    memSizeClass is set up
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+MemInitClasses(void)
+{
+    int	    i;
+    int	    c;
+
+    for (i = 0, c = 0; i <= MEM_SLAB_MAX / 8; i++) {
+	while (memClassSizes[c] < i * 8) {
+	    c++;
+	}
+	memSizeClass[i] = c;
+    }
+    memClassesReady = 1;
+}
+
+
+/***********************************************************************
+ *				MemBlockAlloc
+ ***********************************************************************
+ * SYNOPSIS:	    Allocate the memory for a block
+ * CALLED BY:	    MemAlloc, MemBlockReAlloc
+ * RETURN:	    The memory, or NULL if there's none left
+ * SIDE EFFECTS:    A new slab may be made
+ *
+ * STRATEGY:
+ *	Large blocks come from malloc. Small ones are taken from their
+ *	class's free list if it has any, else the next unused block of
+ *	its current slab, making a new slab if that one's used up.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void *
+MemBlockAlloc(int   size)
+{
+    void    	*block;
+
+    if (size > MEM_SLAB_MAX) {
+	block = (void *)malloc(size);
+	if (block == (void *)0) {
+	    return((void *)0);
+	}
+	if (++memLargeInUse > memLargePeak) {
+	    memLargePeak = memLargeInUse;
+	}
+    } else {
+	MemClass    *mc;
+
+	if (!memClassesReady) {
+	    MemInitClasses();
+	}
+	mc = &memClasses[MEM_CLASS(size)];
+
+	if (mc->free != (MemFreeBlock *)0) {
+	    block = (void *)mc->free;
+	    mc->free = mc->free->next;
+	} else {
+	    int	    csize = memClassSizes[MEM_CLASS(size)];
+
+	    if (mc->next == mc->end) {
+		MemSlab	    *slab;
+
+		slab = (MemSlab *)malloc(sizeof(MemSlab) + MEM_SLAB_SIZE);
+		if (slab == (MemSlab *)0) {
+		    return((void *)0);
+		}
+		slab->next = memSlabs;
+		memSlabs = slab;
+		mc->next = (char *)(slab + 1);
+		mc->end = mc->next + (MEM_SLAB_SIZE / csize) * csize;
+		mc->slabs++;
+	    }
+	    block = (void *)mc->next;
+	    mc->next += csize;
+	}
+	mc->allocs++;
+	if (++mc->inUse > mc->peak) {
+	    mc->peak = mc->inUse;
+	}
+    }
+
+    memAllocs++;
+    memBytesInUse += size;
+    if (memBytesInUse > memBytesPeak) {
+	memBytesPeak = memBytesInUse;
+    }
+    return(block);
+}
+
+
+/***********************************************************************
+ *				MemBlockFree
+ ***********************************************************************
+ * SYNOPSIS:	    Release the memory for a block
+ * CALLED BY:	    MemFree, MemBlockReAlloc
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    A small block goes on its class's free list
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+MemBlockFree(void   *block, 	/* Memory to release */
+	     int    size)   	/* Size it was allocated with */
+{
+    if (size > MEM_SLAB_MAX) {
+	free((char *)block);
+	memLargeInUse--;
+    } else {
+	MemClass    *mc = &memClasses[MEM_CLASS(size)];
+
+	((MemFreeBlock *)block)->next = mc->free;
+	mc->free = (MemFreeBlock *)block;
+	mc->inUse--;
+    }
+    memFrees++;
+    memBytesInUse -= size;
+}
+
+
+/***********************************************************************
+ *				MemBlockReAlloc
+ ***********************************************************************
+ * SYNOPSIS:	    Change the size of a block's memory
+ * CALLED BY:	    MemReAlloc
+ * RETURN:	    The block's new address, or NULL if there's no
+ *	    	    memory (in which case the block is unchanged)
+ * SIDE EFFECTS:    The block may move
+ *
+ * STRATEGY:
+ *	A small block whose new size is in the same class stays put.
+ *	Large blocks are left to realloc. Anything else is copied to a
+ *	new block.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void *
+MemBlockReAlloc(void	*block,	    /* Current memory */
+		int 	oldSize,    /* Size it was allocated with */
+		int 	newSize)    /* Size wanted */
+{
+    void    	*newBlock;
+
+    memReAllocs++;
+
+    if (oldSize > MEM_SLAB_MAX && newSize > MEM_SLAB_MAX) {
+	newBlock = (void *)realloc(block, newSize);
+	if (newBlock == (void *)0) {
+	    return((void *)0);
+	}
+    } else if (oldSize <= MEM_SLAB_MAX && newSize <= MEM_SLAB_MAX &&
+	       MEM_CLASS(oldSize) == MEM_CLASS(newSize))
+    {
+	newBlock = block;
+	memReAllocsInPlace++;
+    } else {
+	/*
+	 * Moving between classes, or between a slab and malloc. The
+	 * allocation and free do the accounting.
+	 */
+	newBlock = MemBlockAlloc(newSize);
+	if (newBlock == (void *)0) {
+	    return((void *)0);
+	}
+	bcopy(block, newBlock, oldSize < newSize ? oldSize : newSize);
+	MemBlockFree(block, oldSize);
+	return(newBlock);
+    }
+
+    memBytesInUse += newSize - oldSize;
+    if (memBytesInUse > memBytesPeak) {
+	memBytesPeak = memBytesInUse;
+    }
+    return(newBlock);
+}
+
+
+/***********************************************************************
+ *				MemFreeAll
+ ***********************************************************************
+ * SYNOPSIS:	    Free every block and handle at once
+ * CALLED BY:	    EXTERNAL
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    Every MemHandle becomes invalid, including those
+ *	    	    of blocks in any VM file still open.
+ *
+ * STRATEGY:
+ *	Free the large blocks one by one, as malloc has them, then the
+ *	slabs wholesale, which is far quicker than freeing each small
+ *	block. The handle table goes too. Statistics are left alone, so
+ *	the peaks cover the whole run.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+MemFreeAll(void)
+{
+    int	    	i;
+    MemSlab 	*slab, *next;
+
+    for (i = 1; i < memNumHandles; i++) {
+	if (memHandleTable[i].addr != 0 &&
+	    memHandleTable[i].size > MEM_SLAB_MAX &&
+	    !(memHandleTable[i].flags & MEM_EXTERNAL))
+	{
+	    free((char *)memHandleTable[i].addr);
+	}
+    }
+
+    for (slab = memSlabs; slab != (MemSlab *)0; slab = next) {
+	next = slab->next;
+	free((char *)slab);
+    }
+    memSlabs = (MemSlab *)0;
+
+    for (i = 0; i < MEM_NUM_CLASSES; i++) {
+	memClasses[i].free = (MemFreeBlock *)0;
+	memClasses[i].next = memClasses[i].end = (char *)0;
+	memClasses[i].slabs = memClasses[i].inUse = 0;
+    }
+    memLargeInUse = memBytesInUse = 0;
+
+    MemFreeHandleTable();
+}
+
+
+/***********************************************************************
+ *				MemPrintStats
+ ***********************************************************************
+ * SYNOPSIS:	    Print allocation statistics
+ * CALLED BY:	    EXTERNAL
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:	    Called like malloc_printstats, so printFunc may be
+ *	    	    fprintf and data a FILE *.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+MemPrintStats(MemPrintFunc  *printFunc,
+	      void  	    *data)
+{
+    int	    i;
+    long    slabs = 0;
+
+    (*printFunc)(data, "Mem: %d handles in use, %d at most, %d in table\n",
+		 memHandlesInUse, memHandlesPeak, memNumHandles);
+    (*printFunc)(data, "Mem: %ld allocs, %ld frees, %ld reallocs (%ld in place)\n",
+		 memAllocs, memFrees, memReAllocs, memReAllocsInPlace);
+    (*printFunc)(data, "Mem: %ld bytes in blocks, %ld at most\n",
+		 memBytesInUse, memBytesPeak);
+    (*printFunc)(data, "Mem: %ld blocks over %d bytes, %ld at most\n",
+		 memLargeInUse, MEM_SLAB_MAX, memLargePeak);
+
+    (*printFunc)(data, "Mem: %5s %6s %8s %8s %10s\n",
+		 "size", "slabs", "in use", "at most", "allocs");
+    for (i = 0; i < MEM_NUM_CLASSES; i++) {
+	MemClass    *mc = &memClasses[i];
+
+	if (mc->allocs != 0) {
+	    (*printFunc)(data, "Mem: %5d %6ld %8ld %8ld %10ld\n",
+			 memClassSizes[i], mc->slabs, mc->inUse, mc->peak,
+			 mc->allocs);
+	}
+	slabs += mc->slabs;
+    }
+    (*printFunc)(data, "Mem: %ld slabs of %d bytes\n", slabs, MEM_SLAB_SIZE);
+}
@@ -14,11 +14,13 @@
  *	MemAllocErr 	    Produce error message if can't allocate memory
  *	MemAllocHandle	    Allocate a handle
  *	MemFreeHandle	    Free a handle
+ *	MemFreeHandleTable  Free the whole handle table
  *
  * REVISION HISTORY:
  *	Date	  Name	    Description
  *	----	  ----	    -----------
  *	8/ 1/89	  ardeb	    Initial version
+ *	10/16/26  agent	    Grow the table by doubling, keep counts
  *
  * DESCRIPTION:
  *	Functions to deal with the handle table
@@ -40,8 +42,8 @@ static char *rcsid =
 #include "malloc.h"
 #include "memInt.h"
 
-#define	MEM_INIT_NUM_HANDLES	30
-#define MEM_INCR_NUM_HANDLES	30
+#define	MEM_INIT_NUM_HANDLES	32
+#define MEM_MAX_NUM_HANDLES	65536	/* A MemHandle is a word */
 
 /*
  * Table of handles
@@ -49,6 +51,8 @@ static char *rcsid =
 MemHandlePtr	memHandleTable = (MemHandlePtr)0;
 int	    	memNumHandles = 0;
 static int  	memHandleFreeList = -1;
+int 	    	memHandlesInUse = 0;
+int 	    	memHandlesPeak = 0;
 
 
 /***********************************************************************
@@ -92,11 +96,14 @@ MemAllocErr(void)
  * SIDE EFFECTS:    None
  *
  * STRATEGY:
+ *	The table doubles in size when it's full, so a tool with tens of
+ *	thousands of blocks doesn't spend its time copying the table.
  *
  * REVISION HISTORY:
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	8/ 1/89		Initial Revision
+ *	agent	10/16/26	Double the table, rather than adding 30
  *
  ***********************************************************************/
 MemHandle
@@ -124,28 +131,44 @@ MemAllocHandle()
 	    i = 1;
 	} else {
 	    /*
-	     * Expand the handle table by the specified number of handles,
-	     * zeroing out all new handles (so we know they're free)
+	     * Double the handle table, as far as a MemHandle can reach.
 	     */
-	    i = memNumHandles + 1;
-	    memNumHandles += MEM_INCR_NUM_HANDLES;
+	    if (memNumHandles == MEM_MAX_NUM_HANDLES) {
+		MemAllocErr();
+	    }
+	    i = memNumHandles;
+	    memNumHandles *= 2;
+	    if (memNumHandles > MEM_MAX_NUM_HANDLES) {
+		memNumHandles = MEM_MAX_NUM_HANDLES;
+	    }
 	    memHandleTable = (MemHandlePtr)realloc((char *)memHandleTable,
 						   memNumHandles *
 						   sizeof(MemHandleRec));
+	    if (memHandleTable == (MemHandlePtr)0) {
+		MemAllocErr();
+	    }
 	}
 	/*
-	 * Link the free handles through their size field (as it's an integer)
+	 * Link the free handles through their size field (as it's an
+	 * integer), zeroing their addresses so we know they're free.
 	 */
 	memHandleFreeList = i;
 	while (i < memNumHandles-1) {
+	    memHandleTable[i].addr = 0;
 	    memHandleTable[i].size = i+1;
 	    i++;
 	}
+	memHandleTable[i].addr = 0;
 	memHandleTable[i].size = -1;
     }
 
     i = memHandleFreeList;
     memHandleFreeList = memHandleTable[i].size;
+    memHandleTable[i].flags = 0;
+
+    if (++memHandlesInUse > memHandlesPeak) {
+	memHandlesPeak = memHandlesInUse;
+    }
 
     /*
      * Return index chosen.
@@ -175,6 +198,38 @@ MemFreeHandle(MemHandle	handle)
 {
     assert((memNumHandles > 0) && (handle < memNumHandles));
 
+    memHandleTable[handle].addr = 0;
     memHandleTable[handle].size = memHandleFreeList;
     memHandleFreeList = handle;
+    memHandlesInUse--;
+}
+
+
+/***********************************************************************
+ *				MemFreeHandleTable
+ ***********************************************************************
+ * SYNOPSIS:	    Free the whole handle table.
+ * CALLED BY:	    MemFreeAll
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    Every handle is gone; the next MemAllocHandle
+ *	    	    starts a new table.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+MemFreeHandleTable(void)
+{
+    if (memHandleTable != (MemHandlePtr)0) {
+	free((char *)memHandleTable);
+    }
+    memHandleTable = (MemHandlePtr)0;
+    memNumHandles = 0;
+    memHandleFreeList = -1;
+    memHandlesInUse = 0;
 }
@@ -42,6 +42,7 @@ static char *rcsid =
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	8/ 7/89		Initial Revision
+ *	agent	10/16/26	Discard the side index of an empty table
  *
  ***********************************************************************/
 int
@@ -93,6 +94,15 @@ ST_Close(VMHandle   	vmHandle,   	/* File in which table resides */
      */
     VMUnlock(vmHandle, table);
 
+    /*
+     * An empty table is about to be freed by our caller, and its block
+     * handle may then be reused for some other table, so its side index
+     * must go.
+     */
+    if (result == 0) {
+	STSideDiscard(vmHandle, table);
+    }
+
     return(result);
 }
 	
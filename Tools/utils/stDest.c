@@ -40,6 +40,7 @@ static char *rcsid =
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	2/28/90		Initial Revision
+ *	agent	10/16/26	Discard the side index
  *
  ***********************************************************************/
 void
@@ -69,8 +70,9 @@ ST_Destroy(VMHandle   	    vmHandle, 	/* File in which table resides */
     }
 
     /*
-     * Biff the header...
+     * Biff the header, and the side index with it...
      */
+    STSideDiscard(vmHandle, table);
     VMFree(vmHandle, table);
 }
 	
@@ -42,6 +42,7 @@ static char *rcsid =
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	9/26/89		Initial Revision
+ *	agent	10/16/26	Search the side index of the dest table
  *
  ***********************************************************************/
 ID
@@ -54,6 +55,8 @@ ST_Dup(VMHandle	    	vmSrcHandle,
     STHeader	    *hdr;
     ID	    	    result;
     int	    	    bucket;
+    STSide  	    *side;
+    dword   	    hash32;
 
     /*
      * Convenience: Null IDs map to Null IDs (avoids conditionals in the
@@ -74,15 +77,22 @@ ST_Dup(VMHandle	    	vmSrcHandle,
     /*
      * Lock down the header for the dest table
      */
+    side = STSideFind(vmDstHandle, dstTable);
     hdr = (STHeader *)VMLock(vmDstHandle, dstTable, (MemHandle *)NULL);
 
     /*
-     * Make sure the string isn't already in the dest table.
+     * Make sure the string isn't already in the dest table, using the
+     * side index if it has one.
      */
     bucket = ST_HASH_TO_BUCKET(stcp->hashval);
-    result = STSearch(vmDstHandle, hdr,
-		      bucket, stcp->hashval,
-		      stcp->string, stcp->length);
+    if (side != NULL) {
+	hash32 = STHash32(stcp->string, stcp->length);
+	result = STSideSearch(side, hash32, stcp->string, stcp->length);
+    } else {
+	result = STSearch(vmDstHandle, hdr,
+			  bucket, stcp->hashval,
+			  stcp->string, stcp->length);
+    }
 
     if (result == NullID) {
 	/*
@@ -91,6 +101,9 @@ ST_Dup(VMHandle	    	vmSrcHandle,
 	result = STAlloc(vmDstHandle, dstTable, hdr,
 			 bucket, stcp->hashval,
 			 stcp->string, stcp->length);
+	if (result != NullID && side != NULL) {
+	    STSideAdd(side, hash32, result, stcp->string, stcp->length);
+	}
     }
 
     VMUnlock(vmDstHandle, dstTable);
@@ -113,6 +126,7 @@ ST_Dup(VMHandle	    	vmSrcHandle,
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	9/26/89		Initial Revision
+ *	agent	10/16/26	Search the side index of the dest table
  *
  ***********************************************************************/
 ID
@@ -125,6 +139,8 @@ ST_DupNoEnter(VMHandle	    	vmSrcHandle,
     STHeader	    *hdr;
     ID	    	    result;
     int	    	    bucket;
+    STSide  	    *side;
+    dword   	    hash32;
 
     /*
      * Convenience: Null IDs map to Null IDs (avoids conditionals in the
@@ -145,15 +161,22 @@ ST_DupNoEnter(VMHandle	    	vmSrcHandle,
     /*
      * Lock down the header for the dest table
      */
+    side = STSideFind(vmDstHandle, dstTable);
     hdr = (STHeader *)VMLock(vmDstHandle, dstTable, (MemHandle *)NULL);
 
     /*
-     * Make sure the string isn't already in the dest table.
+     * Make sure the string isn't already in the dest table, using the
+     * side index if it has one.
      */
     bucket = ST_HASH_TO_BUCKET(stcp->hashval);
-    result = STSearch(vmDstHandle, hdr,
-		      bucket, stcp->hashval,
-		      stcp->string, stcp->length);
+    if (side != NULL) {
+	hash32 = STHash32(stcp->string, stcp->length);
+	result = STSideSearch(side, hash32, stcp->string, stcp->length);
+    } else {
+	result = STSearch(vmDstHandle, hdr,
+			  bucket, stcp->hashval,
+			  stcp->string, stcp->length);
+    }
 
     VMUnlock(vmDstHandle, dstTable);
 
@@ -168,6 +168,7 @@ error:
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	8/ 4/89		Initial Revision
+ *	agent	10/16/26	Search the side index first
  *
  ***********************************************************************/
 ID
@@ -180,6 +181,22 @@ ST_Enter(VMHandle   	vmHandle,   	/* File in which table resides */
     word    	    hashval;	/* Full hash value for the string */
     STHeader 	    *hdr;   	/* Address of header block */
     ID	    	    result; 	/* ID to return as result */
+    STSide  	    *side;  	/* Side index for the table */
+    dword   	    hash32; 	/* Hash value for the side index */
+
+    /*
+     * First take a stab at finding the thing in the side index, which
+     * knows every string in the table, so we needn't go near the chains
+     * unless it's not there.
+     */
+    side = STSideFind(vmHandle, table);
+    if (side != NULL) {
+	hash32 = STHash32(name, len);
+	result = STSideSearch(side, hash32, name, len);
+	if (result != NullID) {
+	    return(result);
+	}
+    }
 
     /*
      * Figure in which bucket the thing should reside.
@@ -193,15 +210,22 @@ ST_Enter(VMHandle   	vmHandle,   	/* File in which table resides */
     hdr = (STHeader *)VMLock(vmHandle, table, (MemHandle *)0);
 
     /*
-     * First take a stab at finding the thing.
+     * If there's no side index, search the chain the hard way.
      */
-    result = STSearch(vmHandle, hdr, bucket, hashval, name, len);
+    if (side == NULL) {
+	result = STSearch(vmHandle, hdr, bucket, hashval, name, len);
+    } else {
+	result = NullID;
+    }
 
     if (result == NullID) {
 	/*
 	 * Not there -- need to make a new entry.
 	 */
 	result = STAlloc(vmHandle, table, hdr, bucket, hashval, name, len);
+	if (result != NullID && side != NULL) {
+	    STSideAdd(side, hash32, result, name, len);
+	}
     }
 	
     /*
@@ -12,6 +12,7 @@
  *	Date	  Name	    Description
  *	----	  ----	    -----------
  *	8/ 3/89	  ardeb	    Initial version
+ *	10/16/26  agent	    Added the in-memory side index (stSide.c)
  *
  * DESCRIPTION:
  *	Internal definitions for the ST module. A string table spans
@@ -28,6 +29,11 @@
  *	      string. The string itself is padded and null-terminated
  *	      to ensure each chain record is word-aligned.
  *
+ *	The chains are what is kept in the file. Searches go instead
+ *	through an in-memory side index (an STSide) built for each table
+ *	the first time it's used, which maps strings to their IDs without
+ *	locking any of the table's blocks.
+ *
  * 	$Id: stInt.h,v 1.7 92/06/03 16:35:11 adam Exp $
  *
  ***********************************************************************/
@@ -114,6 +120,16 @@ extern ID   STAlloc(VMHandle        vmHandle,
 		    const char	    *name,
 		    int 	    len);
 
+typedef struct _STSide	STSide;
+
+extern dword	STHash32(const char *name, int len);
+extern STSide	*STSideFind(VMHandle vmHandle, VMBlockHandle table);
+extern ID   	STSideSearch(STSide *side, dword hash, const char *name,
+			     int len);
+extern void 	STSideAdd(STSide *side, dword hash, ID id, const char *name,
+			  int len);
+extern void 	STSideDiscard(VMHandle vmHandle, VMBlockHandle table);
+
 
 #define STVM_LOCK(v,p,m) (VMLock((v), (p)->vmBlock, (m)) + (p)->offset)
 #define STVM_UNLOCK(v,p)    VMUnlock((v), (p)->vmBlock)
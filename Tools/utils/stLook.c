@@ -42,6 +42,7 @@ static char *rcsid =
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	8/ 4/89		Initial Revision
+ *	agent	10/16/26	Use the side index when there is one
  *
  ***********************************************************************/
 ID
@@ -54,6 +55,16 @@ ST_Lookup(VMHandle   	vmHandle,   	/* File in which table resides */
     STHeader 	    *hdr;   	/* Address of header block */
     ID	    	    result; 	/* ID to return as result */
     word    	    hashval;	/* Actual hash value for the string */
+    STSide  	    *side;  	/* Side index for the table */
+
+    /*
+     * The side index has every string in the table, so its answer is
+     * final.
+     */
+    side = STSideFind(vmHandle, table);
+    if (side != NULL) {
+	return(STSideSearch(side, STHash32(name, len), name, len));
+    }
 
     /*
      * Figure in which bucket the thing should reside.
@@ -0,0 +1,470 @@
+/***********************************************************************
+ *
+ *	Copyright (c) GeoWorks 1996 -- All Rights Reserved
+ *
+ * PROJECT:	  PCGEOS
+ * MODULE:	  Tools Library -- String Table Handling
+ * FILE:	  stSide.c
+ *
+ * AUTHOR:  	  agent: Oct 16, 2026
+ *
+ * ROUTINES:
+ *	Name	  	    Description
+ *	----	  	    -----------
+ *	STHash32    	    Form the 32-bit hash used by the side index
+ *	STSideFind  	    Locate (or build) the side index for a table
+ *	STSideSearch	    Map a string to its ID using a side index
+ *	STSideAdd   	    Record a newly-allocated string in a side index
+ *	STSideDiscard	    Throw away the side index(es) for a table or file
+ *
+ * REVISION HISTORY:
+ *	Date	  Name	    Description
+ *	----	  ----	    -----------
+ *	10/16/26  agent	    Initial version
+ *
+ * DESCRIPTION:
+ *	An in-memory index kept alongside each string table in use. The
+ *	table itself, with its 257 buckets of chain blocks, is what goes
+ *	into the file and is left exactly as it was; the side index just
+ *	lets ST_Enter and ST_Lookup get from a string to its ID without
+ *	locking down the header and a chain block for every search, and
+ *	with a hash strong enough that a table with hundreds of thousands
+ *	of strings doesn't degenerate into a linear search.
+ *
+ *	The index is an open-addressed hash table, probed linearly, that
+ *	doubles whenever it gets three-quarters full. Each entry holds the
+ *	full 32-bit hash, the ID and a pointer to a private copy of the
+ *	string, so comparing against an entry never touches the VM file.
+ *
+ *	An index is built, from the chains in the file, the first time
+ *	a table is used and is thereafter kept current by STAlloc's
+ *	callers, so a miss in the index is as good as a miss in the
+ *	table. Should memory run out, the index is discarded and the
+ *	table is searched the old way.
+ *
+ ***********************************************************************/
+#ifndef lint
+static char *rcsid =
+"$Id$";
+#endif lint
+
+#include <config.h>
+#include <compat/string.h>
+#include <compat/stdlib.h>
+#include "stInt.h"
+
+#include "malloc.h"
+
+#define ST_SIDE_INIT_SIZE   256	    /* Initial number of entries in an index
+				     * (must be a power of 2) */
+#define ST_SIDE_POOL_SIZE   16384   /* Bytes of string storage allocated at
+				     * once */
+
+/*
+ * An entry in the index. An entry whose id is NullID is empty.
+ */
+typedef struct {
+    dword   	    hash;   	/* Full 32-bit hash of the string */
+    ID	    	    id;	    	/* ID of the string in the table */
+    const char	    *string;	/* Our copy of the string */
+    int	    	    length; 	/* Length of same */
+} STSideEntry;
+
+/*
+ * A block of storage for the strings in an index. The strings follow
+ * the header.
+ */
+typedef struct _STSidePool {
+    struct _STSidePool	*next;	    /* Next pool for the same index */
+} STSidePool;
+
+struct _STSide {
+    struct _STSide  *next;  	/* Next index in use */
+    VMHandle	    vmHandle;	/* File in which table resides */
+    VMBlockHandle   table;  	/* Header block of table */
+    STSideEntry	    *entries;	/* The hash table itself */
+    dword   	    size;   	/* Number of entries in same */
+    dword   	    count;  	/* Number of them in use */
+    STSidePool	    *pools; 	/* Storage for the strings */
+    char    	    *avail; 	/* Next free byte in the first pool */
+    int	    	    left;   	/* Bytes remaining there */
+};
+
+static STSide	*stSides = NULL;    /* All the indices in use */
+
+/***********************************************************************
+ *				STHash32
+ ***********************************************************************
+ * SYNOPSIS:	    Form the 32-bit hash value for a string.
+ * CALLED BY:	    ST_Enter, ST_Lookup, ST_Dup, ST_DupNoEnter, STSideFind
+ * RETURN:	    The hash value
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:	    FNV-1a: xor in each byte, then multiply by the
+ *	    	    32-bit FNV prime. Unlike STHash, which must stay as
+ *	    	    it is since its value is stored in the file, every
+ *	    	    byte here affects every bit of the result.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+dword
+STHash32(const char *name,  	/* String to hash */
+	 int	    len)	/* Length of name */
+{
+    const byte	*cp;
+    dword   	hash;
+
+    for (hash = 2166136261UL, cp = (const byte *)name; len > 0; len--) {
+	hash ^= *cp++;
+	hash *= 16777619UL;
+    }
+    return(hash & 0xffffffffUL);
+}
+
+/***********************************************************************
+ *				STSideFree
+ ***********************************************************************
+ * SYNOPSIS:	    Release all the memory for an index.
+ * CALLED BY:	    STSideFind, STSideDiscard
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The index is removed from stSides and freed.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+STSideFree(STSide   *side)
+{
+    STSide  	**prev;
+    STSidePool	*pool, *next;
+
+    for (prev = &stSides; *prev != NULL; prev = &(*prev)->next) {
+	if (*prev == side) {
+	    *prev = side->next;
+	    break;
+	}
+    }
+
+    for (pool = side->pools; pool != NULL; pool = next) {
+	next = pool->next;
+	free((malloc_t)pool);
+    }
+    if (side->entries != NULL) {
+	free((malloc_t)side->entries);
+    }
+    free((malloc_t)side);
+}
+
+/***********************************************************************
+ *				STSideInsert
+ ***********************************************************************
+ * SYNOPSIS:	    Place an entry in an index, growing the hash table
+ *	    	    and copying the string as needed.
+ * CALLED BY:	    STSideFind, STSideAdd
+ * RETURN:	    Non-zero if the entry could be added; zero if we
+ *	    	    ran out of memory.
+ * SIDE EFFECTS:    The entries may move.
+ *
+ * STRATEGY:	    Double the table once it's three-quarters full,
+ *	    	    rehashing from the stored hashes (the strings
+ *	    	    needn't be looked at). Strings are copied into
+ *	    	    pools, one that won't fit in a pool getting its own.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+STSideInsert(STSide 	*side,
+	     dword  	hash,
+	     ID	    	id,
+	     const char	*name,
+	     int    	len)
+{
+    STSideEntry	*ent;
+    dword   	mask;
+    char    	*copy;
+
+    if ((side->count + 1) * 4 > side->size * 3) {
+	STSideEntry *old = side->entries;
+	dword	    oldSize = side->size;
+	dword	    i;
+
+	side->entries = (STSideEntry *)calloc(oldSize * 2,
+					      sizeof(STSideEntry));
+	if (side->entries == NULL) {
+	    side->entries = old;
+	    return(0);
+	}
+	side->size = oldSize * 2;
+	mask = side->size - 1;
+
+	for (i = 0; i < oldSize; i++) {
+	    if (old[i].id != NullID) {
+		for (ent = &side->entries[old[i].hash & mask];
+		     ent->id != NullID;
+		     ent = &side->entries[(ent - side->entries + 1) & mask])
+		{
+		    ;
+		}
+		*ent = old[i];
+	    }
+	}
+	free((malloc_t)old);
+    }
+
+    /*
+     * Copy the string, null-terminated so it may be handed to the likes
+     * of bcmp without fear.
+     */
+    if (len + 1 > side->left) {
+	int	    size = ST_SIDE_POOL_SIZE;
+	STSidePool  *pool;
+
+	if (len + 1 > size - (int)sizeof(STSidePool)) {
+	    size = len + 1 + sizeof(STSidePool);
+	}
+	pool = (STSidePool *)malloc(size);
+	if (pool == NULL) {
+	    return(0);
+	}
+	pool->next = side->pools;
+	side->pools = pool;
+	side->avail = (char *)(pool + 1);
+	side->left = size - sizeof(STSidePool);
+    }
+    copy = side->avail;
+    bcopy(name, copy, len);
+    copy[len] = '\0';
+    side->avail += len + 1;
+    side->left -= len + 1;
+
+    mask = side->size - 1;
+    for (ent = &side->entries[hash & mask];
+	 ent->id != NullID;
+	 ent = &side->entries[(ent - side->entries + 1) & mask])
+    {
+	;
+    }
+    ent->hash = hash;
+    ent->id = id;
+    ent->string = copy;
+    ent->length = len;
+    side->count += 1;
+
+    return(1);
+}
+
+/***********************************************************************
+ *				STSideFind
+ ***********************************************************************
+ * SYNOPSIS:	    Locate the side index for a table, building it from
+ *	    	    the table's chains if this is the first we've seen
+ *	    	    of the table.
+ * CALLED BY:	    ST_Enter, ST_Lookup, ST_Dup, ST_DupNoEnter
+ * RETURN:	    The index, or NULL if there's not the memory for one
+ *	    	    (caller must then use STSearch).
+ * SIDE EFFECTS:    The index found is moved to the front of stSides.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+STSide *
+STSideFind(VMHandle 	vmHandle,   /* File in which table resides */
+	   VMBlockHandle table)	    /* Header block for table */
+{
+    STSide  	**prev;
+    STSide  	*side;
+    STHeader	*hdr;
+    int	    	i;
+
+    for (prev = &stSides; *prev != NULL; prev = &(*prev)->next) {
+	side = *prev;
+	if (side->vmHandle == vmHandle && side->table == table) {
+	    if (prev != &stSides) {
+		*prev = side->next;
+		side->next = stSides;
+		stSides = side;
+	    }
+	    return(side);
+	}
+    }
+
+    side = (STSide *)calloc(1, sizeof(STSide));
+    if (side == NULL) {
+	return(NULL);
+    }
+    side->entries = (STSideEntry *)calloc(ST_SIDE_INIT_SIZE,
+					  sizeof(STSideEntry));
+    if (side->entries == NULL) {
+	free((malloc_t)side);
+	return(NULL);
+    }
+    side->vmHandle = vmHandle;
+    side->table = table;
+    side->size = ST_SIDE_INIT_SIZE;
+    side->next = stSides;
+    stSides = side;
+
+    /*
+     * Enter all the strings already in the table. This is the only time
+     * the side index looks at the chains.
+     */
+    hdr = (STHeader *)VMLock(vmHandle, table, (MemHandle *)NULL);
+
+    for (i = 0; i < ST_NUM_BUCKETS; i++) {
+	STChainHdr  *chdr;
+	STChainPtr  stcp, end;
+	int 	    ok = 1;
+
+	if (hdr->chains[i] == (VMBlockHandle)0) {
+	    continue;
+	}
+	chdr = (STChainHdr *)VMLock(vmHandle, hdr->chains[i],
+				    (MemHandle *)NULL);
+	end = ST_LAST_CP(chdr);
+
+	for (stcp = (STChainPtr)(chdr+1);
+	     stcp < end && ok;
+	     stcp = ST_NEXT_CP(stcp,stcp->length))
+	{
+	    ok = STSideInsert(side,
+			      STHash32(stcp->string, stcp->length),
+			      (ID)((hdr->chains[i] << 16) |
+				   (stcp->string - (char *)chdr)),
+			      stcp->string, stcp->length);
+	}
+	VMUnlock(vmHandle, hdr->chains[i]);
+
+	if (!ok) {
+	    VMUnlock(vmHandle, table);
+	    STSideFree(side);
+	    return(NULL);
+	}
+    }
+
+    VMUnlock(vmHandle, table);
+
+    return(side);
+}
+
+/***********************************************************************
+ *				STSideSearch
+ ***********************************************************************
+ * SYNOPSIS:	    Look for a string in a side index.
+ * CALLED BY:	    ST_Enter, ST_Lookup, ST_Dup, ST_DupNoEnter
+ * RETURN:	    The ID for the string, or NullID if it's not in the
+ *	    	    table.
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+ID
+STSideSearch(STSide 	*side,	    /* Index for the table */
+	     dword  	hash,	    /* STHash32 of the string */
+	     const char	*name,	    /* String for which to search */
+	     int    	len)	    /* Length of same */
+{
+    STSideEntry	*ent;
+    dword   	mask = side->size - 1;
+
+    for (ent = &side->entries[hash & mask];
+	 ent->id != NullID;
+	 ent = &side->entries[(ent - side->entries + 1) & mask])
+    {
+	if (ent->hash == hash && ent->length == len &&
+	    bcmp(ent->string, name, len) == 0)
+	{
+	    return(ent->id);
+	}
+    }
+    return(NullID);
+}
+
+/***********************************************************************
+ *				STSideAdd
+ ***********************************************************************
+ * SYNOPSIS:	    Record a string just entered into a table.
+ * CALLED BY:	    ST_Enter, ST_Dup
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    If there's no memory to hold the new entry, the
+ *	    	    index is discarded, as it can no longer be trusted
+ *	    	    to have every string in the table. side must not be
+ *	    	    used after the call.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+STSideAdd(STSide    	*side,	    /* Index for the table */
+	  dword	    	hash,	    /* STHash32 of the string */
+	  ID	    	id, 	    /* ID STAlloc returned for it */
+	  const char	*name,	    /* The string */
+	  int	    	len)	    /* Length of same */
+{
+    if (!STSideInsert(side, hash, id, name, len)) {
+	STSideFree(side);
+    }
+}
+
+/***********************************************************************
+ *				STSideDiscard
+ ***********************************************************************
+ * SYNOPSIS:	    Throw away the side index for a table, or for all
+ *	    	    the tables in a file.
+ * CALLED BY:	    ST_Destroy, ST_Close, VMClose
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The indices are freed. Should the table be used
+ *	    	    again, its index will be rebuilt.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+STSideDiscard(VMHandle	    vmHandle,	/* File whose index(es) are to go */
+	      VMBlockHandle table)  	/* Table whose index is to go, or 0
+					 * for all tables in the file */
+{
+    STSide  	*side, *next;
+
+    for (side = stSides; side != NULL; side = next) {
+	next = side->next;
+	if (side->vmHandle == vmHandle &&
+	    (table == (VMBlockHandle)0 || side->table == table))
+	{
+	    STSideFree(side);
+	}
+    }
+}
@@ -141,6 +141,10 @@ SOURCE=.\memRAlLk.c
 # End Source File
 # Begin Source File
 
+SOURCE=.\memSlab.c
+# End Source File
+# Begin Source File
+
 SOURCE=.\memUtils.c
 # End Source File
 # Begin Source File
@@ -201,6 +205,10 @@ SOURCE=.\stSearch.c
 # End Source File
 # Begin Source File
 
+SOURCE=.\stSide.c
+# End Source File
+# Begin Source File
+
 SOURCE=.\sttab.c
 # End Source File
 # Begin Source File
@@ -54,6 +54,7 @@ CLEAN :
 	-@erase "$(INTDIR)\memLock.obj"
 	-@erase "$(INTDIR)\memRAl.obj"
 	-@erase "$(INTDIR)\memRAlLk.obj"
+	-@erase "$(INTDIR)\memSlab.obj"
 	-@erase "$(INTDIR)\memUtils.obj"
 	-@erase "$(INTDIR)\objSwap.obj"
 	-@erase "$(INTDIR)\printf.obj"
@@ -69,6 +70,7 @@ CLEAN :
 	-@erase "$(INTDIR)\stLookNL.obj"
 	-@erase "$(INTDIR)\stReloc.obj"
 	-@erase "$(INTDIR)\stSearch.obj"
+	-@erase "$(INTDIR)\stSide.obj"
 	-@erase "$(INTDIR)\sttab.obj"
 	-@erase "$(INTDIR)\vc60.idb"
 	-@erase "$(INTDIR)\vmAl.obj"
@@ -120,6 +122,7 @@ LIB32_OBJS= \
 	"$(INTDIR)\memLock.obj" \
 	"$(INTDIR)\memRAl.obj" \
 	"$(INTDIR)\memRAlLk.obj" \
+	"$(INTDIR)\memSlab.obj" \
 	"$(INTDIR)\memUtils.obj" \
 	"$(INTDIR)\objSwap.obj" \
 	"$(INTDIR)\printf.obj" \
@@ -135,6 +138,7 @@ LIB32_OBJS= \
 	"$(INTDIR)\stLookNL.obj" \
 	"$(INTDIR)\stReloc.obj" \
 	"$(INTDIR)\stSearch.obj" \
+	"$(INTDIR)\stSide.obj" \
 	"$(INTDIR)\sttab.obj" \
 	"$(INTDIR)\vmAl.obj" \
 	"$(INTDIR)\vmAlRd.obj" \
@@ -187,6 +191,7 @@ CLEAN :
 	-@erase "$(INTDIR)\memLock.obj"
 	-@erase "$(INTDIR)\memRAl.obj"
 	-@erase "$(INTDIR)\memRAlLk.obj"
+	-@erase "$(INTDIR)\memSlab.obj"
 	-@erase "$(INTDIR)\memUtils.obj"
 	-@erase "$(INTDIR)\objSwap.obj"
 	-@erase "$(INTDIR)\printf.obj"
@@ -202,6 +207,7 @@ CLEAN :
 	-@erase "$(INTDIR)\stLookNL.obj"
 	-@erase "$(INTDIR)\stReloc.obj"
 	-@erase "$(INTDIR)\stSearch.obj"
+	-@erase "$(INTDIR)\stSide.obj"
 	-@erase "$(INTDIR)\sttab.obj"
 	-@erase "$(INTDIR)\vc60.idb"
 	-@erase "$(INTDIR)\vc60.pdb"
@@ -254,6 +260,7 @@ LIB32_OBJS= \
 	"$(INTDIR)\memLock.obj" \
 	"$(INTDIR)\memRAl.obj" \
 	"$(INTDIR)\memRAlLk.obj" \
+	"$(INTDIR)\memSlab.obj" \
 	"$(INTDIR)\memUtils.obj" \
 	"$(INTDIR)\objSwap.obj" \
 	"$(INTDIR)\printf.obj" \
@@ -269,6 +276,7 @@ LIB32_OBJS= \
 	"$(INTDIR)\stLookNL.obj" \
 	"$(INTDIR)\stReloc.obj" \
 	"$(INTDIR)\stSearch.obj" \
+	"$(INTDIR)\stSide.obj" \
 	"$(INTDIR)\sttab.obj" \
 	"$(INTDIR)\vmAl.obj" \
 	"$(INTDIR)\vmAlRd.obj" \
@@ -411,6 +419,11 @@ SOURCE=.\memRAlLk.c
 "$(INTDIR)\memRAlLk.obj" : $(SOURCE) "$(INTDIR)"
 
 
+SOURCE=.\memSlab.c
+
+"$(INTDIR)\memSlab.obj" : $(SOURCE) "$(INTDIR)"
+
+
 SOURCE=.\memUtils.c
 
 "$(INTDIR)\memUtils.obj" : $(SOURCE) "$(INTDIR)"
@@ -486,6 +499,11 @@ SOURCE=.\stSearch.c
 "$(INTDIR)\stSearch.obj" : $(SOURCE) "$(INTDIR)"
 
 
+SOURCE=.\stSide.c
+
+"$(INTDIR)\stSide.obj" : $(SOURCE) "$(INTDIR)"
+
+
 SOURCE=.\sttab.c
 
 "$(INTDIR)\sttab.obj" : $(SOURCE) "$(INTDIR)"
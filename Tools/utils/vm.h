@@ -39,6 +39,20 @@ typedef word 	VMID;	     	/* Identifier assigned to a
 #define SVMID_HA_DIR	    0xff03
 #define SVMID_HA_BLOCK	    0xff04
 
+/*
+ * Non-zero (the default) to map files opened read-only into memory, where
+ * the system allows it, so locking a block just points into the mapping
+ * rather than reading the block in.
+ */
+extern int  	vmMapFiles;
+
+/*
+ * Non-zero (the default) to write each run of adjacent dirty blocks with
+ * a single gathering write, where the system allows it, rather than
+ * copying them through a buffer.
+ */
+extern int  	vmGatherWrites;
+
 typedef unsigned long VMPtr;
 #define VMP_BLOCK(ptr)	((VMBlockHandle) (((ptr) >> 16) & 0xffff))
 #define VMP_OFFSET(ptr)	((ptr) & 0xffff)
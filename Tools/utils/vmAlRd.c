@@ -12,9 +12,11 @@
  *	Date	  Name	    Description
  *	----	  ----	    -----------
  *	8/ 2/89	  ardeb	    Initial version
+ *	10/16/26  agent	    Added mapping of read-only files
  *
  * DESCRIPTION:
- *	Read a block into new memory from the file
+ *	Read a block into new memory from the file, or point a handle
+ *	at the block where it lies in a mapped file.
  *
  ***********************************************************************/
 #ifndef lint
@@ -29,6 +31,87 @@ static char *rcsid =
 #include <compat/file.h>
 #include <errno.h>
 
+#if defined(unix) || defined(_LINUX)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+int 	vmMapFiles = 1;
+
+
+/***********************************************************************
+ *				VMMapFile
+ ***********************************************************************
+ * SYNOPSIS:	    Map a file opened read-only into memory.
+ * CALLED BY:	    VMOpen
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    file->map and file->mapSize are set if the file
+ *	    	    could be mapped.
+ *
+ * STRATEGY:
+ *	The mapping is private and writable, so the header may still be
+ *	byte-swapped in place when the file is opened without changing
+ *	the file, and blocks never locked are never even read. If the
+ *	file can't be mapped, blocks are just read in, as always.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+VMMapFile(VMFilePtr 	file)
+{
+#if defined(unix) || defined(_LINUX)
+    struct stat	stb;
+    genptr  	base;
+
+    if (!vmMapFiles || fstat(fileno(file->fd), &stb) < 0 ||
+	stb.st_size == 0)
+    {
+	return;
+    }
+
+    base = (genptr)mmap((caddr_t)0, stb.st_size, PROT_READ|PROT_WRITE,
+			MAP_PRIVATE, fileno(file->fd), 0);
+    if (base != (genptr)MAP_FAILED) {
+	file->map = base;
+	file->mapSize = stb.st_size;
+    }
+#endif
+}
+
+
+/***********************************************************************
+ *				VMUnmapFile
+ ***********************************************************************
+ * SYNOPSIS:	    Undo VMMapFile
+ * CALLED BY:	    VMOpen, VMClose
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    Any handles still pointing into the mapping are
+ *	    	    left dangling, so they'd best have been freed.
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+void
+VMUnmapFile(VMFilePtr	file)
+{
+#if defined(unix) || defined(_LINUX)
+    if (file->map != (genptr)NULL) {
+	(void)munmap((caddr_t)file->map, file->mapSize);
+	file->map = (genptr)NULL;
+    }
+#endif
+}
+
 
 /***********************************************************************
  *				VMAllocAndRead
@@ -39,11 +122,20 @@ static char *rcsid =
  * SIDE EFFECTS:    A memory handle is consumed.
  *
  * STRATEGY:
+ *	If the file is mapped and has no relocation routine, the handle
+ *	just points at the block in the mapping. Else allocate the memory
+ *	and read the block in.
+ *
+ *	A relocation routine changes the block in place each time it's
+ *	brought in, and the mapping would keep the changes after the
+ *	handle was freed, so the next VMLock would relocate the block a
+ *	second time. Such blocks always get fresh memory.
  *
  * REVISION HISTORY:
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	7/18/89		Initial Revision
+ *	agent	10/16/26	Use the mapping, if any
  *
  ***********************************************************************/
 MemHandle
@@ -57,15 +149,21 @@ VMAllocAndRead(VMFilePtr    	file,	/* File from which to read it */
     long   	bytesRead = 0;
     char 	errmsg[512];
 
+    if (file->flags & VM_2_0) {
+	pos += sizeof(GeosFileHeader2);
+    }
+
+    if (file->map != (genptr)NULL && file->reloc == (VMRelocRoutine *)0 &&
+	pos + size <= file->mapSize)
+    {
+	return(MemAllocExternal(file->map + pos, size));
+    }
 
     /*XXX: check return */
     memHandle = MemAllocAndLock(size, HF_SWAPABLE|HF_SHARABLE, HAF_NO_ERR,
 				&addr);
 
-    if (FileUtil_Seek(file->fd, ((file->flags & VM_2_0) ?
-				 pos + sizeof(GeosFileHeader2) :
-				 pos),
-		      SEEK_SET) == -1) 
+    if (FileUtil_Seek(file->fd, pos, SEEK_SET) == -1) 
     {
 	char errmsg[512];
 
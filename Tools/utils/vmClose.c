@@ -44,6 +44,8 @@ static char *rcsid =
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	7/19/89		Initial Revision
+ *	agent	10/16/26	Discard string-table side indices
+ *	agent	10/16/26	Unmap the file
  *
  ***********************************************************************/
 void
@@ -65,6 +67,12 @@ VMClose(VMHandle    vmHandle)
 	VMUpdate(vmHandle);
     }
 
+    /*
+     * Any string tables in the file are about to go away, and the handle
+     * may be reused for another file, so biff their side indices.
+     */
+    STSideDiscard(vmHandle, (VMBlockHandle)0);
+
     hdr = file->blkHdr;
     
     /*
@@ -96,6 +104,11 @@ VMClose(VMHandle    vmHandle)
      */
     MemFree(hdr->VMH_blockTable[0].VMB_memHandle);
 
+    /*
+     * No handle points into the mapping of the file now, if it's mapped.
+     */
+    VMUnmapFile(file);
+
     /*
      * Close the stream
      */
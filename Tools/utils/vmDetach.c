@@ -45,6 +45,7 @@ static char *rcsid =
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	9/26/89		Initial Revision
+ *	agent	10/16/26	Copy blocks out of a mapped file
  *
  ***********************************************************************/
 MemHandle
@@ -92,6 +93,19 @@ VMDetach(VMHandle   	vmHandle,
     
     retval = block->VMB_memHandle;
 
+    /*
+     * If the block lies in the mapping of the file, it has to be copied
+     * out, as the mapping goes when the file is closed, while the caller
+     * may hang onto the block much longer than that. MemReAlloc does the
+     * copying for us (and nothing much to a block that's already ours).
+     */
+    if (file->map != (genptr)NULL) {
+	word	size;
+
+	MemInfo(retval, (genptr *)NULL, &size);
+	(void)MemReAlloc(retval, size, HAF_NO_ERR);
+    }
+
 #if 0
     /*
      * If the block is dirty, flush it to disk.
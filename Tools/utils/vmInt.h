@@ -274,6 +274,9 @@ typedef struct {
 				     * being written out */
 #define VM_2_0	    	0x00000008  /* Set if file is a 2.0 VM file */
     int		    fsize;	/* Total size of file */
+    genptr  	    map;    	/* Base of file mapped into memory, or NULL
+				 * if blocks are read in (see VMMapFile) */
+    long    	    mapSize;	/* Number of bytes mapped */
 
 } VMFileRec, *VMFilePtr;
 
@@ -287,8 +290,16 @@ extern void 	    VMFileFree(VMFilePtr file, dword pos, word size);
 extern VMBlock 	    *VMAllocUnassigned(VMFilePtr file);
 extern void 	    VMLinkNewBlocks(VMHeader *hdr, VMBlock *first, int num);
 extern MemHandle    VMAllocAndRead(VMFilePtr file, dword pos, word size);
+extern void 	    VMMapFile(VMFilePtr file);
+extern void 	    VMUnmapFile(VMFilePtr file);
 extern int  	    VMWriteBlock(VMFilePtr file, VMBlock *block);
 
+/*
+ * From the ST module: drop the in-memory indices for string tables in a
+ * file that's going away.
+ */
+extern void 	    STSideDiscard(VMHandle vmHandle, VMBlockHandle table);
+
 #ifdef SWAP
 extern void 	    VMSwapHeader(VMHeader *hdr, word size);
 #endif /* SWAP */
@@ -246,6 +246,7 @@ VMInitFile(VMFilePtr	file)
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	7/18/89		Initial Revision
+ *	agent	10/16/26	Map read-only files
  *
  ***********************************************************************/
 VMHandle
@@ -380,6 +381,14 @@ decode_access:
 	    break;
     }
 
+    /*
+     * A file we'll only be reading is mapped into memory, if possible, so
+     * its blocks needn't be read in one by one.
+     */
+    if (file->flags & VM_READ_ONLY) {
+	VMMapFile(file);
+    }
+
     /*
      * file->fd is now open to the VM file. Now need to locate and read
      * the header.
@@ -555,8 +564,9 @@ decode_access:
 	     */
 	    *status = errno ? errno : EINVAL;
 	    /*
-	     * Close the stream
+	     * Unmap and close the stream
 	     */
+	    VMUnmapFile(file);
 	    (void)FileUtil_Close(file->fd);
 	    /*
 	     * Free the name
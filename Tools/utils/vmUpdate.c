@@ -18,6 +18,7 @@
  *	Date	  Name	    Description
  *	----	  ----	    -----------
  *	8/ 2/89	  ardeb	    Initial version
+ *	10/16/26  agent	    Queue writes in an array; gathering writes
  *
  * DESCRIPTION:
  *	Synchronize a VM file with its in-core image
@@ -29,10 +30,10 @@ static char *rcsid =
 #endif lint
 
 #include <config.h>
-#include <compat/queue.h>
 #include "vmInt.h"
 #include "malloc.h"
 #include <compat/file.h>
+#include <compat/stdlib.h>
 
 #if !defined(_WIN32)
 # define size_t	other_size_t
@@ -45,6 +46,12 @@ static char *rcsid =
 #include <sys/stat.h>
 # include <errno.h>
 
+#if defined(_LINUX)
+#include <unistd.h>
+#endif
+
+int 	vmGatherWrites = 1;
+
 /*
  * Definitions for write-queueing. After running Esp a couple times, I
  * discovered that while it was spending less time doing its thing than
@@ -56,17 +63,21 @@ static char *rcsid =
  * cause a write() system call to be made. This is wasteful. Now, we
  * simply queue all the writes, ordering them by file position, so we
  * can write things as efficiently as possible.
+ *
+ * 10/16/26: The writes are now just appended to an array and sorted
+ * when they're flushed, as keeping a list in order cost time in
+ * proportion to the square of the number of dirty blocks. -- agent
  */
-typedef struct _VMQueue {
-    struct _VMQueue	*next;
-    struct _VMQueue	*prev;
+typedef struct {
     int			fileOff;
     int			size;
     genptr		block;
 } VMQueue;
 
-static VMQueue	writeQueue = { &writeQueue, &writeQueue, -1, 0, 0 };
-    
+static VMQueue	*writeQueue = NULL;	/* Pending writes */
+static int  	writeQueueLen = 0;  	/* Number of them */
+static int  	writeQueueMax = 0;  	/* Number there's room for */
+
 
 /***********************************************************************
  *				VMQueueWrite
@@ -74,7 +85,7 @@ static VMQueue	writeQueue = { &writeQueue, &writeQueue, -1, 0, 0 };
  * SYNOPSIS:	    Queue a block for writing to the file.
  * CALLED BY:	    VMWriteBlock
  * RETURN:	    Nothing
- * SIDE EFFECTS:
+ * SIDE EFFECTS:    The queue may be enlarged.
  *
  * STRATEGY:
  *
@@ -82,6 +93,7 @@ static VMQueue	writeQueue = { &writeQueue, &writeQueue, -1, 0, 0 };
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	10/14/89	Initial Revision
+ *	agent	10/16/26	Append to an array
  *
  ***********************************************************************/
 static void
@@ -90,22 +102,121 @@ VMQueueWrite(int    offset,
 	     genptr block)
 {
     VMQueue 	*q;
-    VMQueue 	*pred;
 
-    q = (VMQueue *)malloc(sizeof(VMQueue));
+    if (writeQueueLen == writeQueueMax) {
+	writeQueueMax = writeQueueMax ? writeQueueMax * 2 : 64;
+	writeQueue = (VMQueue *)realloc((malloc_t)writeQueue,
+					writeQueueMax * sizeof(VMQueue));
+	if (writeQueue == NULL) {
+	    fprintf(stderr, "out of memory queueing writes for vmfile\n");
+	    exit(1);
+	}
+    }
 
+    q = &writeQueue[writeQueueLen++];
     q->fileOff = offset;
     q->size = size;
     q->block = block;
+}
 
-    for (pred = writeQueue.prev;
-	 pred != &writeQueue && pred->fileOff > offset;
-	 pred = pred->prev)
-    {
-	;
+
+/***********************************************************************
+ *				VMQueueCompare
+ ***********************************************************************
+ * SYNOPSIS:	    Order two queued writes by file position, for qsort
+ * CALLED BY:	    VMFlushWrites via qsort
+ * RETURN:	    <0, 0, >0
+ * SIDE EFFECTS:    None
+ *
+ * STRATEGY:
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static int
+VMQueueCompare(const void   *a,
+	       const void   *b)
+{
+    return(((const VMQueue *)a)->fileOff - ((const VMQueue *)b)->fileOff);
+}
+
+#if defined(_LINUX)
+
+/***********************************************************************
+ *				VMGatherWrites
+ ***********************************************************************
+ * SYNOPSIS:	    Write out the (sorted) queue straight from memory,
+ *	    	    seeking once per run of adjacent blocks.
+ * CALLED BY:	    VMFlushWrites
+ * RETURN:	    Nothing
+ * SIDE EFFECTS:    The stream is flushed, as we go around it.
+ *
+ * STRATEGY:
+ *	Blocks are written straight from memory, rather than copied
+ *	through a buffer. A file being built from scratch has its blocks
+ *	placed one after another, so there's usually just the one seek.
+ *	Only lseek and write are used, as they're all the Watcom library
+ *	can be counted on for; the descriptor's position is put back
+ *	afterward for the stream's sake.
+ *
+ * REVISION HISTORY:
+ *	Name	Date		Description
+ *	----	----		-----------
+ *	agent	10/16/26	Initial Revision
+ *
+ ***********************************************************************/
+static void
+VMGatherWrites(VMFilePtr    file)
+{
+    VMQueue 	    *q, *end;
+    int	    	    fd;
+    long    	    base;
+    long    	    next = -1;	/* File offset just past the last block
+				 * written, -1 if we must seek */
+    off_t   	    saved;
+
+    fflush(file->fd);
+    fd = fileno(file->fd);
+    base = (file->flags & VM_2_0) ? sizeof(GeosFileHeader2) : 0;
+    saved = lseek(fd, 0, SEEK_CUR);
+
+    for (q = writeQueue, end = writeQueue + writeQueueLen; q < end; q++) {
+	char	*bp = (char *)q->block;
+	int 	left = q->size;
+	int 	w;
+
+	if (q->fileOff != next &&
+	    lseek(fd, base + q->fileOff, SEEK_SET) < 0)
+	{
+	    next = -1;
+	    continue;
+	}
+
+	/*
+	 * Write it, coping with being interrupted part way.
+	 */
+	while (left > 0) {
+	    w = write(fd, bp, left);
+	    if (w < 0) {
+		if (errno == EINTR) {
+		    continue;
+		}
+		break;
+	    }
+	    bp += w;
+	    left -= w;
+	}
+	next = (left == 0) ? q->fileOff + q->size : -1;
+    }
+
+    if (saved >= 0) {
+	(void)lseek(fd, saved, SEEK_SET);
     }
-    insque((struct qelem*) q, (struct qelem*) pred);
 }
+#endif /* _LINUX */
 
 
 /***********************************************************************
@@ -114,7 +225,7 @@ VMQueueWrite(int    offset,
  * SYNOPSIS:	    Flush pending writes to a file.
  * CALLED BY:	    VMUpdate
  * RETURN:	    Nothing
- * SIDE EFFECTS:
+ * SIDE EFFECTS:    The queue is emptied.
  *
  * STRATEGY:
  *
@@ -122,6 +233,7 @@ VMQueueWrite(int    offset,
  *	Name	Date		Description
  *	----	----		-----------
  *	ardeb	10/14/89	Initial Revision
+ *	agent	10/16/26	Sort the array; use VMGatherWrites if we can
  *
  ***********************************************************************/
 static void
@@ -130,7 +242,7 @@ VMFlushWrites(VMFilePtr	    file)
     genptr	buf;
     int	    	inbuf;
     struct stat	stb;
-    VMQueue 	*q, *nq;
+    VMQueue 	*q, *end;
     int	    	offset;
     int	    	blksize = 2048;	/* assume 2048, unless we can
 				 * find out more in a particular
@@ -157,6 +269,16 @@ VMFlushWrites(VMFilePtr	    file)
 #endif
 #endif /* 0 */
 
+    qsort(writeQueue, writeQueueLen, sizeof(VMQueue), VMQueueCompare);
+
+#if defined(_LINUX)
+    if (vmGatherWrites) {
+	VMGatherWrites(file);
+	writeQueueLen = 0;
+	return;
+    }
+#endif
+
     buf = (genptr)malloc(blksize);
 
     /*
@@ -166,7 +288,7 @@ VMFlushWrites(VMFilePtr	    file)
     inbuf = 0;
     offset = 0;
 
-    for (q = writeQueue.next; q != &writeQueue; q = nq) {
+    for (q = writeQueue, end = writeQueue + writeQueueLen; q < end; q++) {
 	if (offset != q->fileOff) {
 	    /*
 	     * Discontinuity in the queue. If any data stored in the
@@ -237,14 +359,8 @@ VMFlushWrites(VMFilePtr	    file)
 	    inbuf = q->size;
 	    offset += q->size;
 	}
-
-	/*
-	 * Remove the block from the queue and free its record.
-	 */
-	nq = q->next;
-	remque((struct qelem*) q);
-	free((void*) q);
     }
+    writeQueueLen = 0;
 
     /*
      * If any data remaining in the write buffer, flush it to disk now.